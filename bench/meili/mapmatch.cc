@@ -104,10 +104,13 @@ const std::vector<std::string> kBenchmarkCases = {
     VALHALLA_SOURCE_DIR "bench/meili/fixtures/3km_loop_utrecht.json",
 };
 
+// The second argument turns on routing from all of the candidates of a point at once, compare the
+// two to see what it buys for a given trace
 static void BM_ManyCases(benchmark::State& state) {
   logging::Configure({{"type", ""}});
   boost::property_tree::ptree config;
   rapidjson::read_json(VALHALLA_SOURCE_DIR "bench/meili/config.json", config);
+  config.put("meili.default.multi_source_routing", state.range(1) != 0);
   valhalla::tyr::actor_t actor(config, true);
   const std::string test_case(LoadFile(kBenchmarkCases[state.range(0)]));
   for (auto _ : state) {
@@ -115,7 +118,14 @@ static void BM_ManyCases(benchmark::State& state) {
   }
 }
 
-BENCHMARK(BM_ManyCases)->DenseRange(0, kBenchmarkCases.size() - 1);
+BENCHMARK(BM_ManyCases)
+    ->ArgNames({"case", "multi_source"})
+    ->Apply([](benchmark::internal::Benchmark* b) {
+      for (int i = 0; i < static_cast<int>(kBenchmarkCases.size()); ++i) {
+        b->Args({i, 0});
+        b->Args({i, 1});
+      }
+    });
 
 } // namespace
 
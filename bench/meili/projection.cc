@@ -0,0 +1,72 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "meili/geometry_helpers.h"
+#include "midgard/encoded.h"
+
+using namespace valhalla::midgard;
+using namespace valhalla::meili;
+
+namespace {
+
+// a wiggly encoded edge shape with the given number of segments
+std::string MakeShape(size_t segments) {
+  std::mt19937 generator(segments);
+  std::uniform_real_distribution<double> step(-.0005, .0005);
+  std::vector<PointLL> shape{{5.1, 52.1}};
+  while (shape.size() <= segments) {
+    const auto& last = shape.back();
+    shape.emplace_back(last.lng() + step(generator), last.lat() + step(generator));
+  }
+  return encode7(shape);
+}
+
+// the point is either right next to the shape or far enough away that the edge gets rejected
+PointLL MakePoint(bool near) {
+  return near ? PointLL(5.1002, 52.1001) : PointLL(5.2, 52.2);
+}
+
+void BM_ScalarProjection(benchmark::State& state) {
+  const auto encoded = MakeShape(state.range(0));
+  projector_t projector(MakePoint(state.range(1)));
+  for (auto _ : state) {
+    Shape7Decoder<PointLL> shape(encoded.c_str(), encoded.size());
+    benchmark::DoNotOptimize(helpers::Project(projector, shape));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_BufferedProjection(benchmark::State& state) {
+  const auto encoded = MakeShape(state.range(0));
+  projector_t projector(MakePoint(state.range(1)));
+  const double sq_search_radius = 50. * 50.;
+  helpers::ShapeBuffer buffer;
+  for (auto _ : state) {
+    Shape7Decoder<PointLL> shape(encoded.c_str(), encoded.size());
+    buffer.Decode(shape);
+    double sq_distance;
+    const auto segment = helpers::ClosestSegment(projector, buffer, sq_distance);
+    // like the candidate search we only finish the projection when its within the radius
+    if (sq_distance <= sq_search_radius)
+      benchmark::DoNotOptimize(helpers::Project(projector, buffer, segment));
+    benchmark::DoNotOptimize(sq_distance);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void Segments(benchmark::internal::Benchmark* b) {
+  for (int segments : {2, 8, 32, 128}) {
+    b->Args({segments, 1});
+    b->Args({segments, 0});
+  }
+}
+
+BENCHMARK(BM_ScalarProjection)->ArgNames({"segments", "near"})->Apply(Segments);
+BENCHMARK(BM_BufferedProjection)->ArgNames({"segments", "near"})->Apply(Segments);
+
+} // namespace
+
+BENCHMARK_MAIN();
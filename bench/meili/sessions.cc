@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/property_tree/ptree.hpp>
+
+#include "baldr/rapidjson_utils.h"
+#include "meili/map_matcher_factory.h"
+#include "meili/match_sessions.h"
+#include "meili/measurement.h"
+#include "midgard/logging.h"
+#include "midgard/util.h"
+
+using namespace valhalla::midgard;
+using namespace valhalla::meili;
+
+namespace {
+
+#if !defined(VALHALLA_SOURCE_DIR)
+#define VALHALLA_SOURCE_DIR
+#endif
+
+constexpr float kGpsAccuracyMeters = 4.07;
+constexpr float kSearchRadiusMeters = 50;
+
+// the 2.8km loop in utrecht with a point every 20m or so
+std::vector<Measurement> LoadTrace() {
+  boost::property_tree::ptree trace;
+  rapidjson::read_json(VALHALLA_SOURCE_DIR "bench/meili/fixtures/3km_loop_utrecht.json", trace);
+  std::vector<PointLL> shape;
+  for (const auto& point : trace.get_child("shape")) {
+    shape.emplace_back(point.second.get<double>("lon"), point.second.get<double>("lat"));
+  }
+  std::vector<Measurement> measurements;
+  for (const auto& point : resample_spherical_polyline(shape, 20, true)) {
+    measurements.emplace_back(point, kGpsAccuracyMeters, kSearchRadiusMeters);
+  }
+  return measurements;
+}
+
+// Many vehicles driving the loop at the same time, each sends a few points at a time and they
+// take turns doing so, which is what a worker sees when it keeps the sessions of a fleet
+static void BM_OnlineSessions(benchmark::State& state) {
+  logging::Configure({{"type", ""}});
+  boost::property_tree::ptree config;
+  rapidjson::read_json(VALHALLA_SOURCE_DIR "bench/meili/config.json", config);
+  MapMatcherFactory matcher_factory(config);
+  valhalla::Options options;
+  options.set_costing_type(valhalla::Costing::auto_);
+  auto create = [&matcher_factory, &options]() { return matcher_factory.Create(options); };
+
+  const auto trace = LoadTrace();
+  const size_t vehicles = state.range(0);
+  const size_t points_per_request = state.range(1);
+  size_t points = 0;
+  for (auto _ : state) {
+    MatchSessions sessions(vehicles, 0);
+    for (size_t i = 0; i < trace.size(); i += points_per_request) {
+      std::vector<Measurement> chunk(trace.begin() + i,
+                                     trace.begin() + std::min(i + points_per_request, trace.size()));
+      const bool end = i + points_per_request >= trace.size();
+      for (size_t vehicle = 0; vehicle < vehicles; ++vehicle) {
+        const auto id = std::to_string(vehicle);
+        benchmark::DoNotOptimize(sessions.Get(id, "", create)->OnlineMatch(chunk, end));
+        if (end) {
+          sessions.Remove(id);
+        }
+      }
+      points += chunk.size() * vehicles;
+    }
+  }
+  state.SetItemsProcessed(points);
+}
+
+// Matching the whole trace at once for each vehicle, for comparison
+static void BM_OfflineMatches(benchmark::State& state) {
+  logging::Configure({{"type", ""}});
+  boost::property_tree::ptree config;
+  rapidjson::read_json(VALHALLA_SOURCE_DIR "bench/meili/config.json", config);
+  MapMatcherFactory matcher_factory(config);
+  std::unique_ptr<MapMatcher> matcher(matcher_factory.Create(valhalla::Costing::auto_));
+
+  const auto trace = LoadTrace();
+  const size_t vehicles = state.range(0);
+  size_t points = 0;
+  for (auto _ : state) {
+    for (size_t vehicle = 0; vehicle < vehicles; ++vehicle) {
+      benchmark::DoNotOptimize(matcher->OfflineMatch(trace));
+    }
+    points += trace.size() * vehicles;
+  }
+  state.SetItemsProcessed(points);
+}
+
+BENCHMARK(BM_OnlineSessions)->Args({1, 1})->Args({1, 5})->Args({100, 1})->Args({100, 5});
+BENCHMARK(BM_OfflineMatches)->Arg(1)->Arg(100);
+
+} // namespace
+
+BENCHMARK_MAIN();
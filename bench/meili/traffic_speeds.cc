@@ -0,0 +1,83 @@
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/property_tree/ptree.hpp>
+
+#include "baldr/rapidjson_utils.h"
+#include "meili/measurement.h"
+#include "meili/traffic_speed_matcher.h"
+#include "midgard/logging.h"
+#include "midgard/util.h"
+
+using namespace valhalla::midgard;
+using namespace valhalla::meili;
+
+namespace {
+
+#if !defined(VALHALLA_SOURCE_DIR)
+#define VALHALLA_SOURCE_DIR
+#endif
+
+constexpr float kGpsAccuracyMeters = 5;
+constexpr float kSearchRadiusMeters = 50;
+
+// synthetic probes driving part of the 2.8km loop in utrecht, each starts somewhere else on it and
+// goes its own speed, reporting a slightly noisy position every 5 seconds
+std::vector<std::vector<Measurement>> MakeProbes(size_t count) {
+  boost::property_tree::ptree trace;
+  rapidjson::read_json(VALHALLA_SOURCE_DIR "bench/meili/fixtures/3km_loop_utrecht.json", trace);
+  std::vector<PointLL> shape;
+  for (const auto& point : trace.get_child("shape")) {
+    shape.emplace_back(point.second.get<double>("lon"), point.second.get<double>("lat"));
+  }
+  // a point every meter so we can drive along it at any speed
+  const auto loop = resample_spherical_polyline(shape, 1, true);
+
+  std::mt19937 generator(7);
+  std::uniform_int_distribution<size_t> start(0, loop.size() - 1);
+  std::uniform_real_distribution<double> speed(5, 15);
+  std::normal_distribution<double> noise(0, 2e-5);
+  std::vector<std::vector<Measurement>> probes(count);
+  for (auto& probe : probes) {
+    const auto meters_per_report = speed(generator) * 5;
+    double time = 1600000000;
+    for (double along = start(generator), end = along + 1000; along < end;
+         along += meters_per_report, time += 5) {
+      const auto& p = loop[static_cast<size_t>(along) % loop.size()];
+      probe.emplace_back(PointLL(p.lng() + noise(generator), p.lat() + noise(generator)),
+                         kGpsAccuracyMeters, kSearchRadiusMeters, time);
+    }
+  }
+  return probes;
+}
+
+void BM_TrafficSpeeds(benchmark::State& state) {
+  logging::Configure({{"type", ""}});
+  boost::property_tree::ptree config;
+  rapidjson::read_json(VALHALLA_SOURCE_DIR "bench/meili/config.json", config);
+  valhalla::Options options;
+  options.set_costing_type(valhalla::Costing::auto_);
+
+  const auto probes = MakeProbes(state.range(0));
+  TrafficSpeedMatcher matcher(config, state.range(1));
+  for (auto _ : state) {
+    matcher.Clear();
+    benchmark::DoNotOptimize(matcher.Match(probes, options));
+  }
+  state.SetItemsProcessed(state.iterations() * probes.size());
+  state.counters["edges"] = matcher.speeds().size();
+}
+
+BENCHMARK(BM_TrafficSpeeds)
+    ->ArgNames({"probes", "threads"})
+    ->Args({64, 1})
+    ->Args({64, 4})
+    ->Args({512, 1})
+    ->Args({512, 4})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,163 @@
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "midgard/encoded.h"
+#include "midgard/pointll.h"
+
+using namespace valhalla::midgard;
+
+namespace {
+
+// a route like shape with the given number of points, mostly small steps with the odd jump
+const std::vector<PointLL>& MakeShape(size_t points) {
+  static std::vector<PointLL> shape;
+  if (shape.size() == points) {
+    return shape;
+  }
+  std::mt19937 generator(points);
+  std::uniform_real_distribution<double> step(-.0005, .0005);
+  std::bernoulli_distribution jump(.01);
+  shape.assign(1, {5.1, 52.1});
+  while (shape.size() < points) {
+    const auto& last = shape.back();
+    const double scale = jump(generator) ? 100 : 1;
+    shape.emplace_back(last.lng() + scale * step(generator), last.lat() + scale * step(generator));
+  }
+  return shape;
+}
+
+// the encoder as it was before, pushing back one char at a time, to compare against
+template <class container_t>
+std::string LegacyEncode(const container_t& points, const int precision) {
+  std::string output;
+  output.reserve(points.size() * 8);
+  auto serialize = [&output](int number) {
+    number = number < 0 ? ~(static_cast<unsigned int>(number) << 1) : (number << 1);
+    while (number >= 0x20) {
+      output.push_back(static_cast<char>((0x20 | (number & 0x1f)) + 63));
+      number >>= 5;
+    }
+    output.push_back(static_cast<char>(number + 63));
+  };
+  int last_lon = 0, last_lat = 0;
+  for (const auto& p : points) {
+    int lon = static_cast<int>(round(static_cast<double>(p.first) * precision));
+    int lat = static_cast<int>(round(static_cast<double>(p.second) * precision));
+    serialize(lat - last_lat);
+    serialize(lon - last_lon);
+    last_lon = lon;
+    last_lat = lat;
+  }
+  return output;
+}
+
+// the decoder as it was before, bounds checking every char, to compare against
+std::vector<PointLL> LegacyDecode(const std::string& encoded, const double precision) {
+  const char* begin = encoded.data();
+  const char* end = begin + encoded.size();
+  auto next = [&begin, end](const int32_t previous) {
+    int byte, shift = 0, result = 0;
+    do {
+      if (begin == end) {
+        throw std::runtime_error("Bad encoded polyline");
+      }
+      byte = int32_t(*begin++) - 63;
+      result |= (byte & 0x1f) << shift;
+      shift += 5;
+    } while (byte >= 0x20);
+    return previous + (result & 1 ? ~(result >> 1) : (result >> 1));
+  };
+  std::vector<PointLL> points;
+  points.reserve(encoded.size() / 4);
+  int32_t lat = 0, lon = 0;
+  while (begin != end) {
+    lat = next(lat);
+    lon = next(lon);
+    points.emplace_back(double(lon) * precision, double(lat) * precision);
+  }
+  return points;
+}
+
+void BM_LegacyEncode(benchmark::State& state) {
+  const auto& shape = MakeShape(state.range(0));
+  size_t bytes = 0;
+  for (auto _ : state) {
+    auto encoded = LegacyEncode(shape, 1e6);
+    bytes += encoded.size();
+    benchmark::DoNotOptimize(encoded);
+  }
+  state.SetItemsProcessed(state.iterations() * shape.size());
+  state.SetBytesProcessed(bytes);
+}
+
+void BM_Encode(benchmark::State& state) {
+  const auto& shape = MakeShape(state.range(0));
+  size_t bytes = 0;
+  for (auto _ : state) {
+    auto encoded = encode(shape, 1e6);
+    bytes += encoded.size();
+    benchmark::DoNotOptimize(encoded);
+  }
+  state.SetItemsProcessed(state.iterations() * shape.size());
+  state.SetBytesProcessed(bytes);
+}
+
+void BM_Encode7(benchmark::State& state) {
+  const auto& shape = MakeShape(state.range(0));
+  size_t bytes = 0;
+  for (auto _ : state) {
+    auto encoded = encode7(shape, 1e6);
+    bytes += encoded.size();
+    benchmark::DoNotOptimize(encoded);
+  }
+  state.SetItemsProcessed(state.iterations() * shape.size());
+  state.SetBytesProcessed(bytes);
+}
+
+void BM_LegacyDecode(benchmark::State& state) {
+  const auto encoded = encode(MakeShape(state.range(0)), 1e6);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(LegacyDecode(encoded, 1e-6));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * encoded.size());
+}
+
+void BM_Decode(benchmark::State& state) {
+  const auto encoded = encode(MakeShape(state.range(0)), 1e6);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(decode<std::vector<PointLL>>(encoded));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * encoded.size());
+}
+
+void BM_Decode7(benchmark::State& state) {
+  const auto encoded = encode7(MakeShape(state.range(0)), 1e6);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(decode7<std::vector<PointLL>>(encoded));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * encoded.size());
+}
+
+// up to shapes with a million points
+void Points(benchmark::internal::Benchmark* b) {
+  b->RangeMultiplier(100)->Range(100, 1000000)->Unit(benchmark::kMicrosecond);
+}
+
+BENCHMARK(BM_LegacyEncode)->Apply(Points);
+BENCHMARK(BM_Encode)->Apply(Points);
+BENCHMARK(BM_Encode7)->Apply(Points);
+BENCHMARK(BM_LegacyDecode)->Apply(Points);
+BENCHMARK(BM_Decode)->Apply(Points);
+BENCHMARK(BM_Decode7)->Apply(Points);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,107 @@
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "loki/worker.h"
+#include "midgard/logging.h"
+#include "odin/directionsbuilder.h"
+#include "odin/markup_formatter.h"
+#include "thor/worker.h"
+#include "worker.h"
+
+#include "test.h"
+
+using namespace valhalla;
+
+namespace {
+
+#if !defined(VALHALLA_SOURCE_DIR)
+#define VALHALLA_SOURCE_DIR
+#endif
+
+// the test_requests that stay inside the utrecht tiles, routed once up front so that only odin
+// is being measured. each line looks like: -j '{"locations":[...],"costing":"auto"}'
+const std::vector<Api>& Routes() {
+  static std::vector<Api> routes;
+  if (!routes.empty()) {
+    return routes;
+  }
+
+  logging::Configure({{"type", ""}});
+  const auto config =
+      test::make_config("test/data/utrecht_tiles", {},
+                        {{"additional_data", "mjolnir.traffic_extract", "mjolnir.tile_extract"}});
+  loki::loki_worker_t loki_worker(config);
+  thor::thor_worker_t thor_worker(config);
+  for (const auto* file : {"nl_bicycle_routes.txt", "random_routes.txt"}) {
+    std::ifstream requests(std::string(VALHALLA_SOURCE_DIR "test_requests/") + file);
+    std::string line;
+    while (std::getline(requests, line)) {
+      const auto begin = line.find('{');
+      const auto end = line.rfind('}');
+      if (begin == std::string::npos || end == std::string::npos) {
+        continue;
+      }
+      Api api;
+      ParseApi(line.substr(begin, end - begin + 1), Options::route, api);
+      bool in_utrecht = true;
+      for (const auto& location : api.options().locations()) {
+        in_utrecht = in_utrecht && location.ll().lat() > 52 && location.ll().lat() < 52.2 &&
+                     location.ll().lng() > 5 && location.ll().lng() < 5.2;
+      }
+      if (!in_utrecht) {
+        continue;
+      }
+      try {
+        loki_worker.route(api);
+        thor_worker.route(api);
+        routes.emplace_back(std::move(api));
+      } catch (...) {}
+      loki_worker.cleanup();
+      thor_worker.cleanup();
+    }
+  }
+  return routes;
+}
+
+// odin for every route with the output the argument picks: valhalla json with instructions, osrm
+// json with instructions, json without narrative and gpx
+void BM_DirectionsBuilder(benchmark::State& state) {
+  const auto& routes = Routes();
+  if (routes.empty()) {
+    state.SkipWithError("No test_requests could be routed on the utrecht tiles");
+    return;
+  }
+
+  const auto format = static_cast<Options::Format>(state.range(0));
+  const auto directions_type = static_cast<DirectionsType>(state.range(1));
+  const odin::MarkupFormatter markup_formatter;
+  for (auto _ : state) {
+    for (const auto& route : routes) {
+      state.PauseTiming();
+      Api api = route;
+      api.mutable_options()->set_format(format);
+      api.mutable_options()->set_directions_type(directions_type);
+      state.ResumeTiming();
+      odin::DirectionsBuilder::Build(api, markup_formatter);
+      benchmark::DoNotOptimize(api);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * routes.size());
+  state.counters["routes"] = routes.size();
+}
+
+BENCHMARK(BM_DirectionsBuilder)
+    ->ArgNames({"format", "directions"})
+    ->Args({Options::json, DirectionsType::instructions})
+    ->Args({Options::osrm, DirectionsType::instructions})
+    ->Args({Options::json, DirectionsType::maneuvers})
+    ->Args({Options::json, DirectionsType::none})
+    ->Args({Options::gpx, DirectionsType::instructions})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <array>
 #include <benchmark/benchmark.h>
 #include <iostream>
@@ -47,6 +48,49 @@ void BM_ReachUtrecht(benchmark::State& state) {
 
 BENCHMARK(BM_ReachUtrecht)->Unit(benchmark::kMillisecond)->Repetitions(10);
 
+// The same but with results remembered across iterations like they are across requests in loki
+void BM_ReachUtrechtCached(benchmark::State& state) {
+
+  const auto config =
+      test::make_config("test/data/utrecht_tiles", {},
+                        {{"additional_data", "mjolnir.traffic_extract", "mjolnir.tile_extract"}});
+
+  // get tile access
+  GraphReader reader(config.get_child("mjolnir"));
+
+  auto costing = sif::CostFactory{}.Create(Costing::auto_);
+  loki::ReachCache cache(1 << 24);
+  loki::Reach reach_finder(&cache, 0);
+
+  using Edge = std::pair<GraphId, const DirectedEdge*>;
+  std::vector<Edge> edges;
+
+  for (auto tile_id : reader.GetTileSet()) {
+    auto tile = reader.GetGraphTile(tile_id);
+    for (GraphId edge_id = tile->header()->graphid();
+         edge_id.id() < tile->header()->directededgecount(); ++edge_id) {
+      const auto* edge = tile->directededge(edge_id);
+      edges.emplace_back(edge_id, edge);
+    }
+  }
+
+  // warm it up so we only measure the lookups
+  for (const auto& edge : edges) {
+    reach_finder(edge.second, edge.first, 50, reader, costing, kInbound | kOutbound);
+  }
+
+  for (auto _ : state) {
+    for (const auto& edge : edges) {
+      auto reach = reach_finder(edge.second, edge.first, 50, reader, costing, kInbound | kOutbound);
+      benchmark::DoNotOptimize(reach);
+    }
+  }
+  state.counters["hit_rate"] =
+      static_cast<double>(cache.hits()) / std::max<size_t>(cache.hits() + cache.misses(), 1);
+}
+
+BENCHMARK(BM_ReachUtrechtCached)->Unit(benchmark::kMillisecond)->Repetitions(10);
+
 } // namespace
 
 BENCHMARK_MAIN();
@@ -0,0 +1,73 @@
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "worker.h"
+
+using namespace valhalla;
+
+namespace {
+
+// a request for each action with the amount of input growing with the argument
+std::string MakeRequest(Options::Action action, size_t count) {
+  std::string points;
+  for (size_t i = 0; i < count; ++i) {
+    points += (i ? ",{\"lat\":" : "{\"lat\":") + std::to_string(52.09 + i * 1e-3) +
+              ",\"lon\":" + std::to_string(5.11 + i * 1e-3) + "}";
+  }
+  switch (action) {
+    case Options::sources_to_targets:
+      return R"({"costing":"auto","sources":[)" + points + R"(],"targets":[)" + points + "]}";
+    case Options::trace_route:
+      return R"({"costing":"auto","shape_match":"map_snap","shape":[)" + points + "]}";
+    case Options::isochrone:
+      return R"({"costing":"auto","contours":[{"time":10}],"locations":[)" + points + "]}";
+    default:
+      return R"({"costing":"auto","locations":[)" + points + "]}";
+  }
+}
+
+// json parsing plus from_json
+void BM_ParseJson(benchmark::State& state) {
+  const auto action = static_cast<Options::Action>(state.range(0));
+  const auto request = MakeRequest(action, state.range(1));
+  Api api;
+  for (auto _ : state) {
+    ParseApi(request, action, api);
+    benchmark::DoNotOptimize(api);
+  }
+  state.SetBytesProcessed(state.iterations() * request.size());
+}
+
+// the same request as pbf bytes, deserialized and then validated like json would be
+void BM_ParsePbf(benchmark::State& state) {
+  const auto action = static_cast<Options::Action>(state.range(0));
+  Api parsed;
+  ParseApi(MakeRequest(action, state.range(1)), action, parsed);
+  parsed.clear_info();
+  const auto bytes = parsed.SerializeAsString();
+  Api api;
+  for (auto _ : state) {
+    api.ParseFromString(bytes);
+    ParseApi("", action, api);
+    benchmark::DoNotOptimize(api);
+  }
+  state.SetBytesProcessed(state.iterations() * bytes.size());
+}
+
+void Actions(benchmark::internal::Benchmark* b) {
+  for (int action : {Options::route, Options::sources_to_targets, Options::trace_route,
+                     Options::isochrone}) {
+    for (int count : {2, 50}) {
+      b->Args({action, count});
+    }
+  }
+}
+
+BENCHMARK(BM_ParseJson)->ArgNames({"action", "locations"})->Apply(Actions);
+BENCHMARK(BM_ParsePbf)->ArgNames({"action", "locations"})->Apply(Actions);
+
+} // namespace
+
+BENCHMARK_MAIN();
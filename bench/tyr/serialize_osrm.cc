@@ -0,0 +1,144 @@
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "loki/worker.h"
+#include "midgard/logging.h"
+#include "odin/worker.h"
+#include "thor/worker.h"
+#include "tyr/serializers.h"
+#include "worker.h"
+
+#include "test.h"
+
+using namespace valhalla;
+
+namespace {
+
+#if !defined(VALHALLA_SOURCE_DIR)
+#define VALHALLA_SOURCE_DIR
+#endif
+
+// at most this many legs in the long route
+constexpr int kMaxLegs = 50;
+
+// the test_requests that stay inside the utrecht tiles as osrm requests, routed and narrated once
+// up front so that only the serializer is being measured. each line looks like:
+// -j '{"locations":[...],"costing":"auto"}'. the second set is a single long route through their
+// origins one after the other, which is as close to a cross country route as utrecht gets
+const std::vector<Api>& Routes(bool long_route) {
+  static std::vector<Api> routes[2];
+  if (!routes[long_route].empty()) {
+    return routes[long_route];
+  }
+
+  logging::Configure({{"type", ""}});
+  const auto config =
+      test::make_config("test/data/utrecht_tiles", {},
+                        {{"additional_data", "mjolnir.traffic_extract", "mjolnir.tile_extract"}});
+  loki::loki_worker_t loki_worker(config);
+  thor::thor_worker_t thor_worker(config);
+  odin::odin_worker_t odin_worker(config);
+  auto directions = [&](const std::string& request, std::vector<Api>& into) {
+    Api api;
+    ParseApi(request, Options::route, api);
+    api.mutable_options()->set_format(Options::osrm);
+    try {
+      loki_worker.route(api);
+      thor_worker.route(api);
+      odin_worker.narrate(api);
+      into.emplace_back(std::move(api));
+    } catch (...) {}
+    loki_worker.cleanup();
+    thor_worker.cleanup();
+  };
+
+  std::vector<std::string> origins;
+  for (const auto* file : {"nl_bicycle_routes.txt", "random_routes.txt"}) {
+    std::ifstream requests(std::string(VALHALLA_SOURCE_DIR "test_requests/") + file);
+    std::string line;
+    while (std::getline(requests, line)) {
+      const auto begin = line.find('{');
+      const auto end = line.rfind('}');
+      if (begin == std::string::npos || end == std::string::npos) {
+        continue;
+      }
+      const auto request = line.substr(begin, end - begin + 1);
+      Api api;
+      ParseApi(request, Options::route, api);
+      bool in_utrecht = true;
+      for (const auto& location : api.options().locations()) {
+        in_utrecht = in_utrecht && location.ll().lat() > 52 && location.ll().lat() < 52.2 &&
+                     location.ll().lng() > 5 && location.ll().lng() < 5.2;
+      }
+      if (!in_utrecht) {
+        continue;
+      }
+      const auto& origin = api.options().locations(0).ll();
+      origins.emplace_back(R"({"lat":)" + std::to_string(origin.lat()) + R"(,"lon":)" +
+                           std::to_string(origin.lng()) + "}");
+      directions(request, routes[false]);
+    }
+  }
+
+  // add the origins one after the other, leaving out the ones we cant route to
+  std::string locations;
+  std::vector<Api> attempt;
+  for (const auto& origin : origins) {
+    if (locations.empty()) {
+      locations = origin;
+      continue;
+    }
+    attempt.clear();
+    directions(R"({"costing":"auto","locations":[)" + locations + "," + origin + "]}", attempt);
+    if (!attempt.empty()) {
+      locations += "," + origin;
+      routes[true] = std::move(attempt);
+      if (routes[true].front().options().locations_size() > kMaxLegs) {
+        break;
+      }
+    }
+  }
+  return routes[long_route];
+}
+
+// serializeDirections in osrm format for every route, or for one long route with many legs
+void BM_SerializeOsrm(benchmark::State& state) {
+  const auto& routes = Routes(state.range(0));
+  if (routes.empty()) {
+    state.SkipWithError("No test_requests could be routed on the utrecht tiles");
+    return;
+  }
+
+  const auto shape_format = static_cast<ShapeFormat>(state.range(1));
+  size_t bytes = 0;
+  for (auto _ : state) {
+    for (const auto& route : routes) {
+      state.PauseTiming();
+      Api api = route;
+      api.mutable_options()->set_shape_format(shape_format);
+      state.ResumeTiming();
+      auto json = tyr::serializeDirections(api);
+      bytes += json.size();
+      benchmark::DoNotOptimize(json);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * routes.size());
+  state.SetBytesProcessed(bytes);
+  state.counters["routes"] = routes.size();
+  state.counters["legs"] = routes.front().trip().routes(0).legs_size();
+}
+
+BENCHMARK(BM_SerializeOsrm)
+    ->ArgNames({"long", "shape_format"})
+    ->Args({0, polyline6})
+    ->Args({0, geojson})
+    ->Args({1, polyline6})
+    ->Args({1, polyline5})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -534,6 +535,34 @@ bool GraphReader::DoesTileExist(const GraphId& graphid) const {
          stat((file_location + ".gz").c_str(), &buffer) == 0;
 }
 
+uint64_t GraphReader::GetTrafficLastUpdate() const {
+  // only the headers are read, the speeds after them can be changing under us
+  uint64_t last_update = 0;
+  for (const auto& tile : tile_extract_->traffic_tiles) {
+    if (tile.second.second < sizeof(TrafficTileHeader)) {
+      continue;
+    }
+    const auto* header = reinterpret_cast<const volatile TrafficTileHeader*>(tile.second.first);
+    if (header->traffic_tile_version == TRAFFIC_TILE_VERSION) {
+      last_update = std::max(last_update, static_cast<uint64_t>(header->last_update));
+    }
+  }
+  return last_update;
+}
+
+uint64_t GraphReader::GetDatasetId() {
+  for (const auto& tile_id : GetTileSet()) {
+    if (tile_id.level() >= TileHierarchy::GetTransitLevel().level) {
+      continue;
+    }
+    auto tile = GetGraphTile(tile_id);
+    if (tile && tile->header()->nodecount() > 0) {
+      return tile->header()->dataset_id();
+    }
+  }
+  return 0;
+}
+
 class TarballGraphMemory final : public GraphMemory {
 public:
   TarballGraphMemory(std::shared_ptr<midgard::tar> archive, std::pair<char*, size_t> position)
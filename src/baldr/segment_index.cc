@@ -0,0 +1,164 @@
+#include "baldr/segment_index.h"
+#include "midgard/constants.h"
+#include "midgard/util.h"
+
+#include <algorithm>
+#include <cstring>
+#include <queue>
+#include <stdexcept>
+#include <unordered_set>
+
+using namespace valhalla::midgard;
+
+namespace {
+
+// an entry in the best first search queue, either a box of the tree or an actual segment
+struct queue_entry_t {
+  double sq_distance;
+  uint64_t index;
+  int32_t level; // -1 for segments
+  bool operator>(const queue_entry_t& other) const {
+    // break ties deterministically so results do not depend on the heap implementation
+    if (sq_distance != other.sq_distance)
+      return sq_distance > other.sq_distance;
+    if (level != other.level)
+      return level > other.level;
+    return index > other.index;
+  }
+};
+
+constexpr double kSqMetersPerDegreeLat = kMetersPerDegreeLat * kMetersPerDegreeLat;
+
+} // namespace
+
+namespace valhalla {
+namespace baldr {
+
+SegmentIndex::SegmentIndex(const std::string& file_name)
+    : header_(nullptr), segments_(nullptr), boxes_(nullptr) {
+  // map the whole thing in
+  filesystem::directory_entry entry(file_name);
+  if (!entry.is_regular_file() || entry.file_size() < sizeof(SegmentIndexHeader))
+    throw std::runtime_error("Segment index " + file_name + " is missing or truncated");
+  memory_.map(file_name, entry.file_size(), POSIX_MADV_RANDOM, true);
+
+  // check that its what we expect
+  header_ = reinterpret_cast<const SegmentIndexHeader*>(memory_.get());
+  if (std::memcmp(header_->magic, kSegmentIndexMagic, sizeof(kSegmentIndexMagic)) != 0 ||
+      header_->version != kSegmentIndexVersion || header_->node_size < 2 ||
+      header_->level_count == 0 || header_->level_count > kSegmentIndexMaxLevels)
+    throw std::runtime_error("Segment index " + file_name + " has an unsupported format");
+
+  // check that the sizes add up
+  size_t box_count = header_->level_offsets[header_->level_count - 1] +
+                     header_->level_sizes[header_->level_count - 1];
+  size_t expected = sizeof(SegmentIndexHeader) + header_->segment_count * sizeof(IndexedSegment) +
+                    box_count * sizeof(SegmentBox);
+  if (expected != memory_.size())
+    throw std::runtime_error("Segment index " + file_name + " is corrupt");
+
+  segments_ = reinterpret_cast<const IndexedSegment*>(memory_.get() + sizeof(SegmentIndexHeader));
+  boxes_ = reinterpret_cast<const SegmentBox*>(segments_ + header_->segment_count);
+}
+
+void SegmentIndex::Visit(const PointLL& point,
+                         double max_distance,
+                         const Filter& filter,
+                         const std::function<bool(const Hit&)>& visitor) const {
+  if (header_->segment_count == 0)
+    return;
+
+  // we measure everything in the same equirectangular approximation that loki uses
+  projector_t project(point);
+  const double x = point.lng();
+  const double y = point.lat();
+  auto box_distance = [&](const SegmentBox& box) {
+    double dx = 0, dy = 0;
+    double minx = box.minx / kSegmentIndexPrecision, maxx = box.maxx / kSegmentIndexPrecision;
+    double miny = box.miny / kSegmentIndexPrecision, maxy = box.maxy / kSegmentIndexPrecision;
+    if (x < minx)
+      dx = minx - x;
+    else if (x > maxx)
+      dx = x - maxx;
+    if (y < miny)
+      dy = miny - y;
+    else if (y > maxy)
+      dy = y - maxy;
+    dx *= project.lon_scale;
+    return (dx * dx + dy * dy) * kSqMetersPerDegreeLat;
+  };
+
+  // seed with the root and go best first until we are beyond the max distance
+  const double sq_max_distance = max_distance * max_distance;
+  const uint64_t node_size = header_->node_size;
+  const int32_t root = header_->level_count - 1;
+  std::priority_queue<queue_entry_t, std::vector<queue_entry_t>, std::greater<queue_entry_t>> queue;
+  queue.push({box_distance(boxes_[header_->level_offsets[root]]), 0, root});
+  while (!queue.empty()) {
+    auto entry = queue.top();
+    queue.pop();
+    if (entry.sq_distance > sq_max_distance)
+      break;
+
+    // its an actual segment so we can report it
+    if (entry.level < 0) {
+      const auto& segment = segments_[entry.index];
+      auto closest = project(segment.a(), segment.b());
+      if (!visitor(Hit{GraphId(segment.edge_id), segment.shape_index, closest,
+                       std::sqrt(entry.sq_distance)}))
+        break;
+      continue;
+    }
+
+    // its a box so we queue its children
+    uint64_t begin = entry.index * node_size;
+    if (entry.level == 0) {
+      uint64_t end = std::min<uint64_t>(begin + node_size, header_->segment_count);
+      for (uint64_t i = begin; i < end; ++i) {
+        const auto& segment = segments_[i];
+        if (!filter.allowed(segment))
+          continue;
+        auto closest = project(segment.a(), segment.b());
+        queue.push({project.approx.DistanceSquared(closest), i, -1});
+      }
+    } else {
+      const auto level = entry.level - 1;
+      const auto* boxes = boxes_ + header_->level_offsets[level];
+      uint64_t end = std::min<uint64_t>(begin + node_size, header_->level_sizes[level]);
+      for (uint64_t i = begin; i < end; ++i) {
+        queue.push({box_distance(boxes[i]), i, level});
+      }
+    }
+  }
+}
+
+std::vector<SegmentIndex::Hit> SegmentIndex::Nearest(const PointLL& point,
+                                                     size_t k,
+                                                     const Filter& filter,
+                                                     double max_distance) const {
+  std::vector<Hit> hits;
+  if (k == 0)
+    return hits;
+  std::unordered_set<uint64_t> edges;
+  Visit(point, max_distance, filter, [&](const Hit& hit) {
+    if (edges.insert(hit.edge_id).second)
+      hits.push_back(hit);
+    return hits.size() < k;
+  });
+  return hits;
+}
+
+std::vector<SegmentIndex::Hit>
+SegmentIndex::Within(const PointLL& point, double radius, const Filter& filter) const {
+  std::vector<Hit> hits;
+  std::unordered_set<uint64_t> edges;
+  Visit(point, radius, filter, [&](const Hit& hit) {
+    if (edges.insert(hit.edge_id).second)
+      hits.push_back(hit);
+    return true;
+  });
+  return hits;
+}
+
+} // namespace baldr
+} // namespace valhalla
@@ -1,9 +1,12 @@
+#include <cmath>
+
 #include <boost/geometry.hpp>
 #include <boost/geometry/geometries/register/point.hpp>
 #include <boost/geometry/geometries/register/ring.hpp>
 
 #include <valhalla/baldr/json.h>
 #include <valhalla/loki/polygon_search.h>
+#include <valhalla/midgard/aabb2.h>
 #include <valhalla/midgard/constants.h>
 #include <valhalla/midgard/logging.h>
 #include <valhalla/midgard/pointll.h>
@@ -56,6 +59,232 @@ ring_bg_t PBFToRing(const valhalla::Ring& ring_pbf) {
   return new_ring;
 }
 
+// edges are only tested against the rings in the bins they share so we dont bother splitting
+// the work unless there are a decent number of tiles to hand out
+constexpr size_t kMinTilesPerThread = 4;
+
+// how far, in degrees, the geodesic between two points can stray from the straight line between
+// them in lon/lat space. the real bulge is about 2e-4 * d^2 we just leave plenty of room for error
+double bulge(const vm::PointLL& a, const vm::PointLL& b) {
+  auto d = std::max(std::abs(a.lng() - b.lng()), std::abs(a.lat() - b.lat()));
+  return 1e-2 * d * d + 1e-6;
+}
+
+/**
+ * A ring prepared for answering lots of questions about edges that lie near it. Its segments are
+ * bucketed in a grid so we can quickly tell whether an edge comes anywhere near the boundary and
+ * in horizontal strips so a point in polygon test only has to look at a few of them.
+ *
+ * The answers are planar but we only give one when the edge is far enough from the boundary that
+ * the geographic answer has to be the same, otherwise the caller has to ask boost.geometry.
+ */
+class prepared_ring_t {
+public:
+  enum class relation_t { kOutside, kInside, kBoundary };
+
+  explicit prepared_ring_t(const ring_bg_t& ring) : columns_(0), rows_(0) {
+    if (ring.size() < 4) {
+      return;
+    }
+
+    // boxes around each segment big enough to hold the geodesic between its end points
+    segments_.reserve(ring.size() - 1);
+    for (size_t i = 0; i + 1 < ring.size(); ++i) {
+      auto margin = bulge(ring[i], ring[i + 1]);
+      segments_.push_back({ring[i], ring[i + 1],
+                           {std::min(ring[i].lng(), ring[i + 1].lng()) - margin,
+                            std::min(ring[i].lat(), ring[i + 1].lat()) - margin,
+                            std::max(ring[i].lng(), ring[i + 1].lng()) + margin,
+                            std::max(ring[i].lat(), ring[i + 1].lat()) + margin}});
+      if (i == 0) {
+        box_ = segments_.back().box;
+      } else {
+        box_.Expand(segments_.back().box);
+      }
+    }
+
+    // roughly a segment per cell
+    auto dim = std::min<size_t>(256, std::ceil(std::sqrt(segments_.size())));
+    columns_ = rows_ = std::max<size_t>(dim, 1);
+    cell_width_ = std::max(box_.Width() / columns_, 1e-9);
+    cell_height_ = std::max(box_.Height() / rows_, 1e-9);
+    cells_.resize(columns_ * rows_);
+    strips_.resize(rows_);
+    for (size_t i = 0; i < segments_.size(); ++i) {
+      const auto& segment = segments_[i];
+      size_t x0, y0, x1, y1;
+      cells(segment.box, x0, y0, x1, y1);
+      for (auto y = y0; y <= y1; ++y) {
+        for (auto x = x0; x <= x1; ++x) {
+          cells_[y * columns_ + x].push_back(i);
+        }
+      }
+      cells({segment.a.lng(), std::min(segment.a.lat(), segment.b.lat()), segment.a.lng(),
+             std::max(segment.a.lat(), segment.b.lat())},
+            x0, y0, x1, y1);
+      for (auto y = y0; y <= y1; ++y) {
+        strips_[y].push_back(i);
+      }
+    }
+  }
+
+  /**
+   * Classifies the edge shape with respect to the ring
+   * @param shape  the shape of the edge
+   * @return whether the edge is certainly inside, certainly outside or too close to tell
+   */
+  relation_t relate(const std::vector<vm::PointLL>& shape) const {
+    if (segments_.empty() || shape.empty()) {
+      return relation_t::kBoundary;
+    }
+
+    // a box around the edge, again big enough to hold the geodesics between its shape points
+    vm::AABB2<vm::PointLL> box(shape);
+    double margin = 0;
+    for (size_t i = 1; i < shape.size(); ++i) {
+      margin = std::max(margin, bulge(shape[i - 1], shape[i]));
+    }
+    box = {box.minx() - margin, box.miny() - margin, box.maxx() + margin, box.maxy() + margin};
+    if (!box_.Intersects(box)) {
+      return relation_t::kOutside;
+    }
+
+    // if its near any segment we cant say for sure
+    size_t x0, y0, x1, y1;
+    cells(box, x0, y0, x1, y1);
+    for (auto y = y0; y <= y1; ++y) {
+      for (auto x = x0; x <= x1; ++x) {
+        for (auto i : cells_[y * columns_ + x]) {
+          if (segments_[i].box.Intersects(box)) {
+            return relation_t::kBoundary;
+          }
+        }
+      }
+    }
+
+    // otherwise the whole edge is on one side of the boundary, count crossings to see which
+    return contains(shape.front()) ? relation_t::kInside : relation_t::kOutside;
+  }
+
+protected:
+  struct segment_t {
+    vm::PointLL a;
+    vm::PointLL b;
+    vm::AABB2<vm::PointLL> box;
+  };
+
+  // the range of cells covered by the box, clamped to the grid
+  void
+  cells(const vm::AABB2<vm::PointLL>& box, size_t& x0, size_t& y0, size_t& x1, size_t& y1) const {
+    auto clamp = [](double v, size_t count) {
+      return static_cast<size_t>(std::min(std::max(v, 0.0), static_cast<double>(count - 1)));
+    };
+    x0 = clamp((box.minx() - box_.minx()) / cell_width_, columns_);
+    x1 = clamp((box.maxx() - box_.minx()) / cell_width_, columns_);
+    y0 = clamp((box.miny() - box_.miny()) / cell_height_, rows_);
+    y1 = clamp((box.maxy() - box_.miny()) / cell_height_, rows_);
+  }
+
+  // crossing number test only looking at the segments in the points horizontal strip
+  bool contains(const vm::PointLL& p) const {
+    if (p.lat() < box_.miny() || p.lat() > box_.maxy()) {
+      return false;
+    }
+    size_t x0, y0, x1, y1;
+    cells({p.lng(), p.lat(), p.lng(), p.lat()}, x0, y0, x1, y1);
+    bool inside = false;
+    for (auto i : strips_[y0]) {
+      const auto& a = segments_[i].a;
+      const auto& b = segments_[i].b;
+      if ((a.lat() > p.lat()) != (b.lat() > p.lat()) &&
+          p.lng() < (b.lng() - a.lng()) * (p.lat() - a.lat()) / (b.lat() - a.lat()) + a.lng()) {
+        inside = !inside;
+      }
+    }
+    return inside;
+  }
+
+  std::vector<segment_t> segments_;
+  vm::AABB2<vm::PointLL> box_;
+  size_t columns_;
+  size_t rows_;
+  double cell_width_;
+  double cell_height_;
+  std::vector<std::vector<size_t>> cells_;
+  std::vector<std::vector<size_t>> strips_;
+};
+
+// finds the edges in the given tiles bins which intersect the rings in those bins
+std::unordered_set<vb::GraphId>
+edges_in_bins(const std::vector<uint32_t>& tile_ids,
+              const bins_collector& bins_intersected,
+              const std::vector<ring_bg_t>& rings_bg,
+              const std::vector<prepared_ring_t>& rings_prepared,
+              vb::GraphReader& reader,
+              const std::shared_ptr<valhalla::sif::DynamicCost>& costing) {
+  const auto bin_level = vb::TileHierarchy::levels().back().level;
+  std::unordered_set<vb::GraphId> avoid_edge_ids;
+  for (const auto tile_id : tile_ids) {
+    auto tile = reader.GetGraphTile({tile_id, bin_level, 0});
+    if (!tile) {
+      continue;
+    }
+    for (const auto& bin : bins_intersected.find(tile_id)->second) {
+      // tile will be mutated most likely in the loop
+      reader.GetGraphTile({tile_id, bin_level, 0}, tile);
+      for (const auto& edge_id : tile->GetBin(bin.first)) {
+        if (avoid_edge_ids.count(edge_id) != 0) {
+          continue;
+        }
+        // TODO: optimize the tile switching by enqueuing edges
+        // from other levels & tiles and process them after this big loop
+        if (edge_id.Tile_Base() != tile->header()->graphid().Tile_Base() &&
+            !reader.GetGraphTile(edge_id, tile)) {
+          continue;
+        }
+        const auto edge = tile->directededge(edge_id);
+        auto opp_tile = tile;
+        const vb::DirectedEdge* opp_edge = nullptr;
+        vb::GraphId opp_id;
+
+        // bail if we wouldnt be allowed on this edge anyway (or its opposing)
+        if (!costing->Allowed(edge, tile) &&
+            (!(opp_id = reader.GetOpposingEdgeId(edge_id, opp_edge, opp_tile)).Is_Valid() ||
+             !costing->Allowed(opp_edge, opp_tile))) {
+          continue;
+        }
+
+        // TODO: some logic to set percent_along for origin/destination edges
+        // careful: polygon can intersect a single edge multiple times
+        auto shape = tile->edgeinfo(edge).shape();
+        bool intersects = false;
+        for (const auto& ring_loc : bin.second) {
+          // only edges close to the boundary need the expensive geographic test
+          switch (rings_prepared[ring_loc].relate(shape)) {
+            case prepared_ring_t::relation_t::kInside:
+              intersects = true;
+              break;
+            case prepared_ring_t::relation_t::kOutside:
+              break;
+            case prepared_ring_t::relation_t::kBoundary:
+              intersects = bg::intersects(rings_bg[ring_loc], line_bg_t(shape.begin(), shape.end()));
+              break;
+          }
+          if (intersects) {
+            break;
+          }
+        }
+        if (intersects) {
+          avoid_edge_ids.emplace(edge_id);
+          avoid_edge_ids.emplace(
+              opp_id.Is_Valid() ? opp_id : reader.GetOpposingEdgeId(edge_id, opp_edge, opp_tile));
+        }
+      }
+    }
+  }
+  return avoid_edge_ids;
+}
+
 #ifdef LOGGING_LEVEL_TRACE
 // serializes an edge to geojson
 std::string to_geojson(const std::unordered_set<vb::GraphId>& edge_ids, vb::GraphReader& reader) {
@@ -98,7 +327,9 @@ std::unordered_set<vb::GraphId>
 edges_in_rings(const google::protobuf::RepeatedPtrField<valhalla::Ring>& rings_pbf,
                baldr::GraphReader& reader,
                const std::shared_ptr<sif::DynamicCost>& costing,
-               float max_length) {
+               float max_length,
+               const std::vector<std::shared_ptr<baldr::GraphReader>>& thread_readers,
+               midgard::ThreadPool* thread_pool) {
 
   // convert to bg object and check length restriction
   double rings_length = 0;
@@ -114,15 +345,16 @@ edges_in_rings(const google::protobuf::RepeatedPtrField<valhalla::Ring>& rings_p
 
   // Get the lowest level and tiles
   const auto tiles = vb::TileHierarchy::levels().back().tiles;
-  const auto bin_level = vb::TileHierarchy::levels().back().level;
 
   // keep track which tile's bins intersect which rings
   bins_collector bins_intersected;
-  std::unordered_set<vb::GraphId> avoid_edge_ids;
+  std::vector<prepared_ring_t> rings_prepared;
+  rings_prepared.reserve(rings_bg.size());
 
   // first pull out all *unique* bins which intersect the rings
   for (size_t ring_idx = 0; ring_idx < rings_bg.size(); ring_idx++) {
-    auto ring = rings_bg[ring_idx];
+    const auto& ring = rings_bg[ring_idx];
+    rings_prepared.emplace_back(ring);
     auto line_intersected = tiles.Intersect(ring);
     for (const auto& tb : line_intersected) {
       for (const auto& b : tb.second) {
@@ -130,54 +362,37 @@ edges_in_rings(const google::protobuf::RepeatedPtrField<valhalla::Ring>& rings_p
       }
     }
   }
+
+  // hand out contiguous runs of tiles so that each thread mostly touches its own part of the graph
+  std::vector<uint32_t> tile_ids;
+  tile_ids.reserve(bins_intersected.size());
   for (const auto& intersection : bins_intersected) {
-    auto tile = reader.GetGraphTile({intersection.first, bin_level, 0});
-    if (!tile) {
-      continue;
-    }
-    for (const auto& bin : intersection.second) {
-      // tile will be mutated most likely in the loop
-      reader.GetGraphTile({intersection.first, bin_level, 0}, tile);
-      for (const auto& edge_id : tile->GetBin(bin.first)) {
-        if (avoid_edge_ids.count(edge_id) != 0) {
-          continue;
-        }
-        // TODO: optimize the tile switching by enqueuing edges
-        // from other levels & tiles and process them after this big loop
-        if (edge_id.Tile_Base() != tile->header()->graphid().Tile_Base() &&
-            !reader.GetGraphTile(edge_id, tile)) {
-          continue;
-        }
-        const auto edge = tile->directededge(edge_id);
-        auto opp_tile = tile;
-        const baldr::DirectedEdge* opp_edge = nullptr;
-        baldr::GraphId opp_id;
+    tile_ids.push_back(intersection.first);
+  }
+  std::sort(tile_ids.begin(), tile_ids.end());
+  size_t concurrency = std::min(thread_pool ? thread_pool->concurrency() : 1, thread_readers.size());
+  concurrency = std::max<size_t>(1, std::min(concurrency, tile_ids.size() / kMinTilesPerThread));
+  std::vector<std::vector<uint32_t>> partitions(concurrency);
+  for (size_t i = 0; i < tile_ids.size(); ++i) {
+    partitions[i * concurrency / tile_ids.size()].push_back(tile_ids[i]);
+  }
 
-        // bail if we wouldnt be allowed on this edge anyway (or its opposing)
-        if (!costing->Allowed(edge, tile) &&
-            (!(opp_id = reader.GetOpposingEdgeId(edge_id, opp_edge, opp_tile)).Is_Valid() ||
-             !costing->Allowed(opp_edge, opp_tile))) {
-          continue;
-        }
+  // each partition gets its own reader, they share one tile cache, unless there is only one
+  std::vector<std::unordered_set<vb::GraphId>> results(concurrency);
+  if (concurrency == 1) {
+    results.front() = edges_in_bins(tile_ids, bins_intersected, rings_bg, rings_prepared, reader,
+                                    costing);
+  } else {
+    thread_pool->Run(concurrency, [&](size_t i) {
+      results[i] = edges_in_bins(partitions[i], bins_intersected, rings_bg, rings_prepared,
+                                 *thread_readers[i], costing);
+    });
+  }
 
-        // TODO: some logic to set percent_along for origin/destination edges
-        // careful: polygon can intersect a single edge multiple times
-        auto edge_info = tile->edgeinfo(edge);
-        bool intersects = false;
-        for (const auto& ring_loc : bin.second) {
-          intersects = bg::intersects(rings_bg[ring_loc],
-                                      line_bg_t(edge_info.shape().begin(), edge_info.shape().end()));
-          if (intersects) {
-            break;
-          }
-        }
-        if (intersects) {
-          avoid_edge_ids.emplace(edge_id);
-          avoid_edge_ids.emplace(
-              opp_id.Is_Valid() ? opp_id : reader.GetOpposingEdgeId(edge_id, opp_edge, opp_tile));
-        }
-      }
-    }
+  // put them all together
+  std::unordered_set<vb::GraphId> avoid_edge_ids = std::move(results.front());
+  for (size_t i = 1; i < results.size(); ++i) {
+    avoid_edge_ids.insert(results[i].begin(), results[i].end());
   }
 
 // log the GeoJSON of avoided edges
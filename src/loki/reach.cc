@@ -1,11 +1,89 @@
 #include "loki/reach.h"
 
+#include <algorithm>
+
 using namespace valhalla::baldr;
 
 namespace valhalla {
 namespace loki {
 
-Reach::Reach() : Dijkstras() {
+ReachCache::ReachCache(size_t max_entries, size_t shards)
+    : max_shard_entries_(std::max<size_t>(max_entries / std::max<size_t>(shards, 1), 1)),
+      shards_(std::max<size_t>(shards, 1)), hits_(0), misses_(0) {
+}
+
+ReachCache::shard_t& ReachCache::shard(const GraphId& edge_id) {
+  // neighbouring edges go to different shards so that nearby lookups dont contend
+  return shards_[(edge_id.value * 0x9E3779B97F4A7C15ull >> 32) % shards_.size()];
+}
+
+bool ReachCache::Find(uint64_t costing_key,
+                      const GraphId& edge_id,
+                      uint64_t dataset_id,
+                      uint32_t max_reach,
+                      uint8_t direction,
+                      directed_reach& reach) {
+  entry_t entry;
+  {
+    auto& s = shard(edge_id);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    auto found = s.entries.find(edge_key_t{costing_key, edge_id.value});
+    if (found == s.entries.cend()) {
+      ++misses_;
+      return false;
+    }
+    entry = found->second;
+  }
+
+  // it has to be from these tiles and for these directions, also a value at the max it was computed
+  // with could be more with a higher max so its no good to us
+  auto usable = [&entry, max_reach](uint32_t value) {
+    return max_reach <= entry.max_reach || value < entry.max_reach;
+  };
+  if (entry.dataset_id != dataset_id || entry.direction != direction ||
+      !usable(entry.reach.outbound) || !usable(entry.reach.inbound)) {
+    ++misses_;
+    return false;
+  }
+
+  reach.outbound = std::min<uint32_t>(entry.reach.outbound, max_reach);
+  reach.inbound = std::min<uint32_t>(entry.reach.inbound, max_reach);
+  ++hits_;
+  return true;
+}
+
+void ReachCache::Insert(uint64_t costing_key,
+                        const GraphId& edge_id,
+                        uint64_t dataset_id,
+                        uint32_t max_reach,
+                        uint8_t direction,
+                        const directed_reach& reach) {
+  auto& s = shard(edge_id);
+  std::lock_guard<std::mutex> lock(s.mutex);
+  if (s.entries.size() >= max_shard_entries_)
+    s.entries.clear();
+  s.entries[edge_key_t{costing_key, edge_id.value}] =
+      entry_t{dataset_id, max_reach, direction, reach};
+}
+
+void ReachCache::Clear() {
+  for (auto& s : shards_) {
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.entries.clear();
+  }
+}
+
+size_t ReachCache::size() const {
+  size_t size = 0;
+  for (const auto& s : shards_) {
+    std::lock_guard<std::mutex> lock(s.mutex);
+    size += s.entries.size();
+  }
+  return size;
+}
+
+Reach::Reach(ReachCache* cache, uint64_t costing_key)
+    : Dijkstras(), cache_(cache), costing_key_(costing_key) {
   // Mock up the Location struct with the important stuff missing
   auto* path_edge = locations_.Add()->mutable_correlation()->add_edges();
   path_edge->set_distance(0);
@@ -53,6 +131,14 @@ directed_reach Reach::operator()(const DirectedEdge* edge,
     return reach;
   max_reach_ = max_reach;
 
+  // maybe we already know, but not when live traffic closures could have changed it since
+  graph_tile_ptr tile, start_tile = reader.GetGraphTile(edge_id);
+  const bool cacheable = cache_ && start_tile &&
+                         !((costing->flow_mask() & kCurrentFlowMask) && reader.HasLiveTraffic());
+  if (cacheable && cache_->Find(costing_key_, edge_id, start_tile->header()->dataset_id(),
+                                max_reach, direction, reach))
+    return reach;
+
   // these are used below to get conservative estimates of forward and reverse reach
   constexpr uint16_t forward_disallow_mask = sif::kDisallowEndRestriction |
                                              sif::kDisallowSimpleRestriction | sif::kDisallowClosure |
@@ -71,7 +157,6 @@ directed_reach Reach::operator()(const DirectedEdge* edge,
   // we're finding nodes here so we'll double it assuming we queue less edges than nodes we see
   max_reserved_labels_count_ = max_reach * 2;
   Clear();
-  graph_tile_ptr tile, start_tile = reader.GetGraphTile(edge_id);
   if ((tile = start_tile) &&
       costing->Allowed(edge, tile, sif::kDisallowSimpleRestriction | sif::kDisallowShortcut))
     enqueue(edge->endnode(), reader, costing, tile);
@@ -152,6 +237,10 @@ directed_reach Reach::operator()(const DirectedEdge* edge,
     reach.inbound = std::max(reach.inbound, retry_reach.inbound);
   }
 
+  // remember it for next time
+  if (cacheable)
+    cache_->Insert(costing_key_, edge_id, start_tile->header()->dataset_id(), max_reach, direction,
+                   reach);
   return reach;
 }
 
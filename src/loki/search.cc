@@ -9,7 +9,6 @@
 #include <algorithm>
 #include <cmath>
 #include <iterator>
-#include <list>
 #include <unordered_set>
 
 using namespace valhalla::midgard;
@@ -171,14 +170,15 @@ struct candidate_t {
 // interesting bin.  if has_bin() is false, then the best projection
 // is found.
 struct projector_wrapper {
-  projector_wrapper(const Location& location, GraphReader& reader)
+  projector_wrapper(const Location& location, GraphReader& reader, bool use_bins = true)
       : binner(make_binner(location.latlng_)), location(location),
         sq_radius(square(double(location.radius_))), project(location.latlng_) {
     // TODO: something more empirical based on radius
     unreachable.reserve(64);
     reachable.reserve(64);
-    // initialize
-    next_bin(reader);
+    // initialize, when searching the segment index we dont need any bins
+    if (use_bins)
+      next_bin(reader);
   }
 
   // non default constructible and move only type
@@ -256,14 +256,18 @@ struct bin_handler_t {
 
   bin_handler_t(const std::vector<valhalla::baldr::Location>& locations,
                 valhalla::baldr::GraphReader& reader,
-                const std::shared_ptr<DynamicCost>& costing)
-      : reader(reader), costing(costing) {
+                const std::shared_ptr<DynamicCost>& costing,
+                bool use_bins = true,
+                unsigned int min_reach_limit = 0,
+                ReachCache* reach_cache = nullptr,
+                uint64_t costing_key = 0)
+      : reader(reader), costing(costing), reach_finder(reach_cache, costing_key) {
     // get the unique set of input locations and the max reachability of them all
     std::unordered_set<Location> uniq_locations(locations.begin(), locations.end());
     pps.reserve(uniq_locations.size());
-    max_reach_limit = 0;
+    max_reach_limit = min_reach_limit;
     for (const auto& loc : uniq_locations) {
-      pps.emplace_back(loc, reader);
+      pps.emplace_back(loc, reader, use_bins);
       max_reach_limit = std::max(max_reach_limit, loc.min_outbound_reach_);
       max_reach_limit = std::max(max_reach_limit, loc.min_inbound_reach_);
     }
@@ -451,6 +455,12 @@ struct bin_handler_t {
     return reach;
   }
 
+  // whether the reachability of a candidate matters to a location, which is only the case if the
+  // candidate could become its best reachable option
+  static bool needs_reach(const projector_wrapper& pp, const candidate_t& candidate) {
+    return pp.reachable.empty() || candidate.sq_distance < pp.reachable.back().sq_distance;
+  }
+
   // do a mini network expansion or maybe not
   directed_reach check_reachability(std::vector<projector_wrapper>::iterator begin,
                                     std::vector<projector_wrapper>::iterator end,
@@ -461,24 +471,23 @@ struct bin_handler_t {
     if (max_reach_limit == 0)
       return {};
 
-    // do we already know about this one?
-    auto found = directed_reaches.find(edge);
-    if (found != directed_reaches.cend())
-      return found->second;
-
     // we only want to waste time checking if this could become the best reachable option for a
     // given location
     bool check = false;
     auto c_itr = bin_candidates.begin();
     for (auto p_itr = begin; p_itr != end; ++p_itr, ++c_itr) {
-      check = check || p_itr->reachable.empty() ||
-              c_itr->sq_distance < p_itr->reachable.back().sq_distance;
+      check = check || (!c_itr->prefiltered && needs_reach(*p_itr, *c_itr));
     }
 
     // assume its reachable
     if (!check)
       return {max_reach_limit, max_reach_limit};
 
+    // do we already know about this one?
+    auto found = directed_reaches.find(edge);
+    if (found != directed_reaches.cend())
+      return found->second;
+
     // notice we do both directions here because in the end we use this reach for all input locations
     auto reach = reach_finder(edge, edge_id, max_reach_limit, reader, costing, kInbound | kOutbound);
     directed_reaches[edge] = reach;
@@ -494,165 +503,177 @@ struct bin_handler_t {
     return reach;
   }
 
-  // handle a bin for the range of candidates that share it
-  void handle_bin(std::vector<projector_wrapper>::iterator begin,
-                  std::vector<projector_wrapper>::iterator end) {
-    // iterate over the edges in the bin
-    auto tile = begin->cur_tile;
-    auto edges = tile->GetBin(begin->bin_index);
-    for (auto edge_id : edges) {
-      // get the tile and edge
-      if (!reader.GetGraphTile(edge_id, tile)) {
-        continue;
-      }
-
-      // if this edge is filtered
-      const auto* edge = tile->directededge(edge_id);
-      if (!costing->Allowed(edge, tile, kDisallowShortcut)) {
-        // then we try its opposing edge
-        edge_id = reader.GetOpposingEdgeId(edge_id, edge, tile);
-        // but if we couldnt get it or its filtered too then we move on
-        if (!edge_id.Is_Valid() || !costing->Allowed(edge, tile, kDisallowShortcut))
-          continue;
-      }
-
-      // initialize candidates vector:
-      // - reset sq_distance to max so we know the best point along the edge
-      // - apply prefilters based on user's SearchFilter request options
-      auto c_itr = bin_candidates.begin();
-      decltype(begin) p_itr;
-      bool all_prefiltered = true;
-      for (p_itr = begin; p_itr != end; ++p_itr, ++c_itr) {
-        c_itr->sq_distance = std::numeric_limits<double>::max();
-        c_itr->prefiltered =
-            is_search_filter_triggered(edge, *costing, tile, p_itr->location.search_filter_);
-        // set to false if even one candidate was not filtered
-        all_prefiltered = all_prefiltered && c_itr->prefiltered;
-      }
+  // handle a single edge for the range of candidates that want to look at it
+  void handle_edge(std::vector<projector_wrapper>::iterator begin,
+                   std::vector<projector_wrapper>::iterator end,
+                   GraphId edge_id,
+                   graph_tile_ptr& tile) {
+    // get the tile and edge
+    if (!reader.GetGraphTile(edge_id, tile)) {
+      return;
+    }
 
-      // short-circuit if all candidates were prefiltered
-      if (all_prefiltered) {
-        continue;
-      }
+    // if this edge is filtered
+    const auto* edge = tile->directededge(edge_id);
+    if (!costing->Allowed(edge, tile, kDisallowShortcut)) {
+      // then we try its opposing edge
+      edge_id = reader.GetOpposingEdgeId(edge_id, edge, tile);
+      // but if we couldnt get it or its filtered too then we move on
+      if (!edge_id.Is_Valid() || !costing->Allowed(edge, tile, kDisallowShortcut))
+        return;
+    }
 
-      // TODO: can we speed this up? the majority of edges will be short and far away enough
-      // such that the closest point on the edge will be one of the edges end points, we can get
-      // these coordinates them from the nodes in the graph. we can then find whichever end is
-      // closest to the input point p, call it n. we can then define an half plane h intersecting n
-      // so that its orthogonal to the ray from p to n. using h, we only need to test segments
-      // of the shape which are on the same side of h that p is. to make this fast we would need a
-      // a trivial half plane test as maybe a single dot product and comparison?
-
-      // get some shape of the edge
-      auto edge_info = std::make_shared<const EdgeInfo>(tile->edgeinfo(edge));
-      auto shape = edge_info->lazy_shape();
-      PointLL v;
-      if (!shape.empty()) {
-        v = shape.pop();
-      }
+    // initialize candidates vector:
+    // - reset sq_distance to max so we know the best point along the edge
+    // - apply prefilters based on user's SearchFilter request options
+    auto c_itr = bin_candidates.begin();
+    decltype(begin) p_itr;
+    bool all_prefiltered = true;
+    for (p_itr = begin; p_itr != end; ++p_itr, ++c_itr) {
+      c_itr->sq_distance = std::numeric_limits<double>::max();
+      c_itr->prefiltered =
+          is_search_filter_triggered(edge, *costing, tile, p_itr->location.search_filter_);
+      // set to false if even one candidate was not filtered
+      all_prefiltered = all_prefiltered && c_itr->prefiltered;
+    }
 
-      // iterate along this edges segments projecting each of the points
-      for (size_t i = 0; !shape.empty(); ++i) {
-        auto u = v;
-        v = shape.pop();
-        // for each input point
-        c_itr = bin_candidates.begin();
-        for (p_itr = begin; p_itr != end; ++p_itr, ++c_itr) {
-          // skip updating this candidate because it was prefiltered
-          if (c_itr->prefiltered) {
-            continue;
-          }
-          // how close is the input to this segment
-          auto point = p_itr->project(u, v);
-          auto sq_distance = p_itr->project.approx.DistanceSquared(point);
-          // do we want to keep it
-          if (sq_distance < c_itr->sq_distance) {
-            c_itr->sq_distance = sq_distance;
-            c_itr->point = std::move(point);
-            c_itr->index = i;
-          }
-        }
-      }
+    // short-circuit if all candidates were prefiltered
+    if (all_prefiltered) {
+      return;
+    }
 
-      // if we already have a better reachable candidate we can just assume this one is reachable
-      auto reach = check_reachability(begin, end, tile, edge, edge_id);
+    // TODO: can we speed this up? the majority of edges will be short and far away enough
+    // such that the closest point on the edge will be one of the edges end points, we can get
+    // these coordinates them from the nodes in the graph. we can then find whichever end is
+    // closest to the input point p, call it n. we can then define an half plane h intersecting n
+    // so that its orthogonal to the ray from p to n. using h, we only need to test segments
+    // of the shape which are on the same side of h that p is. to make this fast we would need a
+    // a trivial half plane test as maybe a single dot product and comparison?
+
+    // get some shape of the edge
+    auto edge_info = std::make_shared<const EdgeInfo>(tile->edgeinfo(edge));
+    auto shape = edge_info->lazy_shape();
+    PointLL v;
+    if (!shape.empty()) {
+      v = shape.pop();
+    }
 
-      // keep the best point along this edge if it makes sense
+    // iterate along this edges segments projecting each of the points
+    for (size_t i = 0; !shape.empty(); ++i) {
+      auto u = v;
+      v = shape.pop();
+      // for each input point
       c_itr = bin_candidates.begin();
       for (p_itr = begin; p_itr != end; ++p_itr, ++c_itr) {
         // skip updating this candidate because it was prefiltered
         if (c_itr->prefiltered) {
           continue;
         }
-        // is this edge reachable in the right way
-        bool reachable = reach.outbound >= p_itr->location.min_outbound_reach_ &&
-                         reach.inbound >= p_itr->location.min_inbound_reach_;
-        const DirectedEdge* opp_edge = nullptr;
-        graph_tile_ptr opp_tile = tile;
-        GraphId opp_edgeid;
-        // it's possible that it isnt reachable but the opposing is, switch to that if so
-        if (!reachable && (opp_edgeid = reader.GetOpposingEdgeId(edge_id, opp_edge, opp_tile)) &&
-            costing->Allowed(opp_edge, opp_tile, kDisallowShortcut)) {
-          auto opp_reach = check_reachability(begin, end, opp_tile, opp_edge, opp_edgeid);
-          if (opp_reach.outbound >= p_itr->location.min_outbound_reach_ &&
-              opp_reach.inbound >= p_itr->location.min_inbound_reach_) {
-            tile = opp_tile;
-            edge = opp_edge;
-            edge_id = opp_edgeid;
-            reach = opp_reach;
-            reachable = true;
-          }
+        // how close is the input to this segment
+        auto point = p_itr->project(u, v);
+        auto sq_distance = p_itr->project.approx.DistanceSquared(point);
+        // do we want to keep it
+        if (sq_distance < c_itr->sq_distance) {
+          c_itr->sq_distance = sq_distance;
+          c_itr->point = std::move(point);
+          c_itr->index = i;
         }
+      }
+    }
 
-        // which batch of findings will this go into
-        auto* batch = reachable ? &p_itr->reachable : &p_itr->unreachable;
+    // if we already have a better reachable candidate we can just assume this one is reachable
+    const auto reach = check_reachability(begin, end, tile, edge, edge_id);
 
-        // if its empty append
-        if (batch->empty()) {
-          c_itr->edge = edge;
-          c_itr->edge_id = edge_id;
-          c_itr->edge_info = edge_info;
-          c_itr->tile = tile;
-          batch->emplace_back(std::move(*c_itr));
-          continue;
+    // keep the best point along this edge if it makes sense
+    c_itr = bin_candidates.begin();
+    for (p_itr = begin; p_itr != end; ++p_itr, ++c_itr) {
+      // skip updating this candidate because it was prefiltered
+      if (c_itr->prefiltered) {
+        continue;
+      }
+      // is this edge reachable in the right way, each location decides this on its own so that
+      // what it finds doesnt depend on which other locations happened to share the bin with it
+      bool reachable = !needs_reach(*p_itr, *c_itr) ||
+                       (reach.outbound >= p_itr->location.min_outbound_reach_ &&
+                        reach.inbound >= p_itr->location.min_inbound_reach_);
+      auto candidate_tile = tile;
+      const auto* candidate_edge = edge;
+      auto candidate_edge_id = edge_id;
+      const DirectedEdge* opp_edge = nullptr;
+      graph_tile_ptr opp_tile = tile;
+      GraphId opp_edgeid;
+      // it's possible that it isnt reachable but the opposing is, switch to that if so
+      if (!reachable && (opp_edgeid = reader.GetOpposingEdgeId(edge_id, opp_edge, opp_tile)) &&
+          costing->Allowed(opp_edge, opp_tile, kDisallowShortcut)) {
+        auto opp_reach = check_reachability(begin, end, opp_tile, opp_edge, opp_edgeid);
+        if (opp_reach.outbound >= p_itr->location.min_outbound_reach_ &&
+            opp_reach.inbound >= p_itr->location.min_inbound_reach_) {
+          candidate_tile = opp_tile;
+          candidate_edge = opp_edge;
+          candidate_edge_id = opp_edgeid;
+          reachable = true;
         }
+      }
 
-        // get some info about possibilities
-        bool in_radius = c_itr->sq_distance < p_itr->sq_radius;
-        bool better = c_itr->sq_distance < batch->back().sq_distance;
-        bool last_in_radius = batch->back().sq_distance < p_itr->sq_radius;
-        // TODO: this is a bit blunt in that any reachable edges between the best or ones within
-        // the radius will make unreachable edges that are even the tiniest bit further away unviable
-        // it seems like we should have a slightly looser radius to allow for unreachable edges but
-        // its unclear what that should be as in most cases we are working around not actually knowing
-        // the accuracy or even input modality of the incoming location
-        bool closer_external_reachable =
-            reachable && c_itr->sq_distance < p_itr->closest_external_reachable;
-
-        // it has to either be better or in the radius to move on
-        if (in_radius || better) {
-          c_itr->edge = edge;
-          c_itr->edge_id = edge_id;
-          c_itr->edge_info = edge_info;
-          c_itr->tile = tile;
-          // the last one wasnt in the radius so replace it with this one because its better or is
-          // in the radius
-          if (!last_in_radius) {
-            if (closer_external_reachable)
-              p_itr->closest_external_reachable = batch->back().sq_distance;
-            batch->back() = std::move(*c_itr);
-            // last one is in the radius but this one is better so put it on the end
-          } else if (better) {
-            batch->emplace_back(std::move(*c_itr));
-            // last one and this one are both in the radius but this one is not as good
-          } else {
-            batch->emplace_back(std::move(*c_itr));
-            std::swap(*(batch->end() - 1), *(batch->end() - 2));
-          }
-        } // not in radius or better and reachable and closer than closest one outside of radius
-        else if (closer_external_reachable)
-          p_itr->closest_external_reachable = c_itr->sq_distance;
+      // which batch of findings will this go into
+      auto* batch = reachable ? &p_itr->reachable : &p_itr->unreachable;
+
+      // if its empty append
+      if (batch->empty()) {
+        c_itr->edge = candidate_edge;
+        c_itr->edge_id = candidate_edge_id;
+        c_itr->edge_info = edge_info;
+        c_itr->tile = candidate_tile;
+        batch->emplace_back(std::move(*c_itr));
+        continue;
       }
+
+      // get some info about possibilities
+      bool in_radius = c_itr->sq_distance < p_itr->sq_radius;
+      bool better = c_itr->sq_distance < batch->back().sq_distance;
+      bool last_in_radius = batch->back().sq_distance < p_itr->sq_radius;
+      // TODO: this is a bit blunt in that any reachable edges between the best or ones within
+      // the radius will make unreachable edges that are even the tiniest bit further away unviable
+      // it seems like we should have a slightly looser radius to allow for unreachable edges but
+      // its unclear what that should be as in most cases we are working around not actually knowing
+      // the accuracy or even input modality of the incoming location
+      bool closer_external_reachable =
+          reachable && c_itr->sq_distance < p_itr->closest_external_reachable;
+
+      // it has to either be better or in the radius to move on
+      if (in_radius || better) {
+        c_itr->edge = candidate_edge;
+        c_itr->edge_id = candidate_edge_id;
+        c_itr->edge_info = edge_info;
+        c_itr->tile = candidate_tile;
+        // the last one wasnt in the radius so replace it with this one because its better or is
+        // in the radius
+        if (!last_in_radius) {
+          if (closer_external_reachable)
+            p_itr->closest_external_reachable = batch->back().sq_distance;
+          batch->back() = std::move(*c_itr);
+          // last one is in the radius but this one is better so put it on the end
+        } else if (better) {
+          batch->emplace_back(std::move(*c_itr));
+          // last one and this one are both in the radius but this one is not as good
+        } else {
+          batch->emplace_back(std::move(*c_itr));
+          std::swap(*(batch->end() - 1), *(batch->end() - 2));
+        }
+      } // not in radius or better and reachable and closer than closest one outside of radius
+      else if (closer_external_reachable)
+        p_itr->closest_external_reachable = c_itr->sq_distance;
+    }
+  }
+
+  // handle a bin for the range of candidates that share it
+  void handle_bin(std::vector<projector_wrapper>::iterator begin,
+                  std::vector<projector_wrapper>::iterator end) {
+    // iterate over the edges in the bin
+    auto tile = begin->cur_tile;
+    auto edges = tile->GetBin(begin->bin_index);
+    for (auto edge_id : edges) {
+      handle_edge(begin, end, edge_id, tile);
     }
 
     // bin is finished, advance the candidates to their respective next bins
@@ -691,6 +712,31 @@ struct bin_handler_t {
     }
   }
 
+  // instead of walking bins we visit edges in order of distance using the segment index and stop
+  // under the same conditions we would have stopped advancing to the next bin
+  void search(const SegmentIndex& index) {
+    std::unordered_set<uint64_t> visited;
+    graph_tile_ptr tile;
+    for (auto p_itr = pps.begin(); p_itr != pps.end(); ++p_itr) {
+      SegmentIndex::Filter filter;
+      filter.min_road_class =
+          static_cast<RoadClass>(p_itr->location.search_filter_.min_road_class_);
+      filter.max_road_class =
+          static_cast<RoadClass>(p_itr->location.search_filter_.max_road_class_);
+      filter.access_mask = costing->access_mode();
+      visited.clear();
+      index.Visit(p_itr->location.latlng_, p_itr->location.search_cutoff_, filter,
+                  [&](const SegmentIndex::Hit& hit) {
+                    if (p_itr->reachable.size() && hit.distance > p_itr->location.radius_ &&
+                        hit.distance > std::sqrt(p_itr->reachable.back().sq_distance))
+                      return false;
+                    if (visited.insert(hit.edge_id).second)
+                      handle_edge(p_itr, std::next(p_itr), hit.edge_id, tile);
+                    return true;
+                  });
+    }
+  }
+
   // create the PathLocation corresponding to the best projection of the given candidate
   std::unordered_map<Location, PathLocation> finalize() {
     // at this point we have candidates for each location so now we
@@ -793,6 +839,28 @@ struct bin_handler_t {
   }
 };
 
+// below this many locations per thread its not worth starting another one
+constexpr size_t kMinLocationsPerThread = 16;
+
+std::unordered_map<Location, PathLocation> search(const std::vector<Location>& locations,
+                                                  GraphReader& reader,
+                                                  const std::shared_ptr<DynamicCost>& costing,
+                                                  const SegmentIndex* segment_index,
+                                                  ReachCache* reach_cache,
+                                                  uint64_t costing_key,
+                                                  unsigned int max_reach_limit = 0) {
+  // setup the unique list of locations
+  bin_handler_t handler(locations, reader, costing, segment_index == nullptr, max_reach_limit,
+                        reach_cache, costing_key);
+  // search over the bins doing multiple locations per bin or go straight to the closest segments
+  if (segment_index)
+    handler.search(*segment_index);
+  else
+    handler.search();
+  // turn each locations candidate set into path locations
+  return handler.finalize();
+}
+
 } // namespace
 
 namespace valhalla {
@@ -801,7 +869,12 @@ namespace loki {
 std::unordered_map<valhalla::baldr::Location, PathLocation>
 Search(const std::vector<valhalla::baldr::Location>& locations,
        GraphReader& reader,
-       const std::shared_ptr<DynamicCost>& costing) {
+       const std::shared_ptr<DynamicCost>& costing,
+       const SegmentIndex* segment_index,
+       const std::vector<std::shared_ptr<GraphReader>>& thread_readers,
+       midgard::ThreadPool* thread_pool,
+       ReachCache* reach_cache,
+       uint64_t costing_key) {
   // we cannot continue without costing
   if (!costing)
     throw std::runtime_error("No costing was provided for edge candidate search");
@@ -810,12 +883,56 @@ Search(const std::vector<valhalla::baldr::Location>& locations,
   if (locations.empty())
     return std::unordered_map<valhalla::baldr::Location, PathLocation>{};
 
-  // setup the unique list of locations
-  bin_handler_t handler(locations, reader, costing);
-  // search over the bins doing multiple locations per bin
-  handler.search();
-  // turn each locations candidate set into path locations
-  return handler.finalize();
+  // not enough work to bother with more threads
+  std::unordered_set<baldr::Location> uniq_locations(locations.begin(), locations.end());
+  size_t concurrency = std::min(thread_pool ? thread_pool->concurrency() : 1, thread_readers.size());
+  concurrency = std::min(concurrency, uniq_locations.size() / kMinLocationsPerThread);
+  if (concurrency < 2)
+    return search(locations, reader, costing, segment_index, reach_cache, costing_key);
+
+  // what each location finds does not depend on which other locations are searched with it except
+  // that reach is only computed up to the largest reachability anyone asked for
+  unsigned int max_reach_limit = 0;
+  for (const auto& location : uniq_locations) {
+    max_reach_limit = std::max(max_reach_limit, location.min_outbound_reach_);
+    max_reach_limit = std::max(max_reach_limit, location.min_inbound_reach_);
+  }
+
+  // partition the locations by tile so that each thread mostly touches its own part of the graph
+  const auto& tiles = TileHierarchy::levels().back().tiles;
+  using located_t = std::pair<int32_t, baldr::Location>;
+  std::vector<located_t> sorted;
+  sorted.reserve(uniq_locations.size());
+  for (const auto& location : uniq_locations) {
+    sorted.emplace_back(tiles.TileId(location.latlng_), location);
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](const located_t& a, const located_t& b) {
+              if (a.first != b.first)
+                return a.first < b.first;
+              return a.second.latlng_ < b.second.latlng_;
+            });
+  std::vector<std::vector<baldr::Location>> partitions(concurrency);
+  for (size_t i = 0; i < sorted.size(); ++i) {
+    partitions[i * concurrency / sorted.size()].emplace_back(std::move(sorted[i].second));
+  }
+
+  // search each partition with its own reader, they all share one tile cache
+  using results_t = std::unordered_map<valhalla::baldr::Location, PathLocation>;
+  std::vector<results_t> results(concurrency);
+  thread_pool->Run(concurrency, [&](size_t i) {
+    results[i] = search(partitions[i], *thread_readers[i], costing, segment_index, reach_cache,
+                        costing_key, max_reach_limit);
+  });
+
+  // put them all together
+  results_t searched;
+  searched.reserve(uniq_locations.size());
+  for (auto& partition_results : results) {
+    searched.insert(std::make_move_iterator(partition_results.begin()),
+                    std::make_move_iterator(partition_results.end()));
+  }
+  return searched;
 }
 
 } // namespace loki
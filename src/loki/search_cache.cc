@@ -0,0 +1,115 @@
+#include "loki/search_cache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <list>
+#include <type_traits>
+
+using namespace valhalla::baldr;
+
+namespace {
+
+template <typename T> void append(std::string& key, const T& value) {
+  static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be part of the key");
+  key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// the exact coordinate, unless we were asked to snap coordinates to a grid
+void append_coordinate(std::string& key, double coordinate, double precision) {
+  if (precision > 0)
+    append(key, std::llround(coordinate / precision));
+  else
+    append(key, coordinate);
+}
+
+// a rough guess at what an entry costs us, the key is in both the list and the map
+size_t entry_bytes(const std::string& key, const PathLocation& result) {
+  return sizeof(std::list<int>) + 2 * (key.capacity() + sizeof(std::string)) + 4 * sizeof(void*) +
+         (result.edges.size() + result.filtered_edges.size()) * sizeof(PathLocation::PathEdge);
+}
+
+} // namespace
+
+namespace valhalla {
+namespace loki {
+
+SearchCache::SearchCache(size_t max_bytes, double precision, uint32_t max_age)
+    : precision_(std::max(precision, 0.)),
+      results_(0,
+               max_bytes,
+               max_age ? std::chrono::seconds(max_age) : clock_t::duration::max()) {
+}
+
+bool SearchCache::Find(const baldr::Location& location,
+                       uint64_t costing_key,
+                       PathLocation& result,
+                       clock_t::time_point now) {
+  // too old ones are misses, the closures they were filtered with may have changed since
+  const auto* found = results_.find(make_key(location, costing_key), now);
+  if (!found)
+    return false;
+
+  result.edges = found->edges;
+  result.filtered_edges = found->filtered_edges;
+  return true;
+}
+
+void SearchCache::Insert(const baldr::Location& location,
+                         uint64_t costing_key,
+                         const PathLocation& result,
+                         clock_t::time_point now) {
+  auto key = make_key(location, costing_key);
+  auto bytes = entry_bytes(key, result);
+  results_.insert(key, result_t{result.edges, result.filtered_edges}, bytes, now);
+}
+
+void SearchCache::Clear() {
+  results_.clear();
+}
+
+uint64_t SearchCache::CostingKey(const Options& options, const sif::cost_ptr_t& costing) {
+  // the costing options are only repeated and scalar fields so their serialization is stable
+  std::string key;
+  append(key, static_cast<int>(options.costing_type()));
+  append(key, costing ? costing->access_mode() : 0u);
+  auto found = options.costings().find(options.costing_type());
+  if (found != options.costings().cend())
+    key += found->second.SerializeAsString();
+  return std::hash<std::string>()(key);
+}
+
+std::string SearchCache::make_key(const baldr::Location& location, uint64_t costing_key) const {
+  std::string key;
+  key.reserve(96);
+  append(key, costing_key);
+  append_coordinate(key, location.latlng_.lng(), precision_);
+  append_coordinate(key, location.latlng_.lat(), precision_);
+  append(key, static_cast<bool>(location.display_latlng_));
+  if (location.display_latlng_) {
+    append_coordinate(key, location.display_latlng_->lng(), precision_);
+    append_coordinate(key, location.display_latlng_->lat(), precision_);
+  }
+  append(key, location.heading_ ? *location.heading_ : -1.f);
+  append(key, location.heading_tolerance_);
+  append(key, location.min_outbound_reach_);
+  append(key, location.min_inbound_reach_);
+  append(key, location.radius_);
+  append(key, location.preferred_side_);
+  append(key, location.node_snap_tolerance_);
+  append(key, location.search_cutoff_);
+  append(key, location.street_side_tolerance_);
+  append(key, location.street_side_max_distance_);
+  const auto& filter = location.search_filter_;
+  append(key, filter.min_road_class_);
+  append(key, filter.max_road_class_);
+  append(key, filter.exclude_tunnel_);
+  append(key, filter.exclude_bridge_);
+  append(key, filter.exclude_ramp_);
+  append(key, filter.exclude_closures_);
+  append(key, location.preferred_layer_ ? int(*location.preferred_layer_) : INT32_MIN);
+  return key;
+}
+
+} // namespace loki
+} // namespace valhalla
@@ -22,12 +22,13 @@ PointLL to_ll(const valhalla::Location& l) {
 
 void check_shape(const google::protobuf::RepeatedPtrField<valhalla::Location>& shape,
                  unsigned int max_shape,
-                 float max_factor = 1.0f) {
+                 float max_factor = 1.0f,
+                 int min_shape = 2) {
   // Adjust max - this enables max edge_walk shape count to be larger
   max_shape *= max_factor;
 
-  // Must have at least two points
-  if (shape.size() < 2) {
+  // Must have at least two points, unless its the next part of a trace we've already seen some of
+  if (shape.size() < min_shape) {
     throw valhalla_exception_t{123};
     // Validate shape is not larger than the configured max
   } else if (shape.size() > max_shape) {
@@ -134,7 +135,7 @@ void loki_worker_t::init_trace(Api& request) {
   }
 
   // Validate shape count and distance (for now, just send max_factor for distance)
-  check_shape(options.shape(), max_trace_shape);
+  check_shape(options.shape(), max_trace_shape, 1.0f, options.has_session_id_case() ? 1 : 2);
   float breakage_distance =
       options.has_breakage_distance_case() ? options.breakage_distance() : default_breakage_distance;
   check_distance(options.shape(), max_distance.find("trace")->second, breakage_distance, max_factor);
@@ -194,7 +195,7 @@ void loki_worker_t::locations_from_shape(Api& request) {
 
     // Project first and last shape point onto nearest edge(s). Clear current locations list
     // and set the path locations
-    auto projections = loki::Search(locations, *reader, costing);
+    auto projections = search(locations, request);
     options.clear_locations();
     PathLocation::toPBF(projections.at(locations.front()), options.mutable_locations()->Add(),
                         *reader);
@@ -1,4 +1,5 @@
 #include <boost/property_tree/ptree.hpp>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <sstream>
@@ -9,6 +10,7 @@
 
 #include "baldr/json.h"
 #include "baldr/rapidjson_utils.h"
+#include "filesystem.h"
 #include "midgard/logging.h"
 #include "sif/autocost.h"
 #include "sif/bicyclecost.h"
@@ -18,6 +20,7 @@
 #include "tyr/actor.h"
 
 #include "loki/polygon_search.h"
+#include "loki/reach.h"
 #include "loki/search.h"
 #include "loki/worker.h"
 
@@ -28,6 +31,18 @@ using namespace valhalla::baldr;
 using namespace valhalla::sif;
 using namespace valhalla::loki;
 
+namespace {
+
+time_t get_tileset_last_modified(const std::shared_ptr<GraphReader>& reader) {
+  try {
+    return std::chrono::system_clock::to_time_t(
+        filesystem::last_write_time(reader->GetTileSetLocation()));
+  } catch (...) {}
+  return 0;
+}
+
+} // namespace
+
 namespace valhalla {
 namespace loki {
 void loki_worker_t::parse_locations(google::protobuf::RepeatedPtrField<valhalla::Location>* locations,
@@ -77,16 +92,19 @@ void loki_worker_t::parse_costing(Api& api, bool allow_none) {
     if (options.costing_type() == Costing::multimodal) {
       options.set_costing_type(Costing::pedestrian);
       costing = factory.Create(options);
+      costing_key = SearchCache::CostingKey(options, costing);
       options.set_costing_type(Costing::multimodal);
     } // otherwise use the provided costing
     else {
       costing = factory.Create(options);
+      costing_key = SearchCache::CostingKey(options, costing);
     }
   } catch (const std::runtime_error&) { throw valhalla_exception_t{125, "'" + costing_str + "'"}; }
 
   if (options.exclude_polygons_size()) {
     const auto edges =
-        edges_in_rings(options.exclude_polygons(), *reader, costing, max_exclude_polygons_length);
+        edges_in_rings(options.exclude_polygons(), *reader, costing, max_exclude_polygons_length,
+                       search_readers, search_pool.get());
     auto& co = *options.mutable_costings()->find(options.costing_type())->second.mutable_options();
     for (const auto& edge_id : edges) {
       auto* avoid = co.add_exclude_edges();
@@ -104,7 +122,7 @@ void loki_worker_t::parse_costing(Api& api, bool allow_none) {
     }
     try {
       auto exclude_locations = PathLocation::fromPBF(options.exclude_locations());
-      auto results = loki::Search(exclude_locations, *reader, costing);
+      auto results = search(exclude_locations, api);
       std::unordered_set<uint64_t> avoids;
       auto& co = *options.mutable_costings()->find(options.costing_type())->second.mutable_options();
       for (const auto& result : results) {
@@ -149,6 +167,50 @@ void loki_worker_t::parse_costing(Api& api, bool allow_none) {
     options.set_alternates(max_trace_alternates);
 }
 
+std::unordered_map<baldr::Location, PathLocation>
+loki_worker_t::search(const std::vector<baldr::Location>& locations, Api& request) {
+  if (!search_cache)
+    return loki::Search(locations, *reader, costing, segment_index.get(), search_readers,
+                        search_pool.get(), reach_cache.get(), costing_key);
+
+  // take what we can from the cache
+  std::unordered_map<baldr::Location, PathLocation> results;
+  std::vector<baldr::Location> misses;
+  for (const auto& location : locations) {
+    PathLocation result(location);
+    if (search_cache->Find(location, costing_key, result))
+      results.emplace(location, std::move(result));
+    else
+      misses.push_back(location);
+  }
+
+  // search for the rest and remember them for next time
+  if (!misses.empty()) {
+    auto searched = loki::Search(misses, *reader, costing, segment_index.get(), search_readers,
+                                 search_pool.get(), reach_cache.get(), costing_key);
+    for (auto& kv : searched) {
+      search_cache->Insert(kv.first, costing_key, kv.second);
+      results.emplace(kv.first, std::move(kv.second));
+    }
+  }
+
+  // track how well the cache is doing
+  const auto& action = Options_Action_Enum_Name(request.options().action());
+  const auto prefix = action + ".info." + service_name() + ".search_cache.";
+  auto add_statistic = [&request, &prefix](const std::string& name, double value,
+                                           StatisticType type) {
+    auto* stat = request.mutable_info()->mutable_statistics()->Add();
+    stat->set_key(prefix + name);
+    stat->set_value(value);
+    stat->set_type(type);
+  };
+  add_statistic("hit", locations.size() - misses.size(), count);
+  add_statistic("miss", misses.size(), count);
+  add_statistic("entries", search_cache->size(), gauge);
+  add_statistic("bytes", search_cache->bytes(), gauge);
+  return results;
+}
+
 loki_worker_t::loki_worker_t(const boost::property_tree::ptree& config,
                              const std::shared_ptr<baldr::GraphReader>& graph_reader)
     : service_worker_t(config), config(config),
@@ -245,6 +307,44 @@ loki_worker_t::loki_worker_t(const boost::property_tree::ptree& config,
   max_alternates = config.get<unsigned int>("service_limits.max_alternates");
   allow_verbose = config.get<bool>("service_limits.status.allow_verbose", false);
 
+  // optionally find candidates with the segment index rather than the tile bins
+  segment_index_file = config.get<std::string>("mjolnir.segment_index", "");
+  load_segment_index();
+
+  // optionally search for lots of locations in parallel. each thread, including the one the
+  // request came in on, gets a reader of its own but they all share one tile cache
+  auto search_concurrency = config.get<size_t>("loki.search_concurrency", 1);
+  if (search_concurrency > 1) {
+    auto mjolnir = config.get_child("mjolnir");
+    mjolnir.put("global_synchronized_cache", true);
+    for (size_t i = 0; i < search_concurrency; ++i) {
+      search_readers.emplace_back(std::make_shared<GraphReader>(mjolnir));
+    }
+    search_pool = std::make_shared<midgard::ThreadPool>(search_concurrency - 1);
+  }
+
+  // optionally remember where locations snapped to across requests
+  costing_key = 0;
+  tileset_last_modified = get_tileset_last_modified(reader);
+  auto search_cache_size = config.get<size_t>("loki.search_cache.max_bytes", 0);
+  if (search_cache_size) {
+    search_cache.reset(new SearchCache(search_cache_size,
+                                       config.get<double>("loki.search_cache.precision", 0),
+                                       config.get<uint32_t>("loki.search_cache.max_age", 0)));
+  }
+
+  // optionally remember the reach of edges across requests
+  auto reach_cache_size = config.get<size_t>("loki.reach_cache.max_entries", 0);
+  if (reach_cache_size) {
+    reach_cache.reset(new ReachCache(reach_cache_size));
+  }
+
+  // optionally serve the same response to the same request across requests
+  response_cache = ResponseCache::Get(config);
+  if (response_cache) {
+    response_cache->Refresh(*reader);
+  }
+
   // signal that the worker started successfully
   started();
 }
@@ -254,11 +354,63 @@ void loki_worker_t::cleanup() {
   if (reader->OverCommitted()) {
     reader->Trim();
   }
+  for (const auto& search_reader : search_readers) {
+    if (search_reader->OverCommitted()) {
+      search_reader->Trim();
+    }
+  }
+
+  // cached search results and the segment index are only good for the tiles they came from
+  if (search_cache || reach_cache || !segment_index_file.empty()) {
+    auto last_modified = get_tileset_last_modified(reader);
+    if (last_modified != tileset_last_modified) {
+      if (search_cache)
+        search_cache->Clear();
+      if (reach_cache)
+        reach_cache->Clear();
+      if (!segment_index_file.empty())
+        load_segment_index();
+      tileset_last_modified = last_modified;
+    }
+  }
+
+  // new tiles or traffic make the cached responses stale
+  if (response_cache) {
+    response_cache->Refresh(*reader);
+  }
+}
+
+void loki_worker_t::load_segment_index() {
+  if (segment_index_file.empty()) {
+    return;
+  }
+  // an index of some other build of the graph would hand us edges that arent there anymore, if the
+  // tiles were replaced the index may have been too so we look at the file again
+  try {
+    const auto dataset_id = reader->GetDatasetId();
+    if (!segment_index || segment_index->dataset_id() != dataset_id) {
+      segment_index.reset();
+      auto index = std::make_shared<const SegmentIndex>(segment_index_file);
+      if (index->dataset_id() != dataset_id) {
+        throw std::runtime_error("it was built from dataset " + std::to_string(index->dataset_id()) +
+                                 " but the tiles are from dataset " + std::to_string(dataset_id));
+      }
+      segment_index = std::move(index);
+      LOG_INFO("Loaded segment index " + segment_index_file + " with " +
+               std::to_string(segment_index->size()) + " segments");
+    }
+  } catch (const std::exception& e) {
+    segment_index.reset();
+    LOG_WARN("Falling back to tile bins, could not load segment index: " + std::string(e.what()));
+  }
 }
 
 void loki_worker_t::set_interrupt(const std::function<void()>* interrupt_function) {
   interrupt = interrupt_function;
   reader->SetInterrupt(interrupt);
+  for (const auto& search_reader : search_readers) {
+    search_reader->SetInterrupt(interrupt);
+  }
 }
 
 #ifdef HAVE_HTTP
@@ -270,14 +422,15 @@ loki_worker_t::work(const std::list<zmq::message_t>& job,
   // grab the request info and make sure to record any metrics before we are done
   auto& info = *static_cast<prime_server::http_request_info_t*>(request_info);
   LOG_INFO("Got Loki Request " + std::to_string(info.id));
-  Api request;
+  Api& request = request_arena.create();
   prime_server::worker_t::result_t result{true, {}, ""};
   try {
     // request parsing
     auto http_request =
         prime_server::http_request_t::from_string(static_cast<const char*>(job.front().data()),
                                                   job.front().size());
-    ParseApi(http_request, request);
+    // parsing is only timed when there is somewhere to send the timing
+    ParseApi(http_request, request, statsd_client != nullptr);
     const auto& options = request.options();
 
     // check there is a valid action
@@ -287,51 +440,58 @@ loki_worker_t::work(const std::list<zmq::message_t>& job,
 
     // Set the interrupt function
     service_worker_t::set_interrupt(&interrupt_function);
-    // do request specific processing
-    switch (options.action()) {
-      case Options::route:
-      case Options::centroid:
-        route(request);
-        result.messages.emplace_back(request.SerializeAsString());
-        break;
-      case Options::locate:
-        result = to_response(locate(request), info, request);
-        break;
-      case Options::sources_to_targets:
-      case Options::optimized_route:
-        matrix(request);
-        result.messages.emplace_back(request.SerializeAsString());
-        break;
-      case Options::isochrone:
-        isochrones(request);
-        result.messages.emplace_back(request.SerializeAsString());
-        break;
-      case Options::trace_attributes:
-      case Options::trace_route:
-        trace(request);
-        result.messages.emplace_back(request.SerializeAsString());
-        break;
-      case Options::height:
-        result = to_response(height(request), info, request);
-        break;
-      case Options::transit_available:
-        result = to_response(transit_available(request), info, request);
-        break;
-      case Options::status:
-        status(request);
-        result.messages.emplace_back(request.SerializeAsString());
-        break;
-      case Options::expansion:
-        if (options.expansion_action() == Options::route) {
+
+    // we may have just answered this one
+    std::string cached;
+    if (response_cache && response_cache->Lookup(request, *reader, cached)) {
+      result = to_response(cached, info, request);
+    } else {
+      // do request specific processing
+      switch (options.action()) {
+        case Options::route:
+        case Options::centroid:
           route(request);
-        } else {
+          result.messages.emplace_back(request.SerializeAsString());
+          break;
+        case Options::locate:
+          result = to_response(locate(request), info, request);
+          break;
+        case Options::sources_to_targets:
+        case Options::optimized_route:
+          matrix(request);
+          result.messages.emplace_back(request.SerializeAsString());
+          break;
+        case Options::isochrone:
           isochrones(request);
-        }
-        result.messages.emplace_back(request.SerializeAsString());
-        break;
-      default:
-        // apparently you wanted something that we figured we'd support but havent written yet
-        throw valhalla_exception_t{107};
+          result.messages.emplace_back(request.SerializeAsString());
+          break;
+        case Options::trace_attributes:
+        case Options::trace_route:
+          trace(request);
+          result.messages.emplace_back(request.SerializeAsString());
+          break;
+        case Options::height:
+          result = to_response(height(request), info, request);
+          break;
+        case Options::transit_available:
+          result = to_response(transit_available(request), info, request);
+          break;
+        case Options::status:
+          status(request);
+          result.messages.emplace_back(request.SerializeAsString());
+          break;
+        case Options::expansion:
+          if (options.expansion_action() == Options::route) {
+            route(request);
+          } else {
+            isochrones(request);
+          }
+          result.messages.emplace_back(request.SerializeAsString());
+          break;
+        default:
+          // apparently you wanted something that we figured we'd support but havent written yet
+          throw valhalla_exception_t{107};
+      }
     }
   } catch (const valhalla_exception_t& e) {
     LOG_WARN("400::" + std::string(e.what()) + " request_id=" + std::to_string(info.id));
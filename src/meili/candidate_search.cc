@@ -36,6 +36,7 @@ CandidateCollector::WithinSquaredDistance(const midgard::PointLL& location,
   std::vector<baldr::PathLocation> candidates;
   std::unordered_set<baldr::GraphId> visited_nodes;
   midgard::projector_t projector(location);
+  helpers::ShapeBuffer buffer;
   graph_tile_ptr tile;
 
   for (auto it = edgeid_begin; it != edgeid_end; it++) {
@@ -74,12 +75,25 @@ CandidateCollector::WithinSquaredDistance(const midgard::PointLL& location,
     baldr::GraphId snapped_node;
     baldr::PathLocation correlated(baldr::Location(location, stop_type));
 
-    // For avoiding recomputing projection later
+    // Both edges share the shape so we only project once if either is allowed
     const bool edge_included = !costing || costing->Allowed(edge, tile, sif::kDisallowShortcut);
+    const bool oppedge_included =
+        !costing || costing->Allowed(opp_edge, opp_tile, sif::kDisallowShortcut);
+    if (!edge_included && !oppedge_included) {
+      continue;
+    }
 
-    if (edge_included) {
-      std::tie(point, sq_distance, segment, offset) = helpers::Project(projector, shape);
+    // Measure the distance to all of the segments at once and only work out where along the edge
+    // we are, which needs the length of every segment, if its close enough. The vectorized distance
+    // can be off in the last bits so we leave a little slack and decide on the exact one below
+    buffer.Decode(shape);
+    segment = helpers::ClosestSegment(projector, buffer, sq_distance);
+    if (sq_distance > sq_search_radius * (1.0 + 1e-9)) {
+      continue;
+    }
+    std::tie(point, sq_distance, segment, offset) = helpers::Project(projector, buffer, segment);
 
+    if (edge_included) {
       if (sq_distance <= sq_search_radius) {
         const double dist = edge->forward() ? offset : 1.0 - offset;
         if (dist == 1.0) {
@@ -91,14 +105,8 @@ CandidateCollector::WithinSquaredDistance(const midgard::PointLL& location,
       }
     }
 
-    bool oppedge_included = !costing || costing->Allowed(opp_edge, opp_tile, sif::kDisallowShortcut);
-
     // Correlate its opp edge
     if (oppedge_included) {
-      // No need to project again if we already did it above
-      if (!edge_included) {
-        std::tie(point, sq_distance, segment, offset) = helpers::Project(projector, shape);
-      }
       if (sq_distance <= sq_search_radius) {
         const double dist = opp_edge->forward() ? offset : 1.0 - offset;
         if (dist == 1.0) {
@@ -164,8 +172,10 @@ void IndexBin(const graph_tile_ptr& tile,
 
 CandidateGridQuery::CandidateGridQuery(baldr::GraphReader& reader,
                                        float cell_width,
-                                       float cell_height)
-    : reader_(reader), cell_width_(cell_width), cell_height_(cell_height), grid_cache_() {
+                                       float cell_height,
+                                       const std::shared_ptr<GridCache>& shared_cache)
+    : reader_(reader), cell_width_(cell_width), cell_height_(cell_height), grid_cache_(),
+      shared_cache_(shared_cache) {
   bin_level_ = baldr::TileHierarchy::levels().back().level;
 }
 
@@ -178,7 +188,7 @@ CandidateGridQuery::GetGrid(const int32_t bin_id,
   // Check if the bin is in the cache
   const auto it = grid_cache_.find(bin_id);
   if (it != grid_cache_.end()) {
-    return &(it->second);
+    return it->second.get();
   }
 
   // Not in the cache. Get the tile and Index the bin within the tile.
@@ -196,11 +206,20 @@ CandidateGridQuery::GetGrid(const int32_t bin_id,
   int32_t bin_col = rc.second % ndiv;
   int32_t bin_index = (bin_row * ndiv) + bin_col;
 
-  // Insert the bin into the cache and index the bin
-  const auto inserted =
-      grid_cache_.emplace(bin_id, grid_t(tile->BoundingBox(), cell_width_, cell_height_));
-  IndexBin(tile, bin_index, reader_, inserted.first->second);
-  return &(inserted.first->second);
+  // Maybe another query already indexed it
+  const auto version = tile->header()->dataset_id();
+  GridCache::grid_ptr grid = shared_cache_ ? shared_cache_->Find(bin_id, version) : nullptr;
+
+  // Index the bin and share it
+  if (!grid) {
+    auto indexed = std::make_shared<grid_t>(tile->BoundingBox(), cell_width_, cell_height_);
+    IndexBin(tile, bin_index, reader_, *indexed);
+    grid = shared_cache_ ? shared_cache_->Insert(bin_id, version, std::move(indexed))
+                         : std::move(indexed);
+  }
+
+  // Insert the bin into the cache
+  return grid_cache_.emplace(bin_id, std::move(grid)).first->second.get();
 }
 
 std::unordered_set<baldr::GraphId>
@@ -54,6 +54,7 @@ void Config::CandidateSearch::Read(const boost::property_tree::ptree& params) {
 
   ReadParamOptional(cache_size, params, "grid.cache_size");
   ReadParamOptional(grid_size, params, "grid.size");
+  ReadParamOptional(shared_cache_size, params, "grid.shared_cache_size");
 }
 
 void Config::TransitionCost::Read(const boost::property_tree::ptree& params) {
@@ -83,6 +84,10 @@ void Config::TransitionCost::Read(const boost::property_tree::ptree& params) {
   if (const auto node = params.get_child_optional("customizable")) {
     is_turn_penalty_factor_customizable = FindValue(*node, "turn_penalty_factor");
   }
+
+  ReadParamOptional(multi_source_routing, params, "default.multi_source_routing");
+  ReadParamOptional(cache_size, params, "transition_cache.max_paths");
+  ReadParamOptional(concurrency, params, "routing_concurrency");
 }
 
 void Config::EmissionCost::Read(const boost::property_tree::ptree& params) {
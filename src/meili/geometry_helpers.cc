@@ -1,5 +1,8 @@
 #include "meili/geometry_helpers.h"
 
+#include <cmath>
+#include <limits>
+
 #include <valhalla/midgard/constants.h>
 #include <valhalla/midgard/distanceapproximator.h>
 #include <valhalla/midgard/encoded.h>
@@ -14,42 +17,21 @@ namespace valhalla {
 namespace meili {
 namespace helpers {
 
-// snapped point, squared distance, segment index, offset
-std::tuple<PointLL, double, typename std::vector<PointLL>::size_type, double>
-Project(const projector_t& p, Shape7Decoder<midgard::PointLL>& shape, double snap_distance) {
-  PointLL first_point(shape.pop());
-  auto closest_point = first_point;
-  auto closest_segment_point = first_point;
-  double closest_distance = std::numeric_limits<double>::max();
-  size_t closest_segment = 0;
-  double closest_partial_length = 0.0;
-  double total_length = 0.0;
-
-  // for each segment
-  auto u = first_point;
-  size_t i = 0;
-  for (; !shape.empty(); ++i) {
-    // project a onto b where b is the origin vector representing this segment
-    // and a is the origin vector to the point we are projecting, (a.b/b.b)*b
-    auto v = shape.pop();
-
-    auto projection = p(u, v);
-
-    // check if this point is better
-    const auto distance = p.approx.DistanceSquared(projection);
-    if (distance < closest_distance) {
-      closest_point = std::move(projection);
-      closest_distance = distance;
-      closest_segment = i;
-      closest_partial_length = total_length;
-      closest_segment_point = u;
-    }
-
-    // total edge length
-    total_length += u.Distance(v);
-    u = v;
-  }
+namespace {
 
+// works out the percent along and snaps to the ends of the shape, shared by both projections
+std::tuple<PointLL, double, typename std::vector<PointLL>::size_type, double>
+Finish(const projector_t& p,
+       const PointLL& first_point,
+       const PointLL& u,
+       size_t i,
+       PointLL closest_point,
+       double closest_distance,
+       size_t closest_segment,
+       const PointLL& closest_segment_point,
+       double closest_partial_length,
+       double total_length,
+       double snap_distance) {
   // percent_along is a double between 0 and 1 representing the location of
   // the closest point on LineString to the given Point, as a fraction
   // of total 2d line length.
@@ -96,6 +78,142 @@ Project(const projector_t& p, Shape7Decoder<midgard::PointLL>& shape, double sna
   return std::make_tuple(std::move(closest_point), closest_distance, closest_segment, percent_along);
 }
 
+} // namespace
+
+// snapped point, squared distance, segment index, offset
+std::tuple<PointLL, double, typename std::vector<PointLL>::size_type, double>
+Project(const projector_t& p, Shape7Decoder<midgard::PointLL>& shape, double snap_distance) {
+  PointLL first_point(shape.pop());
+  auto closest_point = first_point;
+  auto closest_segment_point = first_point;
+  double closest_distance = std::numeric_limits<double>::max();
+  size_t closest_segment = 0;
+  double closest_partial_length = 0.0;
+  double total_length = 0.0;
+
+  // for each segment
+  auto u = first_point;
+  size_t i = 0;
+  for (; !shape.empty(); ++i) {
+    // project a onto b where b is the origin vector representing this segment
+    // and a is the origin vector to the point we are projecting, (a.b/b.b)*b
+    auto v = shape.pop();
+
+    auto projection = p(u, v);
+
+    // check if this point is better
+    const auto distance = p.approx.DistanceSquared(projection);
+    if (distance < closest_distance) {
+      closest_point = std::move(projection);
+      closest_distance = distance;
+      closest_segment = i;
+      closest_partial_length = total_length;
+      closest_segment_point = u;
+    }
+
+    // total edge length
+    total_length += u.Distance(v);
+    u = v;
+  }
+
+  return Finish(p, first_point, u, i, std::move(closest_point), closest_distance, closest_segment,
+                closest_segment_point, closest_partial_length, total_length, snap_distance);
+}
+
+size_t ShapeBuffer::Decode(Shape7Decoder<midgard::PointLL>& shape) {
+  lngs.clear();
+  lats.clear();
+  while (!shape.empty()) {
+    const auto point = shape.pop();
+    lngs.push_back(point.lng());
+    lats.push_back(point.lat());
+  }
+  return lngs.size();
+}
+
+void SqDistancesToSegments(const projector_t& p,
+                           const double* lngs,
+                           const double* lats,
+                           size_t count,
+                           double* sq_distances) {
+  // keep everything in locals so the compiler knows they dont change under the stores
+  const double lon_scale = p.lon_scale;
+  const double lng = p.lng;
+  const double lat = p.lat;
+  const double m_per_lng_degree = p.approx.GetLngScale() * kMetersPerDegreeLat;
+  for (size_t i = 0; i + 1 < count; ++i) {
+    const double bx = lngs[i + 1] - lngs[i];
+    const double by = lats[i + 1] - lats[i];
+    const double bx2 = bx * lon_scale;
+    const double sq = bx2 * bx2 + by * by;
+    const double dot = (lng - lngs[i]) * lon_scale * bx2 + (lat - lats[i]) * by;
+    // clamp to the segment with abs rather than comparisons, which would keep the compiler from
+    // vectorizing, zero length segments come out at their first point
+    const double ratio = dot / (sq + (sq == 0.0));
+    const double scale = 0.5 * (std::fabs(ratio) - std::fabs(ratio - 1.0) + 1.0);
+    const double dlat = (lats[i] + by * scale - lat) * kMetersPerDegreeLat;
+    const double dlng = (lngs[i] + bx * scale - lng) * m_per_lng_degree;
+    sq_distances[i] = dlat * dlat + dlng * dlng;
+  }
+}
+
+size_t ClosestSegment(const projector_t& p, ShapeBuffer& shape, double& sq_distance) {
+  const auto count = shape.size();
+  if (count < 2) {
+    sq_distance = p.approx.DistanceSquared({shape.lngs.front(), shape.lats.front()});
+    return 0;
+  }
+
+  shape.sq_distances.resize(count - 1);
+  SqDistancesToSegments(p, shape.lngs.data(), shape.lats.data(), count, shape.sq_distances.data());
+
+  // the first of the closest like the scalar projection
+  size_t closest = 0;
+  for (size_t i = 1; i < count - 1; ++i) {
+    if (shape.sq_distances[i] < shape.sq_distances[closest]) {
+      closest = i;
+    }
+  }
+  sq_distance = shape.sq_distances[closest];
+  return closest;
+}
+
+std::tuple<PointLL, double, typename std::vector<PointLL>::size_type, double>
+Project(const projector_t& p,
+        const ShapeBuffer& shape,
+        size_t closest_segment,
+        double snap_distance) {
+  const auto count = shape.size();
+  const PointLL first_point(shape.lngs.front(), shape.lats.front());
+  const PointLL last_point(shape.lngs.back(), shape.lats.back());
+  if (count < 2) {
+    return Finish(p, first_point, last_point, 0, first_point, p.approx.DistanceSquared(first_point),
+                  0, first_point, 0.0, 0.0, snap_distance);
+  }
+
+  // redo the closest one exactly as the scalar projection would have
+  const PointLL u(shape.lngs[closest_segment], shape.lats[closest_segment]);
+  const PointLL v(shape.lngs[closest_segment + 1], shape.lats[closest_segment + 1]);
+  auto closest_point = p(u, v);
+  const auto closest_distance = p.approx.DistanceSquared(closest_point);
+
+  // the lengths are only needed for the one we keep, summed in the same order as the scalar one
+  double closest_partial_length = 0.0;
+  double total_length = 0.0;
+  PointLL a = first_point;
+  for (size_t i = 1; i < count; ++i) {
+    if (i - 1 == closest_segment) {
+      closest_partial_length = total_length;
+    }
+    const PointLL b(shape.lngs[i], shape.lats[i]);
+    total_length += a.Distance(b);
+    a = b;
+  }
+
+  return Finish(p, first_point, last_point, count - 1, std::move(closest_point), closest_distance,
+                closest_segment, u, closest_partial_length, total_length, snap_distance);
+}
+
 } // namespace helpers
 } // namespace meili
 } // namespace valhalla
@@ -0,0 +1,73 @@
+#include "meili/grid_cache.h"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <utility>
+
+namespace valhalla {
+namespace meili {
+
+constexpr size_t GridCache::kShardCount;
+
+GridCache::GridCache(size_t max_bins) {
+  for (auto& s : shards_) {
+    s.reset(new shard_t(std::max<size_t>(max_bins / kShardCount, 1)));
+  }
+}
+
+GridCache::grid_ptr GridCache::Find(int32_t bin_id, uint64_t version) {
+  auto& s = shard(bin_id);
+  std::lock_guard<std::mutex> lock(s.mutex);
+  auto* found =
+      s.bins.find_if(bin_id, [version](const entry_t& entry) { return entry.version == version; });
+  return found ? found->grid : nullptr;
+}
+
+GridCache::grid_ptr GridCache::Insert(int32_t bin_id, uint64_t version, grid_ptr grid) {
+  auto& s = shard(bin_id);
+  std::lock_guard<std::mutex> lock(s.mutex);
+
+  // someone else indexed it while we were, use theirs so there is only one copy around. one from
+  // an older tileset gets replaced
+  auto* found = s.bins.peek(bin_id);
+  if (found && found->version == version) {
+    return found->grid;
+  }
+  return s.bins.insert(bin_id, entry_t{version, std::move(grid)})->grid;
+}
+
+void GridCache::Clear() {
+  for (auto& s : shards_) {
+    std::lock_guard<std::mutex> lock(s->mutex);
+    s->bins.clear();
+  }
+}
+
+size_t GridCache::size() const {
+  return sum([](const midgard::lru_cache<int32_t, entry_t>& bins) { return bins.size(); });
+}
+
+size_t GridCache::hits() const {
+  return sum([](const midgard::lru_cache<int32_t, entry_t>& bins) { return bins.hits(); });
+}
+
+size_t GridCache::misses() const {
+  return sum([](const midgard::lru_cache<int32_t, entry_t>& bins) { return bins.misses(); });
+}
+
+std::shared_ptr<GridCache>
+GridCache::Global(size_t max_bins, const std::string& tileset, float cell_width, float cell_height) {
+  // the grids are only interchangeable if they come from the same tiles and have the same cells
+  static std::mutex mutex;
+  static std::map<std::tuple<std::string, float, float>, std::shared_ptr<GridCache>> caches;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& cache = caches[std::make_tuple(tileset, cell_width, cell_height)];
+  if (!cache) {
+    cache = std::make_shared<GridCache>(max_bins);
+  }
+  return cache;
+}
+
+} // namespace meili
+} // namespace valhalla
@@ -17,6 +17,9 @@ using namespace valhalla::meili;
 
 constexpr float MAX_ACCUMULATED_COST = 99999999.f;
 
+// how many already returned states online matching keeps around before dropping them
+constexpr StateId::Time kMaxOnlineHistory = 64;
+
 inline float GreatCircleDistanceSquared(const Measurement& left, const Measurement& right) {
   return left.lnglat().DistanceSquared(right.lnglat());
 }
@@ -492,7 +495,12 @@ MapMatcher::MapMatcher(const Config& config,
                        baldr::GraphReader& graphreader,
                        CandidateQuery& candidatequery,
                        const sif::mode_costing_t& mode_costing,
-                       sif::TravelMode travelmode)
+                       sif::TravelMode travelmode,
+                       const labelset_storage_ptr_t& labelset_storage,
+                       const transition_cache_ptr_t& transition_cache,
+                       uint64_t costing_key,
+                       const std::vector<std::shared_ptr<baldr::GraphReader>>& thread_readers,
+                       midgard::ThreadPool* thread_pool)
     : config_(config), graphreader_(graphreader), candidatequery_(candidatequery),
       mode_costing_(mode_costing), travelmode_(travelmode), interrupt_(nullptr), vs_(), ts_(vs_),
       container_(), emission_cost_model_(graphreader_, container_, config_.emission_cost),
@@ -502,7 +510,13 @@ MapMatcher::MapMatcher(const Config& config,
                              container_,
                              mode_costing_,
                              travelmode_,
-                             config_.transition_cost) {
+                             config_.transition_cost,
+                             labelset_storage,
+                             transition_cache,
+                             costing_key,
+                             thread_readers,
+                             thread_pool),
+      online_emitted_(0), online_last_() {
   vs_.set_emission_cost_model(emission_cost_model_);
   vs_.set_transition_cost_model(transition_cost_model_);
 }
@@ -517,6 +531,10 @@ void MapMatcher::Clear() {
   vs_.set_transition_cost_model(transition_cost_model_);
   ts_.Clear();
   container_.Clear();
+  online_interpolated_.clear();
+  online_path_.clear();
+  online_emitted_ = 0;
+  online_last_ = {};
 }
 
 void MapMatcher::RemoveRedundancies(const std::vector<StateId>& result,
@@ -524,6 +542,19 @@ void MapMatcher::RemoveRedundancies(const std::vector<StateId>& result,
   if (result.empty()) {
     return;
   }
+
+  // Every candidate that isnt used by the result needs its paths below and they dont depend on
+  // each other, so we find them all up front which lets them be routed in parallel
+  std::vector<StateId> unused_stateids;
+  for (auto stateid = result.cbegin(); stateid != result.cend() - 1; ++stateid) {
+    for (const auto& candidate : container_.column(stateid->time())) {
+      if (candidate.stateid() != *stateid && !ts_.IsRemoved(candidate.stateid())) {
+        unused_stateids.push_back(candidate.stateid());
+      }
+    }
+  }
+  transition_cost_model_.RouteAll(unused_stateids);
+
   // For each pair of states in the last sequence of states
   for (auto left_state_id_itr = result.cbegin(); left_state_id_itr != result.cend() - 1;
        ++left_state_id_itr) {
@@ -866,6 +897,159 @@ MapMatcher::AppendMeasurements(const std::vector<Measurement>& measurements) {
   return interpolated;
 }
 
+MatchResults MapMatcher::OnlineMatch(const std::vector<Measurement>& measurements, bool finish) {
+  // forget about what we handed out a while ago so long running traces dont grow forever
+  if (online_emitted_ > kMaxOnlineHistory) {
+    CompactOnline();
+  }
+
+  // same as AppendMeasurements except that we dont know which measurement is the last one
+  const float sq_max_search_radius = config_.candidate_search.max_search_radius_meters *
+                                     config_.candidate_search.max_search_radius_meters;
+  const float sq_interpolation_distance =
+      config_.routing.interpolation_distance_meters * config_.routing.interpolation_distance_meters;
+  for (const auto& measurement : measurements) {
+    if (container_.size() == 0) {
+      AppendMeasurement(measurement, sq_max_search_radius);
+      continue;
+    }
+    const auto time = container_.size() - 1;
+    if (sq_interpolation_distance <
+        GreatCircleDistanceSquared(container_.measurement(time), measurement)) {
+      AppendOnlineMeasurement(measurement, sq_max_search_radius);
+    } else {
+      online_interpolated_[time].push_back(measurement);
+    }
+  }
+
+  // at the end we always match the last measurement
+  if (finish && container_.size() > 0) {
+    auto interpolated = online_interpolated_.find(container_.size() - 1);
+    if (interpolated != online_interpolated_.end()) {
+      auto measurement = interpolated->second.back();
+      interpolated->second.pop_back();
+      if (interpolated->second.empty()) {
+        online_interpolated_.erase(interpolated);
+      }
+      AppendOnlineMeasurement(measurement, sq_max_search_radius);
+    }
+  }
+
+  // nothing to do
+  if (container_.size() == 0) {
+    return {{}, {}, 0.f};
+  }
+
+  // figure out how much of the path is final
+  const StateId::Time last_time = container_.size() - 1;
+  auto final_state = vs_.SearchWinner(last_time);
+  StateId::Time final_time = last_time;
+  if (!finish) {
+    final_state = vs_.ConvergedState();
+    if (!final_state.IsValid()) {
+      return {{}, {}, 0.f};
+    }
+    final_time = final_state.time();
+  }
+
+  // get the final part of the path, the part we already handed out cant have changed
+  online_path_.resize(final_time + 1);
+  auto path_time = final_time;
+  for (auto stateid = StateIdIterator(vs_, final_time, final_state); stateid != vs_.PathEnd();
+       ++stateid, --path_time) {
+    online_path_[path_time] = *stateid;
+  }
+
+  // we can only say how a state was matched once we know the state after it, unless there is none
+  const StateId::Time emit_end = finish ? final_time + 1 : final_time;
+  if (emit_end <= online_emitted_) {
+    return {{}, {}, 0.f};
+  }
+  std::vector<MatchResult> results;
+  for (StateId::Time time = online_emitted_; time < final_time + 1; ++time) {
+    results.push_back(FindMatchResult(*this, online_path_, time, graphreader_));
+  }
+
+  // start with where we left off last time so the segments are connected
+  std::vector<MatchResult> chunk;
+  if (online_emitted_ > 0) {
+    chunk.push_back(online_last_);
+  }
+  for (StateId::Time time = online_emitted_; time < emit_end; ++time) {
+    const auto& result = results[time - online_emitted_];
+    chunk.push_back(result);
+
+    // add the points between this and the next state
+    const auto interpolated = online_interpolated_.find(time);
+    if (interpolated == online_interpolated_.end()) {
+      continue;
+    }
+    const auto has_next = time + 1 <= final_time;
+    const auto interpolated_results =
+        InterpolateMeasurements(*this, interpolated->second, online_path_[time],
+                                has_next ? online_path_[time + 1] : StateId(), result,
+                                has_next ? results[time + 1 - online_emitted_] : result);
+    chunk.insert(chunk.cend(), interpolated_results.cbegin(), interpolated_results.cend());
+  }
+  online_last_ = results[emit_end - 1 - online_emitted_];
+  online_emitted_ = emit_end;
+
+  // the score is the cost of the path up to the last state we handed out
+  const auto& last_state = online_path_[emit_end - 1];
+  const float score =
+      last_state.IsValid() ? vs_.AccumulatedCost(last_state) : MAX_ACCUMULATED_COST;
+  auto segments = ConstructRoute(*this, chunk);
+  return {std::move(chunk), std::move(segments), score};
+}
+
+void MapMatcher::AppendOnlineMeasurement(const Measurement& measurement,
+                                         const float sq_max_search_radius) {
+  // if the trace lingered near the last match we use the time of the last interpolated point as
+  // the time they left, just like AppendMeasurements
+  const auto time = container_.size() - 1;
+  const auto interpolated = online_interpolated_.find(time);
+  if (interpolated != online_interpolated_.end() && interpolated->second.back().epoch_time() != -1) {
+    const auto& last = container_.measurement(time);
+    auto p = interpolated->second.back().lnglat().Project(last.lnglat(), measurement.lnglat());
+    if (p.Distance(last.lnglat()) / last.lnglat().Distance(measurement.lnglat()) < .2f) {
+      container_.SetMeasurementLeaveTime(time, interpolated->second.back().epoch_time());
+    }
+  }
+  AppendMeasurement(measurement, sq_max_search_radius);
+}
+
+void MapMatcher::CompactOnline() {
+  // keep the last two states we handed out so that routes leaving them still have a predecessor
+  const StateId::Time first = online_emitted_ - 2;
+  auto container = std::move(container_);
+  auto interpolated = std::move(online_interpolated_);
+  auto path = std::move(online_path_);
+  auto emitted = online_emitted_;
+  auto last = online_last_;
+  Clear();
+
+  // start over from there, the part we already handed out can only be matched one way
+  for (StateId::Time time = first; time < container.size(); ++time) {
+    const auto new_time = container_.AppendMeasurement(container.measurement(time));
+    container_.SetMeasurementLeaveTime(new_time, container.leave_time(time));
+    if (time < emitted) {
+      if (path[time].IsValid()) {
+        vs_.AddStateId(container_.AppendCandidate(container.state(path[time]).candidate()));
+      }
+    } else {
+      for (const auto& state : container.column(time)) {
+        vs_.AddStateId(container_.AppendCandidate(state.candidate()));
+      }
+    }
+    auto found = interpolated.find(time);
+    if (found != interpolated.end()) {
+      online_interpolated_.emplace(new_time, std::move(found->second));
+    }
+  }
+  online_emitted_ = emitted - first;
+  online_last_ = last;
+  online_last_.stateid = last.HasState() ? StateId(online_emitted_ - 1, 0) : StateId();
+}
 StateId::Time MapMatcher::AppendMeasurement(const Measurement& measurement,
                                             const float sq_max_search_radius) {
   // Test interrupt
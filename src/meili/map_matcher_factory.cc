@@ -27,12 +27,32 @@ namespace meili {
 
 MapMatcherFactory::MapMatcherFactory(const boost::property_tree::ptree& root,
                                      const std::shared_ptr<baldr::GraphReader>& graph_reader)
-    : config_(root.get_child("meili")), graphreader_(graph_reader) {
+    : config_(root.get_child("meili")), graphreader_(graph_reader),
+      labelset_storage_(std::make_shared<LabelSetStorage>()) {
   if (!graphreader_)
     graphreader_.reset(new baldr::GraphReader(root.get_child("mjolnir")));
-  candidatequery_.reset(
-      new CandidateGridQuery(*graphreader_, local_tile_size() / config_.candidate_search.grid_size,
-                             local_tile_size() / config_.candidate_search.grid_size));
+  // indexed bins can be shared with the matchers on other threads
+  const float cell_size = local_tile_size() / config_.candidate_search.grid_size;
+  std::shared_ptr<GridCache> shared_cache;
+  if (config_.candidate_search.shared_cache_size) {
+    const auto tileset = root.get<std::string>("mjolnir.tile_extract", "") + "|" +
+                         root.get<std::string>("mjolnir.tile_dir", "");
+    shared_cache = GridCache::Global(config_.candidate_search.shared_cache_size, tileset,
+                                     cell_size, cell_size);
+  }
+  candidatequery_.reset(new CandidateGridQuery(*graphreader_, cell_size, cell_size, shared_cache));
+  if (config_.transition_cost.cache_size) {
+    transition_cache_ = std::make_shared<TransitionCache>(config_.transition_cost.cache_size);
+  }
+  // optionally route from the candidates left behind by the top k paths in parallel
+  if (config_.transition_cost.concurrency > 1) {
+    auto mjolnir = root.get_child("mjolnir");
+    mjolnir.put("global_synchronized_cache", true);
+    for (size_t i = 0; i < config_.transition_cost.concurrency; ++i) {
+      thread_readers_.emplace_back(std::make_shared<baldr::GraphReader>(mjolnir));
+    }
+    thread_pool_.reset(new midgard::ThreadPool(config_.transition_cost.concurrency - 1));
+  }
 }
 
 MapMatcherFactory::~MapMatcherFactory() {
@@ -47,8 +67,16 @@ MapMatcher* MapMatcherFactory::Create(const Options& options) {
 
   mode_costing_[static_cast<uint32_t>(mode)] = cost;
 
+  // paths are only the same for the same costing
+  const auto costing_key =
+      transition_cache_
+          ? TransitionCache::CostingKey(options, config.transition_cost.turn_penalty_factor)
+          : 0;
+
   // TODO investigate exception safety
-  return new MapMatcher(config, *graphreader_, *candidatequery_, mode_costing_, mode);
+  return new MapMatcher(config, *graphreader_, *candidatequery_, mode_costing_, mode,
+                        labelset_storage_, transition_cache_, costing_key, thread_readers_,
+                        thread_pool_.get());
 }
 
 Config MapMatcherFactory::MergeConfig(const Options& options) const {
@@ -83,6 +111,11 @@ void MapMatcherFactory::ClearFullCache() {
   if (graphreader_->OverCommitted()) {
     graphreader_->Trim();
   }
+  for (auto& reader : thread_readers_) {
+    if (reader->OverCommitted()) {
+      reader->Trim();
+    }
+  }
 
   if (candidatequery_->size() > config_.candidate_search.cache_size) {
     candidatequery_->Clear();
@@ -92,6 +125,12 @@ void MapMatcherFactory::ClearFullCache() {
 void MapMatcherFactory::ClearCache() {
   graphreader_->Clear();
   candidatequery_->Clear();
+  if (transition_cache_) {
+    transition_cache_->Clear();
+  }
+  for (auto& reader : thread_readers_) {
+    reader->Clear();
+  }
 }
 
 } // namespace meili
@@ -0,0 +1,48 @@
+#include "meili/match_sessions.h"
+
+#include <algorithm>
+
+namespace valhalla {
+namespace meili {
+
+MatchSessions::MatchSessions(size_t max_sessions, uint32_t max_idle)
+    : sessions_(std::max<size_t>(max_sessions, 1),
+                0,
+                clock_t::duration::max(),
+                max_idle ? std::chrono::seconds(max_idle) : clock_t::duration::max()) {
+}
+
+std::shared_ptr<MapMatcher> MatchSessions::Get(const std::string& id,
+                                               const std::string& fingerprint,
+                                               const std::function<MapMatcher*()>& create,
+                                               clock_t::time_point now) {
+  Evict(now);
+
+  // its now the most recently used
+  auto* session = sessions_.peek(id);
+  if (session) {
+    if (session->fingerprint != fingerprint) {
+      return nullptr;
+    }
+    return sessions_.find(id, now)->matcher;
+  }
+
+  // the least recently used one makes room for it
+  std::shared_ptr<MapMatcher> matcher(create());
+  return sessions_.insert(id, session_t{fingerprint, std::move(matcher)}, 0, now)->matcher;
+}
+
+bool MatchSessions::Remove(const std::string& id) {
+  return sessions_.erase(id);
+}
+
+size_t MatchSessions::Evict(clock_t::time_point now) {
+  return sessions_.expire(now);
+}
+
+void MatchSessions::Clear() {
+  sessions_.clear();
+}
+
+} // namespace meili
+} // namespace valhalla
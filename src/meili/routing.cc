@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -15,8 +16,14 @@
 namespace valhalla {
 namespace meili {
 
-LabelSet::LabelSet(const float max_cost, const float bucket_size)
-    : queue_(0.0f, max_cost, bucket_size, &labels_) {
+LabelSet::LabelSet(const float max_cost,
+                   const float bucket_size,
+                   const labelset_storage_ptr_t& storage)
+    : storage_(storage ? storage : std::make_shared<LabelSetStorage>()) {
+  // whatever the last search left behind has to go, it may not have made it to the end
+  clear_queue();
+  clear_status();
+  storage_->queue.reuse(0.0f, max_cost, bucket_size, &labels_);
 }
 
 void LabelSet::put(const baldr::GraphId& nodeid,
@@ -29,20 +36,22 @@ void LabelSet::put(const baldr::GraphId& nodeid,
                    const uint32_t predecessor,
                    const baldr::DirectedEdge* edge,
                    const sif::TravelMode mode,
-                   int restriction_idx) {
+                   int restriction_idx,
+                   const uint16_t origin) {
   if (!nodeid.Is_Valid()) {
     throw std::runtime_error("invalid nodeid");
   }
 
   // Find the node Id. If not found, create a new label and push
   // it to the queue
-  const auto it = node_status_.find(nodeid);
-  if (it == node_status_.end()) {
+  const auto key = node_key(nodeid, origin);
+  const auto it = storage_->node_status.find(key);
+  if (it == storage_->node_status.end()) {
     const uint32_t idx = labels_.size();
     labels_.emplace_back(nodeid, kInvalidDestination, edgeid, source, target, cost, turn_cost,
-                         sortcost, predecessor, edge, mode, restriction_idx);
-    queue_.add(idx);
-    node_status_.emplace(nodeid, idx);
+                         sortcost, predecessor, edge, mode, restriction_idx, origin);
+    storage_->queue.add(idx);
+    storage_->node_status.emplace(key, idx);
   } else {
     // Node has been found. Check if there is a lower sortcost than the
     // existing label - if so update priority queue and Label
@@ -50,10 +59,10 @@ void LabelSet::put(const baldr::GraphId& nodeid,
     if (!status.permanent && sortcost < labels_[status.label_idx].sortcost()) {
       // Update queue first since it uses the label cost within the decrease
       // method to determine the current bucket.
-      queue_.decrease(status.label_idx, sortcost);
+      storage_->queue.decrease(status.label_idx, sortcost);
       labels_[status.label_idx] = {nodeid, kInvalidDestination, edgeid,   source,      target,
                                    cost,   turn_cost,           sortcost, predecessor, edge,
-                                   mode,   restriction_idx};
+                                   mode,   restriction_idx,     origin};
     }
   }
 }
@@ -68,7 +77,8 @@ void LabelSet::put(const uint16_t dest,
                    const uint32_t predecessor,
                    const baldr::DirectedEdge* edge,
                    const sif::TravelMode travelmode,
-                   int restriction_idx) {
+                   int restriction_idx,
+                   const uint16_t origin) {
   if (dest == kInvalidDestination) {
     throw std::runtime_error("invalid destination");
   }
@@ -76,40 +86,52 @@ void LabelSet::put(const uint16_t dest,
   // Find the destination. If not count, create a new label and push it
   // to the queue
   baldr::GraphId inv;
-  const auto it = dest_status_.find(dest);
-  if (it == dest_status_.end()) {
+  const auto key = dest_key(dest, origin);
+  const auto it = storage_->dest_status.find(key);
+  if (it == storage_->dest_status.end()) {
     const uint32_t idx = labels_.size();
     labels_.emplace_back(inv, dest, edgeid, source, target, cost, turn_cost, sortcost, predecessor,
-                         edge, travelmode, restriction_idx);
-    queue_.add(idx);
-    dest_status_.emplace(dest, idx);
+                         edge, travelmode, restriction_idx, origin);
+    storage_->queue.add(idx);
+    storage_->dest_status.emplace(key, idx);
   } else {
     // Decrease cost of the existing label
     const auto& status = it->second;
     if (!status.permanent && sortcost < labels_[status.label_idx].sortcost()) {
       // Update queue first since it uses the label cost within the decrease
       // method to determine the current bucket.
-      queue_.decrease(status.label_idx, sortcost);
-      labels_[status.label_idx] = {inv,         dest, edgeid,     source,
-                                   target,      cost, turn_cost,  sortcost,
-                                   predecessor, edge, travelmode, restriction_idx};
+      storage_->queue.decrease(status.label_idx, sortcost);
+      labels_[status.label_idx] = {inv,         dest, edgeid,     source,          target,
+                                   cost,        turn_cost,        sortcost,        predecessor,
+                                   edge,        travelmode,       restriction_idx, origin};
     }
   }
 }
 
+// Add the labels of a path found elsewhere chaining each to the one before
+uint32_t LabelSet::put(const std::vector<Label>& path) {
+  uint32_t predecessor = baldr::kInvalidLabel;
+  for (const auto& label : path) {
+    labels_.push_back(label);
+    labels_.back().set_predecessor(predecessor);
+    predecessor = labels_.size() - 1;
+  }
+  return predecessor;
+}
+
 // Get the next label from the priority queue. Marks the popped label
 // as permanent (best path found).
 uint32_t LabelSet::pop() {
-  const auto idx = queue_.pop();
+  const auto idx = storage_->queue.pop();
 
   // Mark the popped label as permanent (optimal)
   if (idx != baldr::kInvalidLabel) {
     const auto& label = labels_[idx];
     if (label.nodeid().Is_Valid()) {
-      const auto it = node_status_.find(label.nodeid());
+      const auto it = storage_->node_status.find(node_key(label.nodeid(), label.origin()));
 
       // When these logic errors happen, go check LabelSet::put
-      if (it == node_status_.end()) {
+      if (it == storage_->node_status.end()) {
         // No exception, unless BucketQueue::put was wrong: it said it
         // added but actually failed
         throw std::logic_error("all nodes in the queue should have its status");
@@ -131,9 +153,9 @@ uint32_t LabelSet::pop() {
 
       status.permanent = true;
     } else { // assert(label.dest != kInvalidDestination)
-      const auto it = dest_status_.find(label.dest());
+      const auto it = storage_->dest_status.find(dest_key(label.dest(), label.origin()));
 
-      if (it == dest_status_.end()) {
+      if (it == storage_->dest_status.end()) {
         throw std::logic_error("all dests in the queue should have its status");
       }
       auto& status = it->second;
@@ -181,7 +203,8 @@ void set_origin(baldr::GraphReader& reader,
                 const labelset_ptr_t& labelset,
                 const sif::TravelMode travelmode,
                 const sif::cost_ptr_t& costing,
-                const Label* edgelabel) {
+                const Label* edgelabel,
+                const uint16_t label_origin = 0) {
   // Push dummy labels (invalid edgeid, zero cost, no predecessor) to
   // the queue for the initial expansion later. These dummy labels
   // will also serve as roots in search trees, and sentinels to
@@ -199,7 +222,7 @@ void set_origin(baldr::GraphReader& reader,
         if (!nodeinfo || !costing->Allowed(nodeinfo)) {
           continue;
         }
-        labelset->put(nodeid, travelmode, edgelabel);
+        labelset->put(nodeid, travelmode, edgelabel, label_origin);
       }
     } else if (edge.end_node()) {
       auto edge_nodes = reader.GetDirectedEdgeNodes(edge.id, tile);
@@ -211,11 +234,11 @@ void set_origin(baldr::GraphReader& reader,
         if (!nodeinfo || !costing->Allowed(nodeinfo)) {
           continue;
         }
-        labelset->put(nodeid, travelmode, edgelabel);
+        labelset->put(nodeid, travelmode, edgelabel, label_origin);
       }
     } else {
       // Will decide whether to filter out this edge later
-      labelset->put(origin_idx, travelmode, edgelabel);
+      labelset->put(origin_idx, travelmode, edgelabel, label_origin);
     }
   }
 }
@@ -358,14 +381,45 @@ find_shortest_path(baldr::GraphReader& reader,
                    const float turn_cost_table[181],
                    const float max_dist,
                    const float max_time) {
+  auto results = find_shortest_paths(reader, destinations, {origin_idx}, labelset, approximator,
+                                     search_radius, costing, {edgelabel}, turn_cost_table, max_dist,
+                                     max_time);
+  return std::move(results.front());
+}
+
+/**
+ * Find the shortest paths from several origins to a set of destinations at once.
+ */
+std::vector<std::unordered_map<uint16_t, uint32_t>>
+find_shortest_paths(baldr::GraphReader& reader,
+                    const std::vector<baldr::PathLocation>& destinations,
+                    const std::vector<uint16_t>& origin_idxs,
+                    labelset_ptr_t labelset,
+                    const midgard::DistanceApproximator<midgard::PointLL>& approximator,
+                    const float search_radius,
+                    sif::cost_ptr_t costing,
+                    const std::vector<const Label*>& edgelabels,
+                    const float turn_cost_table[181],
+                    const float max_dist,
+                    const float max_time) {
+  if (origin_idxs.size() != edgelabels.size()) {
+    throw std::invalid_argument("Expect an edge label (or nullptr) for each origin");
+  }
+
   Label label;
   const sif::TravelMode travelmode = costing->travel_mode();
 
-  // Destinations along edges
-  std::unordered_map<baldr::GraphId, std::unordered_set<uint16_t>> edge_dests;
+  // What each origin is still looking for: destinations along edges and at nodes
+  struct search_t {
+    std::unordered_map<baldr::GraphId, std::unordered_set<uint16_t>> edge_dests;
+    std::unordered_map<baldr::GraphId, std::unordered_set<uint16_t>> node_dests;
+  };
+  std::vector<search_t> searches(origin_idxs.size());
+  std::vector<std::unordered_map<uint16_t, uint32_t>> results(origin_idxs.size());
 
-  // Destinations at nodes
-  std::unordered_map<baldr::GraphId, std::unordered_set<uint16_t>> node_dests;
+  // The origin whose label is being expanded and what its still looking for
+  uint16_t origin = 0;
+  search_t* search = nullptr;
 
   // Lambda for heuristic
   float search_rad2 = search_radius * search_radius;
@@ -421,8 +475,8 @@ find_shortest_path(baldr::GraphReader& reader,
 
       // If destinations found along the edge, add segments to each
       // destination to the queue
-      const auto it = edge_dests.find(edgeid);
-      if (it != edge_dests.end()) {
+      const auto it = search->edge_dests.find(edgeid);
+      if (it != search->edge_dests.end()) {
         for (const auto dest : it->second) {
           for (const auto& edge : destinations[dest].edges) {
             if (edge.id == edgeid) {
@@ -436,7 +490,7 @@ find_shortest_path(baldr::GraphReader& reader,
               // distance and for time or time limit is 0
               if (cost.cost < max_dist && (max_time < 0 || cost.secs < max_time)) {
                 labelset->put(dest, edgeid, 0.f, edge.percent_along, cost, turn_cost, cost.cost,
-                              label_idx, directededge, travelmode, restriction_idx);
+                              label_idx, directededge, travelmode, restriction_idx, origin);
               }
             }
           }
@@ -456,7 +510,7 @@ find_shortest_path(baldr::GraphReader& reader,
         if (cost.cost < max_dist && (max_time < 0 || cost.secs < max_time)) {
           float sortcost = cost.cost + heuristic(endtile->get_node_ll(directededge->endnode()));
           labelset->put(directededge->endnode(), edgeid, 0.0f, 1.0f, cost, turn_cost, sortcost,
-                        label_idx, directededge, travelmode, restriction_idx);
+                        label_idx, directededge, travelmode, restriction_idx, origin);
         }
       }
     }
@@ -470,15 +524,46 @@ find_shortest_path(baldr::GraphReader& reader,
     }
   };
 
-  // Load origin to the queue of the labelset
-  set_origin(reader, destinations, origin_idx, labelset, travelmode, costing, edgelabel);
+  // Load origins to the queue of the labelset
+  for (origin = 0; origin < origin_idxs.size(); ++origin) {
+    set_origin(reader, destinations, origin_idxs[origin], labelset, travelmode, costing,
+               edgelabels[origin], origin);
+  }
+
+  // Load destinations, once for all of the origins. An origin is not a destination of the others
+  set_destinations(reader, destinations, searches.front().node_dests, searches.front().edge_dests);
+  if (origin_idxs.size() > 1) {
+    const auto all = std::move(searches.front());
+    const auto keep = [&origin_idxs](uint16_t dest, uint16_t idx) {
+      return dest == origin_idxs[idx] ||
+             std::find(origin_idxs.cbegin(), origin_idxs.cend(), dest) == origin_idxs.cend();
+    };
+    for (origin = 0; origin < origin_idxs.size(); ++origin) {
+      auto& filtered = searches[origin];
+      filtered = {};
+      for (const auto& dests : all.node_dests) {
+        for (const auto dest : dests.second) {
+          if (keep(dest, origin)) {
+            filtered.node_dests[dests.first].insert(dest);
+          }
+        }
+      }
+      for (const auto& dests : all.edge_dests) {
+        for (const auto dest : dests.second) {
+          if (keep(dest, origin)) {
+            filtered.edge_dests[dests.first].insert(dest);
+          }
+        }
+      }
+    }
+  }
 
-  // Load destinations
-  set_destinations(reader, destinations, node_dests, edge_dests);
+  // Origins that have found all of their destinations
+  std::vector<bool> done(origin_idxs.size(), false);
+  size_t searching = origin_idxs.size();
 
   // TODO: use faster unordered_map impl like matrix PR does
-  std::unordered_map<uint16_t, uint32_t> results;
-  while (true) {
+  while (searching > 0) {
     uint32_t label_idx = labelset->pop();
     if (label_idx == baldr::kInvalidLabel) {
       LOG_TRACE("Exhausted labels without finding all destinations");
@@ -488,6 +573,15 @@ find_shortest_path(baldr::GraphReader& reader,
     // Copy the Label since it is possible for it to be invalidated when new
     // labels are added.
     label = labelset->label(label_idx);
+    origin = label.origin();
+    if (done[origin]) {
+      continue;
+    }
+    search = &searches[origin];
+    auto& node_dests = search->node_dests;
+    auto& edge_dests = search->edge_dests;
+    const auto origin_idx = origin_idxs[origin];
+
     // Check if we are looking for a node destination on this label
     if (label.nodeid().Is_Valid()) {
       // If this node is a destination, path to destinations at this
@@ -496,7 +590,7 @@ find_shortest_path(baldr::GraphReader& reader,
       const auto it = node_dests.find(label.nodeid());
       if (it != node_dests.end()) {
         for (const auto dest : it->second) {
-          results[dest] = label_idx;
+          results[origin][dest] = label_idx;
         }
         node_dests.erase(it);
       }
@@ -504,7 +598,9 @@ find_shortest_path(baldr::GraphReader& reader,
       // Congrats!
       if (node_dests.empty() && edge_dests.empty()) {
         LOG_TRACE("The last node destination was found");
-        break;
+        done[origin] = true;
+        --searching;
+        continue;
       }
 
       // Expand edges from this node
@@ -514,7 +610,7 @@ find_shortest_path(baldr::GraphReader& reader,
       // Path to a destination along an edge is found: remember it and
       // remove the destination from the destination list
       const auto destination_idx = label.dest();
-      results[destination_idx] = label_idx;
+      results[origin][destination_idx] = label_idx;
       for (const auto& edge : destinations[destination_idx].edges) {
         const auto it = edge_dests.find(edge.id);
         if (it != edge_dests.end()) {
@@ -528,7 +624,9 @@ find_shortest_path(baldr::GraphReader& reader,
       // Congrats!
       if (edge_dests.empty() && node_dests.empty()) {
         LOG_TRACE("The last edge destination was found");
-        break;
+        done[origin] = true;
+        --searching;
+        continue;
       }
 
       // If this isnt the origin label then we dont need to queue any edges
@@ -539,10 +637,11 @@ find_shortest_path(baldr::GraphReader& reader,
 
       // Expand origin: add segments from origin to destinations ahead
       // at the same edge as well as at the opposite edge to the queue
-      const auto& origin = destinations[origin_idx];
-      bool allows_immediate_uturn = origin.stoptype_ == baldr::Location::StopType::BREAK ||
-                                    origin.stoptype_ == baldr::Location::StopType::VIA;
-      for (const auto& origin_edge : origin.edges) {
+      const auto& origin_location = destinations[origin_idx];
+      bool allows_immediate_uturn =
+          origin_location.stoptype_ == baldr::Location::StopType::BREAK ||
+          origin_location.stoptype_ == baldr::Location::StopType::VIA;
+      for (const auto& origin_edge : origin_location.edges) {
         // The tile will be guaranteed to be directededge's tile in this
         // loop
         graph_tile_ptr start_tile = nullptr;
@@ -583,7 +682,7 @@ find_shortest_path(baldr::GraphReader& reader,
               if (cost.cost < max_dist && (max_time < 0 || cost.secs < max_time)) {
                 labelset->put(other_dest, origin_edge.id, origin_edge.percent_along,
                               destination_edge.percent_along, cost, turn_cost, cost.cost, label_idx,
-                              directed_edge, travelmode, restriction_idx);
+                              directed_edge, travelmode, restriction_idx, origin);
               }
             }
           }
@@ -606,7 +705,7 @@ find_shortest_path(baldr::GraphReader& reader,
           float sortcost = cost.cost + heuristic(endtile->get_node_ll(directed_edge->endnode()));
           labelset->put(directed_edge->endnode(), origin_edge.id, origin_edge.percent_along, 1.f,
                         cost, turn_cost, sortcost, label_idx, directed_edge, travelmode,
-                        restriction_idx);
+                        restriction_idx, origin);
         }
       }
     }
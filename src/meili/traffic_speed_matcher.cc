@@ -0,0 +1,242 @@
+#include "meili/traffic_speed_matcher.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#include "baldr/graphtile.h"
+#include "midgard/logging.h"
+#include "midgard/sequence.h"
+
+using namespace valhalla::baldr;
+
+namespace {
+
+// how far outside of a segment a match result can be and still be considered on it
+constexpr double kDistanceAlongFuzz = 1e-3;
+
+// a point on the path where we know what time it was
+struct anchor_t {
+  double along;  // meters from the start of the path
+  double time;   // seconds since epoch
+  uint32_t run;  // which continuous part of the path its on
+};
+
+// the time at the given distance along the path interpolated between the anchors around it, or -1
+// if there arent anchors on both sides in the same run. the hint is the last anchor at or before the
+// previous distance asked about, the distances have to be asked about in order
+double time_at(const std::vector<anchor_t>& anchors, double along, uint32_t run, size_t& hint) {
+  while (hint + 1 < anchors.size() && anchors[hint + 1].along <= along) {
+    ++hint;
+  }
+  if (hint >= anchors.size() || anchors[hint].along > along || anchors[hint].run != run) {
+    return -1;
+  }
+  const auto& before = anchors[hint];
+  if (before.along == along) {
+    return before.time;
+  }
+  if (hint + 1 == anchors.size() || anchors[hint + 1].run != run) {
+    return -1;
+  }
+  const auto& after = anchors[hint + 1];
+  return before.time + (after.time - before.time) * (along - before.along) /
+                           (after.along - before.along);
+}
+
+} // namespace
+
+namespace valhalla {
+namespace meili {
+
+TrafficSpeedMatcher::TrafficSpeedMatcher(const boost::property_tree::ptree& config,
+                                         unsigned int concurrency) {
+  if (concurrency == 0) {
+    concurrency = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  // every thread gets its own reader and matchers, they share one tile cache if there are many
+  auto root = config;
+  if (concurrency > 1) {
+    root.get_child("mjolnir").put("global_synchronized_cache", true);
+  }
+  for (unsigned int i = 0; i < concurrency; ++i) {
+    readers_.emplace_back(std::make_shared<GraphReader>(root.get_child("mjolnir")));
+    factories_.emplace_back(new MapMatcherFactory(root, readers_.back()));
+  }
+  pool_.reset(new midgard::ThreadPool(concurrency - 1));
+}
+
+size_t TrafficSpeedMatcher::Match(const std::vector<std::vector<Measurement>>& traces,
+                                  const Options& options) {
+  if (traces.empty()) {
+    return 0;
+  }
+
+  // each task matches a contiguous run of the traces into its own speeds with its own matcher, the
+  // pool passes along anything that went wrong in one of them
+  const size_t concurrency = std::min(factories_.size(), traces.size());
+  std::vector<std::unordered_map<GraphId, edge_speed_t>> thread_speeds(concurrency);
+  std::vector<size_t> failures(concurrency, 0);
+  pool_->Run(concurrency, [&](size_t i) {
+    std::unique_ptr<MapMatcher> matcher(factories_[i]->Create(options));
+    const auto begin = traces.begin() + i * traces.size() / concurrency;
+    const auto end = traces.begin() + (i + 1) * traces.size() / concurrency;
+    for (auto trace = begin; trace != end; ++trace) {
+      try {
+        auto paths = matcher->OfflineMatch(*trace);
+        Accumulate(paths.front(), *readers_[i], thread_speeds[i]);
+      } catch (const std::exception& e) {
+        LOG_DEBUG("Could not match probe trace " + std::to_string(trace - traces.begin()) + ": " +
+                  e.what());
+        ++failures[i];
+      }
+      factories_[i]->ClearFullCache();
+    }
+  });
+
+  // add them up in the same order every time
+  size_t failed = 0;
+  for (size_t i = 0; i < concurrency; ++i) {
+    for (const auto& edge : thread_speeds[i]) {
+      auto& speed = speeds_[edge.first];
+      speed.length += edge.second.length;
+      speed.seconds += edge.second.seconds;
+      speed.probes += edge.second.probes;
+    }
+    failed += failures[i];
+  }
+  return failed;
+}
+
+void TrafficSpeedMatcher::Accumulate(const MatchResults& match,
+                                     GraphReader& reader,
+                                     std::unordered_map<GraphId, edge_speed_t>& speeds) {
+  // where each segment starts along the path and which continuous part of the path its on
+  const auto& segments = match.segments;
+  std::vector<double> starts(segments.size() + 1, 0);
+  std::vector<double> lengths(segments.size(), 0);
+  std::vector<uint32_t> runs(segments.size(), 0);
+  graph_tile_ptr tile;
+  uint32_t run = 0;
+  for (size_t i = 0; i < segments.size(); ++i) {
+    const auto* edge = reader.directededge(segments[i].edgeid, tile);
+    lengths[i] = edge ? edge->length() : 0;
+    starts[i + 1] = starts[i] + lengths[i] * (segments[i].target - segments[i].source);
+    runs[i] = run;
+    run += segments[i].discontinuity;
+  }
+
+  // place the points that have a time on the path, they are in the same order as the path is
+  std::vector<anchor_t> anchors;
+  size_t next = 0;
+  for (const auto& result : match.results) {
+    if (!result.edgeid.Is_Valid() || result.epoch_time < 0) {
+      continue;
+    }
+    auto s = next;
+    for (; s < segments.size(); ++s) {
+      const auto& segment = segments[s];
+      if (segment.edgeid == result.edgeid &&
+          segment.source - kDistanceAlongFuzz <= result.distance_along &&
+          result.distance_along <= segment.target + kDistanceAlongFuzz) {
+        break;
+      }
+    }
+    if (s == segments.size()) {
+      continue;
+    }
+    next = s;
+    const auto percent =
+        std::min(std::max(result.distance_along, segments[s].source), segments[s].target);
+    const double along = starts[s] + lengths[s] * (percent - segments[s].source);
+    // time and distance have to move forward together or theres no speed to be had
+    if (!anchors.empty() && anchors.back().run == runs[s] &&
+        (along < anchors.back().along || result.epoch_time < anchors.back().time)) {
+      continue;
+    }
+    anchors.push_back({along, result.epoch_time, runs[s]});
+  }
+
+  // the time spent on each segment comes from interpolating the times at both of its ends
+  size_t hint = 0;
+  for (size_t i = 0; i < segments.size(); ++i) {
+    if (starts[i + 1] <= starts[i]) {
+      continue;
+    }
+    const auto begin = time_at(anchors, starts[i], runs[i], hint);
+    const auto end = time_at(anchors, starts[i + 1], runs[i], hint);
+    if (begin < 0 || end <= begin) {
+      continue;
+    }
+    auto& speed = speeds[segments[i].edgeid];
+    speed.length += starts[i + 1] - starts[i];
+    speed.seconds += end - begin;
+    ++speed.probes;
+  }
+}
+
+TrafficSpeed TrafficSpeedMatcher::Encode(const edge_speed_t& speed) {
+  // 2kph resolution for the whole edge, 0 would mean the edge is closed
+  auto encoded = static_cast<uint32_t>(
+      std::round(std::min(speed.kph(), static_cast<float>(MAX_TRAFFIC_SPEED_KPH)) / 2));
+  encoded = std::max(encoded, 1u);
+  return TrafficSpeed(encoded, encoded, UNKNOWN_TRAFFIC_SPEED_RAW, UNKNOWN_TRAFFIC_SPEED_RAW, 255,
+                      255, 0, 0, 0, false);
+}
+
+size_t TrafficSpeedMatcher::Write(const std::string& traffic_extract,
+                                  uint64_t last_update,
+                                  uint32_t min_probes) {
+  // find where each tile is in the tar and then map it again so we can write to it
+  midgard::tar archive(traffic_extract);
+  midgard::mem_map<char> extract;
+  extract.map(traffic_extract, archive.mm.size());
+  std::unordered_map<GraphId, std::pair<char*, size_t>> tiles;
+  for (const auto& entry : archive.contents) {
+    try {
+      auto tile_id = GraphTile::GetTileId(entry.first);
+      char* data = extract.get() + (entry.second.first - archive.mm.get());
+      tiles.emplace(tile_id, std::make_pair(data, entry.second.second));
+    } catch (...) {
+      // its fine to have things in there that arent tiles
+    }
+  }
+
+  size_t updated = 0;
+  for (const auto& edge : speeds_) {
+    if (edge.second.probes < min_probes || edge.second.seconds <= 0) {
+      continue;
+    }
+    auto found = tiles.find(edge.first.Tile_Base());
+    if (found == tiles.cend() || found->second.second < sizeof(TrafficTileHeader)) {
+      continue;
+    }
+
+    // skip anything the tile doesnt have room for or that readers would ignore anyway
+    auto* header = reinterpret_cast<volatile TrafficTileHeader*>(found->second.first);
+    if (header->traffic_tile_version != TRAFFIC_TILE_VERSION ||
+        edge.first.id() >= header->directed_edge_count ||
+        sizeof(TrafficTileHeader) + (edge.first.id() + 1) * sizeof(TrafficSpeed) >
+            found->second.second) {
+      continue;
+    }
+
+    // the whole speed goes in with one store so that readers never see half of it
+    auto* slot = reinterpret_cast<volatile TrafficSpeed*>(found->second.first +
+                                                          sizeof(TrafficTileHeader)) +
+                 edge.first.id();
+    auto speed = Encode(edge.second);
+    speed.has_incidents = slot->has_incidents;
+    uint64_t bits;
+    std::memcpy(&bits, &speed, sizeof(bits));
+    *reinterpret_cast<volatile uint64_t*>(slot) = bits;
+    header->last_update = last_update;
+    ++updated;
+  }
+  return updated;
+}
+
+} // namespace meili
+} // namespace valhalla
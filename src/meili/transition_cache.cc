@@ -0,0 +1,95 @@
+#include "meili/transition_cache.h"
+
+#include <functional>
+#include <type_traits>
+
+namespace {
+
+template <typename T> void append(std::string& key, const T& value) {
+  static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be part of the key");
+  key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void append(std::string& key, const valhalla::baldr::PathLocation& candidate) {
+  append(key, static_cast<int>(candidate.stoptype_));
+  append(key, static_cast<uint32_t>(candidate.edges.size()));
+  for (const auto& edge : candidate.edges) {
+    append(key, edge.id.value);
+    append(key, edge.percent_along);
+  }
+}
+
+} // namespace
+
+namespace valhalla {
+namespace meili {
+
+TransitionCache::TransitionCache(size_t max_paths) : enabled_(max_paths > 0), paths_(max_paths) {
+}
+
+uint64_t TransitionCache::CostingKey(const Options& options, float turn_penalty_factor) {
+  // the costing options are only repeated and scalar fields so their serialization is stable
+  std::string key;
+  append(key, static_cast<int>(options.costing_type()));
+  append(key, turn_penalty_factor);
+  auto found = options.costings().find(options.costing_type());
+  if (found != options.costings().cend())
+    key += found->second.SerializeAsString();
+  return std::hash<std::string>()(key);
+}
+
+std::string TransitionCache::Key(uint64_t costing_key,
+                                 const Label* edgelabel,
+                                 const baldr::PathLocation& origin,
+                                 const baldr::PathLocation& destination) {
+  // the incoming edge decides which turns and uturns are allowed and what they cost
+  std::string key;
+  key.reserve(128);
+  append(key, costing_key);
+  append(key, edgelabel ? edgelabel->edgeid().value : baldr::GraphId().value);
+  append(key, edgelabel ? edgelabel->restriction_idx() : uint8_t(-1));
+  append(key, origin);
+  append(key, destination);
+  return key;
+}
+
+bool TransitionCache::Find(const std::string& key,
+                           float max_dist,
+                           float max_time,
+                           const std::vector<Label>*& path) {
+  // paths are shortest by distance so a different distance limit doesnt change which one wins,
+  // a tighter time limit than the one it was found with can though so we can only answer for the
+  // same or looser ones
+  const auto* found = paths_.find_if(key, [max_dist, max_time](const path_t& entry) {
+    if (entry.max_time >= 0 && (max_time < 0 || max_time > entry.max_time))
+      return false;
+    // nothing within the limits of that search means nothing within tighter ones
+    if (entry.labels.empty())
+      return max_dist <= entry.max_dist;
+    // if the shortest one is too long they all are, if its too slow there might be a quicker one
+    const auto& cost = entry.labels.back().cost();
+    return cost.cost >= max_dist || max_time < 0 || cost.secs < max_time;
+  });
+  if (!found)
+    return false;
+
+  path = nullptr;
+  if (!found->labels.empty() && found->labels.back().cost().cost < max_dist)
+    path = &found->labels;
+  return true;
+}
+
+void TransitionCache::Insert(std::string key,
+                             std::vector<Label> path,
+                             float max_dist,
+                             float max_time) {
+  if (enabled_)
+    paths_.insert(key, path_t{std::move(path), max_dist, max_time});
+}
+
+void TransitionCache::Clear() {
+  paths_.clear();
+}
+
+} // namespace meili
+} // namespace valhalla
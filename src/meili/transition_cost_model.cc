@@ -1,7 +1,14 @@
+#include <algorithm>
+#include <limits>
+
 #include "meili/transition_cost_model.h"
 #include "meili/routing.h"
 
 namespace {
+
+// not worth starting a thread for fewer routes than this
+constexpr size_t kMinRoutesPerThread = 4;
+
 inline float GreatCircleDistance(const valhalla::meili::Measurement& left,
                                  const valhalla::meili::Measurement& right) {
   return left.lnglat().Distance(right.lnglat());
@@ -21,12 +28,25 @@ TransitionCostModel::TransitionCostModel(baldr::GraphReader& graphreader,
                                          float breakage_distance,
                                          float max_route_distance_factor,
                                          float max_route_time_factor,
-                                         float turn_penalty_factor)
+                                         float turn_penalty_factor,
+                                         bool multi_source_routing,
+                                         const labelset_storage_ptr_t& labelset_storage,
+                                         const transition_cache_ptr_t& transition_cache,
+                                         uint64_t costing_key,
+                                         const std::vector<std::shared_ptr<baldr::GraphReader>>&
+                                             thread_readers,
+                                         midgard::ThreadPool* thread_pool)
     : graphreader_(graphreader), vs_(vs), ts_(ts), container_(container), mode_costing_(mode_costing),
       travelmode_(travelmode), beta_(beta), inv_beta_(1.f / beta_),
       breakage_distance_(breakage_distance), max_route_distance_factor_(max_route_distance_factor),
       max_route_time_factor_(max_route_time_factor),
-      turn_penalty_factor_(turn_penalty_factor), turn_cost_table_{0.f} {
+      turn_penalty_factor_(turn_penalty_factor), turn_cost_table_{0.f},
+      multi_source_routing_(multi_source_routing),
+      labelset_storage_(labelset_storage ? labelset_storage
+                                         : std::make_shared<LabelSetStorage>()),
+      transition_cache_(multi_source_routing ? nullptr : transition_cache),
+      costing_key_(costing_key),
+      thread_readers_(thread_readers), thread_pool_(thread_pool) {
   if (beta_ <= 0.f) {
     throw std::invalid_argument("Expect beta to be positive");
   }
@@ -48,7 +68,13 @@ TransitionCostModel::TransitionCostModel(baldr::GraphReader& graphreader,
                                          const StateContainer& container,
                                          const sif::mode_costing_t& mode_costing,
                                          const sif::TravelMode travelmode,
-                                         const Config::TransitionCost& config)
+                                         const Config::TransitionCost& config,
+                                         const labelset_storage_ptr_t& labelset_storage,
+                                         const transition_cache_ptr_t& transition_cache,
+                                         uint64_t costing_key,
+                                         const std::vector<std::shared_ptr<baldr::GraphReader>>&
+                                             thread_readers,
+                                         midgard::ThreadPool* thread_pool)
     : TransitionCostModel(graphreader,
                           vs,
                           ts,
@@ -59,43 +85,87 @@ TransitionCostModel::TransitionCostModel(baldr::GraphReader& graphreader,
                           config.breakage_distance_meters,
                           config.max_route_distance_factor,
                           config.max_route_time_factor,
-                          config.turn_penalty_factor) {
+                          config.turn_penalty_factor,
+                          config.multi_source_routing,
+                          labelset_storage,
+                          transition_cache,
+                          costing_key,
+                          thread_readers,
+                          thread_pool) {
 }
 
 float TransitionCostModel::operator()(const StateId& lhs, const StateId& rhs) const {
   const auto& left = container_.state(lhs);
   const auto& right = container_.state(rhs);
 
-  if (!left.routed()) {
+  // a route computed along with another state's route has to be redone if it guessed wrong about
+  // which way the search would come in
+  if (!left.routed() || (left.tentative() && left.Settle(RoutedPredecessor(lhs)))) {
     UpdateRoute(lhs, rhs);
   }
 
   // Compute the transition cost if we found a path
   const auto label = left.last_label(right);
   if (label) {
-    // Get some basic info about difference between the two measurements
-    const auto& left_measurement = container_.measurement(lhs.time());
-    const auto& right_measurement = container_.measurement(rhs.time());
-    return CalculateTransitionCost(label->turn_cost(), label->cost().cost,
-                                   GreatCircleDistance(left_measurement, right_measurement),
-                                   label->cost().secs, ClockDistance(lhs.time(), rhs.time()));
+    return LabelCost(lhs, rhs, *label);
   }
 
   // No path found
   return -1.f;
 }
 
-void TransitionCostModel::UpdateRoute(const StateId& lhs, const StateId& rhs) const {
-  const auto& left = container_.state(lhs);
-  const auto& right = container_.state(rhs);
+float TransitionCostModel::LabelCost(const StateId& lhs,
+                                     const StateId& rhs,
+                                     const Label& label) const {
+  // Get some basic info about difference between the two measurements
+  const auto& left_measurement = container_.measurement(lhs.time());
+  const auto& right_measurement = container_.measurement(rhs.time());
+  return CalculateTransitionCost(label.turn_cost(), label.cost().cost,
+                                 GreatCircleDistance(left_measurement, right_measurement),
+                                 label.cost().secs, ClockDistance(lhs.time(), rhs.time()));
+}
 
-  // Prepare edgelabel
+StateId TransitionCostModel::RoutedPredecessor(const StateId& stateid) const {
+  const auto& prev_stateid = vs_.Predecessor(stateid);
+  if (!prev_stateid.IsValid()) {
+    return {};
+  }
+  const auto& original_prev_stateid = ts_.GetOrigin(prev_stateid);
+  return original_prev_stateid.IsValid() ? original_prev_stateid : prev_stateid;
+}
+
+StateId TransitionCostModel::TentativePredecessor(const State& state) const {
+  const auto time = state.stateid().time();
+  if (time == 0) {
+    return {};
+  }
+
+  // the search would pick whichever settled state gets here cheapest if it were to settle this one
+  // now, the states it has yet to settle are more expensive so they are less likely to win
+  StateId best;
+  double best_cost = std::numeric_limits<double>::infinity();
+  for (const auto& prev : container_.column(time - 1)) {
+    const auto costsofar = vs_.AccumulatedCost(prev.stateid());
+    if (costsofar < 0 || !prev.routed() || prev.tentative()) {
+      continue;
+    }
+    const auto label = prev.last_label(state);
+    if (!label) {
+      continue;
+    }
+    const auto cost = costsofar + LabelCost(prev.stateid(), state.stateid(), *label);
+    if (cost < best_cost) {
+      best_cost = cost;
+      best = prev.stateid();
+    }
+  }
+  return best;
+}
+
+const Label* TransitionCostModel::EdgeLabel(const State& state, const StateId& prev_stateid) const {
   const Label* edgelabel = nullptr;
-  const auto& prev_stateid = vs_.Predecessor(left.stateid());
   if (prev_stateid.IsValid()) {
-    const auto& original_prev_stateid = ts_.GetOrigin(prev_stateid);
-    const auto& prev_state =
-        container_.state(original_prev_stateid.IsValid() ? original_prev_stateid : prev_stateid);
+    const auto& prev_state = container_.state(prev_stateid);
     if (!prev_state.routed()) {
       // When ViterbiSearch calls this method, the left state is
       // guaranteed to be optimal, its predecessor is therefore
@@ -106,11 +176,19 @@ void TransitionCostModel::UpdateRoute(const StateId& lhs, const StateId& rhs) co
       throw std::logic_error("The predecessor of current state must have been routed."
                              " Check if you have misused the TransitionCost method");
     }
-    edgelabel = prev_state.last_label(left);
+    edgelabel = prev_state.last_label(state);
   }
+  return edgelabel;
+}
+
+TransitionCostModel::route_request_t
+TransitionCostModel::RouteRequest(const State& left, const StateId::Time& rhs_time) const {
+  // Prepare edgelabel
+  const Label* edgelabel = EdgeLabel(left, RoutedPredecessor(left.stateid()));
 
   // Prepare locations and stateids
-  const auto& right_column = container_.column(right.stateid().time());
+  const auto lhs_time = left.stateid().time();
+  const auto& right_column = container_.column(rhs_time);
   std::vector<baldr::PathLocation> locations;
   locations.reserve(1 + right_column.size());
   locations.push_back(left.candidate());
@@ -131,10 +209,8 @@ void TransitionCostModel::UpdateRoute(const StateId& lhs, const StateId& rhs) co
     //}
   }
 
-  const auto& left_measurement = container_.measurement(lhs.time());
-  const auto& right_measurement = container_.measurement(rhs.time());
-
-  const midgard::DistanceApproximator<midgard::PointLL> approximator(right_measurement.lnglat());
+  const auto& left_measurement = container_.measurement(lhs_time);
+  const auto& right_measurement = container_.measurement(rhs_time);
 
   auto max_route_distance =
       std::min(GreatCircleDistance(left_measurement, right_measurement) * max_route_distance_factor_,
@@ -144,18 +220,213 @@ void TransitionCostModel::UpdateRoute(const StateId& lhs, const StateId& rhs) co
   // labelset
   max_route_distance = std::ceil(std::max(max_route_distance, 1.f));
 
-  auto max_route_time = ClockDistance(lhs.time(), rhs.time()) * max_route_time_factor_;
+  auto max_route_time = ClockDistance(lhs_time, rhs_time) * max_route_time_factor_;
   if (0 <= max_route_time) {
     max_route_time = std::ceil(max_route_time);
   }
 
-  labelset_ptr_t labelset = std::make_shared<LabelSet>(max_route_distance);
-  const auto& results = find_shortest_path(graphreader_, locations, 0, labelset, approximator,
-                                           right_measurement.search_radius(),
-                                           mode_costing_[static_cast<size_t>(travelmode_)], edgelabel,
-                                           turn_cost_table_, max_route_distance, max_route_time);
+  route_request_t request{&left,
+                          edgelabel,
+                          {},
+                          std::move(unreached_stateids),
+                          midgard::DistanceApproximator<midgard::PointLL>(right_measurement.lnglat()),
+                          right_measurement.search_radius(),
+                          max_route_distance,
+                          max_route_time};
+
+  // look up the paths we already know about and only search for the rest, the origin stays at 0
+  request.locations.reserve(locations.size());
+  request.locations.push_back(locations.front());
+  request.searched.reserve(request.stateids.size());
+  if (transition_cache_) {
+    request.keys.reserve(request.stateids.size());
+    request.cached.resize(request.stateids.size(), nullptr);
+  }
+  for (size_t i = 0; i < request.stateids.size(); ++i) {
+    auto& destination = locations[i + 1];
+    if (transition_cache_) {
+      request.keys.push_back(
+          TransitionCache::Key(costing_key_, edgelabel, locations.front(), destination));
+      if (transition_cache_->Find(request.keys.back(), max_route_distance, max_route_time,
+                                  request.cached[i])) {
+        continue;
+      }
+    }
+    request.locations.push_back(std::move(destination));
+    request.searched.push_back(i);
+  }
+  return request;
+}
+
+TransitionCostModel::route_t TransitionCostModel::Route(baldr::GraphReader& reader,
+                                                        const labelset_storage_ptr_t& storage,
+                                                        const route_request_t& request) const {
+  route_t route{std::make_shared<LabelSet>(request.max_route_distance, 1.0f, storage), {}};
+  if (!request.searched.empty()) {
+    route.found =
+        find_shortest_path(reader, request.locations, 0, route.labelset, request.approximator,
+                           request.search_radius, mode_costing_[static_cast<size_t>(travelmode_)],
+                           request.edgelabel, turn_cost_table_, request.max_route_distance,
+                           request.max_route_time);
+  }
+  return route;
+}
+
+void TransitionCostModel::SetRoutes(const std::vector<route_request_t>& requests,
+                                    std::vector<route_t>& routes) const {
+  // copy in all of the cached paths before inserting anything so that none of them gets evicted
+  std::vector<std::unordered_map<uint16_t, uint32_t>> results(requests.size());
+  for (size_t i = 0; i < requests.size(); ++i) {
+    const auto& cached = requests[i].cached;
+    for (size_t j = 0; j < cached.size(); ++j) {
+      if (cached[j]) {
+        results[i].emplace(j + 1, routes[i].labelset->put(*cached[j]));
+      }
+    }
+  }
+
+  for (size_t i = 0; i < requests.size(); ++i) {
+    const auto& request = requests[i];
+    const auto& labelset = routes[i].labelset;
+    const auto& found = routes[i].found;
+    for (size_t j = 0; j < request.searched.size(); ++j) {
+      const auto it = found.find(j + 1);
+      if (it != found.end()) {
+        results[i].emplace(request.searched[j] + 1, it->second);
+      }
+      // remember what the search found, or that it found nothing, for next time
+      if (transition_cache_) {
+        std::vector<Label> path;
+        if (it != found.end()) {
+          for (RoutePathIterator label(labelset.get(), it->second), end(labelset.get());
+               label != end; ++label) {
+            path.push_back(*label);
+          }
+          std::reverse(path.begin(), path.end());
+        }
+        transition_cache_->Insert(request.keys[request.searched[j]], std::move(path),
+                                  request.max_route_distance, request.max_route_time);
+      }
+    }
+    request.left->SetRoute(request.stateids, results[i], labelset);
+  }
+}
+
+void TransitionCostModel::UpdateRoute(const StateId& lhs, const StateId& rhs) const {
+  if (multi_source_routing_) {
+    UpdateRoutes(lhs, rhs);
+    return;
+  }
+  std::vector<route_request_t> requests{RouteRequest(container_.state(lhs), rhs.time())};
+  std::vector<route_t> routes{Route(graphreader_, labelset_storage_, requests.front())};
+  SetRoutes(requests, routes);
+}
+
+void TransitionCostModel::UpdateRoutes(const StateId& lhs, const StateId& rhs) const {
+  const auto& left = container_.state(lhs);
+  const auto request = RouteRequest(left, rhs.time());
+
+  // The rest of the left column will most likely be expanded too so we route from all of it at
+  // once. They go in front of the right column so we have to shift the destination indices to
+  // look like they came from a search with the origin at 0. None of these have been settled yet so
+  // we have to guess their predecessors, the ones we get wrong are routed again later
+  std::vector<const State*> lefts{&left};
+  std::vector<StateId> predecessors{{}};
+  std::vector<const Label*> edgelabels{request.edgelabel};
+  for (const auto& state : container_.column(left.stateid().time())) {
+    if (!state.routed() && state.stateid() != left.stateid()) {
+      lefts.push_back(&state);
+      predecessors.push_back(TentativePredecessor(state));
+      edgelabels.push_back(EdgeLabel(state, predecessors.back()));
+    }
+  }
+  std::vector<baldr::PathLocation> all_locations;
+  all_locations.reserve(lefts.size() + request.stateids.size());
+  std::vector<uint16_t> origin_idxs;
+  for (const auto* state : lefts) {
+    origin_idxs.push_back(all_locations.size());
+    all_locations.push_back(state->candidate());
+  }
+  all_locations.insert(all_locations.end(), request.locations.begin() + 1, request.locations.end());
+
+  labelset_ptr_t labelset =
+      std::make_shared<LabelSet>(request.max_route_distance, 1.0f, labelset_storage_);
+  const auto& all_results =
+      find_shortest_paths(graphreader_, all_locations, origin_idxs, labelset, request.approximator,
+                          request.search_radius, mode_costing_[static_cast<size_t>(travelmode_)],
+                          edgelabels, turn_cost_table_, request.max_route_distance,
+                          request.max_route_time);
+  const uint16_t shift = lefts.size() - 1;
+  for (size_t i = 0; i < lefts.size(); ++i) {
+    std::unordered_map<uint16_t, uint32_t> results;
+    for (const auto& result : all_results[i]) {
+      if (result.first >= lefts.size()) {
+        results.emplace(result.first - shift, result.second);
+      }
+    }
+    if (i == 0) {
+      lefts[i]->SetRoute(request.stateids, results, labelset);
+    } else {
+      lefts[i]->SetTentativeRoute(request.stateids, results, labelset, predecessors[i]);
+    }
+  }
+}
+
+void TransitionCostModel::RouteAll(const std::vector<StateId>& stateids) const {
+  // the ones that would be routed if their transition cost were asked for right now. settling a
+  // tentative route is a one time thing, so with multi source routing this is asked once per state
+  const auto needs_route = [this](const StateId& stateid) {
+    const auto& state = container_.state(stateid);
+    return !state.routed() || (state.tentative() && state.Settle(RoutedPredecessor(stateid)));
+  };
+  const auto route_in_order = [&]() {
+    for (const auto& stateid : stateids) {
+      if (needs_route(stateid)) {
+        UpdateRoute(stateid, StateId(stateid.time() + 1, 0));
+      }
+    }
+  };
+
+  // routing from a whole column at once already does the rest of the column along with the first
+  // state, so there is nothing left to spread over threads
+  if (multi_source_routing_) {
+    route_in_order();
+    return;
+  }
+
+  // not enough work to bother with more threads so we just do them one after the other
+  const size_t unrouted = std::count_if(stateids.begin(), stateids.end(), needs_route);
+  size_t concurrency =
+      std::min(thread_pool_ ? thread_pool_->concurrency() : size_t(1), thread_readers_.size());
+  concurrency = std::min(concurrency, unrouted / kMinRoutesPerThread);
+  if (concurrency < 2) {
+    route_in_order();
+    return;
+  }
+
+  // the transition cache isnt thread safe so its looked up here, and filled in below
+  std::vector<route_request_t> requests;
+  requests.reserve(unrouted);
+  for (const auto& stateid : stateids) {
+    if (needs_route(stateid)) {
+      requests.push_back(RouteRequest(container_.state(stateid), stateid.time() + 1));
+    }
+  }
+
+  // each task routes every nth request with its own reader and queue. a path doesnt depend on who
+  // found it so the states end up the same as routing them one at a time
+  while (thread_storage_.size() < concurrency) {
+    thread_storage_.push_back(std::make_shared<LabelSetStorage>());
+  }
+  std::vector<route_t> routes(requests.size());
+  thread_pool_->Run(concurrency, [&](size_t task) {
+    for (size_t i = task; i < requests.size(); i += concurrency) {
+      routes[i] = Route(*thread_readers_[task], thread_storage_[task], requests[i]);
+    }
+  });
 
-  left.SetRoute(unreached_stateids, results, labelset);
+  // hand the routes to their states
+  SetRoutes(requests, routes);
 }
 
 } // namespace meili
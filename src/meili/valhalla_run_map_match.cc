@@ -1,8 +1,18 @@
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
 #include "baldr/rapidjson_utils.h"
 #include <boost/property_tree/ptree.hpp>
 
 #include "meili/map_matcher_factory.h"
 #include "meili/measurement.h"
+#include "midgard/logging.h"
+#include "tyr/actor.h"
 
 using namespace valhalla::midgard;
 using namespace valhalla::meili;
@@ -35,14 +45,74 @@ ReadMeasurements(istream_t& istream, float default_gps_accuracy, float default_s
   return measurements;
 }
 
+// Matches newline delimited json trace_route or trace_attributes requests from stdin in parallel
+// and writes one line of json per request to stdout as soon as its done
+int RunBatch(const boost::property_tree::ptree& config,
+             const std::string& action_name,
+             unsigned int concurrency) {
+  valhalla::Options::Action action;
+  if (!valhalla::Options_Action_Enum_Parse(action_name, &action) ||
+      (action != valhalla::Options::trace_route && action != valhalla::Options::trace_attributes)) {
+    std::cerr << "The batch action must be trace_route or trace_attributes" << std::endl;
+    return 1;
+  }
+
+  size_t count = 0;
+  auto start = std::chrono::steady_clock::now();
+  valhalla::tyr::actor_t actor(config);
+  auto failed = actor.trace_batch(
+      std::cin, action,
+      [&count](size_t line, bool success, const std::string& response) {
+        std::cout << R"({"line":)" << line << R"(,"success":)" << (success ? "true" : "false")
+                  << R"(,"response":)" << response << "}\n";
+        ++count;
+      },
+      concurrency);
+  std::cout.flush();
+
+  auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  LOG_INFO("Matched " + std::to_string(count) + " traces (" + std::to_string(failed) +
+           " failed) in " + std::to_string(seconds) + " seconds, " +
+           std::to_string(count / std::max(seconds, 1e-3)) + " traces per second");
+  return 0;
+}
+
+int Usage() {
+  std::cout << "usage: valhalla_run_map_match CONFIG [trace_route|trace_attributes [CONCURRENCY]]"
+            << std::endl
+            << "  with just a config, stdin has one lng lat per line and blank lines between "
+               "traces"
+            << std::endl
+            << "  with an action, stdin has one json request per line which are matched in "
+               "parallel"
+            << std::endl;
+  return 1;
+}
+
 int main(int argc, char* argv[]) {
   if (argc < 2) {
-    std::cout << "usage: map_matching CONFIG" << std::endl;
-    return 1;
+    return Usage();
+  }
+
+  // the concurrency has to be a plain number of threads
+  unsigned long concurrency = 0;
+  if (argc > 3) {
+    char* end = nullptr;
+    errno = 0;
+    concurrency = std::strtoul(argv[3], &end, 10);
+    if (!std::isdigit(static_cast<unsigned char>(argv[3][0])) || *end != '\0' || errno == ERANGE ||
+        concurrency > std::numeric_limits<unsigned int>::max()) {
+      return Usage();
+    }
   }
 
   boost::property_tree::ptree config;
   rapidjson::read_json(argv[1], config);
+
+  // a batch of requests rather than plain coordinates
+  if (argc > 2) {
+    return RunBatch(config, argv[2], concurrency);
+  }
   const std::string modename = config.get<std::string>("meili.mode");
   valhalla::Costing::Type costing;
   if (!valhalla::Costing_Enum_Parse(modename, &costing)) {
@@ -444,6 +444,66 @@ double ViterbiSearch::AccumulatedCost(const StateId& stateid) const {
   }
 }
 
+StateId ViterbiSearch::ConvergedState() const {
+  if (winner_by_time.empty()) {
+    return {};
+  }
+
+  // a path steps back to its predecessor or, across a break, to the winner of the previous time
+  // which is exactly what StateIdIterator does when breaks are allowed
+  const auto step = [this](StateId::Time time, const StateId& stateid) {
+    auto predecessor = stateid.IsValid() ? Predecessor(stateid) : StateId();
+    if (!predecessor.IsValid() && time > 0 && time - 1 < winner_by_time.size()) {
+      predecessor = winner_by_time[time - 1];
+    }
+    return predecessor;
+  };
+
+  // anything the search scans from now on is either a descendant of the last winner or of one of
+  // the labels in the queue, so all future paths go through these or their predecessors
+  std::vector<std::pair<StateId::Time, StateId>> heads;
+  heads.emplace_back(winner_by_time.size() - 1, winner_by_time.back());
+  for (const auto& label : queue_) {
+    const auto time = label.stateid().time();
+    if (time < earliest_time_ || time == 0) {
+      continue;
+    }
+    auto predecessor = label.predecessor();
+    if (!predecessor.IsValid() && time - 1 < winner_by_time.size()) {
+      predecessor = winner_by_time[time - 1];
+    }
+    heads.emplace_back(time - 1, predecessor);
+  }
+
+  // walk them all back to the same time
+  StateId::Time time = heads.front().first;
+  for (const auto& head : heads) {
+    time = std::min(time, head.first);
+  }
+  std::unordered_set<StateId> states;
+  for (auto& head : heads) {
+    while (head.first > time) {
+      head.second = step(head.first, head.second);
+      --head.first;
+    }
+    states.insert(head.second);
+  }
+
+  // and then keep going until they meet at a real state
+  while (states.size() > 1 || !states.begin()->IsValid()) {
+    if (time == 0) {
+      return {};
+    }
+    std::unordered_set<StateId> predecessors;
+    for (const auto& stateid : states) {
+      predecessors.insert(step(time, stateid));
+    }
+    states.swap(predecessors);
+    --time;
+  }
+  return *states.begin();
+}
+
 void ViterbiSearch::Clear() {
   IViterbiSearch::Clear();
   states_by_time.clear();
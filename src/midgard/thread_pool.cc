@@ -0,0 +1,104 @@
+#include "midgard/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace valhalla {
+namespace midgard {
+
+ThreadPool::ThreadPool(size_t threads) : stopping_(false) {
+  threads_.reserve(threads);
+  for (size_t i = 0; i < threads; ++i) {
+    threads_.emplace_back(&ThreadPool::Work, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  ready_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void ThreadPool::Work() {
+  while (true) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ready_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      job = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    job();
+  }
+}
+
+void ThreadPool::Run(size_t count, const std::function<void(size_t)>& task) {
+  if (count == 0) {
+    return;
+  }
+
+  // the helpers can outlive this call if they only get to run after all the tasks are taken, so
+  // what they share lives on the heap and they only touch the task once they have claimed one
+  struct batch_t {
+    std::atomic<size_t> next{0};
+    size_t done = 0;
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::vector<std::exception_ptr> errors;
+  };
+  auto batch = std::make_shared<batch_t>();
+  batch->errors.resize(count);
+  const auto* work = &task;
+  auto help = [batch, count, work]() {
+    size_t ran = 0;
+    for (size_t i = batch->next++; i < count; i = batch->next++, ++ran) {
+      try {
+        (*work)(i);
+      } catch (...) { batch->errors[i] = std::current_exception(); }
+    }
+    if (ran > 0) {
+      std::lock_guard<std::mutex> lock(batch->mutex);
+      batch->done += ran;
+      if (batch->done == count) {
+        batch->finished.notify_all();
+      }
+    }
+  };
+
+  // one helper per thread that could have something to do, we are the last one
+  const size_t helpers = std::min(count, concurrency()) - 1;
+  if (helpers > 0) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (size_t i = 0; i < helpers; ++i) {
+        queue_.emplace_back(help);
+      }
+    }
+    ready_.notify_all();
+  }
+  help();
+
+  // wait for the tasks the others claimed and rethrow the first thing that went wrong
+  {
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->finished.wait(lock, [&batch, count]() { return batch->done == count; });
+  }
+  for (const auto& error : batch->errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+} // namespace midgard
+} // namespace valhalla
@@ -0,0 +1,241 @@
+#include "mjolnir/segmentindexbuilder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <unordered_set>
+
+#include "baldr/graphreader.h"
+#include "baldr/graphtile.h"
+#include "baldr/tilehierarchy.h"
+#include "midgard/logging.h"
+
+using namespace valhalla::baldr;
+using namespace valhalla::midgard;
+
+namespace {
+
+// position along a hilbert curve of order 16 for the given cell, see:
+// https://github.com/rawrunprotected/hilbert_curves (public domain)
+uint32_t hilbert(uint32_t x, uint32_t y) {
+  uint32_t a = x ^ y;
+  uint32_t b = 0xFFFF ^ a;
+  uint32_t c = 0xFFFF ^ (x | y);
+  uint32_t d = x & (y ^ 0xFFFF);
+
+  uint32_t A = a | (b >> 1);
+  uint32_t B = (a >> 1) ^ a;
+  uint32_t C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+  uint32_t D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+
+  a = A;
+  b = B;
+  c = C;
+  d = D;
+  A = ((a & (a >> 2)) ^ (b & (b >> 2)));
+  B = ((a & (b >> 2)) ^ (b & ((a ^ b) >> 2)));
+  C ^= ((a & (c >> 2)) ^ (b & (d >> 2)));
+  D ^= ((b & (c >> 2)) ^ ((a ^ b) & (d >> 2)));
+
+  a = A;
+  b = B;
+  c = C;
+  d = D;
+  A = ((a & (a >> 4)) ^ (b & (b >> 4)));
+  B = ((a & (b >> 4)) ^ (b & ((a ^ b) >> 4)));
+  C ^= ((a & (c >> 4)) ^ (b & (d >> 4)));
+  D ^= ((b & (c >> 4)) ^ ((a ^ b) & (d >> 4)));
+
+  a = A;
+  b = B;
+  c = C;
+  d = D;
+  C ^= ((a & (c >> 8)) ^ (b & (d >> 8)));
+  D ^= ((b & (c >> 8)) ^ ((a ^ b) & (d >> 8)));
+
+  a = C ^ (C >> 1);
+  b = D ^ (D >> 1);
+
+  uint32_t i0 = x ^ y;
+  uint32_t i1 = b | (0xFFFF ^ (i0 | a));
+
+  i0 = (i0 | (i0 << 8)) & 0x00FF00FF;
+  i0 = (i0 | (i0 << 4)) & 0x0F0F0F0F;
+  i0 = (i0 | (i0 << 2)) & 0x33333333;
+  i0 = (i0 | (i0 << 1)) & 0x55555555;
+
+  i1 = (i1 | (i1 << 8)) & 0x00FF00FF;
+  i1 = (i1 | (i1 << 4)) & 0x0F0F0F0F;
+  i1 = (i1 | (i1 << 2)) & 0x33333333;
+  i1 = (i1 | (i1 << 1)) & 0x55555555;
+
+  return (i1 << 1) | i0;
+}
+
+int32_t to_fixed(double coord) {
+  return static_cast<int32_t>(std::round(coord * kSegmentIndexPrecision));
+}
+
+SegmentBox segment_box(const IndexedSegment& s) {
+  return {std::min(s.lon0, s.lon1), std::min(s.lat0, s.lat1), std::max(s.lon0, s.lon1),
+          std::max(s.lat0, s.lat1)};
+}
+
+void expand(SegmentBox& box, const SegmentBox& other) {
+  box.minx = std::min(box.minx, other.minx);
+  box.miny = std::min(box.miny, other.miny);
+  box.maxx = std::max(box.maxx, other.maxx);
+  box.maxy = std::max(box.maxy, other.maxy);
+}
+
+} // namespace
+
+namespace valhalla {
+namespace mjolnir {
+
+size_t SegmentIndexBuilder::Build(const boost::property_tree::ptree& pt,
+                                  const std::string& file_name) {
+  GraphReader reader(pt);
+  std::vector<IndexedSegment> segments;
+  // loki checks this against the tiles it loads to make sure the index is for them
+  const auto dataset_id = reader.GetDatasetId();
+
+  // the same edges the bins would hold, ie all the road levels but not transit
+  for (const auto& level : TileHierarchy::levels()) {
+    for (const auto& tile_id : reader.GetTileSet(level.level)) {
+      if (reader.OverCommitted()) {
+        reader.Trim();
+      }
+      auto tile = reader.GetGraphTile(tile_id);
+      if (!tile) {
+        continue;
+      }
+
+      std::unordered_set<uint32_t> infos(tile->header()->directededgecount() / 2);
+      const auto* start_edge = tile->directededge(0);
+      for (uint32_t i = 0; i < tile->header()->directededgecount(); ++i) {
+        const auto* edge = start_edge + i;
+        // loki never wants these
+        if (edge->is_shortcut() || edge->use() == Use::kTransitConnection ||
+            edge->use() == Use::kPlatformConnection || edge->use() == Use::kEgressConnection) {
+          continue;
+        }
+        // each shape only once, both directions share it within a tile and if the opposing edge
+        // lives in another tile then the one in the lower tile id gets to keep it
+        if (!infos.insert(edge->edgeinfo_offset()).second ||
+            (edge->endnode().Tile_Base() != tile_id && edge->endnode().Tile_Base() < tile_id)) {
+          continue;
+        }
+
+        auto info = tile->edgeinfo(edge);
+        const auto& shape = info.shape();
+        IndexedSegment segment{};
+        segment.edge_id = GraphId(tile_id.tileid(), tile_id.level(), i);
+        segment.access = edge->forwardaccess() | edge->reverseaccess();
+        segment.road_class = static_cast<uint8_t>(edge->classification());
+        for (size_t j = 1; j < shape.size(); ++j) {
+          segment.lon0 = to_fixed(shape[j - 1].lng());
+          segment.lat0 = to_fixed(shape[j - 1].lat());
+          segment.lon1 = to_fixed(shape[j].lng());
+          segment.lat1 = to_fixed(shape[j].lat());
+          segment.shape_index = j - 1;
+          segments.push_back(segment);
+        }
+      }
+    }
+  }
+
+  LOG_INFO("Indexing " + std::to_string(segments.size()) + " segments");
+  Write(file_name, segments, dataset_id);
+  return segments.size();
+}
+
+void SegmentIndexBuilder::Write(const std::string& file_name,
+                                std::vector<IndexedSegment>& segments,
+                                uint64_t dataset_id,
+                                uint32_t node_size) {
+  if (node_size < 2)
+    throw std::invalid_argument("Segment index node size must be at least 2");
+
+  // extent of all of the segment midpoints
+  int64_t minx = std::numeric_limits<int32_t>::max(), miny = minx;
+  int64_t maxx = std::numeric_limits<int32_t>::min(), maxy = maxx;
+  for (const auto& s : segments) {
+    int64_t x = (int64_t(s.lon0) + s.lon1) / 2, y = (int64_t(s.lat0) + s.lat1) / 2;
+    minx = std::min(minx, x);
+    miny = std::min(miny, y);
+    maxx = std::max(maxx, x);
+    maxy = std::max(maxy, y);
+  }
+
+  // sort along the hilbert curve with ties broken by edge and position so the output is stable
+  double width = std::max<int64_t>(maxx - minx, 1), height = std::max<int64_t>(maxy - miny, 1);
+  std::vector<std::pair<uint32_t, uint32_t>> order(segments.size());
+  for (uint32_t i = 0; i < segments.size(); ++i) {
+    const auto& s = segments[i];
+    double x = (int64_t(s.lon0) + s.lon1) / 2 - minx, y = (int64_t(s.lat0) + s.lat1) / 2 - miny;
+    order[i] = {hilbert(static_cast<uint32_t>(0xFFFF * x / width),
+                        static_cast<uint32_t>(0xFFFF * y / height)),
+                i};
+  }
+  std::sort(order.begin(), order.end(), [&segments](const std::pair<uint32_t, uint32_t>& a,
+                                                    const std::pair<uint32_t, uint32_t>& b) {
+    if (a.first != b.first)
+      return a.first < b.first;
+    const auto& sa = segments[a.second];
+    const auto& sb = segments[b.second];
+    return sa.edge_id == sb.edge_id ? sa.shape_index < sb.shape_index : sa.edge_id < sb.edge_id;
+  });
+  std::vector<IndexedSegment> sorted;
+  sorted.reserve(segments.size());
+  for (const auto& o : order) {
+    sorted.push_back(segments[o.second]);
+  }
+  segments.swap(sorted);
+
+  // pack the levels of the tree bottom up, level 0 are the boxes of the segments
+  SegmentIndexHeader header{};
+  std::memcpy(header.magic, kSegmentIndexMagic, sizeof(kSegmentIndexMagic));
+  header.version = kSegmentIndexVersion;
+  header.node_size = node_size;
+  header.segment_count = segments.size();
+  header.dataset_id = dataset_id;
+  std::vector<SegmentBox> boxes;
+  size_t child_count = segments.size();
+  do {
+    if (header.level_count == kSegmentIndexMaxLevels)
+      throw std::runtime_error("Too many segments to index with node size " +
+                               std::to_string(node_size));
+    const size_t child_offset = header.level_count ? header.level_offsets[header.level_count - 1] : 0;
+    const size_t count = std::max<size_t>((child_count + node_size - 1) / node_size, 1);
+    header.level_offsets[header.level_count] = boxes.size();
+    header.level_sizes[header.level_count] = count;
+    for (size_t i = 0; i < count; ++i) {
+      SegmentBox box{std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max(),
+                     std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::min()};
+      for (size_t j = i * node_size; j < std::min(child_count, (i + 1) * node_size); ++j) {
+        expand(box, header.level_count ? boxes[child_offset + j] : segment_box(segments[j]));
+      }
+      boxes.push_back(box);
+    }
+    ++header.level_count;
+    child_count = count;
+  } while (child_count > 1);
+
+  // write it all out
+  std::ofstream file(file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file.is_open())
+    throw std::runtime_error("Could not open " + file_name + " for writing");
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(segments.data()),
+             segments.size() * sizeof(IndexedSegment));
+  file.write(reinterpret_cast<const char*>(boxes.data()), boxes.size() * sizeof(SegmentBox));
+  if (!file)
+    throw std::runtime_error("Failed to write " + file_name);
+}
+
+} // namespace mjolnir
+} // namespace valhalla
@@ -0,0 +1,97 @@
+#include <cstdint>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <unordered_map>
+
+#include "config.h"
+
+#include "baldr/rapidjson_utils.h"
+#include <boost/property_tree/ptree.hpp>
+#include <cxxopts.hpp>
+#include <ostream>
+
+#include "filesystem.h"
+#include "midgard/logging.h"
+#include "midgard/util.h"
+#include "mjolnir/segmentindexbuilder.h"
+
+using namespace valhalla::mjolnir;
+
+filesystem::path config_file_path;
+std::string output_file;
+
+bool ParseArguments(int argc, char* argv[]) {
+  try {
+    // clang-format off
+    cxxopts::Options options(
+      "valhalla_build_segment_index",
+      "valhalla_build_segment_index " VALHALLA_VERSION "\n\n"
+      "valhalla_build_segment_index is a program that creates a packed rtree of all of the edge\n"
+      "segments in a tileset. When mjolnir.segment_index points at it, loki uses it to find\n"
+      "candidate edges instead of walking the tile bins.\n\n");
+
+    options.add_options()
+      ("h,help", "Print this help message.")
+      ("v,version", "Print the version of this software.")
+      ("c,config", "Path to the json configuration file.", cxxopts::value<std::string>())
+      ("o,output", "Where to write the index, defaults to mjolnir.segment_index from the config.",
+        cxxopts::value<std::string>(output_file));
+    // clang-format on
+
+    auto result = options.parse(argc, argv);
+
+    if (result.count("help")) {
+      std::cout << options.help() << "\n";
+      exit(0);
+    }
+
+    if (result.count("version")) {
+      std::cout << "valhalla_build_segment_index " << VALHALLA_VERSION << "\n";
+      exit(0);
+    }
+
+    if (result.count("config") &&
+        filesystem::is_regular_file(config_file_path =
+                                        filesystem::path(result["config"].as<std::string>()))) {
+      return true;
+    } else {
+      std::cerr << "Configuration file is required\n\n" << options.help() << "\n\n";
+    }
+  } catch (const cxxopts::OptionException& e) {
+    std::cout << "Unable to parse command line options because: " << e.what() << std::endl;
+  }
+
+  return false;
+}
+
+int main(int argc, char** argv) {
+  if (!ParseArguments(argc, argv)) {
+    return EXIT_FAILURE;
+  }
+
+  boost::property_tree::ptree pt;
+  rapidjson::read_json(config_file_path.string(), pt);
+
+  // configure logging
+  auto logging_subtree = pt.get_child_optional("mjolnir.logging");
+  if (logging_subtree) {
+    auto logging_config =
+        valhalla::midgard::ToMap<const boost::property_tree::ptree&,
+                                 std::unordered_map<std::string, std::string>>(logging_subtree.get());
+    valhalla::midgard::logging::Configure(logging_config);
+  }
+
+  // where to put it
+  if (output_file.empty()) {
+    output_file = pt.get<std::string>("mjolnir.segment_index", "");
+  }
+  if (output_file.empty()) {
+    LOG_ERROR("No output file given and mjolnir.segment_index is not configured");
+    return EXIT_FAILURE;
+  }
+
+  auto count = SegmentIndexBuilder::Build(pt.get_child("mjolnir"), output_file);
+  LOG_INFO("Wrote " + std::to_string(count) + " segments to " + output_file);
+  return EXIT_SUCCESS;
+}
@@ -1,5 +1,8 @@
 #include <iostream>
+#include <list>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "midgard/logging.h"
 #include "odin/directionsbuilder.h"
@@ -26,40 +29,70 @@ namespace odin {
 // NarrativeBuilder::Build to form the maneuver list. This method
 // calls PopulateDirectionsLeg to transform the maneuver list into the
 // trip directions.
-void DirectionsBuilder::Build(Api& api, const MarkupFormatter& markup_formatter) {
+void DirectionsBuilder::Build(Api& api,
+                              const MarkupFormatter& markup_formatter,
+                              midgard::ThreadPool* thread_pool) {
   const auto& options = api.options();
+
+  // Only build as much of the maneuvers and narrative as the output will actually use. gpx only
+  // looks at the trip, pbf can leave out the directions and osrm never uses the verbal strings
+  bool build_maneuvers = options.directions_type() != DirectionsType::none &&
+                         options.format() != Options::gpx &&
+                         (options.format() != Options::pbf || !options.has_pbf_field_selector() ||
+                          options.pbf_field_selector().directions());
+  bool build_narrative =
+      build_maneuvers && options.directions_type() == DirectionsType::instructions;
+  bool build_verbal = build_narrative && options.format() != Options::osrm;
+
+  // Lay out the directions for every leg up front so they come out in the same order as the trip
+  std::vector<std::pair<TripLeg*, DirectionsLeg*>> legs;
   for (auto& trip_route : *api.mutable_trip()->mutable_routes()) {
     auto& directions_route = *api.mutable_directions()->mutable_routes()->Add();
     for (auto& trip_path : *trip_route.mutable_legs()) {
-      auto& trip_directions = *directions_route.mutable_legs()->Add();
-
-      // Validate trip path node list
-      if (trip_path.node_size() < 1) {
-        throw valhalla_exception_t{210};
-      }
-
-      // Create an enhanced trip path from the specified trip_path
-      EnhancedTripLeg etp(trip_path);
+      legs.emplace_back(&trip_path, directions_route.mutable_legs()->Add());
+    }
+  }
 
-      // Produce maneuvers if desired
-      std::list<Maneuver> maneuvers;
-      if (options.directions_type() != DirectionsType::none) {
-        // Update the heading of ~0 length edges
-        UpdateHeading(&etp);
+  // The legs dont depend on each other so they can be built in any order on any thread
+  auto build_leg = [&](size_t i) {
+    auto& trip_path = *legs[i].first;
 
-        ManeuversBuilder maneuversBuilder(options, &etp);
-        maneuvers = maneuversBuilder.Build();
+    // Validate trip path node list
+    if (trip_path.node_size() < 1) {
+      throw valhalla_exception_t{210};
+    }
 
-        // Create the instructions if desired
-        if (options.directions_type() == DirectionsType::instructions) {
-          std::unique_ptr<NarrativeBuilder> narrative_builder =
-              NarrativeBuilderFactory::Create(options, &etp, markup_formatter);
-          narrative_builder->Build(maneuvers);
+    // Create an enhanced trip path from the specified trip_path
+    EnhancedTripLeg etp(trip_path);
+
+    // Produce maneuvers if desired
+    std::list<Maneuver> maneuvers;
+    if (build_maneuvers) {
+      // Update the heading of ~0 length edges
+      UpdateHeading(&etp);
+
+      ManeuversBuilder maneuversBuilder(options, &etp);
+      maneuvers = maneuversBuilder.Build();
+
+      // Create the instructions if desired
+      if (build_narrative) {
+        std::unique_ptr<NarrativeBuilder> narrative_builder =
+            NarrativeBuilderFactory::Create(options, &etp, markup_formatter);
+        narrative_builder->BuildInstructions(maneuvers);
+        if (build_verbal) {
+          narrative_builder->BuildVerbalInstructions(maneuvers);
         }
       }
+    }
 
-      // Return trip directions
-      PopulateDirectionsLeg(options, &etp, maneuvers, trip_directions);
+    // Return trip directions
+    PopulateDirectionsLeg(options, &etp, maneuvers, *legs[i].second);
+  };
+  if (thread_pool && legs.size() > 1) {
+    thread_pool->Run(legs.size(), build_leg);
+  } else {
+    for (size_t i = 0; i < legs.size(); ++i) {
+      build_leg(i);
     }
   }
 }
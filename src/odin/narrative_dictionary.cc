@@ -1,4 +1,7 @@
+#include <algorithm>
+#include <iterator>
 #include <stdexcept>
+#include <utility>
 
 #include <boost/property_tree/ptree.hpp>
 
@@ -30,6 +33,44 @@ std::unordered_map<K, V> as_unordered_map(boost::property_tree::ptree const& pt,
   return items;
 }
 
+// The text of each phrase tag in the order of PhraseTag
+const std::pair<const char*, valhalla::odin::PhraseTag> kPhraseTags[] = {
+    {kCardinalDirectionTag, valhalla::odin::PhraseTag::kCardinalDirection},
+    {kRelativeDirectionTag, valhalla::odin::PhraseTag::kRelativeDirection},
+    {kOrdinalValueTag, valhalla::odin::PhraseTag::kOrdinalValue},
+    {kStreetNamesTag, valhalla::odin::PhraseTag::kStreetNames},
+    {kPreviousStreetNamesTag, valhalla::odin::PhraseTag::kPreviousStreetNames},
+    {kBeginStreetNamesTag, valhalla::odin::PhraseTag::kBeginStreetNames},
+    {kCrossStreetNamesTag, valhalla::odin::PhraseTag::kCrossStreetNames},
+    {kRoundaboutExitStreetNamesTag, valhalla::odin::PhraseTag::kRoundaboutExitStreetNames},
+    {kRoundaboutExitBeginStreetNamesTag,
+     valhalla::odin::PhraseTag::kRoundaboutExitBeginStreetNames},
+    {kRampExitNumbersVisualTag, valhalla::odin::PhraseTag::kRampExitNumbersVisual},
+    {kLengthTag, valhalla::odin::PhraseTag::kLength},
+    {kDestinationTag, valhalla::odin::PhraseTag::kDestination},
+    {kCurrentVerbalCueTag, valhalla::odin::PhraseTag::kCurrentVerbalCue},
+    {kNextVerbalCueTag, valhalla::odin::PhraseTag::kNextVerbalCue},
+    {kKilometersTag, valhalla::odin::PhraseTag::kKilometers},
+    {kMetersTag, valhalla::odin::PhraseTag::kMeters},
+    {kMilesTag, valhalla::odin::PhraseTag::kMiles},
+    {kTenthsOfMilesTag, valhalla::odin::PhraseTag::kTenthsOfMiles},
+    {kFeetTag, valhalla::odin::PhraseTag::kFeet},
+    {kNumberSignTag, valhalla::odin::PhraseTag::kNumberSign},
+    {kBranchSignTag, valhalla::odin::PhraseTag::kBranchSign},
+    {kTowardSignTag, valhalla::odin::PhraseTag::kTowardSign},
+    {kNameSignTag, valhalla::odin::PhraseTag::kNameSign},
+    {kJunctionNameTag, valhalla::odin::PhraseTag::kJunctionName},
+    {kFerryLabelTag, valhalla::odin::PhraseTag::kFerryLabel},
+    {kTransitPlatformTag, valhalla::odin::PhraseTag::kTransitPlatform},
+    {kStationLabelTag, valhalla::odin::PhraseTag::kStationLabel},
+    {kTimeTag, valhalla::odin::PhraseTag::kTime},
+    {kTransitNameTag, valhalla::odin::PhraseTag::kTransitName},
+    {kTransitHeadSignTag, valhalla::odin::PhraseTag::kTransitHeadSign},
+    {kTransitPlatformCountTag, valhalla::odin::PhraseTag::kTransitPlatformCount},
+    {kTransitPlatformCountLabelTag, valhalla::odin::PhraseTag::kTransitPlatformCountLabel},
+    {kLevelTag, valhalla::odin::PhraseTag::kLevel},
+};
+
 } // namespace
 
 namespace valhalla {
@@ -341,6 +382,72 @@ void NarrativeDictionary::Load(PhraseSet& phrase_handle,
                                const boost::property_tree::ptree& phrase_pt) {
 
   phrase_handle.phrases = as_unordered_map<std::string, std::string>(phrase_pt, kPhrasesKey);
+
+  // Split the phrases into templates once here rather than every time they are used
+  phrase_handle.templates.clear();
+  for (const auto& phrase : phrase_handle.phrases) {
+    phrase_handle.templates.emplace(static_cast<uint8_t>(std::stoul(phrase.first)),
+                                    PhraseTemplate(phrase.second));
+  }
+}
+
+PhraseTemplate::PhraseTemplate(const std::string& phrase) : phrase_(phrase) {
+  // everything between tags is plain text, neighbouring plain text is kept as one piece
+  auto add_text = [this](size_t offset, size_t length) {
+    if (length == 0) {
+      return;
+    }
+    if (!tokens_.empty() && tokens_.back().tag == PhraseTag::kNone) {
+      tokens_.back().length += length;
+    } else {
+      tokens_.push_back(
+          {static_cast<uint32_t>(offset), static_cast<uint32_t>(length), PhraseTag::kNone});
+    }
+  };
+
+  size_t text = 0;
+  size_t open = phrase_.find('<');
+  while (open != std::string::npos) {
+    size_t close = phrase_.find('>', open);
+    if (close == std::string::npos) {
+      break;
+    }
+    const auto length = close - open + 1;
+    auto found = std::find_if(std::begin(kPhraseTags), std::end(kPhraseTags),
+                              [&](const std::pair<const char*, PhraseTag>& tag) {
+                                return phrase_.compare(open, length, tag.first) == 0;
+                              });
+    if (found == std::end(kPhraseTags)) {
+      // not one of ours so its just text, there could be a tag starting inside of it though
+      open = phrase_.find('<', open + 1);
+      continue;
+    }
+    add_text(text, open - text);
+    tokens_.push_back({static_cast<uint32_t>(open), static_cast<uint32_t>(length), found->second});
+    text = close + 1;
+    open = phrase_.find('<', text);
+  }
+  add_text(text, phrase_.size() - text);
+}
+
+void PhraseTemplate::Render(std::string& instruction, tag_values_t values) const {
+  // the value for each tag, if there is one
+  const std::string* by_tag[static_cast<size_t>(PhraseTag::kNone) + 1] = {};
+  for (const auto& value : values) {
+    if (value.tag != PhraseTag::kNone) {
+      by_tag[static_cast<size_t>(value.tag)] = &value.value;
+    }
+  }
+
+  instruction.clear();
+  for (const auto& token : tokens_) {
+    const auto* value = by_tag[static_cast<size_t>(token.tag)];
+    if (value) {
+      instruction.append(*value);
+    } else {
+      instruction.append(phrase_, token.offset, token.length);
+    }
+  }
 }
 
 void NarrativeDictionary::Load(StartSubset& start_handle,
@@ -50,6 +50,11 @@ NarrativeBuilder::NarrativeBuilder(const Options& options,
 }
 
 void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
+  BuildInstructions(maneuvers);
+  BuildVerbalInstructions(maneuvers);
+}
+
+void NarrativeBuilder::BuildInstructions(std::list<Maneuver>& maneuvers) {
   Maneuver* prev_maneuver = nullptr;
   for (auto& maneuver : maneuvers) {
     switch (maneuver.type()) {
@@ -60,7 +65,186 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
       case DirectionsLeg_Maneuver_Type_kPostTransitConnectionDestination: {
         // Set instruction
         maneuver.set_instruction(FormStartInstruction(maneuver));
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kDestinationRight:
+      case DirectionsLeg_Maneuver_Type_kDestination:
+      case DirectionsLeg_Maneuver_Type_kDestinationLeft: {
+        // Set instruction
+        maneuver.set_instruction(FormDestinationInstruction(maneuver));
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kBecomes: {
+        if (prev_maneuver) {
+          // Set instruction
+          maneuver.set_instruction(FormBecomesInstruction(maneuver, prev_maneuver));
+        }
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kSlightRight:
+      case DirectionsLeg_Maneuver_Type_kSlightLeft:
+      case DirectionsLeg_Maneuver_Type_kRight:
+      case DirectionsLeg_Maneuver_Type_kSharpRight:
+      case DirectionsLeg_Maneuver_Type_kSharpLeft:
+      case DirectionsLeg_Maneuver_Type_kLeft: {
+        // Set instruction
+        maneuver.set_instruction(FormTurnInstruction(maneuver));
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kUturnRight:
+      case DirectionsLeg_Maneuver_Type_kUturnLeft: {
+        // Set instruction
+        maneuver.set_instruction(FormUturnInstruction(maneuver));
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kRampStraight: {
+        // Set instruction
+        maneuver.set_instruction(FormRampStraightInstruction(maneuver));
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kRampRight:
+      case DirectionsLeg_Maneuver_Type_kRampLeft: {
+        // Set instruction
+        maneuver.set_instruction(FormRampInstruction(maneuver));
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kExitRight:
+      case DirectionsLeg_Maneuver_Type_kExitLeft: {
+        // Set instruction
+        maneuver.set_instruction(FormExitInstruction(maneuver));
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kStayStraight:
+      case DirectionsLeg_Maneuver_Type_kStayRight:
+      case DirectionsLeg_Maneuver_Type_kStayLeft: {
+        if (maneuver.to_stay_on()) {
+          // Set stay on instruction
+          maneuver.set_instruction(FormKeepToStayOnInstruction(maneuver));
+        } else {
+          // Set instruction
+          maneuver.set_instruction(FormKeepInstruction(maneuver));
+        }
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kMerge:
+      case DirectionsLeg_Maneuver_Type_kMergeRight:
+      case DirectionsLeg_Maneuver_Type_kMergeLeft: {
+        // Set instruction
+        maneuver.set_instruction(FormMergeInstruction(maneuver));
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kRoundaboutEnter: {
+        // Set instruction
+        maneuver.set_instruction(FormEnterRoundaboutInstruction(maneuver));
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kRoundaboutExit: {
+        // Set instruction
+        maneuver.set_instruction(FormExitRoundaboutInstruction(maneuver));
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kFerryEnter: {
+        // Set instruction
+        maneuver.set_instruction(FormEnterFerryInstruction(maneuver));
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kTransitConnectionStart: {
+        // Set instruction
+        maneuver.set_instruction(FormTransitConnectionStartInstruction(maneuver));
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kTransitConnectionTransfer: {
+        // Set instruction
+        maneuver.set_instruction(FormTransitConnectionTransferInstruction(maneuver));
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kTransitConnectionDestination: {
+        // Set instruction
+        maneuver.set_instruction(FormTransitConnectionDestinationInstruction(maneuver));
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kTransit: {
+        // Set depart instruction
+        maneuver.set_depart_instruction(FormDepartInstruction(maneuver));
+
+        // Set instruction
+        maneuver.set_instruction(FormTransitInstruction(maneuver));
+
+        // Set arrive instruction
+        maneuver.set_arrive_instruction(FormArriveInstruction(maneuver));
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kTransitRemainOn: {
+        // Set depart instruction
+        maneuver.set_depart_instruction(FormDepartInstruction(maneuver));
+
+        // Set instruction
+        maneuver.set_instruction(FormTransitRemainOnInstruction(maneuver));
+
+        // Set arrive instruction
+        maneuver.set_arrive_instruction(FormArriveInstruction(maneuver));
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kTransitTransfer: {
+        // Set depart instruction
+        maneuver.set_depart_instruction(FormDepartInstruction(maneuver));
 
+        // Set instruction
+        maneuver.set_instruction(FormTransitTransferInstruction(maneuver));
+
+        // Set arrive instruction
+        maneuver.set_arrive_instruction(FormArriveInstruction(maneuver));
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kElevatorEnter: {
+        // Set instruction
+        maneuver.set_instruction(FormElevatorInstruction(maneuver));
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kStepsEnter: {
+        // Set instruction
+        maneuver.set_instruction(FormStepsInstruction(maneuver));
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kEscalatorEnter: {
+        // Set instruction
+        maneuver.set_instruction(FormEscalatorInstruction(maneuver));
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kBuildingEnter: {
+        // Set instruction
+        maneuver.set_instruction(FormEnterBuildingInstruction(maneuver));
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kBuildingExit: {
+        // Set instruction
+        maneuver.set_instruction(FormExitBuildingInstruction(maneuver));
+        break;
+      }
+      case DirectionsLeg_Maneuver_Type_kContinue:
+      default: {
+        // Set instruction
+        maneuver.set_instruction(FormContinueInstruction(maneuver));
+        break;
+      }
+    }
+    maneuver.set_instruction(FormBssManeuverType(maneuver.bss_maneuver_type()) +
+                             maneuver.instruction());
+
+    // Update previous maneuver
+    prev_maneuver = &maneuver;
+  }
+}
+
+void NarrativeBuilder::BuildVerbalInstructions(std::list<Maneuver>& maneuvers) {
+  Maneuver* prev_maneuver = nullptr;
+  for (auto& maneuver : maneuvers) {
+    switch (maneuver.type()) {
+      case DirectionsLeg_Maneuver_Type_kStartRight:
+      case DirectionsLeg_Maneuver_Type_kStart:
+      case DirectionsLeg_Maneuver_Type_kStartLeft:
+      case DirectionsLeg_Maneuver_Type_kFerryExit:
+      case DirectionsLeg_Maneuver_Type_kPostTransitConnectionDestination: {
         // Set verbal succinct transition instruction
         maneuver.set_verbal_succinct_transition_instruction(
             FormVerbalSuccinctStartTransitionInstruction(maneuver));
@@ -76,9 +260,6 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
       case DirectionsLeg_Maneuver_Type_kDestinationRight:
       case DirectionsLeg_Maneuver_Type_kDestination:
       case DirectionsLeg_Maneuver_Type_kDestinationLeft: {
-        // Set instruction
-        maneuver.set_instruction(FormDestinationInstruction(maneuver));
-
         // Set verbal transition alert instruction
         maneuver.set_verbal_transition_alert_instruction(
             FormVerbalAlertDestinationInstruction(maneuver));
@@ -89,9 +270,6 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
       }
       case DirectionsLeg_Maneuver_Type_kBecomes: {
         if (prev_maneuver) {
-          // Set instruction
-          maneuver.set_instruction(FormBecomesInstruction(maneuver, prev_maneuver));
-
           // Set verbal pre transition instruction
           maneuver.set_verbal_pre_transition_instruction(
               FormVerbalBecomesInstruction(maneuver, prev_maneuver));
@@ -99,11 +277,7 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
 
         // Set verbal post transition instruction
         maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionInstruction(maneuver,
-                                                maneuver
-                                                    .HasBeginStreetNames())); // Set verbal succinct
-                                                                              // transition
-                                                                              // instruction
+            FormVerbalPostTransitionInstruction(maneuver, maneuver.HasBeginStreetNames()));
         break;
       }
       case DirectionsLeg_Maneuver_Type_kSlightRight:
@@ -112,9 +286,6 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
       case DirectionsLeg_Maneuver_Type_kSharpRight:
       case DirectionsLeg_Maneuver_Type_kSharpLeft:
       case DirectionsLeg_Maneuver_Type_kLeft: {
-        // Set instruction
-        maneuver.set_instruction(FormTurnInstruction(maneuver));
-
         // Set verbal succinct transition instruction
         maneuver.set_verbal_succinct_transition_instruction(
             FormVerbalSuccinctTurnTransitionInstruction(maneuver));
@@ -132,9 +303,6 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
       }
       case DirectionsLeg_Maneuver_Type_kUturnRight:
       case DirectionsLeg_Maneuver_Type_kUturnLeft: {
-        // Set instruction
-        maneuver.set_instruction(FormUturnInstruction(maneuver));
-
         // Set verbal succinct transition instruction
         maneuver.set_verbal_succinct_transition_instruction(
             FormVerbalSuccinctUturnTransitionInstruction(maneuver));
@@ -151,9 +319,6 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
         break;
       }
       case DirectionsLeg_Maneuver_Type_kRampStraight: {
-        // Set instruction
-        maneuver.set_instruction(FormRampStraightInstruction(maneuver));
-
         // Set verbal transition alert instruction
         maneuver.set_verbal_transition_alert_instruction(
             FormVerbalAlertRampStraightInstruction(maneuver));
@@ -174,9 +339,6 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
       }
       case DirectionsLeg_Maneuver_Type_kRampRight:
       case DirectionsLeg_Maneuver_Type_kRampLeft: {
-        // Set instruction
-        maneuver.set_instruction(FormRampInstruction(maneuver));
-
         // Set verbal transition alert instruction
         maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertRampInstruction(maneuver));
 
@@ -196,9 +358,6 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
       }
       case DirectionsLeg_Maneuver_Type_kExitRight:
       case DirectionsLeg_Maneuver_Type_kExitLeft: {
-        // Set instruction
-        maneuver.set_instruction(FormExitInstruction(maneuver));
-
         // Set verbal transition alert instruction
         maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertExitInstruction(maneuver));
 
@@ -220,9 +379,6 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
       case DirectionsLeg_Maneuver_Type_kStayRight:
       case DirectionsLeg_Maneuver_Type_kStayLeft: {
         if (maneuver.to_stay_on()) {
-          // Set stay on instruction
-          maneuver.set_instruction(FormKeepToStayOnInstruction(maneuver));
-
           // Set verbal transition alert instruction
           maneuver.set_verbal_transition_alert_instruction(
               FormVerbalAlertKeepToStayOnInstruction(maneuver));
@@ -243,9 +399,6 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
                 FormVerbalPostTransitionInstruction(maneuver));
           }
         } else {
-          // Set instruction
-          maneuver.set_instruction(FormKeepInstruction(maneuver));
-
           // Set verbal transition alert instruction
           maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertKeepInstruction(maneuver));
 
@@ -270,9 +423,6 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
       case DirectionsLeg_Maneuver_Type_kMerge:
       case DirectionsLeg_Maneuver_Type_kMergeRight:
       case DirectionsLeg_Maneuver_Type_kMergeLeft: {
-        // Set instruction
-        maneuver.set_instruction(FormMergeInstruction(maneuver));
-
         // Set verbal succinct transition instruction
         maneuver.set_verbal_succinct_transition_instruction(
             FormVerbalSuccinctMergeTransitionInstruction(maneuver));
@@ -293,9 +443,6 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
         break;
       }
       case DirectionsLeg_Maneuver_Type_kRoundaboutEnter: {
-        // Set instruction
-        maneuver.set_instruction(FormEnterRoundaboutInstruction(maneuver));
-
         // Set verbal succinct transition instruction
         maneuver.set_verbal_succinct_transition_instruction(
             FormVerbalSuccinctEnterRoundaboutTransitionInstruction(maneuver));
@@ -318,9 +465,6 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
         break;
       }
       case DirectionsLeg_Maneuver_Type_kRoundaboutExit: {
-        // Set instruction
-        maneuver.set_instruction(FormExitRoundaboutInstruction(maneuver));
-
         // Set verbal succinct transition instruction
         maneuver.set_verbal_succinct_transition_instruction(
             FormVerbalSuccinctExitRoundaboutTransitionInstruction(maneuver));
@@ -334,9 +478,6 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
         break;
       }
       case DirectionsLeg_Maneuver_Type_kFerryEnter: {
-        // Set instruction
-        maneuver.set_instruction(FormEnterFerryInstruction(maneuver));
-
         // Set verbal transition alert instruction
         maneuver.set_verbal_transition_alert_instruction(
             FormVerbalAlertEnterFerryInstruction(maneuver));
@@ -350,9 +491,6 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
         break;
       }
       case DirectionsLeg_Maneuver_Type_kTransitConnectionStart: {
-        // Set instruction
-        maneuver.set_instruction(FormTransitConnectionStartInstruction(maneuver));
-
         // Set verbal pre transition instruction
         maneuver.set_verbal_pre_transition_instruction(
             FormVerbalTransitConnectionStartInstruction(maneuver));
@@ -363,9 +501,6 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
         break;
       }
       case DirectionsLeg_Maneuver_Type_kTransitConnectionTransfer: {
-        // Set instruction
-        maneuver.set_instruction(FormTransitConnectionTransferInstruction(maneuver));
-
         // Set verbal pre transition instruction
         maneuver.set_verbal_pre_transition_instruction(
             FormVerbalTransitConnectionTransferInstruction(maneuver));
@@ -376,9 +511,6 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
         break;
       }
       case DirectionsLeg_Maneuver_Type_kTransitConnectionDestination: {
-        // Set instruction
-        maneuver.set_instruction(FormTransitConnectionDestinationInstruction(maneuver));
-
         // Set verbal pre transition instruction
         maneuver.set_verbal_pre_transition_instruction(
             FormVerbalTransitConnectionDestinationInstruction(maneuver));
@@ -389,15 +521,9 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
         break;
       }
       case DirectionsLeg_Maneuver_Type_kTransit: {
-        // Set depart instruction
-        maneuver.set_depart_instruction(FormDepartInstruction(maneuver));
-
         // Set verbal depart instruction
         maneuver.set_verbal_depart_instruction(FormVerbalDepartInstruction(maneuver));
 
-        // Set instruction
-        maneuver.set_instruction(FormTransitInstruction(maneuver));
-
         // Set verbal pre transition instruction
         maneuver.set_verbal_pre_transition_instruction(FormVerbalTransitInstruction(maneuver));
 
@@ -405,24 +531,15 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
         maneuver.set_verbal_post_transition_instruction(
             FormVerbalPostTransitionTransitInstruction(maneuver));
 
-        // Set arrive instruction
-        maneuver.set_arrive_instruction(FormArriveInstruction(maneuver));
-
         // Set verbal arrive instruction
         maneuver.set_verbal_arrive_instruction(FormVerbalArriveInstruction(maneuver));
 
         break;
       }
       case DirectionsLeg_Maneuver_Type_kTransitRemainOn: {
-        // Set depart instruction
-        maneuver.set_depart_instruction(FormDepartInstruction(maneuver));
-
         // Set verbal depart instruction
         maneuver.set_verbal_depart_instruction(FormVerbalDepartInstruction(maneuver));
 
-        // Set instruction
-        maneuver.set_instruction(FormTransitRemainOnInstruction(maneuver));
-
         // Set verbal pre transition instruction
         maneuver.set_verbal_pre_transition_instruction(
             FormVerbalTransitRemainOnInstruction(maneuver));
@@ -431,24 +548,15 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
         maneuver.set_verbal_post_transition_instruction(
             FormVerbalPostTransitionTransitInstruction(maneuver));
 
-        // Set arrive instruction
-        maneuver.set_arrive_instruction(FormArriveInstruction(maneuver));
-
         // Set verbal arrive instruction
         maneuver.set_verbal_arrive_instruction(FormVerbalArriveInstruction(maneuver));
 
         break;
       }
       case DirectionsLeg_Maneuver_Type_kTransitTransfer: {
-        // Set depart instruction
-        maneuver.set_depart_instruction(FormDepartInstruction(maneuver));
-
         // Set verbal depart instruction
         maneuver.set_verbal_depart_instruction(FormVerbalDepartInstruction(maneuver));
 
-        // Set instruction
-        maneuver.set_instruction(FormTransitTransferInstruction(maneuver));
-
         // Set verbal pre transition instruction
         maneuver.set_verbal_pre_transition_instruction(
             FormVerbalTransitTransferInstruction(maneuver));
@@ -457,43 +565,20 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
         maneuver.set_verbal_post_transition_instruction(
             FormVerbalPostTransitionTransitInstruction(maneuver));
 
-        // Set arrive instruction
-        maneuver.set_arrive_instruction(FormArriveInstruction(maneuver));
-
         // Set verbal arrive instruction
         maneuver.set_verbal_arrive_instruction(FormVerbalArriveInstruction(maneuver));
         break;
       }
-      case DirectionsLeg_Maneuver_Type_kElevatorEnter: {
-        // Set instruction
-        maneuver.set_instruction(FormElevatorInstruction(maneuver));
-        break;
-      }
-      case DirectionsLeg_Maneuver_Type_kStepsEnter: {
-        // Set instruction
-        maneuver.set_instruction(FormStepsInstruction(maneuver));
-        break;
-      }
-      case DirectionsLeg_Maneuver_Type_kEscalatorEnter: {
-        // Set instruction
-        maneuver.set_instruction(FormEscalatorInstruction(maneuver));
-        break;
-      }
-      case DirectionsLeg_Maneuver_Type_kBuildingEnter: {
-        // Set instruction
-        maneuver.set_instruction(FormEnterBuildingInstruction(maneuver));
-        break;
-      }
+      case DirectionsLeg_Maneuver_Type_kElevatorEnter:
+      case DirectionsLeg_Maneuver_Type_kStepsEnter:
+      case DirectionsLeg_Maneuver_Type_kEscalatorEnter:
+      case DirectionsLeg_Maneuver_Type_kBuildingEnter:
       case DirectionsLeg_Maneuver_Type_kBuildingExit: {
-        // Set instruction
-        maneuver.set_instruction(FormExitBuildingInstruction(maneuver));
+        // These only have a text instruction
         break;
       }
       case DirectionsLeg_Maneuver_Type_kContinue:
       default: {
-        // Set instruction
-        maneuver.set_instruction(FormContinueInstruction(maneuver));
-
         // Set verbal transition alert instruction
         maneuver.set_verbal_transition_alert_instruction(
             FormVerbalAlertContinueInstruction(maneuver));
@@ -507,8 +592,6 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
         break;
       }
     }
-    maneuver.set_instruction(FormBssManeuverType(maneuver.bss_maneuver_type()) +
-                             maneuver.instruction());
 
     // Update previous maneuver
     prev_maneuver = &maneuver;
@@ -524,14 +607,12 @@ std::string NarrativeBuilder::FormVerbalAlertApproachInstruction(float distance,
   instruction.reserve(kInstructionInitialCapacity);
   uint8_t phrase_id = 0;
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.approach_verbal_alert_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(distance, dictionary_.approach_verbal_alert_subset.metric_lengths,
-                                dictionary_.approach_verbal_alert_subset.us_customary_lengths));
-  boost::replace_all(instruction, kCurrentVerbalCueTag, verbal_cue);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto length = FormLength(distance, dictionary_.approach_verbal_alert_subset.metric_lengths,
+                                 dictionary_.approach_verbal_alert_subset.us_customary_lengths);
+  const auto& phrase = dictionary_.approach_verbal_alert_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kLength, length},
+                              {PhraseTag::kCurrentVerbalCue, verbal_cue}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -589,13 +670,11 @@ std::string NarrativeBuilder::FormStartInstruction(Maneuver& maneuver) {
     phrase_id += 16;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.start_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kCardinalDirectionTag, cardinal_direction);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.start_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kCardinalDirection, cardinal_direction},
+                              {PhraseTag::kStreetNames, street_names},
+                              {PhraseTag::kBeginStreetNames, begin_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -676,16 +755,14 @@ std::string NarrativeBuilder::FormVerbalStartInstruction(Maneuver& maneuver,
     phrase_id += 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.start_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kCardinalDirectionTag, cardinal_direction);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(maneuver, dictionary_.start_verbal_subset.metric_lengths,
-                                dictionary_.start_verbal_subset.us_customary_lengths));
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto length = FormLength(maneuver, dictionary_.start_verbal_subset.metric_lengths,
+                                 dictionary_.start_verbal_subset.us_customary_lengths);
+  const auto& phrase = dictionary_.start_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kCardinalDirection, cardinal_direction},
+                              {PhraseTag::kStreetNames, street_names},
+                              {PhraseTag::kBeginStreetNames, begin_street_names},
+                              {PhraseTag::kLength, length}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -729,14 +806,10 @@ std::string NarrativeBuilder::FormDestinationInstruction(Maneuver& maneuver) {
     relative_direction = dictionary_.destination_subset.relative_directions.at(1);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.destination_subset.phrases.at(std::to_string(phrase_id));
-
-  if (phrase_id > 0) {
-    // Replace phrase tags with values
-    boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-    boost::replace_all(instruction, kDestinationTag, destination);
-  }
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.destination_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kRelativeDirection, relative_direction},
+                              {PhraseTag::kDestination, destination}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -785,14 +858,10 @@ std::string NarrativeBuilder::FormVerbalAlertDestinationInstruction(Maneuver& ma
     relative_direction = dictionary_.destination_subset.relative_directions.at(1);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.destination_verbal_alert_subset.phrases.at(std::to_string(phrase_id));
-
-  if (phrase_id > 0) {
-    // Replace phrase tags with values
-    boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-    boost::replace_all(instruction, kDestinationTag, destination);
-  }
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.destination_verbal_alert_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kRelativeDirection, relative_direction},
+                              {PhraseTag::kDestination, destination}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -841,14 +910,10 @@ std::string NarrativeBuilder::FormVerbalDestinationInstruction(Maneuver& maneuve
     relative_direction = dictionary_.destination_subset.relative_directions.at(1);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.destination_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  if (phrase_id > 0) {
-    // Replace phrase tags with values
-    boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-    boost::replace_all(instruction, kDestinationTag, destination);
-  }
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.destination_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kRelativeDirection, relative_direction},
+                              {PhraseTag::kDestination, destination}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -871,12 +936,10 @@ std::string NarrativeBuilder::FormBecomesInstruction(Maneuver& maneuver, Maneuve
   // Determine which phrase to use
   uint8_t phrase_id = 0;
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.becomes_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kPreviousStreetNamesTag, prev_street_names);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.becomes_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kPreviousStreetNames, prev_street_names},
+                              {PhraseTag::kStreetNames, street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -906,12 +969,10 @@ std::string NarrativeBuilder::FormVerbalBecomesInstruction(Maneuver& maneuver,
   // Determine which phrase to use
   uint8_t phrase_id = 0;
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.becomes_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kPreviousStreetNamesTag, prev_street_names);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.becomes_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kPreviousStreetNames, prev_street_names},
+                              {PhraseTag::kStreetNames, street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -957,13 +1018,11 @@ std::string NarrativeBuilder::FormContinueInstruction(Maneuver& maneuver,
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.continue_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.continue_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kStreetNames, street_names},
+                              {PhraseTag::kJunctionName, junction_name},
+                              {PhraseTag::kTowardSign, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1013,13 +1072,11 @@ std::string NarrativeBuilder::FormVerbalAlertContinueInstruction(Maneuver& maneu
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.continue_verbal_alert_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.continue_verbal_alert_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kStreetNames, street_names},
+                              {PhraseTag::kJunctionName, junction_name},
+                              {PhraseTag::kTowardSign, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1078,16 +1135,14 @@ std::string NarrativeBuilder::FormVerbalContinueInstruction(Maneuver& maneuver,
     phrase_id += 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.continue_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(maneuver, dictionary_.continue_verbal_subset.metric_lengths,
-                                dictionary_.continue_verbal_subset.us_customary_lengths));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto length = FormLength(maneuver, dictionary_.continue_verbal_subset.metric_lengths,
+                                 dictionary_.continue_verbal_subset.us_customary_lengths);
+  const auto& phrase = dictionary_.continue_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kLength, length},
+                              {PhraseTag::kStreetNames, street_names},
+                              {PhraseTag::kJunctionName, junction_name},
+                              {PhraseTag::kTowardSign, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1163,16 +1218,15 @@ std::string NarrativeBuilder::FormTurnInstruction(Maneuver& maneuver,
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = subset->phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(), subset->relative_directions));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto relative_direction =
+      FormRelativeTwoDirection(maneuver.type(), subset->relative_directions);
+  const auto& phrase = subset->templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kRelativeDirection, relative_direction},
+                              {PhraseTag::kStreetNames, street_names},
+                              {PhraseTag::kBeginStreetNames, begin_street_names},
+                              {PhraseTag::kJunctionName, junction_name},
+                              {PhraseTag::kTowardSign, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1271,16 +1325,15 @@ std::string NarrativeBuilder::FormVerbalTurnInstruction(Maneuver& maneuver,
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = subset->phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(), subset->relative_directions));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto relative_direction =
+      FormRelativeTwoDirection(maneuver.type(), subset->relative_directions);
+  const auto& phrase = subset->templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kRelativeDirection, relative_direction},
+                              {PhraseTag::kStreetNames, street_names},
+                              {PhraseTag::kBeginStreetNames, begin_street_names},
+                              {PhraseTag::kJunctionName, junction_name},
+                              {PhraseTag::kTowardSign, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1341,17 +1394,15 @@ std::string NarrativeBuilder::FormUturnInstruction(Maneuver& maneuver,
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.uturn_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(),
-                                              dictionary_.uturn_subset.relative_directions));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kCrossStreetNamesTag, cross_street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto relative_direction =
+      FormRelativeTwoDirection(maneuver.type(), dictionary_.uturn_subset.relative_directions);
+  const auto& phrase = dictionary_.uturn_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kRelativeDirection, relative_direction},
+                              {PhraseTag::kStreetNames, street_names},
+                              {PhraseTag::kCrossStreetNames, cross_street_names},
+                              {PhraseTag::kJunctionName, junction_name},
+                              {PhraseTag::kTowardSign, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1496,15 +1547,13 @@ std::string NarrativeBuilder::FormVerbalUturnInstruction(uint8_t phrase_id,
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.uturn_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kCrossStreetNamesTag, cross_street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.uturn_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kRelativeDirection, relative_dir},
+                              {PhraseTag::kStreetNames, street_names},
+                              {PhraseTag::kCrossStreetNames, cross_street_names},
+                              {PhraseTag::kJunctionName, junction_name},
+                              {PhraseTag::kTowardSign, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1550,13 +1599,11 @@ std::string NarrativeBuilder::FormRampStraightInstruction(Maneuver& maneuver,
         maneuver.signs().GetExitNameString(element_max_count, limit_by_consecutive_count);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.ramp_straight_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.ramp_straight_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kBranchSign, exit_branch_sign},
+                              {PhraseTag::kTowardSign, exit_toward_sign},
+                              {PhraseTag::kNameSign, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1655,13 +1702,11 @@ std::string NarrativeBuilder::FormVerbalRampStraightInstruction(uint8_t phrase_i
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.ramp_straight_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.ramp_straight_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kBranchSign, exit_branch_sign},
+                              {PhraseTag::kTowardSign, exit_toward_sign},
+                              {PhraseTag::kNameSign, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1729,16 +1774,14 @@ std::string NarrativeBuilder::FormRampInstruction(Maneuver& maneuver,
         maneuver.signs().GetExitNameString(element_max_count, limit_by_consecutive_count);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.ramp_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(),
-                                              dictionary_.ramp_subset.relative_directions));
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto relative_direction =
+      FormRelativeTwoDirection(maneuver.type(), dictionary_.ramp_subset.relative_directions);
+  const auto& phrase = dictionary_.ramp_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kRelativeDirection, relative_direction},
+                              {PhraseTag::kBranchSign, exit_branch_sign},
+                              {PhraseTag::kTowardSign, exit_toward_sign},
+                              {PhraseTag::kNameSign, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1889,14 +1932,12 @@ std::string NarrativeBuilder::FormVerbalRampInstruction(uint8_t phrase_id,
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.ramp_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.ramp_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kRelativeDirection, relative_dir},
+                              {PhraseTag::kBranchSign, exit_branch_sign},
+                              {PhraseTag::kTowardSign, exit_toward_sign},
+                              {PhraseTag::kNameSign, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1974,17 +2015,15 @@ std::string NarrativeBuilder::FormExitInstruction(Maneuver& maneuver,
         maneuver.signs().GetExitNameString(element_max_count, limit_by_consecutive_count);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(),
-                                              dictionary_.exit_subset.relative_directions));
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto relative_direction =
+      FormRelativeTwoDirection(maneuver.type(), dictionary_.exit_subset.relative_directions);
+  const auto& phrase = dictionary_.exit_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kRelativeDirection, relative_direction},
+                              {PhraseTag::kNumberSign, exit_number_sign},
+                              {PhraseTag::kBranchSign, exit_branch_sign},
+                              {PhraseTag::kTowardSign, exit_toward_sign},
+                              {PhraseTag::kNameSign, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2145,15 +2184,13 @@ std::string NarrativeBuilder::FormVerbalExitInstruction(uint8_t phrase_id,
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.exit_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kRelativeDirection, relative_dir},
+                              {PhraseTag::kNumberSign, exit_number_sign},
+                              {PhraseTag::kBranchSign, exit_branch_sign},
+                              {PhraseTag::kTowardSign, exit_toward_sign},
+                              {PhraseTag::kNameSign, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2234,16 +2271,14 @@ std::string NarrativeBuilder::FormKeepInstruction(Maneuver& maneuver,
     phrase_id += 4;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.keep_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeThreeDirection(maneuver.type(),
-                                                dictionary_.keep_subset.relative_directions));
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, toward_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto relative_direction =
+      FormRelativeThreeDirection(maneuver.type(), dictionary_.keep_subset.relative_directions);
+  const auto& phrase = dictionary_.keep_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kRelativeDirection, relative_direction},
+                              {PhraseTag::kNumberSign, exit_number_sign},
+                              {PhraseTag::kStreetNames, street_names},
+                              {PhraseTag::kTowardSign, toward_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2425,14 +2460,12 @@ std::string NarrativeBuilder::FormVerbalKeepInstruction(uint8_t phrase_id,
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.keep_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, toward_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.keep_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kRelativeDirection, relative_dir},
+                              {PhraseTag::kNumberSign, exit_number_sign},
+                              {PhraseTag::kStreetNames, street_names},
+                              {PhraseTag::kTowardSign, toward_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2484,16 +2517,15 @@ std::string NarrativeBuilder::FormKeepToStayOnInstruction(Maneuver& maneuver,
     phrase_id += 2;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.keep_to_stay_on_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeThreeDirection(maneuver.type(), dictionary_.keep_to_stay_on_subset
-                                                                     .relative_directions));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kTowardSignTag, toward_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto relative_direction =
+      FormRelativeThreeDirection(maneuver.type(),
+                                 dictionary_.keep_to_stay_on_subset.relative_directions);
+  const auto& phrase = dictionary_.keep_to_stay_on_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kRelativeDirection, relative_direction},
+                              {PhraseTag::kStreetNames, street_names},
+                              {PhraseTag::kNumberSign, exit_number_sign},
+                              {PhraseTag::kTowardSign, toward_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2583,14 +2615,12 @@ std::string NarrativeBuilder::FormVerbalKeepToStayOnInstruction(uint8_t phrase_i
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.keep_to_stay_on_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kTowardSignTag, toward_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.keep_to_stay_on_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kRelativeDirection, relative_dir},
+                              {PhraseTag::kStreetNames, street_names},
+                              {PhraseTag::kNumberSign, exit_number_sign},
+                              {PhraseTag::kTowardSign, toward_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2641,13 +2671,11 @@ std::string NarrativeBuilder::FormMergeInstruction(Maneuver& maneuver,
         FormRelativeTwoDirection(maneuver.type(), dictionary_.merge_subset.relative_directions);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.merge_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.merge_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kRelativeDirection, relative_direction},
+                              {PhraseTag::kStreetNames, street_names},
+                              {PhraseTag::kTowardSign, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2716,13 +2744,11 @@ std::string NarrativeBuilder::FormVerbalMergeInstruction(Maneuver& maneuver,
                                  dictionary_.merge_verbal_subset.relative_directions);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.merge_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.merge_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kRelativeDirection, relative_direction},
+                              {PhraseTag::kStreetNames, street_names},
+                              {PhraseTag::kTowardSign, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2839,16 +2865,14 @@ std::string NarrativeBuilder::FormEnterRoundaboutInstruction(Maneuver& maneuver,
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_roundabout_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kOrdinalValueTag, ordinal_value);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
-  boost::replace_all(instruction, kRoundaboutExitStreetNamesTag, roundabout_exit_street_names);
-  boost::replace_all(instruction, kRoundaboutExitBeginStreetNamesTag,
-                     roundabout_exit_begin_street_names);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.enter_roundabout_subset.templates.at(phrase_id);
+  phrase.Render(instruction,
+                {{PhraseTag::kOrdinalValue, ordinal_value},
+                 {PhraseTag::kStreetNames, street_names},
+                 {PhraseTag::kTowardSign, guide_sign},
+                 {PhraseTag::kRoundaboutExitStreetNames, roundabout_exit_street_names},
+                 {PhraseTag::kRoundaboutExitBeginStreetNames, roundabout_exit_begin_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2991,16 +3015,14 @@ std::string NarrativeBuilder::FormVerbalEnterRoundaboutInstruction(Maneuver& man
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_roundabout_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kOrdinalValueTag, ordinal_value);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
-  boost::replace_all(instruction, kRoundaboutExitStreetNamesTag, roundabout_exit_street_names);
-  boost::replace_all(instruction, kRoundaboutExitBeginStreetNamesTag,
-                     roundabout_exit_begin_street_names);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.enter_roundabout_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction,
+                {{PhraseTag::kOrdinalValue, ordinal_value},
+                 {PhraseTag::kStreetNames, street_names},
+                 {PhraseTag::kTowardSign, guide_sign},
+                 {PhraseTag::kRoundaboutExitStreetNames, roundabout_exit_street_names},
+                 {PhraseTag::kRoundaboutExitBeginStreetNames, roundabout_exit_begin_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3054,13 +3076,11 @@ std::string NarrativeBuilder::FormExitRoundaboutInstruction(Maneuver& maneuver,
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_roundabout_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.exit_roundabout_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kStreetNames, street_names},
+                              {PhraseTag::kBeginStreetNames, begin_street_names},
+                              {PhraseTag::kTowardSign, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3118,13 +3138,11 @@ std::string NarrativeBuilder::FormVerbalExitRoundaboutInstruction(Maneuver& mane
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_roundabout_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.exit_roundabout_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kStreetNames, street_names},
+                              {PhraseTag::kBeginStreetNames, begin_street_names},
+                              {PhraseTag::kTowardSign, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3168,13 +3186,11 @@ std::string NarrativeBuilder::FormEnterFerryInstruction(Maneuver& maneuver,
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_ferry_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kFerryLabelTag, ferry_label);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.enter_ferry_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kStreetNames, street_names},
+                              {PhraseTag::kFerryLabel, ferry_label},
+                              {PhraseTag::kTowardSign, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3235,13 +3251,11 @@ std::string NarrativeBuilder::FormVerbalEnterFerryInstruction(Maneuver& maneuver
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_ferry_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kFerryLabelTag, ferry_label);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.enter_ferry_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kStreetNames, street_names},
+                              {PhraseTag::kFerryLabel, ferry_label},
+                              {PhraseTag::kTowardSign, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3274,12 +3288,10 @@ std::string NarrativeBuilder::FormTransitConnectionStartInstruction(Maneuver& ma
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_connection_start_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.transit_connection_start_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kTransitPlatform, transit_stop},
+                              {PhraseTag::kStationLabel, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3312,13 +3324,10 @@ std::string NarrativeBuilder::FormVerbalTransitConnectionStartInstruction(Maneuv
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction =
-      dictionary_.transit_connection_start_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.transit_connection_start_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kTransitPlatform, transit_stop},
+                              {PhraseTag::kStationLabel, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3351,12 +3360,10 @@ std::string NarrativeBuilder::FormTransitConnectionTransferInstruction(Maneuver&
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_connection_transfer_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.transit_connection_transfer_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kTransitPlatform, transit_stop},
+                              {PhraseTag::kStationLabel, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3389,13 +3396,10 @@ std::string NarrativeBuilder::FormVerbalTransitConnectionTransferInstruction(Man
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction =
-      dictionary_.transit_connection_transfer_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.transit_connection_transfer_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kTransitPlatform, transit_stop},
+                              {PhraseTag::kStationLabel, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3428,13 +3432,10 @@ std::string NarrativeBuilder::FormTransitConnectionDestinationInstruction(Maneuv
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction =
-      dictionary_.transit_connection_destination_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.transit_connection_destination_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kTransitPlatform, transit_stop},
+                              {PhraseTag::kStationLabel, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3467,13 +3468,11 @@ std::string NarrativeBuilder::FormVerbalTransitConnectionDestinationInstruction(
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction =
-      dictionary_.transit_connection_destination_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase =
+      dictionary_.transit_connection_destination_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kTransitPlatform, transit_stop},
+                              {PhraseTag::kStationLabel, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3496,13 +3495,11 @@ std::string NarrativeBuilder::FormDepartInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.depart_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop_name);
-  boost::replace_all(instruction, kTimeTag,
-                     get_localized_time(maneuver.GetTransitDepartureTime(), dictionary_.GetLocale()));
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto time = get_localized_time(maneuver.GetTransitDepartureTime(), dictionary_.GetLocale());
+  const auto& phrase = dictionary_.depart_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kTransitPlatform, transit_stop_name},
+                              {PhraseTag::kTime, time}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3525,13 +3522,11 @@ std::string NarrativeBuilder::FormVerbalDepartInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.depart_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop_name);
-  boost::replace_all(instruction, kTimeTag,
-                     get_localized_time(maneuver.GetTransitDepartureTime(), dictionary_.GetLocale()));
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto time = get_localized_time(maneuver.GetTransitDepartureTime(), dictionary_.GetLocale());
+  const auto& phrase = dictionary_.depart_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kTransitPlatform, transit_stop_name},
+                              {PhraseTag::kTime, time}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3554,13 +3549,11 @@ std::string NarrativeBuilder::FormArriveInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.arrive_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop_name);
-  boost::replace_all(instruction, kTimeTag,
-                     get_localized_time(maneuver.GetTransitArrivalTime(), dictionary_.GetLocale()));
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto time = get_localized_time(maneuver.GetTransitArrivalTime(), dictionary_.GetLocale());
+  const auto& phrase = dictionary_.arrive_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kTransitPlatform, transit_stop_name},
+                              {PhraseTag::kTime, time}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3583,13 +3576,11 @@ std::string NarrativeBuilder::FormVerbalArriveInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.arrive_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop_name);
-  boost::replace_all(instruction, kTimeTag,
-                     get_localized_time(maneuver.GetTransitArrivalTime(), dictionary_.GetLocale()));
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto time = get_localized_time(maneuver.GetTransitArrivalTime(), dictionary_.GetLocale());
+  const auto& phrase = dictionary_.arrive_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kTransitPlatform, transit_stop_name},
+                              {PhraseTag::kTime, time}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3616,16 +3607,15 @@ std::string NarrativeBuilder::FormTransitInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver, dictionary_.transit_subset.empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
-  boost::replace_all(instruction, kTransitPlatformCountTag,
-                     std::to_string(stop_count)); // TODO: locale specific numerals
-  boost::replace_all(instruction, kTransitPlatformCountLabelTag, stop_count_label);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto transit_name =
+      FormTransitName(maneuver, dictionary_.transit_subset.empty_transit_name_labels);
+  const auto platform_count = std::to_string(stop_count); // TODO: locale specific numerals
+  const auto& phrase = dictionary_.transit_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kTransitName, transit_name},
+                              {PhraseTag::kTransitHeadSign, transit_headsign},
+                              {PhraseTag::kTransitPlatformCount, platform_count},
+                              {PhraseTag::kTransitPlatformCountLabel, stop_count_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3648,14 +3638,12 @@ std::string NarrativeBuilder::FormVerbalTransitInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver,
-                                     dictionary_.transit_verbal_subset.empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto transit_name =
+      FormTransitName(maneuver, dictionary_.transit_verbal_subset.empty_transit_name_labels);
+  const auto& phrase = dictionary_.transit_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kTransitName, transit_name},
+                              {PhraseTag::kTransitHeadSign, transit_headsign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3683,17 +3671,15 @@ std::string NarrativeBuilder::FormTransitRemainOnInstruction(Maneuver& maneuver)
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_remain_on_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver,
-                                     dictionary_.transit_remain_on_subset.empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
-  boost::replace_all(instruction, kTransitPlatformCountTag,
-                     std::to_string(stop_count)); // TODO: locale specific numerals
-  boost::replace_all(instruction, kTransitPlatformCountLabelTag, stop_count_label);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto transit_name =
+      FormTransitName(maneuver, dictionary_.transit_remain_on_subset.empty_transit_name_labels);
+  const auto platform_count = std::to_string(stop_count); // TODO: locale specific numerals
+  const auto& phrase = dictionary_.transit_remain_on_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kTransitName, transit_name},
+                              {PhraseTag::kTransitHeadSign, transit_headsign},
+                              {PhraseTag::kTransitPlatformCount, platform_count},
+                              {PhraseTag::kTransitPlatformCountLabel, stop_count_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3716,14 +3702,13 @@ std::string NarrativeBuilder::FormVerbalTransitRemainOnInstruction(Maneuver& man
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_remain_on_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver, dictionary_.transit_remain_on_verbal_subset
-                                                   .empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto transit_name =
+      FormTransitName(maneuver,
+                      dictionary_.transit_remain_on_verbal_subset.empty_transit_name_labels);
+  const auto& phrase = dictionary_.transit_remain_on_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kTransitName, transit_name},
+                              {PhraseTag::kTransitHeadSign, transit_headsign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3751,17 +3736,15 @@ std::string NarrativeBuilder::FormTransitTransferInstruction(Maneuver& maneuver)
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_transfer_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver,
-                                     dictionary_.transit_transfer_subset.empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
-  boost::replace_all(instruction, kTransitPlatformCountTag,
-                     std::to_string(stop_count)); // TODO: locale specific numerals
-  boost::replace_all(instruction, kTransitPlatformCountLabelTag, stop_count_label);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto transit_name =
+      FormTransitName(maneuver, dictionary_.transit_transfer_subset.empty_transit_name_labels);
+  const auto platform_count = std::to_string(stop_count); // TODO: locale specific numerals
+  const auto& phrase = dictionary_.transit_transfer_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kTransitName, transit_name},
+                              {PhraseTag::kTransitHeadSign, transit_headsign},
+                              {PhraseTag::kTransitPlatformCount, platform_count},
+                              {PhraseTag::kTransitPlatformCountLabel, stop_count_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3784,14 +3767,12 @@ std::string NarrativeBuilder::FormVerbalTransitTransferInstruction(Maneuver& man
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_transfer_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver, dictionary_.transit_transfer_verbal_subset
-                                                   .empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto transit_name =
+      FormTransitName(maneuver, dictionary_.transit_transfer_verbal_subset.empty_transit_name_labels);
+  const auto& phrase = dictionary_.transit_transfer_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kTransitName, transit_name},
+                              {PhraseTag::kTransitHeadSign, transit_headsign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3832,14 +3813,12 @@ std::string NarrativeBuilder::FormVerbalPostTransitionInstruction(Maneuver& mane
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.post_transition_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(maneuver, dictionary_.post_transition_verbal_subset.metric_lengths,
-                                dictionary_.post_transition_verbal_subset.us_customary_lengths));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto length = FormLength(maneuver, dictionary_.post_transition_verbal_subset.metric_lengths,
+                                 dictionary_.post_transition_verbal_subset.us_customary_lengths);
+  const auto& phrase = dictionary_.post_transition_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kLength, length},
+                              {PhraseTag::kStreetNames, street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3860,14 +3839,11 @@ std::string NarrativeBuilder::FormVerbalPostTransitionTransitInstruction(Maneuve
       FormTransitPlatformCountLabel(stop_count, dictionary_.post_transition_transit_verbal_subset
                                                     .transit_stop_count_labels);
 
-  // Set instruction to the determined tagged phrase
-  instruction =
-      dictionary_.post_transition_transit_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformCountTag,
-                     std::to_string(stop_count)); // TODO: locale specific numerals
-  boost::replace_all(instruction, kTransitPlatformCountLabelTag, stop_count_label);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto platform_count = std::to_string(stop_count); // TODO: locale specific numerals
+  const auto& phrase = dictionary_.post_transition_transit_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kTransitPlatformCount, platform_count},
+                              {PhraseTag::kTransitPlatformCountLabel, stop_count_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3911,14 +3887,12 @@ std::string NarrativeBuilder::FormVerbalSuccinctStartTransitionInstruction(Maneu
     phrase_id += 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.start_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kCardinalDirectionTag, cardinal_direction);
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(maneuver, dictionary_.start_verbal_subset.metric_lengths,
-                                dictionary_.start_verbal_subset.us_customary_lengths));
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto length = FormLength(maneuver, dictionary_.start_verbal_subset.metric_lengths,
+                                 dictionary_.start_verbal_subset.us_customary_lengths);
+  const auto& phrase = dictionary_.start_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kCardinalDirection, cardinal_direction},
+                              {PhraseTag::kLength, length}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3977,14 +3951,13 @@ NarrativeBuilder::FormVerbalSuccinctTurnTransitionInstruction(Maneuver& maneuver
                                                maneuver.verbal_formatter(), &markup_formatter_);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = subset->phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(), subset->relative_directions));
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto relative_direction =
+      FormRelativeTwoDirection(maneuver.type(), subset->relative_directions);
+  const auto& phrase = subset->templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kRelativeDirection, relative_direction},
+                              {PhraseTag::kJunctionName, junction_name},
+                              {PhraseTag::kTowardSign, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4023,15 +3996,13 @@ NarrativeBuilder::FormVerbalSuccinctUturnTransitionInstruction(Maneuver& maneuve
         maneuver.signs().GetJunctionNameString(element_max_count, limit_by_consecutive_count, delim,
                                                maneuver.verbal_formatter(), &markup_formatter_);
   }
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.uturn_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(),
-                                              dictionary_.uturn_verbal_subset.relative_directions));
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto relative_direction =
+      FormRelativeTwoDirection(maneuver.type(), dictionary_.uturn_verbal_subset.relative_directions);
+  const auto& phrase = dictionary_.uturn_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kRelativeDirection, relative_direction},
+                              {PhraseTag::kJunctionName, junction_name},
+                              {PhraseTag::kTowardSign, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4075,12 +4046,10 @@ NarrativeBuilder::FormVerbalSuccinctMergeTransitionInstruction(Maneuver& maneuve
                                  dictionary_.merge_verbal_subset.relative_directions);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.merge_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.merge_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kRelativeDirection, relative_direction},
+                              {PhraseTag::kTowardSign, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4123,12 +4092,10 @@ std::string NarrativeBuilder::FormVerbalSuccinctEnterRoundaboutTransitionInstruc
                                                         &markup_formatter_);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_roundabout_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kOrdinalValueTag, ordinal_value);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.enter_roundabout_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kOrdinalValue, ordinal_value},
+                              {PhraseTag::kTowardSign, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4159,10 +4126,9 @@ std::string NarrativeBuilder::FormVerbalSuccinctExitRoundaboutTransitionInstruct
                                                  maneuver.verbal_formatter(), &markup_formatter_);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_roundabout_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.exit_roundabout_verbal_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kTowardSign, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4188,11 +4154,9 @@ std::string NarrativeBuilder::FormElevatorInstruction(Maneuver& maneuver) {
     end_level = maneuver.end_level_ref();
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.elevator_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kLevelTag, end_level);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.elevator_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kLevel, end_level}});
 
   return instruction;
 }
@@ -4213,11 +4177,9 @@ std::string NarrativeBuilder::FormStepsInstruction(Maneuver& maneuver) {
     end_level = maneuver.end_level_ref();
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.steps_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kLevelTag, end_level);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.steps_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kLevel, end_level}});
 
   return instruction;
 }
@@ -4238,11 +4200,9 @@ std::string NarrativeBuilder::FormEscalatorInstruction(Maneuver& maneuver) {
     end_level = maneuver.end_level_ref();
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.escalator_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kLevelTag, end_level);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.escalator_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kLevel, end_level}});
 
   return instruction;
 }
@@ -4265,11 +4225,9 @@ std::string NarrativeBuilder::FormEnterBuildingInstruction(Maneuver& maneuver) {
     phrase_id += 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_building_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.enter_building_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kStreetNames, street_names}});
 
   return instruction;
 }
@@ -4292,11 +4250,9 @@ std::string NarrativeBuilder::FormExitBuildingInstruction(Maneuver& maneuver) {
     phrase_id += 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_building_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  // Set instruction to the determined tagged phrase and replace its tags with values
+  const auto& phrase = dictionary_.exit_building_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kStreetNames, street_names}});
 
   return instruction;
 }
@@ -4714,14 +4670,12 @@ std::string NarrativeBuilder::FormVerbalMultiCue(Maneuver& maneuver,
   if (maneuver.distant_verbal_multi_cue()) {
     phrase_id = 1;
   }
-  instruction = dictionary_.verbal_multi_cue_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kCurrentVerbalCueTag, first_verbal_cue);
-  boost::replace_all(instruction, kNextVerbalCueTag, second_verbal_cue);
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(maneuver, dictionary_.post_transition_verbal_subset.metric_lengths,
-                                dictionary_.post_transition_verbal_subset.us_customary_lengths));
+  const auto length = FormLength(maneuver, dictionary_.post_transition_verbal_subset.metric_lengths,
+                                 dictionary_.post_transition_verbal_subset.us_customary_lengths);
+  const auto& phrase = dictionary_.verbal_multi_cue_subset.templates.at(phrase_id);
+  phrase.Render(instruction, {{PhraseTag::kCurrentVerbalCue, first_verbal_cue},
+                              {PhraseTag::kNextVerbalCue, second_verbal_cue},
+                              {PhraseTag::kLength, length}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1,8 +1,10 @@
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -28,7 +30,16 @@ namespace valhalla {
 namespace odin {
 
 odin_worker_t::odin_worker_t(const boost::property_tree::ptree& config)
-    : service_worker_t(config), markup_formatter_(config) {
+    : service_worker_t(config), markup_formatter_(config),
+      response_cache_(ResponseCache::Get(config)) {
+  // 0 means one thread per core
+  auto leg_concurrency = config.get<unsigned int>("odin.leg_concurrency", 1);
+  if (leg_concurrency == 0) {
+    leg_concurrency = std::max(1u, std::thread::hardware_concurrency());
+  }
+  if (leg_concurrency > 1) {
+    leg_pool_ = std::make_shared<midgard::ThreadPool>(leg_concurrency - 1);
+  }
   // signal that the worker started successfully
   started();
 }
@@ -42,11 +53,17 @@ std::string odin_worker_t::narrate(Api& request) const {
 
   // get some annotated directions
   try {
-    odin::DirectionsBuilder().Build(request, markup_formatter_);
+    odin::DirectionsBuilder().Build(request, markup_formatter_, leg_pool_.get());
   } catch (...) { throw valhalla_exception_t{202}; }
 
   // serialize those to the proper format
-  return tyr::serializeDirections(request);
+  auto response = tyr::serializeDirections(request);
+
+  // keep it around if the request is one we cache
+  if (response_cache_) {
+    response_cache_->Store(request, response);
+  }
+  return response;
 }
 
 void odin_worker_t::status(Api&) const {
@@ -67,7 +84,7 @@ odin_worker_t::work(const std::list<zmq::message_t>& job,
                     const std::function<void()>& interrupt_function) {
   auto& info = *static_cast<prime_server::http_request_info_t*>(request_info);
   LOG_INFO("Got Odin Request " + std::to_string(info.id));
-  Api request;
+  Api& request = request_arena.create();
   prime_server::worker_t::result_t result{false, {}, {}};
   try {
     // Set the interrupt function
@@ -0,0 +1,211 @@
+#include "response_cache.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include "filesystem.h"
+#include "proto_conversions.h"
+
+namespace {
+
+// how often to look at the traffic tiles to see if theres a new snapshot
+constexpr std::chrono::seconds kTrafficCheckInterval{1};
+
+// when the tiles were last written, the same thing loki looks at to know its caches are stale
+time_t get_last_modified(const std::string& location) {
+  try {
+    return std::chrono::system_clock::to_time_t(filesystem::last_write_time(location));
+  } catch (...) {}
+  return 0;
+}
+
+// rough bookkeeping cost of an entry on top of its key and response
+constexpr size_t kEntryOverhead = 128;
+
+// the responses that only depend on the request, the graph and the traffic. pbf is left out
+// because it carries the request info along with it
+bool cacheable(const valhalla::Options& options) {
+  switch (options.action()) {
+    case valhalla::Options::route:
+    case valhalla::Options::optimized_route:
+    case valhalla::Options::sources_to_targets:
+      return options.format() != valhalla::Options::pbf;
+    default:
+      return false;
+  }
+}
+
+} // namespace
+
+namespace valhalla {
+
+std::shared_ptr<ResponseCache> ResponseCache::Get(const boost::property_tree::ptree& config) {
+  const auto max_bytes = config.get<size_t>("loki.response_cache.max_bytes", 0);
+  if (max_bytes == 0) {
+    return nullptr;
+  }
+  const auto max_age = config.get<uint32_t>("loki.response_cache.max_age", 60);
+  const auto bucket = config.get<uint32_t>("loki.response_cache.date_time_bucket", 60);
+
+  // the workers of a pipeline have to find the same cache so that what loki looks up is what thor
+  // or odin store, but a differently configured cache is a different cache
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::shared_ptr<ResponseCache>> caches;
+  const auto settings =
+      std::to_string(max_bytes) + '/' + std::to_string(max_age) + '/' + std::to_string(bucket);
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& cache = caches[settings];
+  if (!cache) {
+    cache = std::make_shared<ResponseCache>(max_bytes, max_age, bucket);
+  }
+  return cache;
+}
+
+ResponseCache::ResponseCache(size_t max_bytes, uint32_t max_age, uint32_t date_time_bucket)
+    : date_time_bucket_(std::max(date_time_bucket, 1u)),
+      entries_(0, max_bytes, std::chrono::seconds(max_age)) {
+}
+
+std::string ResponseCache::Key(const Api& api, const baldr::GraphReader& reader) const {
+  Options options = api.options();
+
+  // leaving now is the same request for a little while
+  const auto now = std::chrono::duration_cast<std::chrono::seconds>(
+      std::chrono::system_clock::now().time_since_epoch());
+  const auto bucket = "current@" + std::to_string(now.count() / date_time_bucket_);
+  if (options.date_time() == "current") {
+    options.set_date_time(bucket);
+  }
+  for (auto& location : *options.mutable_locations()) {
+    if (location.date_time() == "current") {
+      location.set_date_time(bucket);
+    }
+  }
+
+  // maps serialize in any order unless you ask for it to be deterministic
+  std::string key = reader.GetTileSetLocation();
+  key.push_back('\0');
+  {
+    google::protobuf::io::StringOutputStream stream(&key);
+    google::protobuf::io::CodedOutputStream coded(&stream);
+    coded.SetSerializationDeterministic(true);
+    options.SerializeToCodedStream(&coded);
+  }
+  return key;
+}
+
+void ResponseCache::Refresh(baldr::GraphReader& reader) {
+  const auto now = std::chrono::steady_clock::now();
+  const auto& location = reader.GetTileSetLocation();
+  const auto last_modified = get_last_modified(location);
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto found = tilesets_.find(location);
+  const bool replaced = found == tilesets_.end() || found->second.last_modified != last_modified;
+  if (!replaced && now - found->second.traffic_checked < kTrafficCheckInterval) {
+    return;
+  }
+
+  // looking at the tiles takes a while so we dont hold up everyone else while we do it. whoever
+  // comes along in the meantime keeps using what we had, so only we look this time around
+  auto& claimed = tilesets_[location];
+  claimed.traffic_checked = now;
+  auto tileset = claimed;
+  lock.unlock();
+  if (replaced) {
+    tileset.dataset_id = reader.GetDatasetId();
+    tileset.last_modified = last_modified;
+  }
+  tileset.traffic = reader.GetTrafficLastUpdate();
+  lock.lock();
+  auto& kept = tilesets_[location];
+  if (kept.traffic_checked != now) {
+    return;
+  }
+  kept = tileset;
+
+  // nothing computed on the tiles that were there before is any good now
+  if (replaced) {
+    const auto prefix = location + '\0';
+    entries_.erase_if([&prefix](const std::string& key, const entry_t&) {
+      return key.compare(0, prefix.size(), prefix) == 0;
+    });
+  }
+}
+
+bool ResponseCache::Lookup(Api& api, baldr::GraphReader& reader, std::string& response) {
+  if (!cacheable(api.options())) {
+    return false;
+  }
+
+  // the tiles are looked at when the worker cleans up, unless we have never seen them before
+  tileset_t tileset;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto found = tilesets_.find(reader.GetTileSetLocation());
+    if (found == tilesets_.end()) {
+      lock.unlock();
+      Refresh(reader);
+      lock.lock();
+      found = tilesets_.find(reader.GetTileSetLocation());
+    }
+    tileset = found->second;
+  }
+
+  auto key = Key(api, reader);
+  bool hit = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // anything computed on a different graph or traffic or thats just too old is useless
+    const auto* found = entries_.find_if(key, [&tileset](const entry_t& entry) {
+      return entry.dataset_id == tileset.dataset_id && entry.traffic == tileset.traffic;
+    });
+    if (found) {
+      response = found->response;
+      hit = true;
+    } else {
+      entries_.erase(key);
+    }
+  }
+
+  // remember what this would be stored under and that it was looked up
+  auto* info = api.mutable_info();
+  if (!hit) {
+    info->set_response_cache_key(std::move(key));
+    info->set_response_cache_dataset_id(tileset.dataset_id);
+    info->set_response_cache_traffic(tileset.traffic);
+  }
+  auto* stat = info->mutable_statistics()->Add();
+  stat->set_key(Options_Action_Enum_Name(api.options().action()) + ".info.response_cache." +
+                (hit ? "hit" : "miss"));
+  stat->set_value(1);
+  stat->set_type(count);
+  return hit;
+}
+
+void ResponseCache::Store(const Api& api, const std::string& response) {
+  const auto& key = api.info().response_cache_key();
+  if (key.empty()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.insert(key,
+                  {response, api.info().response_cache_dataset_id(),
+                   api.info().response_cache_traffic()},
+                  2 * key.size() + response.size() + kEntryOverhead);
+}
+
+size_t ResponseCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.bytes();
+}
+
+void ResponseCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+}
+
+} // namespace valhalla
@@ -1,14 +1,19 @@
 #include "skadi/sample.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstddef>
+#include <ctime>
 #include <fstream>
 #include <future>
 #include <limits>
 #include <list>
 #include <regex>
 #include <set>
+#include <sstream>
 #include <stdexcept>
+#include <thread>
 #include <unordered_map>
 
 #include <boost/optional.hpp>
@@ -50,35 +55,55 @@ uint64_t file_size(const std::string& file_name) {
   return rc == 0 ? s.st_size : -1;
 }
 
+time_t file_mtime(const std::string& file_name) {
+  struct stat s {};
+  int rc = stat(file_name.c_str(), &s);
+  return rc == 0 ? FS_MTIME(s) : -1;
+}
+
 } // namespace
 
 namespace valhalla {
 namespace skadi {
 
-enum class format_t { UNKNOWN = 0, RAW = 1, GZIP = 2, LZ4 = 3 };
+enum class format_t : uint8_t { UNKNOWN = 0, RAW = 1, GZIP = 2, LZ4 = 3 };
+
+// usages are pushed this far negative while an unpacked tile is being evicted so that anyone trying
+// to use it at the same time can tell and goes the slow way instead
+constexpr int EVICTING = std::numeric_limits<int>::min() / 2;
 
 class cache_item_t {
 private:
-  format_t format;
+  std::atomic<format_t> format;
   valhalla::midgard::mem_map<char> data;
-  int usages;
-  const char* unpacked;
+  // a copy of the compressed tile that was unpacked to disk, if there is one
+  valhalla::midgard::mem_map<char> unpacked_file;
+  std::atomic<int> usages;
+  std::atomic<const char*> unpacked;
 
 public:
   cache_item_t() : format(format_t::UNKNOWN), usages(0), unpacked(nullptr) {
   }
-  cache_item_t(cache_item_t&&) = default;
   ~cache_item_t() {
-    free((void*)unpacked);
+    // a tile unpacked to disk goes away with the mapping
+    if (!unpacked_file) {
+      free((void*)unpacked.load());
+    }
   }
 
+  // readers use the mapping without locking so a tile is only ever mapped once, the cache has to be
+  // locked while we do it
   bool init(const std::string& path, format_t format) {
+    if (get_format() != format_t::UNKNOWN) {
+      return false;
+    }
     auto size = file_size(path);
     if (format == format_t::RAW && size != HGT_BYTES) {
       return false;
     }
-    this->format = format;
     data.map(path, size, POSIX_MADV_SEQUENTIAL, true);
+    // readers dont lock so the format only changes once the data is there to be read
+    this->format.store(format, std::memory_order_release);
     return true;
   }
 
@@ -87,27 +112,50 @@ public:
   }
 
   inline format_t get_format() const {
-    return format;
+    return format.load(std::memory_order_acquire);
   }
 
-  inline int& get_usages() {
-    return usages;
+  // takes a reference to the unpacked tile without locking, null if its not unpacked or is being
+  // evicted. a non null result has to be released when its no longer used
+  inline const char* acquire_unpacked() {
+    if (usages.fetch_add(1, std::memory_order_acquire) >= 0) {
+      auto rv = unpacked.load(std::memory_order_acquire);
+      if (rv) {
+        return rv;
+      }
+    }
+    usages.fetch_sub(1, std::memory_order_release);
+    return nullptr;
   }
 
-  inline const char* get_unpacked() {
-    return unpacked;
+  // another reference to an unpacked tile someone already holds
+  inline void acquire() {
+    usages.fetch_add(1, std::memory_order_relaxed);
   }
 
-  inline const char* detach_unpacked() {
-    auto rv = unpacked;
-    unpacked = nullptr;
-    return rv;
+  inline void release() {
+    usages.fetch_sub(1, std::memory_order_release);
   }
 
-  bool unpack(const char* unpacked) {
-    this->unpacked = unpacked;
+  // only once the tile is completely unpacked can readers find it
+  inline void attach_unpacked(const char* unpacked) {
+    this->unpacked.store(unpacked, std::memory_order_release);
+  }
+
+  // takes the unpacked tile away so the memory can be reused, but only if nobody is using it
+  const char* evict() {
+    int expected = 0;
+    if (!usages.compare_exchange_strong(expected, EVICTING, std::memory_order_acquire)) {
+      return nullptr;
+    }
+    auto rv = unpacked.exchange(nullptr, std::memory_order_acq_rel);
+    // leaves any increments from readers that lost the race, they undo them themselves
+    usages.fetch_sub(EVICTING, std::memory_order_release);
+    return rv;
+  }
 
-    if (format == format_t::GZIP) {
+  bool unpack(char* unpacked) {
+    if (get_format() == format_t::GZIP) {
       // for setting where to read compressed data from
       auto src_func = [this](z_stream& s) -> void {
         s.next_in = static_cast<Byte*>(static_cast<void*>(data.get()));
@@ -115,8 +163,8 @@ public:
       };
 
       // for setting where to write the uncompressed data to
-      auto dst_func = [this](z_stream& s) -> int {
-        s.next_out = (Byte*)(this->unpacked);
+      auto dst_func = [unpacked](z_stream& s) -> int {
+        s.next_out = (Byte*)(unpacked);
         s.avail_out = HGT_BYTES;
         return Z_FINISH; // we know the output will hold all the input
       };
@@ -124,10 +172,10 @@ public:
       // we have to unzip it
       if (!baldr::inflate(src_func, dst_func)) {
         LOG_WARN("Corrupt gzip elevation data");
-        format = format_t::UNKNOWN;
+        format.store(format_t::UNKNOWN, std::memory_order_release);
         return false;
       }
-    } else if (format == format_t::LZ4) {
+    } else if (get_format() == format_t::LZ4) {
       LZ4F_decompressionContext_t decode;
       LZ4F_decompressOptions_t options;
       LZ4F_createDecompressionContext(&decode, LZ4F_VERSION);
@@ -138,12 +186,11 @@ public:
       size_t result;
 
       do {
-        result = LZ4F_decompress(decode, const_cast<char*>(this->unpacked), &dest_size, data.get(),
-                                 &src_size, &options);
+        result = LZ4F_decompress(decode, unpacked, &dest_size, data.get(), &src_size, &options);
         if (LZ4F_isError(result)) {
           LZ4F_freeDecompressionContext(decode);
           LOG_WARN("Corrupt lz4 elevation data");
-          format = format_t::UNKNOWN;
+          format.store(format_t::UNKNOWN, std::memory_order_release);
           return false;
         }
       } while (result != 0);
@@ -151,13 +198,69 @@ public:
       LZ4F_freeDecompressionContext(decode);
     } else {
       LOG_WARN("Corrupt elevation data of unknown type");
-      format = format_t::UNKNOWN;
+      format.store(format_t::UNKNOWN, std::memory_order_release);
       return false;
     }
 
     return true;
   }
 
+  // whether the file is a whole unpacked copy of the tile made since the compressed tile changed
+  bool is_unpacked_copy(const std::string& path) const {
+    auto source_time = file_mtime(data.name());
+    return source_time != -1 && file_size(path) == HGT_BYTES && file_mtime(path) >= source_time;
+  }
+
+  // unpacks the tile into a raw hgt file at the given path, unless an up to date copy is already
+  // there. it doesnt change anything readers can see so it can run without the lock
+  bool unpack_to(const std::string& path) {
+    if (!is_unpacked_copy(path)) {
+      auto dir = filesystem::path(path);
+      dir.replace_filename("");
+      if (!filesystem::exists(dir) && !filesystem::create_directories(dir)) {
+        return false;
+      }
+
+      // unpack next to where it goes so nobody, not even another process, sees half a tile
+      std::stringstream tmp;
+      tmp << path << ".tmp_" << std::this_thread::get_id();
+      try {
+        midgard::mem_map<char> raw;
+        raw.create(tmp.str(), HGT_BYTES);
+        if (!unpack(raw.get())) {
+          raw.unmap();
+          filesystem::remove(tmp.str());
+          return false;
+        }
+      } catch (const std::exception& e) {
+        LOG_WARN("Could not unpack elevation data to " + tmp.str() + ": " + e.what());
+        filesystem::remove(tmp.str());
+        return false;
+      }
+      if (!filesystem::rename(tmp.str(), path)) {
+        filesystem::remove(tmp.str());
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // maps an unpacked copy on disk and lets readers find it like a tile unpacked in memory, except
+  // that it is never evicted. the cache has to be locked while we do it
+  const char* attach_unpacked_file(const std::string& path) {
+    if (unpacked.load(std::memory_order_acquire) || !is_unpacked_copy(path)) {
+      return nullptr;
+    }
+    try {
+      unpacked_file.map(path, HGT_BYTES, POSIX_MADV_SEQUENTIAL, true);
+    } catch (const std::exception& e) {
+      LOG_WARN("Could not map unpacked elevation data " + path + ": " + e.what());
+      return nullptr;
+    }
+    attach_unpacked(unpacked_file.get());
+    return unpacked_file.get();
+  }
+
   static boost::optional<std::pair<uint16_t, format_t>> parse_hgt_name(const std::string& name) {
     std::smatch m;
     std::regex e(".*/([NS])([0-9]{2})([WE])([0-9]{3})\\.hgt(\\.(gz|lz4))?$");
@@ -198,10 +301,11 @@ public:
   tile_data() : c(nullptr), index(TILE_COUNT), reusable(false), data(nullptr) {
   }
 
-  tile_data(const tile_data& other) : c(nullptr) {
+  tile_data(const tile_data& other) : c(nullptr), reusable(false) {
     *this = other;
   }
 
+  // takes over a reference the caller already acquired for reusable tiles
   tile_data(cache_t* c, uint16_t index, bool reusable, const int16_t* data);
   ~tile_data();
   tile_data& operator=(const tile_data& other);
@@ -282,25 +386,17 @@ public:
 struct cache_t {
   // Cached tiles
   std::vector<cache_item_t> cache;
-  // Set of reusable tile indexes
+  // Set of reusable tile indexes, only ones that currently have an unpacked tile attached
   std::unordered_set<uint16_t> reusable;
   // Map of pending tiles. No matter how many requests received, only one inflate job per tile
   // started.
   std::unordered_map<uint16_t, std::shared_future<tile_data>> pending_tiles;
-  // Guards access to the pending_tiles
-  std::recursive_mutex mutex;
+  // Guards everything but looking up tiles that are already raw or unpacked, those are lock free
+  std::mutex mutex;
   // Elevation tile path
   std::string data_source;
-
-  void increment_usages(uint16_t index) {
-    std::lock_guard<std::recursive_mutex> lock(mutex);
-    cache[index].get_usages()++;
-  }
-
-  void decrement_usages(uint16_t index) {
-    std::lock_guard<std::recursive_mutex> lock(mutex);
-    cache[index].get_usages()--;
-  }
+  // Where to keep unpacked copies of compressed tiles on disk, if anywhere
+  std::string unpacked_dir;
 
   // no need for synchronization as size is constant(set in constructor
   // and never change after thatn)
@@ -317,94 +413,132 @@ bool cache_t::insert(int pos, const std::string& path, format_t format) {
   if (pos >= cache.size())
     return false;
 
-  std::lock_guard<std::recursive_mutex> lock(mutex);
+  std::lock_guard<std::mutex> lock(mutex);
   return cache[pos].init(path, format);
 }
 
 tile_data cache_t::source(uint16_t index) {
   // bail if it's out of bounds
-  if (index >= TILE_COUNT) {
+  if (index >= cache.size()) {
     return {};
   }
 
-  // if we don't have anything maybe it's lazy loaded
+  // most of the time its either raw or already unpacked and we dont need the lock at all
   auto& item = cache[index];
+  auto format = item.get_format();
+  if (format == format_t::RAW) {
+    return {this, index, false, (const int16_t*)item.get_data()};
+  }
+  if (format != format_t::UNKNOWN) {
+    auto unpacked = item.acquire_unpacked();
+    if (unpacked) {
+      return {this, index, true, (const int16_t*)unpacked};
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(mutex);
+
+  // someone else is already unpacking it so we wait for them, the item is theirs until they finish
+  auto it = pending_tiles.find(index);
+  if (it != pending_tiles.end()) {
+    auto future = it->second;
+    lock.unlock();
+    return future.get();
+  }
+
+  // if we don't have anything maybe it's lazy loaded
   if (item.get_data() == nullptr) {
     auto f = data_source + get_hgt_file_name(index);
     item.init(f, format_t::RAW);
   }
 
   // it wasn't in cache and when we tried to load it the file was of unknown type
-  if (item.get_format() == format_t::UNKNOWN) {
+  format = item.get_format();
+  if (format == format_t::UNKNOWN) {
     return {};
   }
 
   // we have it raw or we don't
-  if (item.get_format() == format_t::RAW) {
+  if (format == format_t::RAW) {
     return {this, index, false, (const int16_t*)item.get_data()};
   }
 
   // we were able to load it but the format wasn't RAW, which only leaves compressed formats
-  mutex.lock();
-  auto it = pending_tiles.find(index);
-  if (it != pending_tiles.end()) {
-    auto future = it->second;
-    mutex.unlock();
-    return future.get();
-  }
-
-  // item in cache is already unpacked
-  const char* unpacked = item.get_unpacked();
+  // and someone might have unpacked it while we waited for the lock
+  auto unpacked = item.acquire_unpacked();
   if (unpacked) {
-    auto rv = tile_data(this, index, true, (const int16_t*)unpacked);
-    mutex.unlock();
-    return rv;
+    return {this, index, true, (const int16_t*)unpacked};
   }
 
   std::promise<tile_data> promise;
-  it = pending_tiles.emplace(index, promise.get_future()).first;
-
-  if (reusable.size() >= UNPACKED_TILES_COUNT) {
-    for (auto i : reusable) {
-      if (cache[i].get_usages() <= 0) {
-        reusable.erase(i);
-        unpacked = cache[i].detach_unpacked();
-        break;
-      }
+  pending_tiles.emplace(index, promise.get_future());
+  tile_data rv;
+
+  // if we have somewhere to keep it we unpack it to disk once, or pick up the copy a previous run
+  // left there, and map it from then on
+  if (!unpacked_dir.empty()) {
+    auto path = unpacked_dir + get_hgt_file_name(index);
+    lock.unlock();
+    bool unpacked_to = item.unpack_to(path);
+    lock.lock();
+    auto unpacked = unpacked_to ? item.attach_unpacked_file(path) : nullptr;
+    if (unpacked) {
+      item.acquire();
+      rv = tile_data(this, index, true, (const int16_t*)unpacked);
     }
   }
-  if (!unpacked) {
-    unpacked = (char*)malloc(HGT_BYTES);
-  }
-  reusable.insert(index);
-  auto rv = tile_data(this, index, true, (const int16_t*)unpacked);
-  mutex.unlock();
 
-  if (!item.unpack(unpacked)) {
-    rv = tile_data();
+  // otherwise it goes into memory, reusing the memory of an unpacked tile nobody is using
+  if (!rv && item.get_format() != format_t::UNKNOWN) {
+    char* buffer = nullptr;
+    if (reusable.size() >= UNPACKED_TILES_COUNT) {
+      for (auto i = reusable.begin(); i != reusable.end(); ++i) {
+        buffer = const_cast<char*>(cache[*i].evict());
+        if (buffer) {
+          reusable.erase(i);
+          break;
+        }
+      }
+    }
+    if (!buffer) {
+      buffer = (char*)malloc(HGT_BYTES);
+    }
+    lock.unlock();
+
+    bool unpacked = item.unpack(buffer);
+
+    lock.lock();
+    if (unpacked) {
+      // one reference for the tile we return and then readers can find it
+      item.acquire();
+      item.attach_unpacked(buffer);
+      reusable.insert(index);
+      rv = tile_data(this, index, true, (const int16_t*)buffer);
+    } else {
+      free(buffer);
+    }
   }
 
-  mutex.lock();
   promise.set_value(rv);
-  pending_tiles.erase(it);
-  mutex.unlock();
+  pending_tiles.erase(index);
   return rv;
 }
 
 tile_data::tile_data(cache_t* c, uint16_t index, bool reusable, const int16_t* data)
     : c(c), data(data), index(index), reusable(reusable) {
-  if (reusable)
-    c->increment_usages(index);
 }
 
 tile_data::~tile_data() {
-  if (reusable)
-    c->decrement_usages(index);
+  if (c && reusable)
+    c->cache[index].release();
 }
 
 tile_data& tile_data::operator=(const tile_data& other) {
+  if (this == &other)
+    return *this;
+
   if (c && reusable)
-    c->decrement_usages(index);
+    c->cache[index].release();
 
   c = other.c;
   data = other.data;
@@ -412,12 +546,13 @@ tile_data& tile_data::operator=(const tile_data& other) {
   reusable = other.reusable;
 
   if (c && reusable)
-    c->increment_usages(index);
+    c->cache[index].acquire();
   return *this;
 }
 
 sample::sample(const boost::property_tree::ptree& pt)
-    : sample(pt.get<std::string>("additional_data.elevation", "")) {
+    : sample(pt.get<std::string>("additional_data.elevation", ""),
+             pt.get<std::string>("additional_data.elevation_unpacked", "")) {
   url_ = pt.get<std::string>("additional_data.elevation_url", "");
 
   auto max_concurrent_users = pt.get<size_t>("mjolnir.max_concurrent_reader_users", 1);
@@ -430,10 +565,10 @@ sample::sample(const boost::property_tree::ptree& pt)
   remote_path_ = pt.get<std::string>("additional_data.elevation_dir", "");
 }
 
-sample::sample(const std::string& data_source) {
+sample::sample(const std::string& data_source, const std::string& unpacked_dir) {
   // cache initialization logic moved to different a method
   // to make future constructor merging easier, see sample.h
-  cache_initialisation(data_source);
+  cache_initialisation(data_source, unpacked_dir);
 }
 
 sample::~sample() {
@@ -447,10 +582,7 @@ template <class coord_t> double sample::get(const coord_t& coord, tile_data& til
 
   // the caller can pass a cached tile, so we only fetch one if its not the one they already have
   if (index != tile.get_index()) {
-    {
-      std::lock_guard<std::mutex> _(cache_lck);
-      tile = cache_->source(index);
-    }
+    tile = cache_->source(index);
     if (!tile) {
       if (!fetch(index))
         return get_no_data_value();
@@ -476,12 +608,33 @@ template <class coord_t> double sample::get(const coord_t& coord) {
 }
 
 template <class coords_t> std::vector<double> sample::get_all(const coords_t& coords) {
-  std::vector<double> values;
-  values.reserve(coords.size());
+  // sample the coordinates a tile at a time so that each tile is looked up once no matter how the
+  // coordinates jump back and forth between tiles, they still come out in the order they went in
+  std::vector<const typename coords_t::value_type*> postings;
+  std::vector<std::pair<uint16_t, uint32_t>> order;
+  postings.reserve(coords.size());
+  order.reserve(coords.size());
+  for (const auto& coord : coords) {
+    order.emplace_back(get_tile_index(coord), postings.size());
+    postings.push_back(&coord);
+  }
+  if (!std::is_sorted(order.begin(), order.end())) {
+    std::sort(order.begin(), order.end());
+  }
 
+  std::vector<double> values(postings.size());
   tile_data tile;
-  for (const auto& coord : coords) {
-    values.emplace_back(get(coord, tile));
+  uint16_t missing = TILE_COUNT;
+  for (const auto& posting : order) {
+    // no need to look for a tile again that we just couldnt find
+    if (posting.first == missing) {
+      values[posting.second] = get_no_data_value();
+      continue;
+    }
+    values[posting.second] = get(*postings[posting.second], tile);
+    if (tile.get_index() != posting.first) {
+      missing = posting.first;
+    }
   }
 
   return values;
@@ -602,9 +755,10 @@ std::string get_hgt_file_name(uint16_t index) {
 }
 
 // we don't need lock as this method is called in constructor only
-void sample::cache_initialisation(const std::string& data_source) {
+void sample::cache_initialisation(const std::string& data_source, const std::string& unpacked_dir) {
   cache_ = std::make_unique<cache_t>();
   cache_->data_source = data_source;
+  cache_->unpacked_dir = unpacked_dir;
 
   // messy but needed
   while (cache_->data_source.size() &&
@@ -617,7 +771,7 @@ void sample::cache_initialisation(const std::string& data_source) {
     LOG_DEBUG("No elevation data_source was provided");
     return;
   }
-  cache_->cache.resize(TILE_COUNT);
+  cache_->cache = std::vector<cache_item_t>(TILE_COUNT);
 
   // check the directory for files that look like what we need
   auto files = filesystem::get_files(cache_->data_source);
@@ -626,10 +780,16 @@ void sample::cache_initialisation(const std::string& data_source) {
     auto data = cache_item_t::parse_hgt_name(f);
     if (data && data->second != format_t::UNKNOWN) {
       if (!cache_->insert(data->first, f, data->second)) {
-        LOG_WARN("Corrupt elevation data: " + f);
+        LOG_WARN("Corrupt or duplicate elevation data: " + f);
       }
     }
   }
+
+  // tiles unpacked by a previous run are picked up the first time they are used
+  while (cache_->unpacked_dir.size() &&
+         cache_->unpacked_dir.back() == filesystem::path::preferred_separator) {
+    cache_->unpacked_dir.pop_back();
+  }
 }
 
 double get_no_data_value() {
@@ -6,6 +6,7 @@
 #include "midgard/logging.h"
 #include "midgard/polyline2.h"
 #include "midgard/util.h"
+#include "tyr/serializers.h"
 
 using namespace rapidjson;
 using namespace valhalla::midgard;
@@ -47,9 +48,13 @@ std::string thor_worker_t::expansion(Api& request) {
     exp_props.insert(static_cast<Options_ExpansionProperties>(prop));
   }
 
+  // pbf output collects the same things into its own object on the side
+  const bool pbf = options.format() == Options::pbf;
+  Expansion expansion;
+
   // a lambda that the path algorithm can call to add stuff to the dom
   // route and isochrone produce different GeoJSON properties
-  auto track_expansion = [&dom, &opp_edges, &gen_factor, &skip_opps,
+  auto track_expansion = [&dom, &expansion, pbf, &opp_edges, &gen_factor, &skip_opps,
                           &exp_props](baldr::GraphReader& reader, baldr::GraphId edgeid,
                                       const char* algorithm = nullptr, const char* status = nullptr,
                                       const float duration = 0.f, const uint32_t distance = 0,
@@ -78,6 +83,30 @@ std::string thor_worker_t::expansion(Api& request) {
       std::reverse(shape.begin(), shape.end());
     Polyline2<PointLL>::Generalize(shape, gen_factor, {}, false);
 
+    if (pbf) {
+      tyr::to_pbf_coords(shape, *expansion.add_geometries()->mutable_coords());
+      if (algorithm) {
+        expansion.set_algorithm(algorithm);
+      }
+      if (!exp_props.size()) {
+        return;
+      }
+      if (exp_props.count(Options_ExpansionProperties_durations))
+        expansion.add_durations(static_cast<uint32_t>(duration));
+      if (exp_props.count(Options_ExpansionProperties_distances))
+        expansion.add_distances(distance);
+      if (exp_props.count(Options_ExpansionProperties_costs))
+        expansion.add_costs(static_cast<uint32_t>(cost));
+      if (exp_props.count(Options_ExpansionProperties_statuses))
+        expansion.add_edge_status(status && *status == 's'
+                                      ? Expansion::settled
+                                      : (status && *status == 'c' ? Expansion::connected
+                                                                  : Expansion::reached));
+      if (exp_props.count(Options_ExpansionProperties_edge_ids))
+        expansion.add_edge_ids(edgeid);
+      return;
+    }
+
     // make the geom
     auto& a = dom.GetAllocator();
     auto* coords = GetValueByPointer(dom, "/features/0/geometry/coordinates");
@@ -159,6 +188,10 @@ std::string thor_worker_t::expansion(Api& request) {
   isochrone_gen.set_track_expansion(nullptr);
 
   // serialize it
+  if (pbf) {
+    request.mutable_expansion()->Swap(&expansion);
+    return tyr::serializePbf(request);
+  }
   return to_string(dom, 5);
 }
 
@@ -37,6 +37,14 @@ std::string thor_worker_t::matrix(Api& request) {
 
   // lambdas to do the real work
   std::vector<TimeDistance> time_distances;
+  auto serialize = [&]() {
+    auto response = tyr::serializeMatrix(request, time_distances, distance_scale);
+    // keep it around if the request is one we cache
+    if (response_cache) {
+      response_cache->Store(request, response);
+    }
+    return response;
+  };
   auto costmatrix = [&]() {
     return costmatrix_.SourceToTarget(options.sources(), options.targets(), *reader, mode_costing,
                                       mode, max_matrix_distance.find(costing)->second);
@@ -52,7 +60,7 @@ std::string thor_worker_t::matrix(Api& request) {
         time_distance_bss_matrix_.SourceToTarget(options.sources(), options.targets(), *reader,
                                                  mode_costing, mode,
                                                  max_matrix_distance.find(costing)->second);
-    return tyr::serializeMatrix(request, time_distances, distance_scale);
+    return serialize();
   }
   switch (source_to_target_algorithm) {
     case SELECT_OPTIMAL:
@@ -83,7 +91,7 @@ std::string thor_worker_t::matrix(Api& request) {
       time_distances = timedistancematrix();
       break;
   }
-  return tyr::serializeMatrix(request, time_distances, distance_scale);
+  return serialize();
 }
 } // namespace thor
 } // namespace valhalla
@@ -1,5 +1,6 @@
 #include "thor/worker.h"
 #include <cstdint>
+#include <thread>
 
 #include "baldr/attributes_controller.h"
 #include "baldr/json.h"
@@ -355,6 +356,7 @@ void thor_worker_t::path_arrive_by(Api& api, const std::string& costing) {
   std::unordered_map<size_t, std::pair<EdgeTrimmingInfo, EdgeTrimmingInfo>> edge_trimming;
   std::vector<thor::PathInfo> path;
   std::vector<std::string> algorithms;
+  std::vector<leg_job_t> legs;
   const Options& options = api.options();
   valhalla::Trip& trip = *api.mutable_trip();
   trip.mutable_routes()->Reserve(options.alternates() + 1);
@@ -442,10 +444,10 @@ void thor_worker_t::path_arrive_by(Api& api, const std::string& costing) {
           route = trip.mutable_routes()->Add();
           route->mutable_legs()->Reserve(options.locations_size());
         }
-        auto& leg = *route->mutable_legs()->Add();
-        TripLegBuilder::Build(options, controller, *reader, mode_costing, path.begin(), path.end(),
-                              *origin, *destination, leg, algorithms, interrupt, edge_trimming,
-                              intermediates);
+        // The leg gets built once all the paths are found so that the legs can be built together
+        legs.push_back({route->mutable_legs()->Add(), std::move(path), *origin, *destination,
+                        algorithms, std::move(edge_trimming), std::move(intermediates),
+                        &*origin});
         path.clear();
         edge_trimming.clear();
       }
@@ -490,6 +492,7 @@ void thor_worker_t::path_arrive_by(Api& api, const std::string& costing) {
         edge_trimming.clear();
         path.clear();
         algorithms.clear();
+        legs.clear();
         trip.mutable_routes()->Clear();
         origin = ++correlated.rbegin();
         continue;
@@ -499,6 +502,8 @@ void thor_worker_t::path_arrive_by(Api& api, const std::string& costing) {
     }
     ++origin;
   }
+  // Build all the legs now that we have their paths
+  build_legs(legs, options);
   // Reverse the legs because protobuf only has adding to the end
   std::reverse(route->mutable_legs()->begin(), route->mutable_legs()->end());
   // assign changed locations
@@ -512,6 +517,7 @@ void thor_worker_t::path_depart_at(Api& api, const std::string& costing) {
   std::unordered_map<size_t, std::pair<EdgeTrimmingInfo, EdgeTrimmingInfo>> edge_trimming;
   std::vector<thor::PathInfo> path;
   std::vector<std::string> algorithms;
+  std::vector<leg_job_t> legs;
   const Options& options = api.options();
   valhalla::Trip& trip = *api.mutable_trip();
   trip.mutable_routes()->Reserve(options.alternates() + 1);
@@ -586,10 +592,10 @@ void thor_worker_t::path_depart_at(Api& api, const std::string& costing) {
           route = trip.mutable_routes()->Add();
           route->mutable_legs()->Reserve(options.locations_size());
         }
-        auto& leg = *route->mutable_legs()->Add();
-        thor::TripLegBuilder::Build(options, controller, *reader, mode_costing, path.begin(),
-                                    path.end(), *origin, *destination, leg, algorithms, interrupt,
-                                    edge_trimming, {std::next(origin), destination});
+        // The leg gets built once all the paths are found so that the legs can be built together
+        legs.push_back({route->mutable_legs()->Add(), std::move(path), *origin, *destination,
+                        algorithms, std::move(edge_trimming), {std::next(origin), destination},
+                        &*origin});
 
         path.clear();
         edge_trimming.clear();
@@ -635,6 +641,7 @@ void thor_worker_t::path_depart_at(Api& api, const std::string& costing) {
         edge_trimming.clear();
         path.clear();
         algorithms.clear();
+        legs.clear();
         trip.mutable_routes()->Clear();
         destination = ++correlated.begin();
         continue;
@@ -644,10 +651,43 @@ void thor_worker_t::path_depart_at(Api& api, const std::string& costing) {
     }
     ++destination;
   }
+  // Build all the legs now that we have their paths
+  build_legs(legs, options);
   // assign changed locations
   *api.mutable_options()->mutable_locations() = std::move(correlated);
 }
 
+void thor_worker_t::build_legs(std::vector<leg_job_t>& legs, const Options& options) {
+  // each task builds a contiguous run of the legs with its own reader. TripLegBuilder only calls
+  // const methods of the costing, none of the costings have mutable members and recosting makes a
+  // costing of its own, so the tasks can share mode_costing
+  const size_t concurrency =
+      std::min(leg_pool ? std::min(leg_pool->concurrency(), leg_readers.size()) : 1, legs.size());
+  const auto caller = std::this_thread::get_id();
+  auto work = [&](size_t i) {
+    auto& graphreader = leg_readers.empty() ? *reader : *leg_readers[i];
+    // only the thread the request came in on gets to check whether its been cancelled
+    const auto* interrupt_callback = std::this_thread::get_id() == caller ? interrupt : nullptr;
+    const auto end = legs.begin() + (i + 1) * legs.size() / concurrency;
+    for (auto job = legs.begin() + i * legs.size() / concurrency; job != end; ++job) {
+      TripLegBuilder::Build(options, controller, graphreader, mode_costing, job->path.begin(),
+                            job->path.end(), job->origin, job->destination, *job->leg,
+                            job->algorithms, interrupt_callback, job->edge_trimming,
+                            job->intermediates);
+    }
+  };
+  if (concurrency > 1) {
+    leg_pool->Run(concurrency, work);
+  } else if (concurrency == 1) {
+    work(0);
+  }
+
+  // building a leg resolves a 'current' date_time at its origin, which we need to keep
+  for (const auto& job : legs) {
+    job.correlated_origin->set_date_time(job.origin.date_time());
+  }
+}
+
 /**
  * offset a time in one timezone by some number of seconds to a time in another timezone
  *
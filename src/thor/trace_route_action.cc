@@ -58,6 +58,21 @@ void add_path_edge(valhalla::Location* l,
   // edge->set_minimum_reachability();
 }
 
+// the part of a session's trace we matched this time around doesnt line up with the shape that was
+// sent in so we swap in the matched points and mark where the legs start and end
+void shape_from_results(valhalla::Options& options, std::vector<meili::MatchResult>& results) {
+  results.front().is_break_point = results.back().is_break_point = true;
+  options.clear_shape();
+  for (const auto& result : results) {
+    auto* location = options.mutable_shape()->Add();
+    location->mutable_ll()->set_lng(result.lnglat.lng());
+    location->mutable_ll()->set_lat(result.lnglat.lat());
+    location->set_time(result.epoch_time);
+    location->set_type(result.is_break_point ? valhalla::Location::kBreak
+                                             : valhalla::Location::kVia);
+  }
+}
+
 } // namespace
 
 namespace valhalla {
@@ -184,7 +199,42 @@ thor_worker_t::map_match(Api& request) {
   int topk = request.options().action() == Options::trace_attributes
                  ? request.options().alternates() + 1
                  : 1;
-  auto topk_match_results = matcher->OfflineMatch(trace, topk);
+  std::vector<meili::MatchResults> topk_match_results;
+  const auto& transition_cache = matcher_factory.transition_cache();
+  const size_t hits = transition_cache ? transition_cache->hits() : 0;
+  const size_t misses = transition_cache ? transition_cache->misses() : 0;
+  const bool session = options.has_session_id_case() && options.action() == Options::trace_route &&
+                       options.shape_match() == ShapeMatch::map_snap;
+  if (session) {
+    // we only get back the part of the session's trace that wont change anymore
+    auto result = matcher->OnlineMatch(trace, options.session_end());
+    if (options.session_end()) {
+      match_sessions.Remove(options.session_id());
+    }
+    if (result.results.size() < 2 || result.segments.empty()) {
+      throw valhalla_exception_t{446};
+    }
+    shape_from_results(options, result.results);
+    topk_match_results.emplace_back(std::move(result));
+  } else {
+    topk_match_results = matcher->OfflineMatch(trace, topk);
+  }
+
+  // track how well the transition cache is doing
+  if (transition_cache) {
+    const auto& action = Options_Action_Enum_Name(options.action());
+    const auto prefix = action + ".info." + service_name() + ".transition_cache.";
+    auto add_statistic = [&request, &prefix](const std::string& name, double value,
+                                             StatisticType type) {
+      auto* stat = request.mutable_info()->mutable_statistics()->Add();
+      stat->set_key(prefix + name);
+      stat->set_value(value);
+      stat->set_type(type);
+    };
+    add_statistic("hit", transition_cache->hits() - hits, count);
+    add_statistic("miss", transition_cache->misses() - misses, count);
+    add_statistic("entries", transition_cache->size(), gauge);
+  }
 
   // Process each score/match result
   std::vector<std::tuple<float, float, std::vector<meili::MatchResult>>> map_match_results;
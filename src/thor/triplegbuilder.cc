@@ -33,6 +33,27 @@ using namespace valhalla::thor;
 
 namespace {
 
+/**
+ * Which of the larger groups of attributes were asked for. Scanning the controller for a category
+ * means looking at every attribute so we do it once per leg rather than for every edge. When a group
+ * isnt wanted we skip reading the tile data it comes from altogether, which for narrow filters on
+ * trace_attributes is most of the work. Legs that will be narrated need the intersecting edges and
+ * the turn lanes no matter what attributes were requested.
+ */
+struct requested_categories_t {
+  requested_categories_t(const AttributesController& controller, const bool narrated)
+      : shape_attributes(controller.category_attribute_enabled(kShapeAttributesCategory)),
+        edge_signs(controller.category_attribute_enabled(kEdgeSignCategory)),
+        intersecting_edges(narrated ||
+                           controller.category_attribute_enabled(kNodeIntersectingEdgeCategory)),
+        turn_lanes(narrated) {
+  }
+  bool shape_attributes;
+  bool edge_signs;
+  bool intersecting_edges;
+  bool turn_lanes;
+};
+
 uint32_t
 GetAdminIndex(const AdminInfo& admin_info,
               std::unordered_map<AdminInfo, uint32_t, AdminInfo::AdminInfoHasher>& admin_info_map,
@@ -161,6 +182,7 @@ valhalla::TripLeg_Closure* fetch_or_create_closure_annotation(TripLeg& leg) {
  * and where incidents occur along the edge. Also sets the various per shape point attributes
  * such as time, distance, speed. Also updates the incidents list on the edge with their shape indices
  * @param controller
+ * @param requested
  * @param tile
  * @param edge
  * @param shape
@@ -173,6 +195,7 @@ valhalla::TripLeg_Closure* fetch_or_create_closure_annotation(TripLeg& leg) {
  * @param incidents
  */
 void SetShapeAttributes(const AttributesController& controller,
+                        const requested_categories_t& requested,
                         const graph_tile_ptr& tile,
                         const graph_tile_ptr& end_node_tile,
                         const DirectedEdge* edge,
@@ -188,13 +211,12 @@ void SetShapeAttributes(const AttributesController& controller,
 
   // bail if nothing to do
   if (!cut_for_traffic && incidents.start_index == incidents.end_index &&
-      !controller.category_attribute_enabled(kShapeAttributesCategory)) {
+      !requested.shape_attributes) {
     return;
   }
 
   // initialize shape_attributes once
-  if (!leg.has_shape_attributes() &&
-      controller.category_attribute_enabled(kShapeAttributesCategory)) {
+  if (!leg.has_shape_attributes() && requested.shape_attributes) {
     leg.mutable_shape_attributes();
   }
 
@@ -776,6 +798,7 @@ void AddIntersectingEdges(const AttributesController& controller,
 /**
  * Add trip edge. (TODO more comments)
  * @param  controller         Controller to determine which attributes to set.
+ * @param  requested          Which groups of attributes the controller asks for.
  * @param  edge               Identifier of an edge within the tiled, hierarchical graph.
  * @param  trip_id            Trip Id (0 if not a transit edge).
  * @param  block_id           Transit block Id (0 if not a transit edge)
@@ -792,6 +815,7 @@ void AddIntersectingEdges(const AttributesController& controller,
  *
  */
 TripLeg_Edge* AddTripEdge(const AttributesController& controller,
+                          const requested_categories_t& requested,
                           const GraphId& edge,
                           const uint32_t trip_id,
                           const uint32_t block_id,
@@ -867,7 +891,7 @@ TripLeg_Edge* AddTripEdge(const AttributesController& controller,
 #endif
 
   // Set the signs (if the directed edge has sign information) and if requested
-  if (directededge->sign()) {
+  if (directededge->sign() && requested.edge_signs) {
     // Add the edge signs
     std::unordered_map<uint32_t, std::pair<uint8_t, std::string>> pronunciations;
     std::vector<SignInfo> edge_signs = graphtile->GetSigns(idx, pronunciations);
@@ -878,7 +902,7 @@ TripLeg_Edge* AddTripEdge(const AttributesController& controller,
   }
 
   // Process the named junctions at nodes
-  if (has_junction_name && start_tile) {
+  if (has_junction_name && start_tile && controller(kEdgeSignJunctionName)) {
     // Add the node signs
     std::unordered_map<uint32_t, std::pair<uint8_t, std::string>> pronunciations;
     std::vector<SignInfo> node_signs = start_tile->GetSigns(start_node_idx, pronunciations, true);
@@ -903,7 +927,7 @@ TripLeg_Edge* AddTripEdge(const AttributesController& controller,
   }
 
   // If turn lanes exist
-  if (directededge->turnlanes()) {
+  if (directededge->turnlanes() && requested.turn_lanes) {
     auto turnlanes = graphtile->turnlanes(idx);
     trip_edge->mutable_turn_lanes()->Reserve(turnlanes.size());
     for (auto tl : turnlanes) {
@@ -1458,6 +1482,9 @@ void TripLegBuilder::Build(
     tp_dest->set_side_of_street(GetTripLegSideOfStreet(end_sos));
   }
 
+  // Work out once which groups of attributes we need to bother with on each edge
+  const requested_categories_t requested(controller, options.action() != Options::trace_attributes);
+
   // Structures to process admins
   std::unordered_map<AdminInfo, uint32_t, AdminInfo::AdminInfoHasher> admin_info_map;
   std::vector<AdminInfo> admin_info_list;
@@ -1566,9 +1593,9 @@ void TripLegBuilder::Build(
 
     // Add edge to the trip node and set its attributes
     TripLeg_Edge* trip_edge =
-        AddTripEdge(controller, edge, edge_itr->trip_id, multimodal_builder.block_id, mode,
-                    travel_type, costing, directededge, node->drive_on_right(), trip_node, graphtile,
-                    time_info, startnode.id(), node->named_intersection(), start_tile,
+        AddTripEdge(controller, requested, edge, edge_itr->trip_id, multimodal_builder.block_id,
+                    mode, travel_type, costing, directededge, node->drive_on_right(), trip_node,
+                    graphtile, time_info, startnode.id(), node->named_intersection(), start_tile,
                     edge_itr->restriction_index);
 
     // some information regarding shape/length trimming
@@ -1700,8 +1727,8 @@ void TripLegBuilder::Build(
 
     graph_tile_ptr end_node_tile = graphtile;
     graphreader.GetGraphTile(directededge->endnode(), end_node_tile);
-    SetShapeAttributes(controller, graphtile, end_node_tile, directededge, trip_shape, begin_index,
-                       trip_path, trim_start_pct, trim_end_pct, edge_seconds,
+    SetShapeAttributes(controller, requested, graphtile, end_node_tile, directededge, trip_shape,
+                       begin_index, trip_path, trim_start_pct, trim_end_pct, edge_seconds,
                        costing->flow_mask() & kCurrentFlowMask, incidents);
 
     // Set begin shape index if requested
@@ -1720,7 +1747,7 @@ void TripLegBuilder::Build(
 
     // Add the intersecting edges at the node. Skip it if the node was an inner node (excluding start
     // node and end node) of a shortcut that was recovered.
-    if (startnode.Is_Valid() && !edge_itr->start_node_is_recovered) {
+    if (startnode.Is_Valid() && !edge_itr->start_node_is_recovered && requested.intersecting_edges) {
       AddIntersectingEdges(controller, start_tile, node, directededge, prev_de, prior_opp_local_index,
                            graphreader, trip_node);
     }
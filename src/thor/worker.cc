@@ -1,8 +1,10 @@
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -48,6 +50,26 @@ const std::unordered_map<std::string, float> kMaxDistances = {
 // a scale factor to apply to the score so that we bias towards closer results more
 constexpr float kDistanceScale = 10.f;
 
+// everything MapMatcherFactory::Create makes a matcher from, so that a session can tell whether a
+// request still wants the matcher it has
+std::string matcher_fingerprint(const Options& options) {
+  std::string fingerprint = std::to_string(options.costing_type());
+  auto costing = options.costings().find(options.costing_type());
+  if (costing != options.costings().cend()) {
+    fingerprint += costing->second.SerializeAsString();
+  }
+  auto add = [&fingerprint](bool has, float value) {
+    fingerprint.push_back(has);
+    fingerprint.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  };
+  add(options.has_search_radius_case(), options.search_radius());
+  add(options.has_turn_penalty_factor_case(), options.turn_penalty_factor());
+  add(options.has_gps_accuracy_case(), options.gps_accuracy());
+  add(options.has_breakage_distance_case(), options.breakage_distance());
+  add(options.has_interpolation_distance_case(), options.interpolation_distance());
+  return fingerprint;
+}
+
 #ifdef HAVE_HTTP
 std::string serialize_to_pbf(Api& request) {
   std::string buf;
@@ -72,7 +94,10 @@ thor_worker_t::thor_worker_t(const boost::property_tree::ptree& config,
       timedep_reverse(config.get_child("thor")), isochrone_gen(config.get_child("thor")),
       reader(graph_reader ? graph_reader
                           : std::make_shared<baldr::GraphReader>(config.get_child("mjolnir"))),
-      matcher_factory(config, reader), controller{} {
+      matcher_factory(config, reader),
+      match_sessions(config.get<size_t>("meili.sessions.max_sessions", 1024),
+                     config.get<uint32_t>("meili.sessions.max_idle", 300)),
+      controller{}, response_cache(ResponseCache::Get(config)) {
 
   // Select the matrix algorithm based on the conf file (defaults to
   // select_optimal if not present)
@@ -101,6 +126,21 @@ thor_worker_t::thor_worker_t(const boost::property_tree::ptree& config,
   max_timedep_distance =
       config.get<float>("service_limits.max_timedep_distance", kDefaultMaxTimeDependentDistance);
 
+  // the legs of a route can be built in parallel. each thread, including the one the request came
+  // in on, gets a reader of its own but they all share one tile cache. 0 means one thread per core
+  auto leg_concurrency = config.get<unsigned int>("thor.leg_concurrency", 1);
+  if (leg_concurrency == 0) {
+    leg_concurrency = std::max(1u, std::thread::hardware_concurrency());
+  }
+  if (leg_concurrency > 1) {
+    auto mjolnir = config.get_child("mjolnir");
+    mjolnir.put("global_synchronized_cache", true);
+    for (unsigned int i = 0; i < leg_concurrency; ++i) {
+      leg_readers.emplace_back(std::make_shared<baldr::GraphReader>(mjolnir));
+    }
+    leg_pool = std::make_shared<midgard::ThreadPool>(leg_concurrency - 1);
+  }
+
   // signal that the worker started successfully
   started();
 }
@@ -117,7 +157,7 @@ thor_worker_t::work(const std::list<zmq::message_t>& job,
   // get request info and make sure to record any metrics before we are done
   auto& info = *static_cast<prime_server::http_request_info_t*>(request_info);
   LOG_INFO("Got Thor Request " + std::to_string(info.id));
-  Api request;
+  Api& request = request_arena.create();
   prime_server::worker_t::result_t result{true, {}, {}};
   try {
     // crack open the original request
@@ -269,7 +309,18 @@ void thor_worker_t::parse_measurements(const Api& request) {
   // Create a matcher
   const auto& options = request.options();
   try {
-    matcher.reset(matcher_factory.Create(options));
+    // a session keeps its matcher around between requests
+    if (options.has_session_id_case() && options.action() == Options::trace_route &&
+        options.shape_match() == ShapeMatch::map_snap) {
+      matcher = match_sessions.Get(options.session_id(), matcher_fingerprint(options),
+                                   [this, &options]() { return matcher_factory.Create(options); });
+      // the session was started with other costing or matching options
+      if (!matcher) {
+        throw valhalla_exception_t{447};
+      }
+    } else {
+      matcher.reset(matcher_factory.Create(options));
+    }
   } catch (const std::invalid_argument& ex) { throw std::runtime_error(std::string(ex.what())); }
 
   // we require locations
@@ -320,6 +371,11 @@ void thor_worker_t::cleanup() {
   if (reader->OverCommitted()) {
     reader->Trim();
   }
+  for (const auto& leg_reader : leg_readers) {
+    if (leg_reader->OverCommitted()) {
+      leg_reader->Trim();
+    }
+  }
 }
 
 void thor_worker_t::set_interrupt(const std::function<void()>* interrupt_function) {
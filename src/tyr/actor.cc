@@ -1,6 +1,12 @@
 #include "tyr/actor.h"
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
 #include "baldr/rapidjson_utils.h"
 #include "loki/worker.h"
+#include "midgard/thread_pool.h"
 #include "odin/worker.h"
 #include "thor/worker.h"
 #include "tyr/serializers.h"
@@ -15,12 +21,14 @@ namespace tyr {
 
 struct actor_t::pimpl_t {
   pimpl_t(const boost::property_tree::ptree& config)
-      : reader(new baldr::GraphReader(config.get_child("mjolnir"))), loki_worker(config, reader),
-        thor_worker(config, reader), odin_worker(config) {
+      : config(config), reader(new baldr::GraphReader(config.get_child("mjolnir"))),
+        loki_worker(config, reader), thor_worker(config, reader), odin_worker(config),
+        response_cache(ResponseCache::Get(config)) {
   }
   pimpl_t(const boost::property_tree::ptree& config, baldr::GraphReader& graph_reader)
-      : reader(&graph_reader, [](baldr::GraphReader*) {}), loki_worker(config, reader),
-        thor_worker(config, reader), odin_worker(config) {
+      : config(config), reader(&graph_reader, [](baldr::GraphReader*) {}),
+        loki_worker(config, reader), thor_worker(config, reader), odin_worker(config),
+        response_cache(ResponseCache::Get(config)) {
   }
   void set_interrupts(const std::function<void()>* interrupt_function) {
     loki_worker.set_interrupt(interrupt_function);
@@ -32,10 +40,23 @@ struct actor_t::pimpl_t {
     thor_worker.cleanup();
     odin_worker.cleanup();
   }
+  // a cached response only has the options and info to go with it, so the callers that want the
+  // rest of the api filled out dont get one
+  bool cached(Api& api, bool wants_api, std::string& response) {
+    return !wants_api && response_cache && response_cache->Lookup(api, *reader, response);
+  }
+  boost::property_tree::ptree config;
   std::shared_ptr<baldr::GraphReader> reader;
   loki::loki_worker_t loki_worker;
   thor::thor_worker_t thor_worker;
   odin_worker_t odin_worker;
+  // the requests the caller doesnt want a copy of are allocated from here
+  request_arena_t request_arena;
+  std::shared_ptr<ResponseCache> response_cache;
+  // trace_batch keeps its threads and their actors around, so the matchers stay warm from one batch
+  // to the next
+  std::unique_ptr<midgard::ThreadPool> batch_pool;
+  std::vector<std::unique_ptr<actor_t>> batch_actors;
 };
 
 actor_t::actor_t(const boost::property_tree::ptree& config, bool auto_cleanup)
@@ -89,19 +110,23 @@ std::string
 actor_t::route(const std::string& request_str, const std::function<void()>* interrupt, Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
+  // if the caller doesn't want a copy we'll allocate one from our arena
+  const bool wants_api = api;
   if (!api) {
-    api = &dummy;
+    api = &pimpl->request_arena.create();
   }
   // parse the request
   ParseApi(request_str, Options::route, *api);
-  // check the request and locate the locations in the graph
-  pimpl->loki_worker.route(*api);
-  // route between the locations in the graph to find the best path
-  pimpl->thor_worker.route(*api);
-  // get some directions back from them and serialize
-  auto bytes = pimpl->odin_worker.narrate(*api);
+  // unless we just answered the same thing
+  std::string bytes;
+  if (!pimpl->cached(*api, wants_api, bytes)) {
+    // check the request and locate the locations in the graph
+    pimpl->loki_worker.route(*api);
+    // route between the locations in the graph to find the best path
+    pimpl->thor_worker.route(*api);
+    // get some directions back from them and serialize
+    bytes = pimpl->odin_worker.narrate(*api);
+  }
   // if they want you do to do the cleanup automatically
   if (auto_cleanup) {
     cleanup();
@@ -113,10 +138,9 @@ std::string
 actor_t::locate(const std::string& request_str, const std::function<void()>* interrupt, Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
+  // if the caller doesn't want a copy we'll allocate one from our arena
   if (!api) {
-    api = &dummy;
+    api = &pimpl->request_arena.create();
   }
   // parse the request
   ParseApi(request_str, Options::locate, *api);
@@ -133,17 +157,21 @@ std::string
 actor_t::matrix(const std::string& request_str, const std::function<void()>* interrupt, Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
+  // if the caller doesn't want a copy we'll allocate one from our arena
+  const bool wants_api = api;
   if (!api) {
-    api = &dummy;
+    api = &pimpl->request_arena.create();
   }
   // parse the request
   ParseApi(request_str, Options::sources_to_targets, *api);
-  // check the request and locate the locations in the graph
-  pimpl->loki_worker.matrix(*api);
-  // compute the matrix
-  auto json = pimpl->thor_worker.matrix(*api);
+  // unless we just answered the same thing
+  std::string json;
+  if (!pimpl->cached(*api, wants_api, json)) {
+    // check the request and locate the locations in the graph
+    pimpl->loki_worker.matrix(*api);
+    // compute the matrix
+    json = pimpl->thor_worker.matrix(*api);
+  }
   // if they want you do to do the cleanup automatically
   if (auto_cleanup) {
     cleanup();
@@ -156,19 +184,23 @@ std::string actor_t::optimized_route(const std::string& request_str,
                                      Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
+  // if the caller doesn't want a copy we'll allocate one from our arena
+  const bool wants_api = api;
   if (!api) {
-    api = &dummy;
+    api = &pimpl->request_arena.create();
   }
   // parse the request
   ParseApi(request_str, Options::optimized_route, *api);
-  // check the request and locate the locations in the graph
-  pimpl->loki_worker.matrix(*api);
-  // compute compute all pairs and then the shortest path through them all
-  pimpl->thor_worker.optimized_route(*api);
-  // get some directions back from them and serialize
-  auto bytes = pimpl->odin_worker.narrate(*api);
+  // unless we just answered the same thing
+  std::string bytes;
+  if (!pimpl->cached(*api, wants_api, bytes)) {
+    // check the request and locate the locations in the graph
+    pimpl->loki_worker.matrix(*api);
+    // compute compute all pairs and then the shortest path through them all
+    pimpl->thor_worker.optimized_route(*api);
+    // get some directions back from them and serialize
+    bytes = pimpl->odin_worker.narrate(*api);
+  }
   // if they want you do to do the cleanup automatically
   if (auto_cleanup) {
     cleanup();
@@ -180,10 +212,9 @@ std::string
 actor_t::isochrone(const std::string& request_str, const std::function<void()>* interrupt, Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
+  // if the caller doesn't want a copy we'll allocate one from our arena
   if (!api) {
-    api = &dummy;
+    api = &pimpl->request_arena.create();
   }
   // parse the request
   ParseApi(request_str, Options::isochrone, *api);
@@ -203,10 +234,9 @@ std::string actor_t::trace_route(const std::string& request_str,
                                  Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
+  // if the caller doesn't want a copy we'll allocate one from our arena
   if (!api) {
-    api = &dummy;
+    api = &pimpl->request_arena.create();
   }
   // parse the request
   ParseApi(request_str, Options::trace_route, *api);
@@ -228,10 +258,9 @@ std::string actor_t::trace_attributes(const std::string& request_str,
                                       Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
+  // if the caller doesn't want a copy we'll allocate one from our arena
   if (!api) {
-    api = &dummy;
+    api = &pimpl->request_arena.create();
   }
   // parse the request
   ParseApi(request_str, Options::trace_attributes, *api);
@@ -250,10 +279,9 @@ std::string
 actor_t::height(const std::string& request_str, const std::function<void()>* interrupt, Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
+  // if the caller doesn't want a copy we'll allocate one from our arena
   if (!api) {
-    api = &dummy;
+    api = &pimpl->request_arena.create();
   }
   // parse the request
   ParseApi(request_str, Options::height, *api);
@@ -271,10 +299,9 @@ std::string actor_t::transit_available(const std::string& request_str,
                                        Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
+  // if the caller doesn't want a copy we'll allocate one from our arena
   if (!api) {
-    api = &dummy;
+    api = &pimpl->request_arena.create();
   }
   // parse the request
   ParseApi(request_str, Options::transit_available, *api);
@@ -291,10 +318,9 @@ std::string
 actor_t::expansion(const std::string& request_str, const std::function<void()>* interrupt, Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
+  // if the caller doesn't want a copy we'll allocate one from our arena
   if (!api) {
-    api = &dummy;
+    api = &pimpl->request_arena.create();
   }
   // parse the request
   ParseApi(request_str, Options::expansion, *api);
@@ -317,10 +343,9 @@ std::string
 actor_t::centroid(const std::string& request_str, const std::function<void()>* interrupt, Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
+  // if the caller doesn't want a copy we'll allocate one from our arena
   if (!api) {
-    api = &dummy;
+    api = &pimpl->request_arena.create();
   }
   // parse the request
   ParseApi(request_str, Options::centroid, *api);
@@ -341,10 +366,9 @@ std::string
 actor_t::status(const std::string& request_str, const std::function<void()>* interrupt, Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
+  // if the caller doesn't want a copy we'll allocate one from our arena
   if (!api) {
-    api = &dummy;
+    api = &pimpl->request_arena.create();
   }
   // parse the request
   ParseApi(request_str, Options::status, *api);
@@ -363,5 +387,83 @@ actor_t::status(const std::string& request_str, const std::function<void()>* int
   return json;
 }
 
+size_t actor_t::trace_batch(std::istream& requests,
+                            Options::Action action,
+                            const std::function<void(size_t, bool, const std::string&)>& result,
+                            unsigned int concurrency) {
+  if (action != Options::trace_route && action != Options::trace_attributes) {
+    throw valhalla_exception_t{106};
+  }
+  if (concurrency == 0) {
+    concurrency = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  // every thread gets its own workers but they all share the same tile cache
+  if (pimpl->batch_actors.size() != concurrency) {
+    auto config = pimpl->config;
+    config.put("mjolnir.global_synchronized_cache", true);
+    pimpl->batch_pool.reset(new midgard::ThreadPool(concurrency - 1));
+    pimpl->batch_actors.clear();
+    for (unsigned int i = 0; i < concurrency; ++i) {
+      pimpl->batch_actors.emplace_back(new actor_t(config, true));
+    }
+  }
+
+  std::mutex input_lock, output_lock;
+  size_t line_count = 0;
+  size_t failed = 0;
+  auto work = [&](size_t thread) {
+    auto& actor = *pimpl->batch_actors[thread];
+    request_arena_t request_arena;
+    std::string request;
+    while (true) {
+      // grab the next request
+      size_t line;
+      {
+        std::lock_guard<std::mutex> lock(input_lock);
+        if (!std::getline(requests, request)) {
+          return;
+        }
+        line = line_count++;
+      }
+      if (request.find_first_not_of(" \t\r") == std::string::npos) {
+        continue;
+      }
+
+      // match it, failures dont stop the batch they just get reported
+      Api& api = request_arena.create();
+      std::string response;
+      bool success = true;
+      try {
+        response = action == Options::trace_route ? actor.trace_route(request, nullptr, &api)
+                                                  : actor.trace_attributes(request, nullptr, &api);
+        // each response goes on its own line so there is no room for bytes
+        if (api.options().format() == Options::pbf) {
+          throw valhalla_exception_t{169, std::string(" for a batch, use json")};
+        }
+      } catch (const valhalla_exception_t& e) {
+        response = serialize_error(e, api);
+        success = false;
+      } catch (const std::exception& e) {
+        response = serialize_error(valhalla_exception_t{499, std::string(e.what())}, api);
+        success = false;
+      }
+      // the actor only cleans up after itself when the request succeeds
+      if (!success) {
+        actor.cleanup();
+      }
+
+      // hand it back
+      std::lock_guard<std::mutex> lock(output_lock);
+      failed += !success;
+      result(line, success, response);
+    }
+  };
+
+  // the pool passes along anything that went wrong in one of the threads
+  pimpl->batch_pool->Run(concurrency, work);
+  return failed;
+}
+
 } // namespace tyr
 } // namespace valhalla
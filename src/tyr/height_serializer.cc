@@ -1,6 +1,7 @@
-#include <sstream>
+#include <string>
+#include <vector>
 
-#include "baldr/json.h"
+#include "baldr/rapidjson_utils.h"
 #include "skadi/sample.h"
 #include "tyr/serializers.h"
 
@@ -10,51 +11,60 @@ using namespace valhalla::baldr;
 
 namespace {
 
-json::ArrayPtr serialize_range_height(const std::vector<double>& ranges,
-                                      const std::vector<double>& heights,
-                                      const uint32_t precision,
-                                      const double no_data_value) {
-  auto array = json::array({});
+// about how many bytes each height needs in the json, enough to not have to grow
+constexpr size_t kBytesPerHeight = 32;
+
+void serialize_range_height(const std::vector<double>& ranges,
+                            const std::vector<double>& heights,
+                            const uint32_t precision,
+                            const double no_data_value,
+                            rapidjson::writer_wrapper_t& writer) {
+  writer.start_array("range_height");
   // for each posting
   auto range = ranges.cbegin();
 
   for (const auto height : heights) {
-    auto element = json::array({json::fixed_t{*range, 0}});
+    writer.start_array();
+    writer.fixed(*range, 0);
     if (height == no_data_value) {
-      element->push_back(nullptr);
+      writer(nullptr);
     } else {
-      element->push_back({json::fixed_t{height, precision}});
+      writer.fixed(height, precision);
     }
-    array->push_back(element);
+    writer.end_array();
     ++range;
   }
-  return array;
+  writer.end_array();
 }
 
-json::ArrayPtr serialize_height(const std::vector<double>& heights,
-                                const uint32_t precision,
-                                const double no_data_value) {
-  auto array = json::array({});
+void serialize_height(const std::vector<double>& heights,
+                      const uint32_t precision,
+                      const double no_data_value,
+                      rapidjson::writer_wrapper_t& writer) {
+  writer.start_array("height");
 
   for (const auto height : heights) {
     // add all heights's to an array
     if (height == no_data_value) {
-      array->push_back(nullptr);
+      writer(nullptr);
     } else {
-      array->push_back({json::fixed_t{height, precision}});
+      writer.fixed(height, precision);
     }
   }
 
-  return array;
+  writer.end_array();
 }
 
-json::ArrayPtr serialize_shape(const google::protobuf::RepeatedPtrField<valhalla::Location>& shape) {
-  auto array = json::array({});
+void serialize_shape(const google::protobuf::RepeatedPtrField<valhalla::Location>& shape,
+                     rapidjson::writer_wrapper_t& writer) {
+  writer.start_array("shape");
   for (const auto& p : shape) {
-    array->emplace_back(json::map(
-        {{"lon", json::fixed_t{p.ll().lng(), 6}}, {"lat", json::fixed_t{p.ll().lat(), 6}}}));
+    writer.start_object();
+    writer.fixed("lon", p.ll().lng(), 6);
+    writer.fixed("lat", p.ll().lat(), 6);
+    writer.end_object();
   }
-  return array;
+  writer.end_array();
 }
 
 } // namespace
@@ -68,35 +78,45 @@ namespace tyr {
   "range_height": [ [0,303], [8467,275], [25380,198] ]
 }
 */
-std::string serializeHeight(const Api& request,
+std::string serializeHeight(Api& request,
                             const std::vector<double>& heights,
                             const std::vector<double>& ranges) {
-  auto json = json::map({});
+  // the pbf just gets the numbers as they are
+  if (request.options().format() == Options::pbf) {
+    auto& height = *request.mutable_height();
+    height.mutable_heights()->Add(heights.begin(), heights.end());
+    height.mutable_ranges()->Add(ranges.begin(), ranges.end());
+    return serializePbf(request);
+  }
+
+  // write the json as we go, with room for all of it up front
+  const auto& options = request.options();
+  rapidjson::writer_wrapper_t writer(heights.size() * kBytesPerHeight + options.shape_size() * 48 +
+                                     options.encoded_polyline().size() + 256);
 
   // get the precision to use for returned heights
   uint32_t precision = request.options().height_precision();
 
+  writer.start_object();
   // get the distances between the postings
   if (ranges.size()) {
-    json = json::map({{"range_height", serialize_range_height(ranges, heights, precision,
-                                                              skadi::get_no_data_value())}});
+    serialize_range_height(ranges, heights, precision, skadi::get_no_data_value(), writer);
   } // just the postings
   else {
-    json = json::map({{"height", serialize_height(heights, precision, skadi::get_no_data_value())}});
+    serialize_height(heights, precision, skadi::get_no_data_value(), writer);
   }
+
   // send back the shape as well
-  if (request.options().has_encoded_polyline_case()) {
-    json->emplace("encoded_polyline", request.options().encoded_polyline());
+  if (options.has_encoded_polyline_case()) {
+    writer.dom_string("encoded_polyline", options.encoded_polyline());
   } else {
-    json->emplace("shape", serialize_shape(request.options().shape()));
+    serialize_shape(options.shape(), writer);
   }
-  if (request.options().has_id_case()) {
-    json->emplace("id", request.options().id());
+  if (options.has_id_case()) {
+    writer.dom_string("id", options.id());
   }
-
-  std::stringstream ss;
-  ss << *json;
-  return ss.str();
+  writer.end_object();
+  return writer.get_buffer();
 }
 } // namespace tyr
 } // namespace valhalla
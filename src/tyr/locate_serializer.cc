@@ -176,15 +176,61 @@ json::MapPtr serialize(const midgard::PointLL& ll, const std::string& reason, bo
 
   return m;
 }
+void serialize_pbf(Locate& locate,
+                   const std::vector<baldr::Location>& locations,
+                   const std::unordered_map<baldr::Location, PathLocation>& projections,
+                   GraphReader& reader) {
+  for (const auto& location : locations) {
+    auto* result = locate.add_results();
+    auto found = projections.find(location);
+    if (found == projections.cend()) {
+      result->mutable_location()->mutable_ll()->set_lng(location.latlng_.lng());
+      result->mutable_location()->mutable_ll()->set_lat(location.latlng_.lat());
+      continue;
+    }
+
+    // the candidates go in the correlation just like they do for the other actions
+    const auto& projection = found->second;
+    PathLocation::toPBF(projection, result->mutable_location(), reader);
+    std::unordered_set<uint64_t> nodes;
+    for (const auto& edge : projection.edges) {
+      auto tile = reader.GetGraphTile(edge.id);
+      if (!tile) {
+        result->add_way_ids(0);
+        continue;
+      }
+      const auto* directed_edge = tile->directededge(edge.id);
+      result->add_way_ids(tile->edgeinfo(directed_edge).wayid());
+
+      // and the node if we snapped to it
+      if (edge.end_node() && nodes.emplace(directed_edge->endnode()).second) {
+        GraphId node_id = directed_edge->endnode();
+        auto node_tile = reader.GetGraphTile(node_id);
+        if (!node_tile)
+          continue;
+        auto ll = node_tile->get_node_ll(node_id);
+        auto* node = result->add_nodes();
+        node->set_graph_id(node_id);
+        node->mutable_ll()->set_lng(ll.lng());
+        node->mutable_ll()->set_lat(ll.lat());
+      }
+    }
+  }
+}
 } // namespace
 
 namespace valhalla {
 namespace tyr {
 
-std::string serializeLocate(const Api& request,
+std::string serializeLocate(Api& request,
                             const std::vector<baldr::Location>& locations,
                             const std::unordered_map<baldr::Location, PathLocation>& projections,
                             GraphReader& reader) {
+  if (request.options().format() == Options::pbf) {
+    serialize_pbf(*request.mutable_locate(), locations, projections, reader);
+    return serializePbf(request);
+  }
+
   auto json = json::array({});
   for (const auto& location : locations) {
     try {
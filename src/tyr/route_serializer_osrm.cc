@@ -248,7 +248,7 @@ void route_summary(json::MapPtr& route, const valhalla::Api& api, bool imperial,
 }
 
 // Generate leg shape in geojson format.
-json::MapPtr geojson_shape(const std::vector<PointLL> shape) {
+json::MapPtr geojson_shape(const std::vector<PointLL>& shape) {
   auto geojson = json::map({});
   auto coords = json::array({});
   coords->reserve(shape.size());
@@ -261,36 +261,32 @@ json::MapPtr geojson_shape(const std::vector<PointLL> shape) {
   return geojson;
 }
 
-// Generate full shape of the route.
-std::vector<PointLL> full_shape(const valhalla::DirectionsRoute& directions,
-                                const valhalla::Options& options) {
-  // If just one leg and it we want polyline6 then we just return the encoded leg shape
-  if (directions.legs().size() == 1 && options.shape_format() == polyline6) {
-    return midgard::decode<std::vector<PointLL>>(directions.legs().begin()->shape());
-  }
-  // TODO: there is a tricky way to do this... since the end of each leg is the same as the
-  // beginning we essentially could just peel off the first encoded shape point of all the legs (but
-  // the first) this way we wouldn't really have to do any decoding (would be far faster). it might
-  // even be the case that the string length of the first number is a fixed length (which would be
-  // great!) have to have a look should make this a function in midgard probably so the logic is all
-  // in the same place
-  std::vector<PointLL> decoded;
-  for (const auto& leg : directions.legs()) {
-    auto decoded_leg = midgard::decode<std::vector<PointLL>>(leg.shape());
-    decoded.insert(decoded.end(), decoded.size() ? decoded_leg.begin() + 1 : decoded_leg.begin(),
-                   decoded_leg.end());
+// Generate full shape of the route from the already decoded leg shapes.
+std::vector<PointLL> full_shape(const std::vector<std::vector<PointLL>>& leg_shapes) {
+  // the end of each leg is the beginning of the next so we skip it
+  size_t size = 0;
+  for (const auto& leg_shape : leg_shapes) {
+    size += leg_shape.size();
+  }
+  std::vector<PointLL> shape;
+  shape.reserve(size);
+  for (const auto& leg_shape : leg_shapes) {
+    shape.insert(shape.end(), shape.size() ? leg_shape.begin() + 1 : leg_shape.begin(),
+                 leg_shape.end());
   }
-  return decoded;
+  return shape;
 }
 
 // Generate simplified shape of the route.
-std::vector<PointLL> simplified_shape(const valhalla::DirectionsRoute& directions) {
+std::vector<PointLL> simplified_shape(const valhalla::DirectionsRoute& directions,
+                                      const std::vector<std::vector<PointLL>>& leg_shapes) {
   Coordinate south_west(std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
   Coordinate north_east(std::numeric_limits<int>::min(), std::numeric_limits<int>::min());
   std::vector<PointLL> simple_shape;
   std::unordered_set<size_t> indices;
+  auto leg_shape = leg_shapes.begin();
   for (const auto& leg : directions.legs()) {
-    auto decoded_leg = midgard::decode<std::vector<PointLL>>(leg.shape());
+    const auto& decoded_leg = *leg_shape++;
     for (const auto& coord : decoded_leg) {
       south_west.lng = std::min(south_west.lng, toFixed(coord.lng()));
       south_west.lat = std::min(south_west.lat, toFixed(coord.lat()));
@@ -315,13 +311,19 @@ std::vector<PointLL> simplified_shape(const valhalla::DirectionsRoute& direction
 
 void route_geometry(json::MapPtr& route,
                     const valhalla::DirectionsRoute& directions,
+                    const std::vector<std::vector<PointLL>>& leg_shapes,
                     const valhalla::Options& options) {
   std::vector<PointLL> shape;
   if (options.has_generalize_case() && options.generalize() == 0.0f) {
-    shape = simplified_shape(directions);
+    shape = simplified_shape(directions, leg_shapes);
   } else if (!options.has_generalize_case() ||
              (options.has_generalize_case() && options.generalize() > 0.0f)) {
-    shape = full_shape(directions, options);
+    // If just one leg and we want polyline6 then the encoded leg shape is already the answer
+    if (directions.legs_size() == 1 && options.shape_format() == polyline6) {
+      route->emplace("geometry", directions.legs(0).shape());
+      return;
+    }
+    shape = full_shape(leg_shapes);
   }
   if (options.shape_format() == geojson) {
     route->emplace("geometry", geojson_shape(shape));
@@ -429,9 +431,79 @@ struct IntersectionEdges {
   }
 };
 
+// The parts of the intersections at every node of a leg that dont depend on the maneuver passing
+// through them. They are gathered in one pass over the trip leg before any step is serialized and
+// the sorted bearings of all the nodes share one array, so the steps dont have to walk their part
+// of the leg through heap allocated enhanced trip leg wrappers or sort anything themselves
+struct leg_intersections_t {
+  struct node_t {
+    // the range of bearings and entries of the edges at the node, sorted by bearing
+    uint32_t begin;
+    uint32_t end;
+    // which of those are the edges into and out of the node
+    uint32_t in;
+    uint32_t out;
+    // the first routeable rest or service area we pass at the node
+    const TripLeg_IntersectingEdge* rest_stop;
+  };
+  std::vector<node_t> nodes;
+  std::vector<uint32_t> bearings;
+  std::vector<bool> entries;
+
+  explicit leg_intersections_t(TripLeg& leg) : nodes(leg.node_size(), node_t{0, 0, 0, 0, nullptr}) {
+    bearings.reserve(leg.node_size() * 3);
+    entries.reserve(leg.node_size() * 3);
+    std::vector<IntersectionEdges> edges;
+    // there is no edge leaving the last node so it only ever gets an arrive intersection
+    for (int i = 0; i < leg.node_size() - 1; ++i) {
+      auto* node = leg.mutable_node(i);
+      const auto& curr_edge = node->edge();
+      auto& intersection = nodes[i];
+
+      // Get bearings and access to outgoing intersecting edges. Do not add
+      // any intersecting edges for the first depart intersection.
+      edges.clear();
+      edges.emplace_back(curr_edge.begin_heading(), true, false, true);
+      if (i > 0) {
+        for (int m = 0; m < node->intersecting_edge_size(); ++m) {
+          EnhancedTripLeg_IntersectingEdge intersecting_edge(node->mutable_intersecting_edge(m));
+          bool routeable = intersecting_edge.IsTraversableOutbound(curr_edge.travel_mode());
+          edges.emplace_back(intersecting_edge.begin_heading(), routeable, false, false);
+          if (routeable && !intersection.rest_stop &&
+              (intersecting_edge.use() == TripLeg_Use_kRestAreaUse ||
+               intersecting_edge.use() == TripLeg_Use_kServiceAreaUse)) {
+            intersection.rest_stop = &node->intersecting_edge(m);
+          }
+        }
+
+        // Add the incoming edge, it is not routeable
+        // TODO - what if a true U-turn - need to set it to routeable.
+        uint32_t prior_heading = leg.node(i - 1).edge().end_heading();
+        edges.emplace_back(((prior_heading + 180) % 360), false, true, false);
+      }
+
+      // Sort edges by increasing bearing and remember the in/out edge indexes
+      std::sort(edges.begin(), edges.end());
+      intersection.begin = bearings.size();
+      for (uint32_t n = 0; n < edges.size(); ++n) {
+        if (edges[n].in_edge) {
+          intersection.in = n;
+        }
+        if (edges[n].out_edge) {
+          intersection.out = n;
+        }
+        bearings.push_back(edges[n].bearing);
+        entries.push_back(edges[n].routeable);
+      }
+      intersection.end = bearings.size();
+    }
+  }
+};
+
 // Add intersections along a step/maneuver.
 json::ArrayPtr intersections(const valhalla::DirectionsLeg::Maneuver& maneuver,
-                             valhalla::odin::EnhancedTripLeg* etp,
+                             valhalla::TripLeg& leg,
+                             const leg_intersections_t& leg_intersections,
                              const std::vector<PointLL>& shape,
                              uint32_t& count,
                              const bool arrive_maneuver,
@@ -440,20 +512,20 @@ json::ArrayPtr intersections(const valhalla::DirectionsLeg::Maneuver& maneuver,
   count = 0;
   auto intersections = json::array({});
   uint32_t n = arrive_maneuver ? maneuver.end_path_index() + 1 : maneuver.end_path_index();
-  EnhancedTripLeg_Node* prev_node = nullptr;
+  intersections->reserve(n - maneuver.begin_path_index());
   for (uint32_t i = maneuver.begin_path_index(); i < n; i++) {
     auto intersection = json::map({});
 
-    // Get the node and current edge from the enhanced trip path
+    // Get the node and current edge from the trip path
     // NOTE: curr_edge does not exist for the arrive maneuver
-    auto node = etp->GetEnhancedNode(i);
-    auto curr_edge = etp->GetCurrEdge(i);
-    auto prev_edge = etp->GetPrevEdge(i);
+    const auto& node = leg.node(i);
+    const auto& curr_edge = node.edge();
+    const auto& precomputed = leg_intersections.nodes[i];
 
     // Add the node location (lon, lat). Use the last shape point for
     // the arrive step
     auto loc = json::array({});
-    size_t shape_index = arrive_maneuver ? shape.size() - 1 : curr_edge->begin_shape_index();
+    size_t shape_index = arrive_maneuver ? shape.size() - 1 : curr_edge.begin_shape_index();
     PointLL ll = shape[shape_index];
     loc->emplace_back(json::fixed_t{ll.lng(), 6});
     loc->emplace_back(json::fixed_t{ll.lat(), 6});
@@ -462,31 +534,28 @@ json::ArrayPtr intersections(const valhalla::DirectionsLeg::Maneuver& maneuver,
 
     // Add index into admin list
     if (controller(kNodeAdminIndex)) {
-      intersection->emplace("admin_index", static_cast<uint64_t>(node->admin_index()));
+      intersection->emplace("admin_index", static_cast<uint64_t>(node.admin_index()));
     }
 
     if (!arrive_maneuver && controller(kEdgeIsUrban)) {
-      intersection->emplace("is_urban", curr_edge->is_urban());
+      intersection->emplace("is_urban", curr_edge.is_urban());
     }
 
-    auto toll_collection = json::map({});
-    if (node->type() == TripLeg_Node::kTollBooth) {
-      toll_collection->emplace("type", std::string("toll_booth"));
-    } else if (node->type() == TripLeg_Node::kTollGantry) {
-      toll_collection->emplace("type", std::string("toll_gantry"));
+    if (node.type() == TripLeg_Node::kTollBooth) {
+      intersection->emplace("toll_collection", json::map({{"type", std::string("toll_booth")}}));
+    } else if (node.type() == TripLeg_Node::kTollGantry) {
+      intersection->emplace("toll_collection", json::map({{"type", std::string("toll_gantry")}}));
     }
-    if (!toll_collection->empty())
-      intersection->emplace("toll_collection", toll_collection);
 
-    if (node->cost().transition_cost().seconds() > 0)
+    if (node.cost().transition_cost().seconds() > 0)
       intersection->emplace("turn_duration",
-                            json::fixed_t{node->cost().transition_cost().seconds(), 3});
-    if (node->cost().transition_cost().cost() > 0)
-      intersection->emplace("turn_weight", json::fixed_t{node->cost().transition_cost().cost(), 3});
-    auto next_node = i + 1 < n ? etp->GetEnhancedNode(i + 1) : nullptr;
-    if (next_node) {
-      auto secs = next_node->cost().elapsed_cost().seconds() - node->cost().elapsed_cost().seconds();
-      auto cost = next_node->cost().elapsed_cost().cost() - node->cost().elapsed_cost().cost();
+                            json::fixed_t{node.cost().transition_cost().seconds(), 3});
+    if (node.cost().transition_cost().cost() > 0)
+      intersection->emplace("turn_weight", json::fixed_t{node.cost().transition_cost().cost(), 3});
+    if (i + 1 < n) {
+      const auto& next_node = leg.node(i + 1);
+      auto secs = next_node.cost().elapsed_cost().seconds() - node.cost().elapsed_cost().seconds();
+      auto cost = next_node.cost().elapsed_cost().cost() - node.cost().elapsed_cost().cost();
       if (secs > 0)
         intersection->emplace("duration", json::fixed_t{secs, 3});
       if (cost > 0)
@@ -496,90 +565,47 @@ json::ArrayPtr intersections(const valhalla::DirectionsLeg::Maneuver& maneuver,
     // TODO: add recosted durations to the intersection?
 
     // Add rest_stop when passing by a rest_area or service_area
-    if (i > 0 && !arrive_maneuver) {
+    if (i > 0 && !arrive_maneuver && precomputed.rest_stop) {
       auto rest_stop = json::map({});
-      for (uint32_t m = 0; m < node->intersecting_edge_size(); m++) {
-        auto intersecting_edge = node->GetIntersectingEdge(m);
-        bool routeable = intersecting_edge->IsTraversableOutbound(curr_edge->travel_mode());
-
-        std::string sign_text;
-        if (intersecting_edge->has_sign()) {
-          const valhalla::TripSign& trip_leg_sign = intersecting_edge->sign();
-          // I've looked at the results from guide_destinations(), destinations(), and
-          // exit_destinations(). exit_destinations() does not contain rest-area names.
-          // guide_destinations() and destinations() return the same string value for
-          // the rest area name. So I've decided to use guide_destinations().
-          sign_text = destinations(trip_leg_sign);
-        }
-
-        if (routeable && intersecting_edge->use() == TripLeg_Use_kRestAreaUse) {
-          rest_stop->emplace("type", std::string("rest_area"));
-          if (!sign_text.empty()) {
-            rest_stop->emplace("name", sign_text);
-          }
-          intersection->emplace("rest_stop", rest_stop);
-          break;
-        } else if (routeable && intersecting_edge->use() == TripLeg_Use_kServiceAreaUse) {
-          rest_stop->emplace("type", std::string("service_area"));
-          if (!sign_text.empty()) {
-            rest_stop->emplace("name", sign_text);
-          }
-          intersection->emplace("rest_stop", rest_stop);
-          break;
-        }
-      }
-    }
-
-    // Get bearings and access to outgoing intersecting edges. Do not add
-    // any intersecting edges for the first depart intersection and for
-    // the arrival step.
-    std::vector<IntersectionEdges> edges;
-
-    // Add the edge departing the node
-    if (!arrive_maneuver) {
-      edges.emplace_back(curr_edge->begin_heading(), true, false, true);
-      if (i > 0) {
-        for (uint32_t m = 0; m < node->intersecting_edge_size(); m++) {
-          auto intersecting_edge = node->GetIntersectingEdge(m);
-          bool routable = intersecting_edge->IsTraversableOutbound(curr_edge->travel_mode());
-          edges.emplace_back(intersecting_edge->begin_heading(), routable, false, false);
+      rest_stop->emplace("type", std::string(precomputed.rest_stop->use() == TripLeg_Use_kRestAreaUse
+                                                 ? "rest_area"
+                                                 : "service_area"));
+      // I've looked at the results from guide_destinations(), destinations(), and
+      // exit_destinations(). exit_destinations() does not contain rest-area names.
+      // guide_destinations() and destinations() return the same string value for
+      // the rest area name. So I've decided to use destinations().
+      if (precomputed.rest_stop->has_sign()) {
+        std::string sign_text = destinations(precomputed.rest_stop->sign());
+        if (!sign_text.empty()) {
+          rest_stop->emplace("name", sign_text);
         }
       }
+      intersection->emplace("rest_stop", rest_stop);
     }
 
-    // Add the incoming edge except for the first depart intersection.
-    // Set routable to false except for arrive.
-    // TODO - what if a true U-turn - need to set it to routeable.
-    if (i > 0) {
-      bool entry = (arrive_maneuver) ? true : false;
-      uint32_t prior_heading = prev_edge->end_heading();
-      edges.emplace_back(((prior_heading + 180) % 360), entry, true, false);
-    }
-
-    // Create bearing and entry output
+    // Create bearing and entry output. The arrival step only has the incoming
+    // edge, which is routable, and the depart intersection has no incoming edge
     auto bearings = json::array({});
     auto entries = json::array({});
-
-    // Sort edges by increasing bearing and update the in/out edge indexes
-    std::sort(edges.begin(), edges.end());
-    uint32_t incoming_index, outgoing_index;
-    for (uint32_t n = 0; n < edges.size(); ++n) {
-      if (edges[n].in_edge) {
-        incoming_index = n;
-      }
-      if (edges[n].out_edge) {
-        outgoing_index = n;
+    if (!arrive_maneuver) {
+      bearings->reserve(precomputed.end - precomputed.begin);
+      entries->reserve(precomputed.end - precomputed.begin);
+      for (uint32_t b = precomputed.begin; b < precomputed.end; ++b) {
+        bearings->emplace_back(static_cast<uint64_t>(leg_intersections.bearings[b]));
+        entries->emplace_back(static_cast<bool>(leg_intersections.entries[b]));
       }
-      bearings->emplace_back(static_cast<uint64_t>(edges[n].bearing));
-      entries->emplace_back(edges[n].routeable);
+    } else if (i > 0) {
+      uint32_t prior_heading = leg.node(i - 1).edge().end_heading();
+      bearings->emplace_back(static_cast<uint64_t>((prior_heading + 180) % 360));
+      entries->emplace_back(true);
     }
 
     // Add the index of the input edge and output edge
     if (i > 0) {
-      intersection->emplace("in", static_cast<uint64_t>(incoming_index));
+      intersection->emplace("in", static_cast<uint64_t>(arrive_maneuver ? 0 : precomputed.in));
     }
     if (!arrive_maneuver) {
-      intersection->emplace("out", static_cast<uint64_t>(outgoing_index));
+      intersection->emplace("out", static_cast<uint64_t>(precomputed.out));
     }
 
     intersection->emplace("entry", entries);
@@ -587,10 +613,10 @@ json::ArrayPtr intersections(const valhalla::DirectionsLeg::Maneuver& maneuver,
 
     // Add tunnel_name for tunnels
     if (!arrive_maneuver) {
-      if (curr_edge->tunnel() && !curr_edge->tagged_value().empty()) {
-        for (uint32_t t = 0; t < curr_edge->tagged_value().size(); ++t) {
-          if (curr_edge->tagged_value().Get(t).type() == TaggedValue_Type_kTunnel) {
-            intersection->emplace("tunnel_name", curr_edge->tagged_value().Get(t).value());
+      if (curr_edge.tunnel() && !curr_edge.tagged_value().empty()) {
+        for (uint32_t t = 0; t < curr_edge.tagged_value().size(); ++t) {
+          if (curr_edge.tagged_value().Get(t).type() == TaggedValue_Type_kTunnel) {
+            intersection->emplace("tunnel_name", curr_edge.tagged_value().Get(t).value());
           }
         }
       }
@@ -599,28 +625,23 @@ json::ArrayPtr intersections(const valhalla::DirectionsLeg::Maneuver& maneuver,
     // Add classes based on the first edge after the maneuver (not needed
     // for arrive maneuver).
     if (!arrive_maneuver) {
-      std::vector<std::string> classes;
-      if (curr_edge->tunnel()) {
-        classes.push_back("tunnel");
+      auto class_list = json::array({});
+      if (curr_edge.tunnel()) {
+        class_list->emplace_back(std::string("tunnel"));
       }
-      if (maneuver.portions_toll() || curr_edge->toll()) {
-        classes.push_back("toll");
+      if (maneuver.portions_toll() || curr_edge.toll()) {
+        class_list->emplace_back(std::string("toll"));
       }
-      if (curr_edge->road_class() == valhalla::RoadClass::kMotorway) {
-        classes.push_back("motorway");
+      if (curr_edge.road_class() == valhalla::RoadClass::kMotorway) {
+        class_list->emplace_back(std::string("motorway"));
       }
-      if (curr_edge->use() == TripLeg::Use::TripLeg_Use_kFerryUse) {
-        classes.push_back("ferry");
+      if (curr_edge.use() == TripLeg::Use::TripLeg_Use_kFerryUse) {
+        class_list->emplace_back(std::string("ferry"));
       }
-
-      if (curr_edge->destination_only()) {
-        classes.push_back("restricted");
+      if (curr_edge.destination_only()) {
+        class_list->emplace_back(std::string("restricted"));
       }
-      if (classes.size() > 0) {
-        auto class_list = json::array({});
-        for (const auto& cl : classes) {
-          class_list->emplace_back(cl);
-        }
+      if (!class_list->empty()) {
         intersection->emplace("classes", class_list);
       }
     }
@@ -628,68 +649,70 @@ json::ArrayPtr intersections(const valhalla::DirectionsLeg::Maneuver& maneuver,
     // Process turn lanes - which are stored on the previous edge to the node
     // Check if there is an active turn lane
     // Verify that turn lanes are not non-directional
-    if (prev_edge && (prev_edge->turn_lanes_size() > 0) && prev_edge->HasActiveTurnLane() &&
-        !prev_edge->HasNonDirectionalTurnLane()) {
-      auto lanes = json::array({});
-      for (const auto& turn_lane : prev_edge->turn_lanes()) {
-        auto lane = json::map({});
-        // Process 'valid' & 'active' flags
-        bool is_active = turn_lane.state() == TurnLane::kActive;
-        // an active lane is also valid
-        bool is_valid = is_active || turn_lane.state() == TurnLane::kValid;
-        lane->emplace("active", is_active);
-        lane->emplace("valid", is_valid);
-        // Add valid_indication for a valid & active lanes
-        if (turn_lane.state() != TurnLane::kInvalid) {
-          lane->emplace("valid_indication", turn_lane_direction(turn_lane.active_direction()));
-        }
+    if (i > 0 && leg.node(i - 1).edge().turn_lanes_size() > 0) {
+      EnhancedTripLeg_Edge prev_edge(leg.mutable_node(i - 1)->mutable_edge());
+      if (prev_edge.HasActiveTurnLane() && !prev_edge.HasNonDirectionalTurnLane()) {
+        auto lanes = json::array({});
+        for (const auto& turn_lane : prev_edge.turn_lanes()) {
+          auto lane = json::map({});
+          // Process 'valid' & 'active' flags
+          bool is_active = turn_lane.state() == TurnLane::kActive;
+          // an active lane is also valid
+          bool is_valid = is_active || turn_lane.state() == TurnLane::kValid;
+          lane->emplace("active", is_active);
+          lane->emplace("valid", is_valid);
+          // Add valid_indication for a valid & active lanes
+          if (turn_lane.state() != TurnLane::kInvalid) {
+            lane->emplace("valid_indication", turn_lane_direction(turn_lane.active_direction()));
+          }
 
-        // Process 'indications' array - add indications from left to right
-        auto indications = json::array({});
-        uint16_t mask = turn_lane.directions_mask();
+          // Process 'indications' array - add indications from left to right
+          auto indications = json::array({});
+          uint16_t mask = turn_lane.directions_mask();
 
-        // TODO make map for lane mask to osrm indication string
+          // TODO make map for lane mask to osrm indication string
 
-        // reverse (left u-turn)
-        if (mask & kTurnLaneReverse && prev_edge->drive_on_right()) {
-          indications->emplace_back(osrmconstants::kModifierUturn);
-        }
-        // sharp_left
-        if (mask & kTurnLaneSharpLeft) {
-          indications->emplace_back(osrmconstants::kModifierSharpLeft);
-        }
-        // left
-        if (mask & kTurnLaneLeft) {
-          indications->emplace_back(osrmconstants::kModifierLeft);
-        }
-        // slight_left
-        if (mask & kTurnLaneSlightLeft) {
-          indications->emplace_back(osrmconstants::kModifierSlightLeft);
-        }
-        // through
-        if (mask & kTurnLaneThrough) {
-          indications->emplace_back(osrmconstants::kModifierStraight);
-        }
-        // slight_right
-        if (mask & kTurnLaneSlightRight) {
-          indications->emplace_back(osrmconstants::kModifierSlightRight);
-        }
-        // right
-        if (mask & kTurnLaneRight) {
-          indications->emplace_back(osrmconstants::kModifierRight);
-        }
-        // sharp_right
-        if (mask & kTurnLaneSharpRight) {
-          indications->emplace_back(osrmconstants::kModifierSharpRight);
-        }
-        // reverse (right u-turn)
-        if (mask & kTurnLaneReverse && !prev_edge->drive_on_right()) {
-          indications->emplace_back(osrmconstants::kModifierUturn);
+          // reverse (left u-turn)
+          if (mask & kTurnLaneReverse && prev_edge.drive_on_right()) {
+            indications->emplace_back(osrmconstants::kModifierUturn);
+          }
+          // sharp_left
+          if (mask & kTurnLaneSharpLeft) {
+            indications->emplace_back(osrmconstants::kModifierSharpLeft);
+          }
+          // left
+          if (mask & kTurnLaneLeft) {
+            indications->emplace_back(osrmconstants::kModifierLeft);
+          }
+          // slight_left
+          if (mask & kTurnLaneSlightLeft) {
+            indications->emplace_back(osrmconstants::kModifierSlightLeft);
+          }
+          // through
+          if (mask & kTurnLaneThrough) {
+            indications->emplace_back(osrmconstants::kModifierStraight);
+          }
+          // slight_right
+          if (mask & kTurnLaneSlightRight) {
+            indications->emplace_back(osrmconstants::kModifierSlightRight);
+          }
+          // right
+          if (mask & kTurnLaneRight) {
+            indications->emplace_back(osrmconstants::kModifierRight);
+          }
+          // sharp_right
+          if (mask & kTurnLaneSharpRight) {
+            indications->emplace_back(osrmconstants::kModifierSharpRight);
+          }
+          // reverse (right u-turn)
+          if (mask & kTurnLaneReverse && !prev_edge.drive_on_right()) {
+            indications->emplace_back(osrmconstants::kModifierUturn);
+          }
+          lane->emplace("indications", std::move(indications));
+          lanes->emplace_back(std::move(lane));
         }
-        lane->emplace("indications", std::move(indications));
-        lanes->emplace_back(std::move(lane));
+        intersection->emplace("lanes", std::move(lanes));
       }
-      intersection->emplace("lanes", std::move(lanes));
     }
 
     // Add the intersection to the JSON array
@@ -1210,17 +1233,26 @@ void maneuver_geometry(json::MapPtr& step,
                        bool is_arrive_maneuver,
                        const valhalla::Options& options) {
   // Must add one to the end range since maneuver end shape index is exclusive
-  std::vector<PointLL> maneuver_shape(shape.begin() + begin_idx, shape.begin() + end_idx + 1);
-  // Last maneuver shape is a linestring with two identical points at the destination
-  if (is_arrive_maneuver) {
-    maneuver_shape.push_back(shape.back());
-  }
+  const auto begin = shape.begin() + begin_idx;
+  const auto end = shape.begin() + end_idx + 1;
 
   if (options.shape_format() == geojson) {
+    std::vector<PointLL> maneuver_shape(begin, end);
+    // Last maneuver shape is a linestring with two identical points at the destination
+    if (is_arrive_maneuver) {
+      maneuver_shape.push_back(shape.back());
+    }
     step->emplace("geometry", geojson_shape(maneuver_shape));
   } else {
+    // Encode the range in place rather than copying it out of the leg shape first
     int precision = options.shape_format() == polyline6 ? 1e6 : 1e5;
-    step->emplace("geometry", midgard::encode(maneuver_shape, precision));
+    std::string geometry;
+    midgard::encode(begin, end, geometry, precision);
+    // The repeated destination point of the arrive maneuver is an offset of zero in both axes
+    if (is_arrive_maneuver) {
+      geometry += "??";
+    }
+    step->emplace("geometry", std::move(geometry));
   }
 }
 
@@ -1312,6 +1344,7 @@ std::string get_pronunciations(const valhalla::DirectionsLeg::Maneuver& maneuver
 
 // Serialize each leg
 json::ArrayPtr serialize_legs(const google::protobuf::RepeatedPtrField<valhalla::DirectionsLeg>& legs,
+                              const std::vector<std::vector<PointLL>>& leg_shapes,
                               const std::vector<std::string>& leg_summaries,
                               google::protobuf::RepeatedPtrField<valhalla::TripLeg>& path_legs,
                               bool imperial,
@@ -1336,7 +1369,10 @@ json::ArrayPtr serialize_legs(const google::protobuf::RepeatedPtrField<valhalla:
 
     // Get the full shape for the leg. We want to use this for serializing
     // encoded shape for each step (maneuver) in OSRM output.
-    auto shape = midgard::decode<std::vector<PointLL>>(leg->shape());
+    const auto& shape = leg_shapes[leg_index];
+
+    // Gather what the intersections of all the steps need in one go over the leg
+    leg_intersections_t leg_intersections(path_leg);
 
     //#########################################################################
     // Iterate through maneuvers - convert to OSRM steps
@@ -1501,8 +1537,9 @@ json::ArrayPtr serialize_legs(const google::protobuf::RepeatedPtrField<valhalla:
       }
 
       // Add intersections
-      step->emplace("intersections", intersections(maneuver, &etp, shape, prev_intersection_count,
-                                                   arrive_maneuver, controller));
+      step->emplace("intersections",
+                    intersections(maneuver, path_leg, leg_intersections, shape,
+                                  prev_intersection_count, arrive_maneuver, controller));
 
       // Add step
       prev_rotary = rotary;
@@ -1708,14 +1745,22 @@ std::string serialize(valhalla::Api& api) {
     // Add linear references, if applicable
     route_references(route, api.trip().routes(i), options);
 
+    // Decode the shape of every leg once, the route geometry and the steps are both cut from it
+    std::vector<std::vector<PointLL>> leg_shapes;
+    leg_shapes.reserve(api.directions().routes(i).legs_size());
+    for (const auto& leg : api.directions().routes(i).legs()) {
+      leg_shapes.emplace_back(midgard::decode<std::vector<PointLL>>(leg.shape()));
+    }
+
     // Concatenated route geometry
-    route_geometry(route, api.directions().routes(i), options);
+    route_geometry(route, api.directions().routes(i), leg_shapes, options);
 
     // Other route summary information
     route_summary(route, api, imperial, i);
 
     // Serialize route legs
-    route->emplace("legs", serialize_legs(api.directions().routes(i).legs(), route_leg_summaries[i],
+    route->emplace("legs", serialize_legs(api.directions().routes(i).legs(), leg_shapes,
+                                          route_leg_summaries[i],
                                           *api.mutable_trip()->mutable_routes(i)->mutable_legs(),
                                           imperial, options, controller));
 
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <functional>
+#include <unordered_map>
+
 #include "proto/directions.pb.h"
 #include "proto/options.pb.h"
 #include "proto/trip.pb.h"
@@ -100,17 +103,20 @@ public:
       leg_segs_by_dist.reserve(route.legs_size());
       for (size_t j = 0; j < route.legs_size(); j++) {
         const DirectionsLeg& leg = route.legs(j);
-        std::unordered_map<std::string, std::pair<uint32_t, float>> maneuver_summary_map;
+        // keyed on the names in the maneuvers themselves so we only copy them once below
+        std::unordered_map<std::reference_wrapper<const std::string>, std::pair<uint32_t, float>,
+                           std::hash<std::string>, std::equal_to<std::string>>
+            maneuver_summary_map;
         maneuver_summary_map.reserve(leg.maneuver_size());
         uint32_t maneuver_index = 0;
         for (const auto& maneuver : leg.maneuver()) {
           if (maneuver.street_name_size() > 0) {
             const std::string& name = maneuver.street_name(0).value();
-            auto maneuver_summary = maneuver_summary_map.find(name);
-            if (maneuver_summary == maneuver_summary_map.end()) {
-              maneuver_summary_map[name] = std::make_pair(maneuver_index, maneuver.length());
-            } else {
-              maneuver_summary->second.second += maneuver.length();
+            auto inserted = maneuver_summary_map.emplace(std::cref(name),
+                                                         std::make_pair(maneuver_index,
+                                                                        maneuver.length()));
+            if (!inserted.second) {
+              inserted.first->second.second += maneuver.length();
             }
           }
           ++maneuver_index;
@@ -121,7 +127,8 @@ public:
         std::vector<NamedSegment> segs_by_dist;
         segs_by_dist.reserve(maneuver_summary_map.size());
         for (const auto& map_item : maneuver_summary_map) {
-          segs_by_dist.emplace_back(map_item.first, map_item.second.first, map_item.second.second);
+          segs_by_dist.emplace_back(map_item.first.get(), map_item.second.first,
+                                    map_item.second.second);
         }
 
         // Sort list by descending maneuver distance
@@ -168,17 +175,19 @@ public:
   // The summary returned is guaranteed to be comprised of as few named
   // segments as possible, while also being unique among all route/same-leg
   // summaries.
-  std::string get_n_segment_summary(size_t route_idx, size_t leg_idx, size_t num_named_segs) {
+  const std::string&
+  get_n_segment_summary(size_t route_idx, size_t leg_idx, size_t num_named_segs) {
+    static const std::string empty;
     if (route_idx >= cache.size()) {
-      return "";
+      return empty;
     }
 
     if (leg_idx >= cache[route_idx].size()) {
-      return "";
+      return empty;
     }
 
     if (num_named_segs == 0) {
-      return "";
+      return empty;
     }
 
     // num_named_segs is the number of named segments you'd like the summary to
@@ -186,7 +195,7 @@ public:
     // summaries offset by n = num_named_segs - 1.
     size_t n = num_named_segs - 1;
     if (n >= cache[route_idx][leg_idx].size()) {
-      return "";
+      return empty;
     }
 
     // empty summary means cache miss
@@ -203,6 +212,11 @@ public:
                 [](const NamedSegment* a, const NamedSegment* b) { return a->index < b->index; });
 
       std::string summary;
+      size_t length = 0;
+      for (size_t i = 0; i < num_named_segs; i++) {
+        length += segs_by_maneuver_index[i]->name.size() + 2;
+      }
+      summary.reserve(length);
       for (size_t i = 0; i < num_named_segs; i++) {
         summary += segs_by_maneuver_index[i]->name;
         if (i != num_named_segs - 1)
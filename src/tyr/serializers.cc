@@ -177,6 +177,22 @@ std::string serializePbf(Api& request) {
       case Options::status:
         selection.set_status(true);
         break;
+      // everything else has its own object
+      case Options::isochrone:
+        selection.set_isochrone(true);
+        break;
+      case Options::sources_to_targets:
+        selection.set_matrix(true);
+        break;
+      case Options::locate:
+        selection.set_locate(true);
+        break;
+      case Options::height:
+        selection.set_height(true);
+        break;
+      case Options::expansion:
+        selection.set_expansion(true);
+        break;
       // should never get here, actions which dont have pbf yet return json
       default:
         throw std::logic_error("Requested action is not yet serializable as pbf");
@@ -198,6 +214,16 @@ std::string serializePbf(Api& request) {
     request.clear_directions();
   if (!selection.status())
     request.clear_status();
+  if (!selection.isochrone())
+    request.clear_isochrone();
+  if (!selection.matrix())
+    request.clear_matrix();
+  if (!selection.locate())
+    request.clear_locate();
+  if (!selection.height())
+    request.clear_height();
+  if (!selection.expansion())
+    request.clear_expansion();
   if (!selection.options())
     request.clear_options();
 
@@ -288,6 +314,28 @@ json::ArrayPtr waypoints(const google::protobuf::RepeatedPtrField<valhalla::Loca
   return waypoints;
 }
 
+void waypoints(const char* key,
+               const google::protobuf::RepeatedPtrField<valhalla::Location>& locations,
+               rapidjson::writer_wrapper_t& writer) {
+  writer.start_array(key);
+  for (const auto& location : locations) {
+    if (location.correlation().edges().size() == 0) {
+      writer(nullptr);
+      continue;
+    }
+    const auto& edge = location.correlation().edges(0);
+    writer.start_object();
+    writer.start_array("location");
+    writer.fixed(edge.ll().lng(), 6);
+    writer.fixed(edge.ll().lat(), 6);
+    writer.end_array();
+    writer.dom_string("name", edge.names_size() ? edge.names(0) : std::string());
+    writer.fixed("distance", to_ll(location.ll()).Distance(to_ll(edge.ll())), 3);
+    writer.end_object();
+  }
+  writer.end_array();
+}
+
 json::ArrayPtr waypoints(const valhalla::Trip& trip) {
   auto waypoints = json::array({});
   // For multi-route the same waypoints are used for all routes.
@@ -40,8 +40,14 @@ int main(int argc, char** argv) {
     thread_count = std::max<size_t>(std::thread::hardware_concurrency(), 1);
   }
 
+  // optionally unpack compressed tiles to disk and map them from there
+  std::string unpacked_dir;
+  if (argc > 4) {
+    unpacked_dir = argv[4];
+  }
+
   LOG_INFO("Loading elevation data");
-  valhalla::skadi::sample sample(argv[1]);
+  valhalla::skadi::sample sample(argv[1], unpacked_dir);
 
   LOG_INFO("Loading coordinate postings");
   std::vector<std::vector<std::pair<double, double>>> postings;
@@ -72,7 +78,8 @@ int main(int argc, char** argv) {
     t.join();
   }
   std::chrono::duration<double> elapsed = std::chrono::system_clock::now() - start;
-  LOG_INFO(std::to_string(posting_count / elapsed.count()) + " postings per second");
+  LOG_INFO(std::to_string(posting_count / elapsed.count()) + " postings per second on " +
+           std::to_string(thread_count) + " threads");
 
   return EXIT_SUCCESS;
 }
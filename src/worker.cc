@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <sstream>
 #include <typeinfo>
@@ -99,6 +101,7 @@ const std::unordered_map<unsigned, valhalla::valhalla_exception_t> error_codes{
     {165, {165, "Date and time required for destination for date_type of invariant", 400, HTTP_400, OSRM_INVALID_OPTIONS, "missing_invariant_date"}},
     {167, {167, "Exceeded maximum circumference for exclude_polygons", 400, HTTP_400, OSRM_PERIMETER_EXCEEDED, "too_large_polygon"}},
     {168, {168, "Invalid expansion property type", 400, HTTP_400, OSRM_INVALID_OPTIONS, "invalid_expansion_property"}},
+    {169, {169, "Unsupported format", 400, HTTP_400, OSRM_INVALID_OPTIONS, "wrong_format"}},
     {170, {170, "Locations are in unconnected regions. Go check/edit the map at osm.org", 400, HTTP_400, OSRM_NO_ROUTE, "impossible_route"}},
     {171, {171, "No suitable edges near location", 400, HTTP_400, OSRM_NO_SEGMENT, "no_edges_near"}},
     {172, {172, "Exceeded breakage distance for all pairs", 400, HTTP_400, OSRM_BREAKAGE_EXCEEDED, "too_large_breakage_distance"}},
@@ -134,12 +137,27 @@ const std::unordered_map<unsigned, valhalla::valhalla_exception_t> error_codes{
     {443, {443, "Exact route match algorithm failed to find path", 400, HTTP_400, OSRM_NO_SEGMENT, "shape_match_failed"}},
     {444, {444, "Map Match algorithm failed to find path", 400, HTTP_400, OSRM_NO_SEGMENT, "map_match_failed"}},
     {445, {445, "Shape match algorithm specification in api request is incorrect. Please see documentation for valid shape_match input.", 400, HTTP_400, OSRM_INVALID_URL, "wrong_match_type"}},
+    {446, {446, "Not enough of the session's trace has been matched yet", 400, HTTP_400, OSRM_NO_SEGMENT, "session_not_matched_yet"}},
+    {447, {447, "The session was started with different costing or matching options", 400, HTTP_400, OSRM_INVALID_OPTIONS, "session_options_mismatch"}},
     {499, {499, "Unknown", 400, HTTP_400, OSRM_INVALID_URL, "unknown"}},
     {503, {503, "Leg count mismatch", 400, HTTP_400, OSRM_INVALID_URL, "wrong_number_of_legs"}},
 };
 
 // clang-format on
 
+// keeps track of how long it took to turn the request into the api object for each action and kind
+// of input, which for json is mostly from_json. only when the caller asked for it, since like the
+// other timings it is only of use to a service that reports them
+void record_parse_time(Api& api, std::chrono::steady_clock::time_point start, const char* input) {
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  auto* stat = api.mutable_info()->mutable_statistics()->Add();
+  stat->set_key(Options_Action_Enum_Name(api.options().action()) + ".info.parse_" + input +
+                ".latency_ms");
+  stat->set_value(std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(elapsed)
+                      .count());
+  stat->set_type(timing);
+}
+
 rapidjson::Document from_string(const std::string& json, const valhalla_exception_t& e) {
   rapidjson::Document d;
   if (json.empty()) {
@@ -522,6 +540,11 @@ void from_json(rapidjson::Document& doc, Options::Action action, Api& api) {
     api.clear_trip();
     api.clear_directions();
     api.clear_status();
+    api.clear_isochrone();
+    api.clear_matrix();
+    api.clear_locate();
+    api.clear_height();
+    api.clear_expansion();
     api.clear_info();
     pbf = true;
   } // when its json we start with a blank slate and fill it all in
@@ -568,8 +591,10 @@ void from_json(rapidjson::Document& doc, Options::Action action, Api& api) {
   // so that we serialize correctly at the end we fix up any request discrepancies
   if (options.format() == Options::pbf) {
     const std::unordered_set<Options::Action> pbf_actions{
-        Options::route,    Options::optimized_route,  Options::trace_route,
-        Options::centroid, Options::trace_attributes, Options::status,
+        Options::route,     Options::optimized_route,    Options::trace_route,
+        Options::centroid,  Options::trace_attributes,   Options::status,
+        Options::isochrone, Options::sources_to_targets, Options::locate,
+        Options::height,    Options::expansion,
     };
     // if its not a pbf supported action we reset to json
     if (pbf_actions.count(options.action()) == 0) {
@@ -1006,6 +1031,13 @@ void from_json(rapidjson::Document& doc, Options::Action action, Api& api) {
     options.set_interpolation_distance(*interpolation_distance);
   }
 
+  // if specified, match the shape as the next part of a longer trace
+  auto session_id = rapidjson::get_optional<std::string>(doc, "/session_id");
+  if (session_id && !session_id->empty()) {
+    options.set_session_id(*session_id);
+    options.set_session_end(rapidjson::get<bool>(doc, "/session_end", false));
+  }
+
   // if specified, get the filter_action value in there
   auto filter_action_str = rapidjson::get_optional<std::string>(doc, "/filters/action");
   FilterAction filter_action;
@@ -1122,38 +1154,57 @@ std::string serialize_error(const valhalla_exception_t& exception, Api& request)
   return body.str();
 }
 
-void ParseApi(const std::string& request, Options::Action action, valhalla::Api& api) {
+void ParseApi(const std::string& request,
+              Options::Action action,
+              valhalla::Api& api,
+              bool time_parsing) {
+  // an empty request means the pbf is already filled out and only needs validating
+  auto start = std::chrono::steady_clock::now();
+  const char* input = request.empty() && api.has_options() ? "pbf" : "json";
   // maybe parse some json
   auto document = from_string(request, valhalla_exception_t{100});
   from_json(document, action, api);
+  if (time_parsing) {
+    record_parse_time(api, start, input);
+  }
 }
 
 #ifdef HAVE_HTTP
-void ParseApi(const http_request_t& request, valhalla::Api& api) {
+void ParseApi(const http_request_t& request, valhalla::Api& api, bool time_parsing) {
   // block all but get and post
   if (request.method != method_t::POST && request.method != method_t::GET) {
     throw valhalla_exception_t{101};
   };
 
-  // this is a service request
+  auto start = std::chrono::steady_clock::now();
   api.Clear();
-  api.mutable_info()->set_is_service(true);
 
   // get the action
   Options::Action action = static_cast<Options::Action>(Options::Action_ARRAYSIZE);
   if (!request.path.empty())
     Options_Action_Enum_Parse(request.path.substr(1), &action);
 
-  // if its a protobuf mime go with that
+  // if its a protobuf mime go with that, the bytes go straight into the api object without any json
+  // in between and then get the same validation and defaults as json requests do. the mime type can
+  // have parameters after it but it cant just start the same as ours
   auto pbf_content = request.headers.find("Content-Type");
-  if (pbf_content != request.headers.end() && pbf_content->second == worker::PBF_MIME.second) {
-    if (!api.ParseFromString(request.body)) {
+  const auto& pbf_mime = worker::PBF_MIME.second;
+  if (pbf_content != request.headers.end() &&
+      pbf_content->second.compare(0, pbf_mime.size(), pbf_mime) == 0 &&
+      (pbf_content->second.size() == pbf_mime.size() ||
+       pbf_content->second[pbf_mime.size()] == ';')) {
+    if (!api.ParseFromArray(request.body.data(), static_cast<int>(request.body.size()))) {
       throw valhalla_exception_t{103};
     }
     // validate the options
     rapidjson::Document dummy;
     dummy.SetObject();
     from_json(dummy, action, api);
+    // this is a service request, from_json starts the info over so we mark it after
+    api.mutable_info()->set_is_service(true);
+    if (time_parsing) {
+      record_parse_time(api, start, "pbf");
+    }
     return;
   }
 
@@ -1199,6 +1250,10 @@ void ParseApi(const http_request_t& request, valhalla::Api& api) {
 
   // parse out the options
   from_json(document, action, api);
+  api.mutable_info()->set_is_service(true);
+  if (time_parsing) {
+    record_parse_time(api, start, "json");
+  }
 }
 
 const headers_t::value_type CORS{"Access-Control-Allow-Origin", "*"};
@@ -1277,6 +1332,29 @@ struct statsd_client_t : public Statsd::StatsdClient {
   std::vector<std::string> tags;
 };
 
+request_arena_t::request_arena_t(size_t max_block_size)
+    : block_(64 * 1024), max_block_size_(max_block_size) {
+}
+
+Api& request_arena_t::create() {
+  // if the last request didnt fit in the block grow it so that the next one like it will
+  if (arena_) {
+    const auto used = static_cast<size_t>(arena_->SpaceAllocated());
+    arena_.reset();
+    if (used > block_.size() && block_.size() < max_block_size_) {
+      block_.resize(std::min(used, max_block_size_));
+    }
+  }
+
+  // start the arena in the block, anything past it comes in ever bigger blocks from the heap
+  google::protobuf::ArenaOptions options;
+  options.initial_block = block_.data();
+  options.initial_block_size = block_.size();
+  options.max_block_size = 1024 * 1024;
+  arena_.reset(new google::protobuf::Arena(options));
+  return *google::protobuf::Arena::CreateMessage<Api>(arena_.get());
+}
+
 service_worker_t::service_worker_t(const boost::property_tree::ptree& conf) : interrupt(nullptr) {
   if (conf.count("statsd")) {
     statsd_client = std::make_unique<statsd_client_t>(conf);
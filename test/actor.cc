@@ -4,6 +4,7 @@
 #include <string>
 
 #include "tyr/actor.h"
+#include "worker.h"
 
 #include "test.h"
 
@@ -78,6 +79,37 @@ TEST(Actor, TraceAttributes) {
   EXPECT_THROW(actor.trace_attributes(request, &interrupt), test_exception_t);
 }
 
+TEST(Actor, RequestArena) {
+  request_arena_t arena(1024 * 1024);
+  for (int i = 0; i < 3; ++i) {
+    // every request starts out empty and on the arena
+    auto& api = arena.create();
+    EXPECT_NE(api.GetArena(), nullptr);
+    EXPECT_FALSE(api.has_trip());
+
+    // more than fits in the first block
+    auto* leg = api.mutable_trip()->add_routes()->add_legs();
+    for (int j = 0; j < 10000; ++j) {
+      leg->add_node()->mutable_edge()->add_name()->set_value("Tulpehocken Road");
+    }
+    EXPECT_EQ(leg->node_size(), 10000);
+    EXPECT_EQ(leg->node(9999).edge().name(0).value(), "Tulpehocken Road");
+  }
+}
+
+TEST(Actor, ArenaMatchesHeap) {
+  tyr::actor_t actor(conf, true);
+  std::string request = R"({"locations":[{"lat":40.546115,"lon":-76.385076,"type":"break"},
+        {"lat":40.544232,"lon":-76.385752,"type":"break"}],"costing":"auto"})";
+  // the api comes from the actors arena when the caller doesnt want it
+  auto from_arena = actor.route(request);
+  Api api;
+  auto from_heap = actor.route(request, nullptr, &api);
+  EXPECT_EQ(from_arena, from_heap);
+  EXPECT_EQ(api.GetArena(), nullptr);
+  EXPECT_EQ(api.trip().routes_size(), 1);
+}
+
 // TODO: test the rest of them
 
 } // namespace
@@ -2,6 +2,7 @@
 
 #include "test.h"
 
+#include <stdexcept>
 #include <string>
 
 using namespace std;
@@ -620,6 +621,64 @@ TEST(Encode, VarInt) {
                   {58.26482, -169.02219}});
 }
 
+TEST(Encode, Ranges) {
+  const container_t points{{-76.3002, 40.0390}, {-76.2990, 40.0403}, {-76.2980, 40.0420},
+                           {-76.2966, 40.0431}, {-76.2951, 40.0445}};
+
+  // a range encodes the same as a container of just that range
+  std::string output;
+  encode(points.begin() + 1, points.end() - 1, output);
+  EXPECT_EQ(output, encode(container_t(points.begin() + 1, points.end() - 1)));
+  output.clear();
+  encode7(points.begin() + 1, points.end() - 1, output);
+  EXPECT_EQ(output, encode7(container_t(points.begin() + 1, points.end() - 1)));
+
+  // and gets appended to whatever is already there
+  output = "prefix";
+  encode(points.begin(), points.end(), output, 1e5);
+  EXPECT_EQ(output, "prefix" + encode(points, 1e5));
+  output = "prefix";
+  encode(points.begin(), points.begin(), output);
+  EXPECT_EQ(output, "prefix");
+}
+
+TEST(Encode, LargeDeltas) {
+  // deltas that need every last chunk, a number at the very end of the string is decoded
+  // without reading past it
+  const container_t points{{179.999999, 89.999999}, {-179.999999, -89.999999},
+                           {179.999999, -89.999999}, {0, 0}, {-0.000001, 0.000001}};
+  assert_approx_equal(decode<container_t>(encode(points)), points);
+  assert_approx_equal(decode7<container_t>(encode7(points)), points);
+  for (size_t i = 1; i <= points.size(); ++i) {
+    const container_t some(points.begin(), points.begin() + i);
+    assert_approx_equal(decode<container_t>(encode(some)), some);
+    assert_approx_equal(decode7<container_t>(encode7(some)), some);
+  }
+
+  // a long shape of nothing but big jumps outgrows the room the output starts with
+  container_t jumps;
+  for (size_t i = 0; i < 1000; ++i) {
+    jumps.emplace_back(points[i % 3]);
+  }
+  std::string output = "prefix";
+  encode(jumps.begin(), jumps.end(), output);
+  EXPECT_EQ(output.substr(0, 6), "prefix");
+  assert_approx_equal(decode<container_t>(output.substr(6)), jumps);
+  output = "prefix";
+  encode7(jumps.begin(), jumps.end(), output);
+  EXPECT_EQ(output.substr(0, 6), "prefix");
+  assert_approx_equal(decode7<container_t>(output.substr(6)), jumps);
+}
+
+TEST(Encode, Malformed) {
+  // a number that doesnt end before the string does
+  EXPECT_THROW(decode<container_t>(std::string("_p~iF~ps|U_")), std::runtime_error);
+  EXPECT_THROW(decode7<container_t>(std::string("\x80\x80", 2)), std::runtime_error);
+  // a number that doesnt end before its too big to be one
+  EXPECT_THROW(decode<container_t>(std::string(12, '~')), std::runtime_error);
+  EXPECT_THROW(decode7<container_t>(std::string(12, '\xff')), std::runtime_error);
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
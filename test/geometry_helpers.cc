@@ -0,0 +1,97 @@
+#include <random>
+
+#include "meili/geometry_helpers.h"
+#include "midgard/encoded.h"
+
+#include "test.h"
+
+using namespace valhalla;
+using namespace valhalla::midgard;
+using namespace valhalla::meili;
+
+namespace {
+
+// a wiggly line with some repeated points thrown in
+std::vector<PointLL> make_shape(std::mt19937& generator, size_t count) {
+  std::uniform_real_distribution<double> step(-.0005, .0005);
+  std::vector<PointLL> shape{{5.1, 52.1}};
+  while (shape.size() < count) {
+    const auto& last = shape.back();
+    if (shape.size() % 7 == 0) {
+      shape.push_back(last);
+    } else {
+      shape.emplace_back(last.lng() + step(generator), last.lat() + step(generator));
+    }
+  }
+  return shape;
+}
+
+TEST(GeometryHelpers, segment_distances_match_projector) {
+  std::mt19937 generator(17);
+  const auto shape = make_shape(generator, 64);
+  std::vector<double> lngs, lats;
+  for (const auto& p : shape) {
+    lngs.push_back(p.lng());
+    lats.push_back(p.lat());
+  }
+
+  std::uniform_real_distribution<double> offset(-.002, .002);
+  for (int i = 0; i < 100; ++i) {
+    const PointLL point(5.1 + offset(generator), 52.1 + offset(generator));
+    projector_t projector(point);
+    std::vector<double> sq_distances(shape.size() - 1);
+    helpers::SqDistancesToSegments(projector, lngs.data(), lats.data(), shape.size(),
+                                   sq_distances.data());
+    for (size_t j = 0; j + 1 < shape.size(); ++j) {
+      const auto expected = projector.approx.DistanceSquared(projector(shape[j], shape[j + 1]));
+      EXPECT_NEAR(sq_distances[j], expected, 1e-6 + expected * 1e-9) << "segment " << j;
+    }
+  }
+}
+
+TEST(GeometryHelpers, buffered_projection_matches_scalar) {
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> offset(-.003, .003);
+  helpers::ShapeBuffer buffer;
+  for (size_t count : {1, 2, 3, 10, 100}) {
+    const auto shape = make_shape(generator, count);
+    const auto encoded = encode7(shape);
+    for (int i = 0; i < 50; ++i) {
+      // some right on the shape points to hit the snapping
+      const PointLL point = i % 10 == 0 ? shape[i % shape.size()]
+                                        : PointLL(5.1 + offset(generator), 52.1 + offset(generator));
+      projector_t projector(point);
+      for (double snap_distance : {0.0, 5.0}) {
+        Shape7Decoder<PointLL> scalar_shape(encoded.c_str(), encoded.size());
+        const auto expected = helpers::Project(projector, scalar_shape, snap_distance);
+
+        Shape7Decoder<PointLL> vector_shape(encoded.c_str(), encoded.size());
+        ASSERT_EQ(buffer.Decode(vector_shape), count);
+        double sq_distance;
+        const auto segment = helpers::ClosestSegment(projector, buffer, sq_distance);
+        const auto projected = helpers::Project(projector, buffer, segment, snap_distance);
+
+        EXPECT_NEAR(sq_distance, std::get<1>(expected), 1e-6 + std::get<1>(expected) * 1e-9);
+        EXPECT_TRUE(std::get<0>(projected).ApproximatelyEqual(std::get<0>(expected)));
+        EXPECT_NEAR(std::get<1>(projected), std::get<1>(expected), 1e-6);
+        EXPECT_NEAR(std::get<3>(projected), std::get<3>(expected), 1e-9);
+        // when the closest point is a shape point shared by two segments either one is right
+        const auto& closest = std::get<0>(expected);
+        const auto segment_idx = std::get<2>(expected);
+        const bool at_shape_point =
+            closest.ApproximatelyEqual(shape[segment_idx]) ||
+            (segment_idx + 1 < shape.size() && closest.ApproximatelyEqual(shape[segment_idx + 1]));
+        if (!at_shape_point) {
+          EXPECT_EQ(std::get<2>(projected), segment_idx);
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,81 @@
+#include <thread>
+#include <vector>
+
+#include "meili/grid_cache.h"
+
+#include "test.h"
+
+using namespace valhalla;
+using namespace valhalla::meili;
+
+namespace {
+
+GridCache::grid_ptr make_grid() {
+  return std::make_shared<GridCache::grid_t>(midgard::AABB2<midgard::PointLL>(0, 0, 1, 1), .1f,
+                                             .1f);
+}
+
+TEST(GridCache, hit_and_miss) {
+  GridCache cache(1024);
+  EXPECT_EQ(cache.Find(7, 1), nullptr);
+
+  auto grid = make_grid();
+  EXPECT_EQ(cache.Insert(7, 1, grid), grid);
+  EXPECT_EQ(cache.Find(7, 1), grid);
+  EXPECT_EQ(cache.size(), 1);
+
+  // another thread got there first so we get theirs
+  EXPECT_EQ(cache.Insert(7, 1, make_grid()), grid);
+
+  // the tiles changed so its stale
+  EXPECT_EQ(cache.Find(7, 2), nullptr);
+  auto newer = make_grid();
+  EXPECT_EQ(cache.Insert(7, 2, newer), newer);
+  EXPECT_EQ(cache.Find(7, 2), newer);
+  EXPECT_EQ(cache.Find(7, 1), nullptr);
+  EXPECT_EQ(cache.size(), 1);
+
+  EXPECT_EQ(cache.hits(), 2);
+  EXPECT_EQ(cache.misses(), 3);
+
+  cache.Clear();
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_EQ(cache.Find(7, 2), nullptr);
+}
+
+TEST(GridCache, global) {
+  auto cache = GridCache::Global(16, "tiles", .1f, .1f);
+  EXPECT_EQ(cache, GridCache::Global(32, "tiles", .1f, .1f));
+  EXPECT_NE(cache, GridCache::Global(16, "tiles", .2f, .2f));
+  EXPECT_NE(cache, GridCache::Global(16, "other_tiles", .1f, .1f));
+}
+
+TEST(GridCache, threads) {
+  GridCache cache(64);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&cache]() {
+      for (int i = 0; i < 1000; ++i) {
+        int32_t bin_id = i % 100;
+        auto grid = cache.Find(bin_id, 1);
+        if (!grid) {
+          grid = cache.Insert(bin_id, 1, make_grid());
+        }
+        ASSERT_NE(grid, nullptr);
+        EXPECT_EQ(grid->ncols(), 10);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_LE(cache.size(), 64);
+  EXPECT_EQ(cache.hits() + cache.misses(), 8000);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -215,6 +215,79 @@ TEST_F(AvoidTest, TestAvoidShortcutsTruck) {
   ASSERT_EQ(found_shortcuts, 2);
 }
 
+TEST(AvoidPolygons, TestParallel) {
+  // a grid big enough that the ring below passes through a bunch of tiles
+  const std::string ascii_map = R"(
+    A---B---C---D---E
+    |   |   |   |   |
+    F---G---H---I---J
+    |   |   |   |   |
+    K---L---M---N---O
+  )";
+  const gurka::ways ways = {{"AB", {{"highway", "primary"}}}, {"BC", {{"highway", "primary"}}},
+                            {"CD", {{"highway", "primary"}}}, {"DE", {{"highway", "primary"}}},
+                            {"FG", {{"highway", "primary"}}}, {"GH", {{"highway", "primary"}}},
+                            {"HI", {{"highway", "primary"}}}, {"IJ", {{"highway", "primary"}}},
+                            {"KL", {{"highway", "primary"}}}, {"LM", {{"highway", "primary"}}},
+                            {"MN", {{"highway", "primary"}}}, {"NO", {{"highway", "primary"}}},
+                            {"AF", {{"highway", "primary"}}}, {"FK", {{"highway", "primary"}}},
+                            {"BG", {{"highway", "primary"}}}, {"GL", {{"highway", "primary"}}},
+                            {"CH", {{"highway", "primary"}}}, {"HM", {{"highway", "primary"}}},
+                            {"DI", {{"highway", "primary"}}}, {"IN", {{"highway", "primary"}}},
+                            {"EJ", {{"highway", "primary"}}}, {"JO", {{"highway", "primary"}}}};
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, 10000);
+  auto map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_avoid_polygons_parallel");
+
+  // a ring around the middle row which all of the inner vertical ways cross
+  Options options;
+  options.set_costing_type(Costing::auto_);
+  auto* ring = options.mutable_exclude_polygons()->Add();
+  const auto& nw = map.nodes["A"];
+  const auto& se = map.nodes["O"];
+  const auto dx = (se.lng() - nw.lng()) / 8;
+  const auto dy = (nw.lat() - se.lat()) / 4;
+  for (const auto& coord : {vm::PointLL{nw.lng() + dx, nw.lat() - dy},
+                            vm::PointLL{se.lng() - dx, nw.lat() - dy},
+                            vm::PointLL{se.lng() - dx, se.lat() + dy},
+                            vm::PointLL{nw.lng() + dx, se.lat() + dy}}) {
+    auto* ll = ring->add_coords();
+    ll->set_lat(coord.lat());
+    ll->set_lng(coord.lng());
+  }
+
+  auto conf = map.config.get_child("mjolnir");
+  conf.put("global_synchronized_cache", true);
+  baldr::GraphReader reader(conf);
+  std::vector<std::shared_ptr<baldr::GraphReader>> thread_readers;
+  for (int i = 0; i < 4; ++i) {
+    thread_readers.emplace_back(std::make_shared<baldr::GraphReader>(conf));
+  }
+  vm::ThreadPool pool(3);
+
+  // it has to be the same no matter how many threads work on it
+  const auto costing = sif::CostFactory{}.Create(options);
+  const auto serial = vl::edges_in_rings(options.exclude_polygons(), reader, costing, 1e6);
+  const auto parallel =
+      vl::edges_in_rings(options.exclude_polygons(), reader, costing, 1e6, thread_readers, &pool);
+  EXPECT_EQ(serial, parallel);
+
+  // the ways crossing the ring are avoided in both directions
+  EXPECT_FALSE(serial.empty());
+  for (const auto& name : {"BG", "GL", "CH", "HM", "DI", "IN", "FG", "IJ"}) {
+    const std::string from(1, name[0]), to(1, name[1]);
+    EXPECT_TRUE(serial.count(std::get<0>(gurka::findEdgeByNodes(reader, layout, from, to))))
+        << name << " should be avoided";
+    EXPECT_TRUE(serial.count(std::get<0>(gurka::findEdgeByNodes(reader, layout, to, from))))
+        << name << " should be avoided in reverse";
+  }
+  // but not the ones outside of it
+  for (const auto& name : {"AB", "KL", "AF", "FK", "EJ", "JO"}) {
+    const std::string from(1, name[0]), to(1, name[1]);
+    EXPECT_FALSE(serial.count(std::get<0>(gurka::findEdgeByNodes(reader, layout, from, to))))
+        << name << " should not be avoided";
+  }
+}
+
 TEST_P(AvoidTest, TestAvoidLocation) {
   // avoid the location on "High road"
   std::vector<vm::PointLL> avoid_locs{avoid_map.nodes["x"]};
@@ -0,0 +1,84 @@
+#include "gurka.h"
+#include "test.h"
+
+#include <gtest/gtest.h>
+
+using namespace valhalla;
+
+class LegConcurrency : public ::testing::Test {
+protected:
+  static gurka::map map;
+
+  static void SetUpTestSuite() {
+    const std::string ascii_map = R"(
+      A----B----C----D
+      |    |    |    |
+      E----F----G----H
+      |    |    |    |
+      I----J----K----L
+    )";
+    const gurka::ways ways = {
+        {"ABCD", {{"highway", "primary"}, {"name", "North Street"}}},
+        {"EFGH", {{"highway", "secondary"}, {"name", "Middle Street"}}},
+        {"IJKL", {{"highway", "primary"}, {"name", "South Street"}}},
+        {"AEI", {{"highway", "residential"}, {"name", "First Avenue"}}},
+        {"BFJ", {{"highway", "residential"}, {"name", "Second Avenue"}}},
+        {"CGK", {{"highway", "residential"}, {"name", "Third Avenue"}}},
+        {"DHL", {{"highway", "residential"}, {"name", "Fourth Avenue"}}},
+    };
+    const auto layout = gurka::detail::map_to_coordinates(ascii_map, 100);
+    map = gurka::buildtiles(layout, ways, {}, {}, "test/data/leg_concurrency");
+  }
+
+  // the same map but building the legs and their directions on the given number of threads
+  static gurka::map with_threads(unsigned int threads) {
+    auto copy = map;
+    copy.config.put("thor.leg_concurrency", threads);
+    copy.config.put("odin.leg_concurrency", threads);
+    return copy;
+  }
+
+  // the route comes out the same no matter how many threads built its legs, returns how many legs
+  static int expect_same_route(const std::vector<std::string>& waypoints,
+                               const std::string& stop_type,
+                               const std::unordered_map<std::string, std::string>& options = {}) {
+    std::string one_json, many_json;
+    auto one = gurka::do_action(Options::route, with_threads(1), waypoints, "auto", options, {},
+                                &one_json, stop_type);
+    auto many = gurka::do_action(Options::route, with_threads(4), waypoints, "auto", options, {},
+                                 &many_json, stop_type);
+
+    EXPECT_EQ(one.trip().routes_size(), 1);
+    EXPECT_EQ(many.trip().routes_size(), 1);
+    EXPECT_TRUE(test::pbf_equals(one.trip(), many.trip()));
+    EXPECT_TRUE(test::pbf_equals(one.directions(), many.directions()));
+    EXPECT_EQ(one_json, many_json);
+    return many.trip().routes_size() ? many.trip().routes(0).legs_size() : 0;
+  }
+};
+
+gurka::map LegConcurrency::map = {};
+
+TEST_F(LegConcurrency, depart_at_breaks) {
+  expect_same_route({"A", "D", "L", "I", "F", "G", "K"}, "break");
+}
+
+TEST_F(LegConcurrency, depart_at_through_and_via) {
+  // the breaks split the route into legs and the others have to stay inside of them
+  const std::unordered_map<std::string, std::string> breaks = {{"/locations/0/type", "break"},
+                                                               {"/locations/2/type", "break"},
+                                                               {"/locations/4/type", "break"},
+                                                               {"/locations/6/type", "break"}};
+  EXPECT_EQ(expect_same_route({"A", "C", "D", "L", "J", "F", "G"}, "through", breaks), 3);
+  EXPECT_EQ(expect_same_route({"A", "C", "D", "L", "J", "F", "G"}, "via", breaks), 3);
+}
+
+TEST_F(LegConcurrency, arrive_by_breaks) {
+  expect_same_route({"A", "D", "L", "I", "F", "G", "K"}, "break",
+                    {{"/date_time/type", "2"}, {"/date_time/value", "2021-04-01T09:00"}});
+}
+
+TEST_F(LegConcurrency, more_threads_than_legs) {
+  expect_same_route({"A", "L"}, "break");
+  expect_same_route({"A", "D", "L"}, "break");
+}
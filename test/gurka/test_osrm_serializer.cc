@@ -1,4 +1,5 @@
 #include "gurka.h"
+#include "tyr/serializers.h"
 #include <gtest/gtest.h>
 
 using namespace valhalla;
@@ -515,3 +516,226 @@ TEST(Standalone, HeadingNumberAutoRoute) {
   }
   // clang-format on
 }
+
+TEST(Standalone, NarrativeOnlyWhatTheFormatUses) {
+  const std::string ascii_map = R"(
+    B---C---D
+    |
+    A
+  )";
+
+  const gurka::ways ways = {
+      {"AB", {{"highway", "primary"}, {"name", "Avenue A"}}},
+      {"BCD", {{"highway", "primary"}, {"name", "Avenue B"}}},
+  };
+
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, 100, {40.7351162, -73.985719});
+  auto map = gurka::buildtiles(layout, ways, {}, {}, "test/data/osrm_serializer_narrative");
+
+  // valhalla json gets the text and the verbal instructions
+  auto result = gurka::do_action(valhalla::Options::route, map, {"A", "D"}, "auto");
+  const auto& full = result.directions().routes(0).legs(0);
+  ASSERT_EQ(full.maneuver_size(), 3);
+  for (const auto& maneuver : full.maneuver()) {
+    EXPECT_FALSE(maneuver.text_instruction().empty());
+    EXPECT_FALSE(maneuver.verbal_pre_transition_instruction().empty());
+  }
+
+  // osrm gets the same text instructions but never uses the verbal ones
+  result = gurka::do_action(valhalla::Options::route, map, {"A", "D"}, "auto",
+                            {{"/format", "osrm"}});
+  const auto& osrm = result.directions().routes(0).legs(0);
+  ASSERT_EQ(osrm.maneuver_size(), full.maneuver_size());
+  for (int i = 0; i < osrm.maneuver_size(); ++i) {
+    EXPECT_EQ(osrm.maneuver(i).text_instruction(), full.maneuver(i).text_instruction());
+    EXPECT_TRUE(osrm.maneuver(i).verbal_pre_transition_instruction().empty());
+    EXPECT_TRUE(osrm.maneuver(i).verbal_post_transition_instruction().empty());
+  }
+
+  // gpx only looks at the trip so there are no maneuvers at all
+  result = gurka::do_action(valhalla::Options::route, map, {"A", "D"}, "auto",
+                            {{"/format", "gpx"}});
+  EXPECT_EQ(result.directions().routes(0).legs(0).maneuver_size(), 0);
+  EXPECT_GT(result.trip().routes(0).legs(0).node_size(), 0);
+}
+
+TEST(Standalone, OsrmSerializerLegShapesAndIntersections) {
+  const std::string ascii_map = R"(
+        E
+        |
+    A---B---C---D
+        |
+        F
+  )";
+
+  const gurka::ways ways = {
+      {"AB", {{"highway", "primary"}}},
+      {"BC", {{"highway", "primary"}}},
+      {"CD", {{"highway", "primary"}}},
+      {"EBF", {{"highway", "residential"}, {"oneway", "yes"}}},
+  };
+
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, 100, {40.7351162, -73.985719});
+  auto map = gurka::buildtiles(layout, ways, {}, {}, "test/data/osrm_serializer_leg_shapes");
+
+  // the route geometry of one leg is the leg shape and of several legs is the legs glued together
+  for (const auto& waypoints : std::vector<std::vector<std::string>>{{"A", "D"}, {"A", "C", "D"}}) {
+    auto result = gurka::do_action(valhalla::Options::route, map, waypoints, "auto");
+    auto json = gurka::convert_to_json(result, Options::Format::Options_Format_osrm);
+    std::vector<midgard::PointLL> legs;
+    for (const auto& leg : result.directions().routes(0).legs()) {
+      auto shape = midgard::decode<std::vector<midgard::PointLL>>(leg.shape());
+      legs.insert(legs.end(), legs.empty() ? shape.begin() : shape.begin() + 1, shape.end());
+    }
+    EXPECT_EQ(json["routes"][0]["geometry"].GetString(), midgard::encode(legs));
+    EXPECT_EQ(json["routes"][0]["legs"].Size(), waypoints.size() - 1);
+  }
+
+  // B has the way we came from, the way we go and a oneway we can only leave the node on
+  auto result = gurka::do_action(valhalla::Options::route, map, {"A", "D"}, "auto");
+  auto json = gurka::convert_to_json(result, Options::Format::Options_Format_osrm);
+  const auto& steps = json["routes"][0]["legs"][0]["steps"];
+  const auto& depart = steps[0]["intersections"][0];
+  EXPECT_FALSE(depart.HasMember("in"));
+  EXPECT_EQ(depart["out"].GetInt(), 0);
+  EXPECT_EQ(depart["bearings"].Size(), 1);
+
+  const rapidjson::Value* b = nullptr;
+  for (const auto& step : steps.GetArray()) {
+    for (const auto& intersection : step["intersections"].GetArray()) {
+      if (intersection["bearings"].Size() == 4) {
+        b = &intersection;
+      }
+    }
+  }
+  ASSERT_NE(b, nullptr);
+  const auto& bearings = (*b)["bearings"];
+  for (int i = 1; i < 4; ++i) {
+    EXPECT_LT(bearings[i - 1].GetInt(), bearings[i].GetInt());
+  }
+  EXPECT_NEAR(bearings[(*b)["in"].GetInt()].GetInt(), 270, 2);
+  EXPECT_NEAR(bearings[(*b)["out"].GetInt()].GetInt(), 90, 2);
+  EXPECT_FALSE((*b)["entry"][(*b)["in"].GetInt()].GetBool());
+  EXPECT_TRUE((*b)["entry"][(*b)["out"].GetInt()].GetBool());
+  int entries = 0;
+  for (const auto& entry : (*b)["entry"].GetArray()) {
+    entries += entry.GetBool();
+  }
+  EXPECT_EQ(entries, 2);
+
+  // the arrival only has the way we came in on
+  const auto& arrive = steps[steps.Size() - 1]["intersections"][0];
+  EXPECT_EQ(arrive["in"].GetInt(), 0);
+  EXPECT_FALSE(arrive.HasMember("out"));
+  ASSERT_EQ(arrive["bearings"].Size(), 1);
+  EXPECT_NEAR(arrive["bearings"][0].GetInt(), 270, 2);
+  EXPECT_TRUE(arrive["entry"][0].GetBool());
+}
+
+TEST(Standalone, OsrmSerializerRestStopsLanesAndLegs) {
+  const std::string ascii_map = R"(
+    A
+    |
+    B
+    | \
+    |  C
+    D
+    |
+    E
+    | \
+    |  F
+    G
+  )";
+
+  const gurka::ways ways = {
+      {"AB",
+       {{"highway", "motorway"}, {"lanes", "3"}, {"turn:lanes", "through|through|slight_right"}}},
+      {"BC",
+       {{"highway", "motorway_link"},
+        {"service", "rest_area"},
+        {"destination", "Bear Peak Rest Area"}}},
+      {"BD", {{"highway", "motorway"}}},
+      {"DE", {{"highway", "motorway"}}},
+      {"EF",
+       {{"highway", "motorway_link"},
+        {"service", "rest_area"},
+        {"amenity", "yes"},
+        {"destination", "Bear Peak Service Area"}}},
+      {"EG", {{"highway", "motorway"}}},
+  };
+
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, 100);
+  auto map = gurka::buildtiles(layout, ways, {}, {}, "test/data/osrm_serializer_rest_stops",
+                               {{"mjolnir.data_processing.use_rest_area", "true"}});
+
+  // one leg per pair of waypoints and the route adds them up
+  const std::vector<std::string> waypoints = {"A", "D", "E", "G"};
+  auto result = gurka::do_action(valhalla::Options::route, map, waypoints, "auto");
+  auto json = gurka::convert_to_json(result, Options::Format::Options_Format_osrm);
+  ASSERT_EQ(json["waypoints"].Size(), 4);
+  const auto& route = json["routes"][0];
+  EXPECT_STREQ(route["weight_name"].GetString(), "auto");
+  const auto& legs = route["legs"];
+  ASSERT_EQ(legs.Size(), 3);
+  double distance = 0, duration = 0;
+  for (size_t i = 0; i < legs.Size(); ++i) {
+    const auto expected = layout.at(waypoints[i]).Distance(layout.at(waypoints[i + 1]));
+    EXPECT_NEAR(legs[i]["distance"].GetDouble(), expected, 1);
+    EXPECT_GT(legs[i]["duration"].GetDouble(), 0);
+    distance += legs[i]["distance"].GetDouble();
+    duration += legs[i]["duration"].GetDouble();
+  }
+  EXPECT_NEAR(route["distance"].GetDouble(), distance, 0.5);
+  EXPECT_NEAR(route["duration"].GetDouble(), duration, 0.5);
+
+  // we leave A going south and arrive at G coming from the north
+  const auto& depart = legs[0]["steps"][0]["intersections"][0];
+  ASSERT_EQ(depart["bearings"].Size(), 1);
+  EXPECT_NEAR(depart["bearings"][0].GetInt(), 180, 2);
+  const auto& last = legs[2]["steps"][legs[2]["steps"].Size() - 1]["intersections"];
+  const auto& arrive = last[last.Size() - 1];
+  ASSERT_EQ(arrive["bearings"].Size(), 1);
+  EXPECT_TRUE(arrive["bearings"][0].GetInt() <= 2 || arrive["bearings"][0].GetInt() >= 358);
+
+  // we pass the rest area at B which is also where the turn lanes of AB end
+  const auto& steps = legs[0]["steps"];
+  ASSERT_EQ(steps[0]["intersections"].Size(), 2);
+  EXPECT_FALSE(steps[0]["intersections"][0].HasMember("rest_stop"));
+  const auto& b = steps[0]["intersections"][1];
+  ASSERT_TRUE(b.HasMember("rest_stop"));
+  EXPECT_STREQ(b["rest_stop"]["type"].GetString(), "rest_area");
+  EXPECT_STREQ(b["rest_stop"]["name"].GetString(), "Bear Peak Rest Area");
+  EXPECT_EQ(b["bearings"].Size(), 3);
+  ASSERT_TRUE(b.HasMember("lanes"));
+  const auto& lanes = b["lanes"];
+  ASSERT_EQ(lanes.Size(), 3);
+  for (size_t i = 0; i < lanes.Size(); ++i) {
+    ASSERT_EQ(lanes[i]["indications"].Size(), 1);
+    EXPECT_STREQ(lanes[i]["indications"][0].GetString(), i < 2 ? "straight" : "slight right");
+  }
+  EXPECT_TRUE(lanes[0]["active"].GetBool());
+  EXPECT_TRUE(lanes[1]["active"].GetBool());
+  EXPECT_FALSE(lanes[2]["active"].GetBool());
+
+  // nothing between D and E
+  for (const auto& step : legs[1]["steps"].GetArray()) {
+    for (const auto& intersection : step["intersections"].GetArray()) {
+      EXPECT_FALSE(intersection.HasMember("rest_stop"));
+      EXPECT_FALSE(intersection.HasMember("lanes"));
+    }
+  }
+
+  // the lanes are the same when we leave at B but we only get them once
+  result = gurka::do_action(valhalla::Options::route, map, {"A", "C"}, "auto");
+  json = gurka::convert_to_json(result, Options::Format::Options_Format_osrm);
+  int with_lanes = 0;
+  for (const auto& step : json["routes"][0]["legs"][0]["steps"].GetArray()) {
+    for (const auto& intersection : step["intersections"].GetArray()) {
+      if (intersection.HasMember("lanes")) {
+        ++with_lanes;
+        EXPECT_EQ(intersection["lanes"].Size(), 3);
+      }
+    }
+  }
+  EXPECT_EQ(with_lanes, 1);
+}
@@ -138,3 +138,130 @@ TEST(pbf_api, pbf_error) {
     api.mutable_options()->set_action(Options::route);
   }
 }
+
+TEST(pbf_api, pbf_only_outputs) {
+  const std::string ascii_map = R"(
+    A----B----C
+         |
+         D)";
+  const gurka::ways ways = {
+      {"ABC", {{"highway", "primary"}}},
+      {"BD", {{"highway", "residential"}}},
+  };
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, 100);
+  auto map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_pbf_only_outputs");
+
+  auto ll = [&](const std::string& node) {
+    const auto& p = map.nodes.at(node);
+    return "{\"lon\":" + std::to_string(p.lng()) + ",\"lat\":" + std::to_string(p.lat()) + "}";
+  };
+  auto act = [&](Options::Action action, const std::string& request) {
+    std::string json, bytes;
+    gurka::do_action(action, map, request + "}", nullptr, &json);
+    gurka::do_action(action, map, request + ",\"format\":\"pbf\"}", nullptr, &bytes);
+    Api pbf;
+    EXPECT_TRUE(pbf.ParseFromString(bytes));
+    EXPECT_FALSE(pbf.has_options());
+    rapidjson::Document doc;
+    doc.Parse(json.c_str());
+    EXPECT_FALSE(doc.HasParseError());
+    return std::make_pair(std::move(pbf), std::move(doc));
+  };
+
+  // the matrix is the same numbers row by row
+  auto matrix = act(Options::sources_to_targets, "{\"sources\":[" + ll("A") + "," + ll("D") +
+                                                     "],\"targets\":[" + ll("C") + "," + ll("D") +
+                                                     "," + ll("A") + "],\"costing\":\"auto\"");
+  const auto& m = matrix.first.matrix();
+  EXPECT_EQ(m.sources(), 2);
+  EXPECT_EQ(m.targets(), 3);
+  ASSERT_EQ(m.times_size(), 6);
+  ASSERT_EQ(m.distances_size(), 6);
+  ASSERT_EQ(m.connected_size(), 6);
+  const auto& rows = matrix.second["sources_to_targets"];
+  for (int i = 0; i < 6; ++i) {
+    const auto& pair = rows[i / 3][i % 3];
+    EXPECT_TRUE(m.connected(i));
+    EXPECT_EQ(m.times(i), pair["time"].GetUint64());
+    EXPECT_NEAR(m.distances(i), pair["distance"].GetDouble(), .001);
+  }
+
+  // every candidate edge has its way id
+  auto locate = act(Options::locate, "{\"locations\":[" + ll("A") + "," + ll("D") +
+                                         "],\"costing\":\"auto\"");
+  ASSERT_EQ(locate.first.locate().results_size(), 2);
+  for (int i = 0; i < 2; ++i) {
+    const auto& result = locate.first.locate().results(i);
+    const auto& edges = locate.second[i]["edges"];
+    ASSERT_EQ(result.location().correlation().edges_size(), edges.Size());
+    ASSERT_EQ(result.way_ids_size(), edges.Size());
+    for (int j = 0; j < result.way_ids_size(); ++j) {
+      EXPECT_EQ(result.way_ids(j), edges[j]["way_id"].GetUint64());
+      EXPECT_NEAR(result.location().correlation().edges(j).percent_along(),
+                  edges[j]["percent_along"].GetDouble(), 1e-5);
+    }
+    EXPECT_EQ(result.nodes_size(), locate.second[i]["nodes"].Size());
+  }
+
+  // heights and ranges come through as they are
+  auto height = act(Options::height,
+                    "{\"shape\":[" + ll("A") + "," + ll("B") + "," + ll("C") + "],\"range\":true");
+  ASSERT_EQ(height.first.height().heights_size(), 3);
+  ASSERT_EQ(height.first.height().ranges_size(), 3);
+  EXPECT_EQ(height.first.height().ranges(0), 0);
+  EXPECT_NEAR(height.first.height().ranges(2), height.second["range_height"][2][0].GetDouble(), 1);
+
+  // the contours decode back to the same rings as the geojson
+  auto isochrone = act(Options::isochrone, "{\"locations\":[" + ll("B") +
+                                               "],\"costing\":\"auto\",\"contours\":[{\"time\":1},"
+                                               "{\"time\":0.5}],\"polygons\":true");
+  const auto& intervals = isochrone.first.isochrone().intervals();
+  ASSERT_EQ(intervals.size(), 2);
+  EXPECT_EQ(intervals[0].metric(), Isochrone::Interval::time);
+  EXPECT_EQ(intervals[0].metric_value(), 1.f);
+  EXPECT_EQ(intervals[1].metric_value(), .5f);
+  const auto& features = isochrone.second["features"];
+  ASSERT_EQ(features.Size(), 2);
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(intervals[i].color(), features[i]["properties"]["color"].GetString());
+    ASSERT_EQ(intervals[i].contours_size(), 1);
+    const auto& ring = intervals[i].contours(0).geometries(0).coords();
+    const auto& expected = features[i]["geometry"]["coordinates"][0];
+    ASSERT_EQ(ring.size(), expected.Size() * 2);
+    int32_t lon = 0, lat = 0;
+    for (int j = 0; j < ring.size(); j += 2) {
+      lon += ring[j];
+      lat += ring[j + 1];
+      EXPECT_NEAR(lon * 1e-6, expected[j / 2][0].GetDouble(), 1e-6);
+      EXPECT_NEAR(lat * 1e-6, expected[j / 2][1].GetDouble(), 1e-6);
+    }
+  }
+
+  // the expansion has a geometry and each of the asked for properties per edge
+  auto expansion = act(Options::expansion,
+                       "{\"locations\":[" + ll("A") + "," + ll("D") +
+                           "],\"costing\":\"auto\",\"action\":\"route\",\"expansion_properties\":["
+                           "\"edge_ids\",\"statuses\",\"distances\"]");
+  const auto& e = expansion.first.expansion();
+  const auto& properties = expansion.second["features"][0]["properties"];
+  ASSERT_GT(e.geometries_size(), 0);
+  EXPECT_EQ(e.geometries_size(), expansion.second["features"][0]["geometry"]["coordinates"].Size());
+  ASSERT_EQ(e.edge_ids_size(), e.geometries_size());
+  EXPECT_EQ(e.edge_status_size(), e.geometries_size());
+  EXPECT_EQ(e.distances_size(), e.geometries_size());
+  EXPECT_EQ(e.durations_size(), 0);
+  for (int i = 0; i < e.edge_ids_size(); ++i) {
+    EXPECT_EQ(e.edge_ids(i), properties["edge_ids"][i].GetUint64());
+    EXPECT_EQ(Expansion::EdgeStatus_Name(e.edge_status(i))[0],
+              properties["statuses"][i].GetString()[0]);
+  }
+  EXPECT_EQ(e.algorithm(), expansion.second["properties"]["algorithm"].GetString());
+
+  // without any properties there is still the geometry and the algorithm that made it
+  auto bare = act(Options::expansion, "{\"locations\":[" + ll("A") + "," + ll("D") +
+                                          "],\"costing\":\"auto\",\"action\":\"route\"");
+  const auto& b = bare.first.expansion();
+  EXPECT_EQ(b.geometries_size(), e.geometries_size());
+  EXPECT_EQ(b.algorithm(), e.algorithm());
+  EXPECT_EQ(b.edge_ids_size(), 0);
+}
@@ -0,0 +1,229 @@
+#include "filesystem.h"
+#include "gurka.h"
+#include "proto_conversions.h"
+#include "response_cache.h"
+#include "test.h"
+#include "tyr/actor.h"
+#include "worker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+#include <boost/format.hpp>
+#include <gtest/gtest.h>
+
+using namespace valhalla;
+
+class ResponseCacheTest : public ::testing::Test {
+protected:
+  static gurka::map map;
+  static std::shared_ptr<baldr::GraphReader> reader;
+
+  static void SetUpTestSuite() {
+    const std::string ascii_map = R"(
+      A----B----C
+      |    |    |
+      D----E----F
+    )";
+    const gurka::ways ways = {
+        {"ABC", {{"highway", "primary"}}},
+        {"DEF", {{"highway", "primary"}}},
+        {"AD", {{"highway", "residential"}}},
+        {"BE", {{"highway", "residential"}}},
+        {"CF", {{"highway", "residential"}}},
+    };
+    const auto layout = gurka::detail::map_to_coordinates(ascii_map, 100);
+    map = gurka::buildtiles(layout, ways, {}, {}, "test/data/response_cache");
+    map.config.put("mjolnir.traffic_extract", "test/data/response_cache/traffic.tar");
+    map.config.put("loki.response_cache.max_bytes", 1 << 20);
+    test::build_live_traffic_data(map.config);
+    reader = test::make_clean_graphreader(map.config.get_child("mjolnir"));
+  }
+
+  void SetUp() override {
+    ResponseCache::Get(map.config)->Clear();
+  }
+
+  // a request between two nodes, the first one nudged north by the given degrees
+  static std::string request(const std::string& from,
+                             const std::string& to,
+                             double nudge = 0,
+                             const std::string& extra = "") {
+    return (boost::format(R"({"locations":[{"lat":%.7f,"lon":%.7f},{"lat":%.7f,"lon":%.7f}],)"
+                          R"("costing":"auto"%s})") %
+            (map.nodes.at(from).lat() + nudge) % map.nodes.at(from).lng() %
+            map.nodes.at(to).lat() % map.nodes.at(to).lng() % extra)
+        .str();
+  }
+
+  // looks the request up like loki would and returns whether it was a hit
+  static bool lookup(const std::string& json, Options::Action action, std::string& response) {
+    Api api;
+    ParseApi(json, action, api);
+    auto hit = ResponseCache::Get(map.config)->Lookup(api, *reader, response);
+    const auto& stats = api.info().statistics();
+    EXPECT_TRUE(std::any_of(stats.begin(), stats.end(), [&](const Statistic& stat) {
+      return stat.key() == Options_Action_Enum_Name(action) + ".info.response_cache." +
+                               (hit ? "hit" : "miss");
+    }));
+    EXPECT_EQ(api.info().response_cache_key().empty(), hit);
+    return hit;
+  }
+};
+
+gurka::map ResponseCacheTest::map = {};
+std::shared_ptr<baldr::GraphReader> ResponseCacheTest::reader;
+
+TEST_F(ResponseCacheTest, RepeatedRouteIsServedFromCache) {
+  tyr::actor_t actor(map.config, true);
+  std::string cached;
+  EXPECT_FALSE(lookup(request("A", "F"), Options::route, cached));
+
+  auto first = actor.route(request("A", "F"));
+  EXPECT_GT(ResponseCache::Get(map.config)->size(), first.size());
+  EXPECT_TRUE(lookup(request("A", "F"), Options::route, cached));
+  EXPECT_EQ(cached, first);
+  EXPECT_EQ(actor.route(request("A", "F")), first);
+
+  // a different route is its own entry
+  EXPECT_FALSE(lookup(request("C", "D"), Options::route, cached));
+  EXPECT_NE(actor.route(request("C", "D")), first);
+  EXPECT_TRUE(lookup(request("C", "D"), Options::route, cached));
+}
+
+TEST_F(ResponseCacheTest, NearbyLocationsAreDifferentRequests) {
+  tyr::actor_t actor(map.config, true);
+  auto first = actor.route(request("A", "F"));
+
+  // the response echoes the locations so even the slightest nudge needs a response of its own
+  std::string cached;
+  EXPECT_FALSE(lookup(request("A", "F", 3e-6), Options::route, cached));
+  auto nudged = actor.route(request("A", "F", 3e-6));
+  EXPECT_NE(nudged, first);
+  EXPECT_TRUE(lookup(request("A", "F", 3e-6), Options::route, cached));
+  EXPECT_EQ(cached, nudged);
+  EXPECT_TRUE(lookup(request("A", "F"), Options::route, cached));
+  EXPECT_EQ(cached, first);
+
+  // and so are other options
+  EXPECT_FALSE(lookup(request("A", "F", 0, R"(,"units":"miles")"), Options::route, cached));
+}
+
+TEST_F(ResponseCacheTest, EachConfigGetsItsOwnCache) {
+  auto cache = ResponseCache::Get(map.config);
+  EXPECT_EQ(ResponseCache::Get(map.config), cache);
+
+  // other settings are another cache rather than whichever cache was made first
+  auto config = map.config;
+  config.put("loki.response_cache.max_age", 1);
+  auto other = ResponseCache::Get(config);
+  ASSERT_NE(other, nullptr);
+  EXPECT_NE(other, cache);
+  EXPECT_EQ(ResponseCache::Get(config), other);
+
+  config.put("loki.response_cache.max_bytes", 0);
+  EXPECT_EQ(ResponseCache::Get(config), nullptr);
+}
+
+TEST_F(ResponseCacheTest, CallersThatWantTheApiArentServed) {
+  tyr::actor_t actor(map.config, true);
+  auto first = actor.route(request("A", "F"));
+
+  Api api;
+  EXPECT_EQ(actor.route(request("A", "F"), nullptr, &api), first);
+  EXPECT_EQ(api.trip().routes_size(), 1);
+}
+
+TEST_F(ResponseCacheTest, MatrixIsCached) {
+  tyr::actor_t actor(map.config, true);
+  const auto json = (boost::format(R"({"sources":[{"lat":%.7f,"lon":%.7f}],)"
+                                   R"("targets":[{"lat":%.7f,"lon":%.7f}],"costing":"auto"})") %
+                     map.nodes.at("A").lat() % map.nodes.at("A").lng() % map.nodes.at("F").lat() %
+                     map.nodes.at("F").lng())
+                        .str();
+  auto first = actor.matrix(json);
+
+  std::string cached;
+  EXPECT_TRUE(lookup(json, Options::sources_to_targets, cached));
+  EXPECT_EQ(cached, first);
+}
+
+TEST_F(ResponseCacheTest, PbfIsNotCached) {
+  tyr::actor_t actor(map.config, true);
+  const auto json = request("A", "F", 0, R"(,"format":"pbf")");
+  actor.route(json);
+
+  Api api;
+  ParseApi(json, Options::route, api);
+  std::string cached;
+  EXPECT_FALSE(ResponseCache::Get(map.config)->Lookup(api, *reader, cached));
+  EXPECT_TRUE(api.info().response_cache_key().empty());
+  EXPECT_EQ(ResponseCache::Get(map.config)->size(), 0);
+}
+
+TEST_F(ResponseCacheTest, NewTrafficInvalidates) {
+  tyr::actor_t actor(map.config, true);
+  actor.route(request("A", "F"));
+  std::string cached;
+  EXPECT_TRUE(lookup(request("A", "F"), Options::route, cached));
+
+  // write a new snapshot and give the cache a chance to notice
+  test::customize_live_traffic_data(map.config, [](baldr::GraphReader&, baldr::TrafficTile& tile,
+                                                   int, baldr::TrafficSpeed*) {
+    tile.header->last_update = 1600000000;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  EXPECT_TRUE(lookup(request("A", "F"), Options::route, cached));
+  ResponseCache::Get(map.config)->Refresh(*reader);
+  EXPECT_FALSE(lookup(request("A", "F"), Options::route, cached));
+}
+
+TEST_F(ResponseCacheTest, NewTilesInvalidate) {
+  tyr::actor_t actor(map.config, true);
+  actor.route(request("A", "F"));
+  std::string cached;
+  EXPECT_TRUE(lookup(request("A", "F"), Options::route, cached));
+
+  // touching the tile set is what replacing the tiles looks like
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  const auto touched = map.config.get<std::string>("mjolnir.tile_dir") + "/touched";
+  std::ofstream(touched).put('\n');
+  ResponseCache::Get(map.config)->Refresh(*reader);
+  EXPECT_EQ(ResponseCache::Get(map.config)->size(), 0);
+  EXPECT_FALSE(lookup(request("A", "F"), Options::route, cached));
+  filesystem::remove(touched);
+}
+
+TEST_F(ResponseCacheTest, ExpiresAndEvicts) {
+  // nothing lives longer than no time at all
+  ResponseCache expired(1 << 20, 0, 60);
+  Api api;
+  ParseApi(request("A", "F"), Options::route, api);
+  std::string cached;
+  EXPECT_FALSE(expired.Lookup(api, *reader, cached));
+  expired.Store(api, "response");
+  EXPECT_GT(expired.size(), 0);
+  EXPECT_FALSE(expired.Lookup(api, *reader, cached));
+  EXPECT_EQ(expired.size(), 0);
+
+  // the oldest response makes room for the newest one
+  ResponseCache small(300, 60, 60);
+  api.mutable_info()->set_response_cache_key("a");
+  small.Store(api, std::string(100, 'a'));
+  api.mutable_info()->set_response_cache_key("b");
+  small.Store(api, std::string(100, 'b'));
+  EXPECT_LE(small.size(), 300);
+  EXPECT_EQ(small.size(), 2 + 100 + 128);
+
+  // unless it doesnt fit at all
+  small.Store(api, std::string(1000, 'c'));
+  EXPECT_EQ(small.size(), 2 + 100 + 128);
+
+  // and requests that werent looked up are never kept
+  small.Clear();
+  api.mutable_info()->clear_response_cache_key();
+  small.Store(api, "response");
+  EXPECT_EQ(small.size(), 0);
+}
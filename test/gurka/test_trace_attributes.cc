@@ -72,3 +72,65 @@ TEST(Standalone, ShoulderAttributes) {
   EXPECT_TRUE(edges[1].HasMember("shoulder"));
   EXPECT_FALSE(edges[1]["shoulder"].GetBool());
 }
+
+TEST(Standalone, FilteredAttributesSkipUnrequestedData) {
+
+  const std::string ascii_map = R"(
+      1
+    A---2B-3-4C
+         |
+         D)";
+
+  const gurka::ways ways = {{"AB", {{"highway", "primary"}}},
+                            {"BC",
+                             {{"highway", "motorway_link"},
+                              {"oneway", "yes"},
+                              {"destination", "Town"}}},
+                            {"BD", {{"highway", "primary"}}}};
+
+  const double gridsize = 10;
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, gridsize);
+  auto map = gurka::buildtiles(layout, ways, {}, {}, "test/data/filtered_trace_attributes");
+
+  // without filters we get the sign and the edge going off to D at B
+  std::string trace_json;
+  auto api = gurka::do_action(valhalla::Options::trace_attributes, map, {"1", "2", "3", "4"},
+                              "auto", {}, {}, &trace_json, "via");
+  const auto& leg = api.trip().routes(0).legs(0);
+  ASSERT_EQ(leg.node_size(), 3);
+  EXPECT_TRUE(leg.node(1).edge().has_sign());
+  EXPECT_EQ(leg.node(1).intersecting_edge_size(), 1);
+
+  rapidjson::Document result;
+  result.Parse(trace_json.c_str());
+  EXPECT_TRUE(result["edges"][1].HasMember("sign"));
+
+  // asking for just the lengths leaves the signs and the intersecting edges out of the leg entirely
+  api = gurka::do_action(valhalla::Options::trace_attributes, map, {"1", "2", "3", "4"}, "auto",
+                         {{"/filters/action", "include"}, {"/filters/attributes/0", "edge.length"}},
+                         {}, &trace_json, "via");
+  const auto& narrow = api.trip().routes(0).legs(0);
+  ASSERT_EQ(narrow.node_size(), 3);
+  EXPECT_FALSE(narrow.node(1).edge().has_sign());
+  EXPECT_EQ(narrow.node(1).intersecting_edge_size(), 0);
+  EXPECT_GT(narrow.node(1).edge().length_km(), 0);
+  EXPECT_FALSE(narrow.has_shape_attributes());
+
+  result.Parse(trace_json.c_str());
+  auto edges = result["edges"].GetArray();
+  ASSERT_EQ(edges.Size(), 2);
+  EXPECT_FALSE(edges[1].HasMember("sign"));
+  EXPECT_TRUE(edges[1].HasMember("length"));
+
+  // any one of them is enough to get them back
+  api = gurka::do_action(valhalla::Options::trace_attributes, map, {"1", "2", "3", "4"}, "auto",
+                         {{"/filters/action", "include"},
+                          {"/filters/attributes/0", "node.intersecting_edge.road_class"},
+                          {"/filters/attributes/1", "edge.sign.exit_toward"}},
+                         {}, &trace_json, "via");
+  const auto& some = api.trip().routes(0).legs(0);
+  ASSERT_EQ(some.node_size(), 3);
+  EXPECT_EQ(some.node(1).intersecting_edge_size(), 1);
+  ASSERT_TRUE(some.node(1).edge().has_sign());
+  EXPECT_EQ(some.node(1).edge().sign().exit_toward_locations_size(), 1);
+}
@@ -0,0 +1,122 @@
+#include "gurka.h"
+#include "meili/traffic_speed_matcher.h"
+#include "midgard/util.h"
+#include "test.h"
+
+#include <gtest/gtest.h>
+
+using namespace valhalla;
+
+class TrafficSpeedMatcherTest : public ::testing::Test {
+protected:
+  static gurka::map map;
+
+  static void SetUpTestSuite() {
+    const std::string ascii_map = R"(
+      A----B----C----D
+    )";
+    const gurka::ways ways = {
+        {"AB", {{"highway", "primary"}}},
+        {"BC", {{"highway", "primary"}}},
+        {"CD", {{"highway", "primary"}}},
+    };
+    const auto layout = gurka::detail::map_to_coordinates(ascii_map, 50);
+    map = gurka::buildtiles(layout, ways, {}, {}, "test/data/traffic_speed_matcher",
+                            {{"mjolnir.traffic_extract",
+                              "test/data/traffic_speed_matcher/traffic.tar"}});
+    test::build_live_traffic_data(map.config);
+  }
+
+  // a probe driving from A to D at the given speed with a point every 20m
+  static std::vector<meili::Measurement> probe(double meters_per_second, double start_time) {
+    std::vector<midgard::PointLL> line{map.nodes["A"], map.nodes["D"]};
+    std::vector<meili::Measurement> trace;
+    double time = start_time;
+    const auto points = midgard::resample_spherical_polyline(line, 20, true);
+    for (size_t i = 0; i < points.size(); ++i) {
+      if (i > 0) {
+        time += points[i - 1].Distance(points[i]) / meters_per_second;
+      }
+      trace.emplace_back(points[i], 5.f, 20.f, time);
+    }
+    return trace;
+  }
+
+  static Options options() {
+    Options options;
+    options.set_costing_type(Costing::auto_);
+    return options;
+  }
+};
+
+gurka::map TrafficSpeedMatcherTest::map = {};
+
+TEST_F(TrafficSpeedMatcherTest, speeds_along_the_path) {
+  meili::TrafficSpeedMatcher matcher(map.config, 1);
+  EXPECT_EQ(matcher.Match({probe(10, 1000), probe(20, 2000)}, options()), 0);
+
+  // the middle edge is covered by both probes the whole way so its the average of the two
+  auto reader = test::make_clean_graphreader(map.config.get_child("mjolnir"));
+  auto BC = std::get<0>(gurka::findEdgeByNodes(*reader, map.nodes, "B", "C"));
+  auto found = matcher.speeds().find(BC);
+  ASSERT_NE(found, matcher.speeds().cend());
+  EXPECT_EQ(found->second.probes, 2);
+  // 2 x 250m in 25s + 12.5s
+  EXPECT_NEAR(found->second.kph(), 500 / 37.5 * 3.6, 1.);
+
+  // nothing is driven the other way
+  auto CB = std::get<0>(gurka::findEdgeByNodes(*reader, map.nodes, "C", "B"));
+  EXPECT_EQ(matcher.speeds().count(CB), 0);
+
+  // unmatchable traces are counted but dont stop the rest
+  std::vector<meili::Measurement> nowhere{{{0, 0}, 5.f, 20.f, 0}, {{0, .001}, 5.f, 20.f, 10}};
+  EXPECT_EQ(matcher.Match({nowhere, probe(10, 3000)}, options()), 1);
+  EXPECT_EQ(matcher.speeds().at(BC).probes, 3);
+}
+
+TEST_F(TrafficSpeedMatcherTest, same_speeds_on_more_threads) {
+  std::vector<std::vector<meili::Measurement>> traces;
+  for (int i = 0; i < 12; ++i) {
+    traces.push_back(probe(8 + i, 1000 * i));
+  }
+
+  meili::TrafficSpeedMatcher one(map.config, 1);
+  one.Match(traces, options());
+  meili::TrafficSpeedMatcher many(map.config, 4);
+  many.Match(traces, options());
+
+  ASSERT_EQ(one.speeds().size(), many.speeds().size());
+  for (const auto& speed : one.speeds()) {
+    auto found = many.speeds().find(speed.first);
+    ASSERT_NE(found, many.speeds().cend());
+    EXPECT_EQ(found->second.probes, speed.second.probes);
+    EXPECT_NEAR(found->second.length, speed.second.length, 1e-6);
+    EXPECT_NEAR(found->second.seconds, speed.second.seconds, 1e-6);
+  }
+}
+
+TEST_F(TrafficSpeedMatcherTest, write_live_speeds) {
+  meili::TrafficSpeedMatcher matcher(map.config, 2);
+  matcher.Match({probe(10, 1000), probe(10, 2000)}, options());
+  EXPECT_EQ(matcher.Write(map.config.get<std::string>("mjolnir.traffic_extract"), 1234, 3), 0);
+  const auto updated =
+      matcher.Write(map.config.get<std::string>("mjolnir.traffic_extract"), 1234, 2);
+  EXPECT_EQ(updated, matcher.speeds().size());
+
+  // anything reading the tiles sees the new speeds
+  auto reader = test::make_clean_graphreader(map.config.get_child("mjolnir"));
+  for (const auto& speed : matcher.speeds()) {
+    auto tile = reader->GetGraphTile(speed.first);
+    ASSERT_TRUE(tile);
+    const auto* edge = tile->directededge(speed.first);
+    const auto& live = tile->trafficspeed(edge);
+    EXPECT_TRUE(live.speed_valid());
+    EXPECT_NEAR(live.get_overall_speed(), speed.second.kph(), 2.);
+    EXPECT_EQ(tile->GetSpeed(edge, baldr::kCurrentFlowMask), live.get_overall_speed());
+    EXPECT_EQ(static_cast<uint64_t>(tile->get_traffic_tile().header->last_update), 1234);
+  }
+
+  // a crawl isnt a closure
+  meili::edge_speed_t crawl{10, 100, 1};
+  EXPECT_FALSE(meili::TrafficSpeedMatcher::Encode(crawl).closed());
+}
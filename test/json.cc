@@ -74,6 +74,37 @@ TEST(JSON, Serialize) {
   EXPECT_EQ(res, ans) << "Wrong json";
 }
 
+TEST(JSON, WriterFixedMatchesDom) {
+  using namespace valhalla::baldr;
+  std::stringstream dom;
+  dom << *json::array({json::fixed_t{40.7, 3}, json::fixed_t{-73.990433, 6}, json::fixed_t{12, 0},
+                       json::fixed_t{0.5, 2}, json::fixed_t{-0.0001, 3}});
+
+  rapidjson::writer_wrapper_t writer;
+  writer.start_array();
+  writer.fixed(40.7, 3);
+  writer.fixed(-73.990433, 6);
+  writer.fixed(12, 0);
+  writer.fixed(0.5, 2);
+  writer.fixed(-0.0001, 3);
+  writer.end_array();
+  EXPECT_EQ(writer.get_buffer(), dom.str());
+}
+
+TEST(JSON, WriterDomString) {
+  using namespace valhalla::baldr;
+  for (const std::string value : {"plain", "a/b", "A/B \\ \"road\"\t\x01\n/"}) {
+    std::stringstream dom;
+    dom << *json::map({{"name", value}});
+
+    rapidjson::writer_wrapper_t writer;
+    writer.start_object();
+    writer.dom_string("name", value);
+    writer.end_object();
+    EXPECT_EQ(writer.get_buffer(), dom.str());
+  }
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
@@ -524,6 +524,30 @@ TEST(LokiService, test_actions_whitelist) {
   }
 }
 
+TEST(LokiService, test_pbf_content_type) {
+  Api locate;
+  ParseApi(R"({"locations":[{"lat":52.09,"lon":5.11}],"costing":"auto"})", Options::locate, locate);
+  const auto bytes = locate.SerializeAsString();
+
+  // only the protobuf mime type, with or without parameters, means the body is protobuf bytes
+  for (const std::string type : {"application/x-protobuf", "application/x-protobuf; proto=Api",
+                                 "application/x-protobuffer", "application/x-protobuf-text"}) {
+    const bool is_pbf = type.find(';') != std::string::npos || type == "application/x-protobuf";
+    http_request_t request(POST, "/locate", bytes, {}, {{"Content-Type", type}});
+    Api api;
+    try {
+      ParseApi(request, api);
+      EXPECT_TRUE(is_pbf) << type << " should not have been read as protobuf";
+      EXPECT_EQ(api.options().locations_size(), 1);
+      EXPECT_TRUE(api.info().is_service());
+      EXPECT_EQ(api.info().statistics_size(), 0) << "Parsing is only timed when asked";
+    } catch (const valhalla_exception_t& e) {
+      EXPECT_FALSE(is_pbf) << type << " should have been read as protobuf";
+      EXPECT_EQ(e.code, 100);
+    }
+  }
+}
+
 } // namespace
 
 class LokiServiceEnv : public ::testing::Environment {
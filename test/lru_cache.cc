@@ -0,0 +1,119 @@
+#include <string>
+
+#include "midgard/lru_cache.h"
+
+#include "test.h"
+
+using namespace valhalla::midgard;
+
+namespace {
+
+using cache_t = lru_cache<std::string, int>;
+
+TEST(LruCache, hit_and_miss) {
+  cache_t cache(10);
+  EXPECT_EQ(cache.find("a"), nullptr);
+  ASSERT_NE(cache.insert("a", 1), nullptr);
+  ASSERT_NE(cache.find("a"), nullptr);
+  EXPECT_EQ(*cache.find("a"), 1);
+
+  // replacing keeps one entry
+  cache.insert("a", 2);
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_EQ(*cache.find("a"), 2);
+
+  // unusable values are misses but stay where they are
+  EXPECT_EQ(cache.find_if("a", [](int value) { return value == 1; }), nullptr);
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_EQ(*cache.peek("a"), 2);
+  EXPECT_EQ(cache.peek("b"), nullptr);
+
+  EXPECT_EQ(cache.hits(), 3);
+  EXPECT_EQ(cache.misses(), 2);
+
+  EXPECT_TRUE(cache.erase("a"));
+  EXPECT_FALSE(cache.erase("a"));
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_EQ(cache.evictions(), 0);
+}
+
+TEST(LruCache, evicts_least_recently_used) {
+  cache_t cache(3);
+  cache.insert("a", 1);
+  cache.insert("b", 2);
+  cache.insert("c", 3);
+
+  // touch the first so that the second is the oldest, peeking doesnt count
+  EXPECT_NE(cache.find("a"), nullptr);
+  EXPECT_NE(cache.peek("b"), nullptr);
+  cache.insert("d", 4);
+  EXPECT_EQ(cache.size(), 3);
+  EXPECT_EQ(cache.evictions(), 1);
+  EXPECT_EQ(cache.find("b"), nullptr);
+  EXPECT_NE(cache.find("a"), nullptr);
+  EXPECT_NE(cache.find("c"), nullptr);
+  EXPECT_NE(cache.find("d"), nullptr);
+
+  // the same goes for bytes
+  cache_t bytes(0, 100);
+  bytes.insert("a", 1, 40);
+  bytes.insert("b", 2, 40);
+  EXPECT_EQ(bytes.bytes(), 80);
+  bytes.insert("c", 3, 40);
+  EXPECT_EQ(bytes.size(), 2);
+  EXPECT_EQ(bytes.bytes(), 80);
+  EXPECT_EQ(bytes.find("a"), nullptr);
+
+  // something too big to ever fit is not cached and doesnt evict anything
+  EXPECT_EQ(bytes.insert("b", 4, 101), nullptr);
+  ASSERT_NE(bytes.find("b"), nullptr);
+  EXPECT_EQ(*bytes.find("b"), 2);
+  EXPECT_EQ(bytes.bytes(), 80);
+
+  // removing on purpose isnt evicting
+  EXPECT_EQ(bytes.erase_if([](const std::string& key, int) { return key == "c"; }), 1);
+  EXPECT_EQ(bytes.bytes(), 40);
+  bytes.clear();
+  EXPECT_EQ(bytes.size(), 0);
+  EXPECT_EQ(bytes.bytes(), 0);
+  EXPECT_EQ(bytes.evictions(), 1);
+}
+
+TEST(LruCache, expires) {
+  const auto now = cache_t::clock_t::now();
+  const auto later = [now](int seconds) { return now + std::chrono::seconds(seconds); };
+
+  // age counts from the insert no matter how often its found
+  cache_t aged(0, 0, std::chrono::seconds(60));
+  aged.insert("a", 1, 0, now);
+  aged.insert("b", 2, 0, later(30));
+  EXPECT_NE(aged.find("a", later(59)), nullptr);
+  EXPECT_EQ(aged.find("a", later(60)), nullptr);
+  EXPECT_EQ(aged.size(), 1);
+  EXPECT_EQ(aged.expire(later(89)), 0);
+  EXPECT_EQ(aged.expire(later(90)), 1);
+  EXPECT_EQ(aged.size(), 0);
+  EXPECT_EQ(aged.evictions(), 2);
+
+  // idle time counts from the last time it was found
+  cache_t idle(0, 0, cache_t::clock_t::duration::max(), std::chrono::seconds(60));
+  idle.insert("a", 1, 0, now);
+  idle.insert("b", 2, 0, now);
+  EXPECT_NE(idle.find("a", later(50)), nullptr);
+  EXPECT_EQ(idle.expire(later(100)), 1);
+  EXPECT_NE(idle.find("a", later(100)), nullptr);
+  EXPECT_EQ(idle.find("b", later(100)), nullptr);
+
+  // and without limits nothing gets old
+  cache_t forever(0);
+  forever.insert("a", 1, 0, now);
+  EXPECT_EQ(forever.expire(later(1000000)), 0);
+  EXPECT_NE(forever.find("a", later(1000000)), nullptr);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,11 +1,14 @@
 #include <algorithm>
 #include <iostream>
 #include <random>
+#include <sstream>
 #include <utility>
 #include <vector>
 
 #include "baldr/json.h"
 #include "loki/worker.h"
+#include "meili/map_matcher_factory.h"
+#include "meili/match_sessions.h"
 #include "midgard/distanceapproximator.h"
 #include "midgard/encoded.h"
 #include "midgard/logging.h"
@@ -1505,6 +1508,325 @@ TEST(Mapmatch, openlr_parameter_falsy_native_api) {
     EXPECT_THROW(response.get_child("trip.linear_references"), std::runtime_error);
   }
 }
+
+std::vector<PointLL> online_trace(tyr::actor_t& actor) {
+  // drive a route and take a point every so often as if it were a gps trace
+  auto route = test::json_to_pt(actor.route(
+      R"({"costing":"auto","locations":[{"lat":52.0938563,"lon":5.08531221},{"lat":52.0795,"lon":5.1216}]})"));
+  auto shape = midgard::decode<std::vector<PointLL>>(
+      route.get_child("trip.legs").front().second.get<std::string>("shape"));
+  return midgard::resample_spherical_polyline(shape, 25);
+}
+
+TEST(Mapmatch, test_online_match) {
+  tyr::actor_t actor(conf, true);
+  auto shape = online_trace(actor);
+  ASSERT_GT(shape.size(), 100) << "The trace should be long enough to compact the session";
+  std::vector<meili::Measurement> trace;
+  for (const auto& p : shape) {
+    trace.emplace_back(p, 5.f, 50.f);
+  }
+
+  // match it all at once
+  meili::MapMatcherFactory factory(conf);
+  std::shared_ptr<meili::MapMatcher> offline(factory.Create(Costing::auto_));
+  auto expected = std::move(offline->OfflineMatch(trace).front());
+  ASSERT_EQ(expected.results.size(), trace.size());
+
+  // match it a few points at a time, each chunk starts where the last one left off
+  std::shared_ptr<meili::MapMatcher> online(factory.Create(Costing::auto_));
+  std::vector<meili::MatchResult> results;
+  size_t empty_chunks = 0;
+  for (size_t i = 0; i < trace.size(); i += 3) {
+    std::vector<meili::Measurement> points(trace.begin() + i,
+                                           trace.begin() + std::min(i + 3, trace.size()));
+    auto chunk = online->OnlineMatch(points, i + 3 >= trace.size());
+    if (chunk.results.empty()) {
+      ++empty_chunks;
+      continue;
+    }
+    EXPECT_FALSE(chunk.segments.empty());
+    if (!results.empty()) {
+      EXPECT_EQ(results.back().edgeid, chunk.results.front().edgeid);
+      EXPECT_EQ(results.back().lnglat, chunk.results.front().lnglat);
+    }
+    results.insert(results.end(), chunk.results.begin() + !results.empty(), chunk.results.end());
+  }
+  EXPECT_LT(empty_chunks, trace.size() / 6) << "The path should settle shortly after the trace";
+
+  // it should be the same as matching it all at once
+  ASSERT_EQ(results.size(), expected.results.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    EXPECT_EQ(results[i].edgeid, expected.results[i].edgeid) << "Point " << i << " was mismatched";
+    EXPECT_NEAR(results[i].distance_along, expected.results[i].distance_along, 1e-5);
+  }
+}
+
+TEST(Mapmatch, test_multi_source_routing) {
+  tyr::actor_t actor(conf, true);
+  auto shape = online_trace(actor);
+  std::vector<meili::Measurement> trace;
+  for (const auto& p : shape) {
+    trace.emplace_back(p, 5.f, 50.f);
+  }
+
+  // routing from one candidate at a time
+  meili::MapMatcherFactory factory(conf);
+  std::shared_ptr<meili::MapMatcher> matcher(factory.Create(Costing::auto_));
+  auto expected = std::move(matcher->OfflineMatch(trace).front());
+  ASSERT_EQ(expected.results.size(), trace.size());
+
+  // and from all of them at once should find the same thing, even when the label storage is reused
+  // and the transition cache and routing threads that it doesnt use are configured
+  auto multi_conf = conf;
+  multi_conf.put("meili.default.multi_source_routing", true);
+  multi_conf.put("meili.transition_cache.max_paths", 1000);
+  multi_conf.put("meili.routing_concurrency", 3);
+  meili::MapMatcherFactory multi_factory(multi_conf);
+  for (int i = 0; i < 2; ++i) {
+    std::shared_ptr<meili::MapMatcher> multi_matcher(multi_factory.Create(Costing::auto_));
+    auto results = std::move(multi_matcher->OfflineMatch(trace).front());
+    ASSERT_EQ(results.results.size(), expected.results.size());
+    for (size_t j = 0; j < results.results.size(); ++j) {
+      EXPECT_EQ(results.results[j].edgeid, expected.results[j].edgeid)
+          << "Point " << j << " was mismatched";
+      EXPECT_NEAR(results.results[j].distance_along, expected.results[j].distance_along, 1e-5);
+    }
+    EXPECT_NEAR(results.score, expected.score, 1.f);
+  }
+}
+
+TEST(Mapmatch, test_transition_cache) {
+  tyr::actor_t actor(conf, true);
+  auto shape = online_trace(actor);
+  std::vector<meili::Measurement> trace;
+  for (const auto& p : shape) {
+    trace.emplace_back(p, 5.f, 50.f);
+  }
+
+  meili::MapMatcherFactory factory(conf);
+  std::shared_ptr<meili::MapMatcher> matcher(factory.Create(Costing::auto_));
+  auto expected = std::move(matcher->OfflineMatch(trace).front());
+
+  // the second time around the paths come out of the cache and should be the same
+  auto cache_conf = conf;
+  cache_conf.put("meili.transition_cache.max_paths", 100000);
+  meili::MapMatcherFactory cache_factory(cache_conf);
+  const auto& cache = cache_factory.transition_cache();
+  ASSERT_NE(cache, nullptr);
+  for (int i = 0; i < 2; ++i) {
+    std::shared_ptr<meili::MapMatcher> cache_matcher(cache_factory.Create(Costing::auto_));
+    auto results = std::move(cache_matcher->OfflineMatch(trace).front());
+    ASSERT_EQ(results.results.size(), expected.results.size());
+    for (size_t j = 0; j < results.results.size(); ++j) {
+      EXPECT_EQ(results.results[j].edgeid, expected.results[j].edgeid)
+          << "Point " << j << " was mismatched";
+      EXPECT_NEAR(results.results[j].distance_along, expected.results[j].distance_along, 1e-5);
+    }
+    ASSERT_EQ(results.segments.size(), expected.segments.size());
+    for (size_t j = 0; j < results.segments.size(); ++j) {
+      EXPECT_EQ(results.segments[j].edgeid, expected.segments[j].edgeid);
+    }
+    EXPECT_NEAR(results.score, expected.score, 1.f);
+    EXPECT_GT(cache->size(), 0);
+    if (i > 0) {
+      EXPECT_GT(cache->hits(), 0);
+    }
+  }
+
+  // a different costing doesnt get the same paths
+  const auto hits = cache->hits();
+  std::shared_ptr<meili::MapMatcher> bike_matcher(cache_factory.Create(Costing::bicycle));
+  bike_matcher->OfflineMatch(trace);
+  EXPECT_EQ(cache->hits(), hits);
+}
+
+TEST(Mapmatch, test_topk_concurrency) {
+  tyr::actor_t actor(conf, true);
+  auto shape = online_trace(actor);
+  std::vector<meili::Measurement> trace;
+  for (const auto& p : shape) {
+    trace.emplace_back(p, 5.f, 50.f);
+  }
+
+  meili::MapMatcherFactory factory(conf);
+  std::shared_ptr<meili::MapMatcher> matcher(factory.Create(Costing::auto_));
+  auto expected = matcher->OfflineMatch(trace, 4);
+
+  // routing from the unused candidates on other threads gives the same alternatives in the same
+  // order, with or without the transition cache. the second time around the cache knows some paths
+  for (const bool cached : {false, true}) {
+    auto concurrent_conf = conf;
+    concurrent_conf.put("meili.routing_concurrency", 4);
+    if (cached) {
+      concurrent_conf.put("meili.transition_cache.max_paths", 100000);
+    }
+    meili::MapMatcherFactory concurrent_factory(concurrent_conf);
+    for (int i = 0; i < 2; ++i) {
+      std::shared_ptr<meili::MapMatcher> concurrent_matcher(
+          concurrent_factory.Create(Costing::auto_));
+      auto paths = concurrent_matcher->OfflineMatch(trace, 4);
+      ASSERT_EQ(paths.size(), expected.size());
+      for (size_t k = 0; k < paths.size(); ++k) {
+        ASSERT_EQ(paths[k].results.size(), expected[k].results.size());
+        for (size_t j = 0; j < paths[k].results.size(); ++j) {
+          EXPECT_EQ(paths[k].results[j].edgeid, expected[k].results[j].edgeid)
+              << "Point " << j << " of path " << k << " was mismatched";
+        }
+        ASSERT_EQ(paths[k].segments.size(), expected[k].segments.size());
+        for (size_t j = 0; j < paths[k].segments.size(); ++j) {
+          EXPECT_EQ(paths[k].segments[j].edgeid, expected[k].segments[j].edgeid);
+        }
+        EXPECT_NEAR(paths[k].score, expected[k].score, 1.f);
+      }
+    }
+    if (cached) {
+      EXPECT_GT(concurrent_factory.transition_cache()->hits(), 0);
+    }
+  }
+}
+
+TEST(Mapmatch, test_online_session) {
+  tyr::actor_t actor(conf, true);
+  auto shape = online_trace(actor);
+  std::vector<float> accuracies(shape.size(), 5.f);
+  auto expected = test::json_to_pt(actor.trace_route(
+      R"({"costing":"auto","shape_match":"map_snap","shape":)" + to_locations(shape, accuracies) +
+      "}"));
+  auto expected_length = expected.get<float>("trip.summary.length");
+
+  // send the trace in a bit at a time, we only hear back once its settled
+  float length = 0;
+  size_t chunks = 0;
+  for (size_t i = 0; i < shape.size(); i += 5) {
+    std::vector<PointLL> points(shape.begin() + i, shape.begin() + std::min(i + 5, shape.size()));
+    bool end = i + 5 >= shape.size();
+    try {
+      auto matched = test::json_to_pt(actor.trace_route(
+          R"({"costing":"auto","shape_match":"map_snap","session_id":"truck 1","session_end":)" +
+          std::string(end ? "true" : "false") +
+          R"(,"shape":)" + to_locations(points, accuracies) + "}"));
+      length += matched.get<float>("trip.summary.length");
+      ++chunks;
+    } catch (const valhalla_exception_t& e) {
+      EXPECT_FALSE(end) << "The end of the session should always match";
+      EXPECT_EQ(e.code, 446);
+    }
+  }
+
+  // all the bits of route should add up to the whole
+  EXPECT_GT(chunks, 1);
+  EXPECT_NEAR(length, expected_length, expected_length * .01f + chunks * .001f);
+
+  // a session cant change its options midway
+  std::vector<PointLL> points(shape.begin(), shape.begin() + 5);
+  auto request = [&](const std::string& costing) {
+    return R"({"costing":")" + costing +
+           R"(","shape_match":"map_snap","session_id":"truck 2","shape":)" +
+           to_locations(points, accuracies) + "}";
+  };
+  try {
+    actor.trace_route(request("auto"));
+  } catch (const valhalla_exception_t& e) { EXPECT_EQ(e.code, 446); }
+  try {
+    actor.trace_route(request("bicycle"));
+    FAIL() << "The session should not have let its costing change";
+  } catch (const valhalla_exception_t& e) { EXPECT_EQ(e.code, 447); }
+}
+
+TEST(Mapmatch, test_trace_batch) {
+  // a few traces and one that cant be matched
+  std::vector<std::string> requests = {
+      R"({"costing":"auto","shape_match":"map_snap","shape":[{"lon":5.08531221,"lat":52.0938563},{"lon":5.0865867,"lat":52.0930211}]})",
+      R"({"costing":"auto","shape_match":"map_snap","shape":[{"lat":52.0990768,"lon":5.1069392},{"lat":52.0995259,"lon":5.1073563}]})",
+      R"({"costing":"auto","shape_match":"map_snap","shape":[{"lat":52.09110,"lon":5.09806},{"lat":52.09050,"lon":5.09769},{"lat":52.09098,"lon":5.09679}]})",
+      R"({"costing":"auto","shape_match":"map_snap","shape":[{"lat":0,"lon":0},{"lat":0.0001,"lon":0}]})",
+  };
+  std::stringstream input;
+  for (int i = 0; i < 5; ++i) {
+    for (const auto& request : requests) {
+      input << request << "\n\n";
+    }
+  }
+
+  // they should match the same as they do one at a time
+  tyr::actor_t actor(conf, true);
+  std::vector<std::string> expected;
+  for (const auto& request : requests) {
+    try {
+      expected.push_back(actor.trace_attributes(request));
+    } catch (const valhalla_exception_t&) { expected.push_back(""); }
+  }
+  std::vector<bool> seen(requests.size() * 5);
+  auto failed = actor.trace_batch(input, Options::trace_attributes,
+                                  [&](size_t line, bool success, const std::string& response) {
+                                    ASSERT_EQ(line % 2, 0) << "Blank lines should be skipped";
+                                    ASSERT_LT(line / 2, seen.size());
+                                    EXPECT_FALSE(seen[line / 2]);
+                                    seen[line / 2] = true;
+                                    const auto& answer = expected[line / 2 % requests.size()];
+                                    EXPECT_EQ(success, !answer.empty());
+                                    if (success) {
+                                      EXPECT_EQ(response, answer);
+                                    } else {
+                                      EXPECT_NE(response.find("error_code"), std::string::npos);
+                                    }
+                                  },
+                                  3);
+  EXPECT_EQ(failed, 5);
+  EXPECT_EQ(std::count(seen.begin(), seen.end(), true), seen.size());
+
+  // there is no room for pbf in a line of output
+  std::stringstream pbf(R"({"format":"pbf",)" + requests.front().substr(1) + "\n");
+  failed = actor.trace_batch(pbf, Options::trace_route,
+                             [](size_t, bool success, const std::string& response) {
+                               EXPECT_FALSE(success);
+                               EXPECT_NE(response.find("169"), std::string::npos);
+                             });
+  EXPECT_EQ(failed, 1);
+
+  // only the map matching actions are supported
+  std::stringstream empty;
+  EXPECT_THROW(actor.trace_batch(empty, Options::route, [](size_t, bool, const std::string&) {}),
+               valhalla_exception_t);
+}
+
+TEST(Mapmatch, test_session_eviction) {
+  meili::MapMatcherFactory factory(conf);
+  meili::MatchSessions sessions(2, 60);
+  auto create = [&factory]() { return factory.Create(Costing::auto_); };
+  auto now = meili::MatchSessions::clock_t::now();
+
+  // the same session gets the same matcher
+  auto a = sessions.Get("a", "", create, now);
+  EXPECT_EQ(a, sessions.Get("a", "", create, now));
+  sessions.Get("b", "", create, now);
+  EXPECT_EQ(sessions.size(), 2);
+
+  // too many sessions evicts the least recently used
+  sessions.Get("a", "", create, now);
+  sessions.Get("c", "", create, now);
+  EXPECT_EQ(sessions.size(), 2);
+  EXPECT_EQ(sessions.evicted(), 1);
+  EXPECT_NE(sessions.Get("b", "", create, now), nullptr);
+  EXPECT_EQ(sessions.evicted(), 2);
+  EXPECT_NE(a, sessions.Get("a", "", create, now)) << "a should have been evicted by b";
+
+  // idle sessions are evicted
+  EXPECT_EQ(sessions.Evict(now + std::chrono::seconds(30)), 0);
+  EXPECT_EQ(sessions.Evict(now + std::chrono::seconds(61)), 2);
+  EXPECT_EQ(sessions.size(), 0);
+
+  // a session sticks to the options it was started with
+  a = sessions.Get("a", "", create, now);
+  EXPECT_EQ(sessions.Get("a", "bicycle", create, now), nullptr);
+  EXPECT_EQ(a, sessions.Get("a", "", create, now));
+
+  // finished sessions can be removed
+  EXPECT_TRUE(sessions.Remove("a"));
+  EXPECT_FALSE(sessions.Remove("a"));
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
@@ -1338,6 +1338,117 @@ TEST(NarrativeDictionary, test_en_US_approach_verbal_alert) {
   validate(us_customary_lengths, kExpectedUsCustomaryLengths);
 }
 
+TEST(NarrativeDictionary, test_phrase_template) {
+  PhraseTemplate phrase("Turn <RELATIVE_DIRECTION> onto <STREET_NAMES>. <NOT_A_TAG> <STREET_NAMES>");
+  std::string instruction = "something left over";
+  phrase.Render(instruction,
+                {{PhraseTag::kRelativeDirection, "left"}, {PhraseTag::kStreetNames, "Main St"}});
+  EXPECT_EQ(instruction, "Turn left onto Main St. <NOT_A_TAG> Main St");
+
+  // tags without a value stay as they are
+  phrase.Render(instruction, {{PhraseTag::kStreetNames, "Main St"}});
+  EXPECT_EQ(instruction, "Turn <RELATIVE_DIRECTION> onto Main St. <NOT_A_TAG> Main St");
+
+  // tags right next to each other and at the ends, and brackets that never close
+  PhraseTemplate tags("<CURRENT_VERBAL_CUE><NEXT_VERBAL_CUE> <<LENGTH>");
+  tags.Render(instruction, {{PhraseTag::kCurrentVerbalCue, "a"},
+                            {PhraseTag::kNextVerbalCue, "b"},
+                            {PhraseTag::kLength, "c"}});
+  EXPECT_EQ(instruction, "ab <c");
+  PhraseTemplate("no tags < here").Render(instruction);
+  EXPECT_EQ(instruction, "no tags < here");
+}
+
+TEST(NarrativeDictionary, test_templates_match_phrases) {
+  // every phrase of every locale is split into a template that renders back to the phrase
+  for (const auto& locale : get_locales()) {
+    const auto& dictionary = *locale.second;
+    const std::vector<const PhraseSet*> sets = {&dictionary.start_subset,
+                                                &dictionary.destination_subset,
+                                                &dictionary.turn_verbal_subset,
+                                                &dictionary.exit_subset,
+                                                &dictionary.transit_subset,
+                                                &dictionary.verbal_multi_cue_subset,
+                                                &dictionary.exit_building_subset};
+    for (const auto* set : sets) {
+      ASSERT_EQ(set->templates.size(), set->phrases.size()) << locale.first;
+      for (const auto& phrase : set->phrases) {
+        std::string instruction;
+        set->templates.at(std::stoul(phrase.first)).Render(instruction);
+        EXPECT_EQ(instruction, phrase.second) << locale.first;
+      }
+    }
+  }
+}
+
+TEST(NarrativeDictionary, test_en_US_templates_round_trip) {
+  // the text of each tag in the order of PhraseTag
+  const std::vector<std::string> tag_texts = {kCardinalDirectionTag, kRelativeDirectionTag,
+                                              kOrdinalValueTag, kStreetNamesTag,
+                                              kPreviousStreetNamesTag, kBeginStreetNamesTag,
+                                              kCrossStreetNamesTag, kRoundaboutExitStreetNamesTag,
+                                              kRoundaboutExitBeginStreetNamesTag,
+                                              kRampExitNumbersVisualTag, kLengthTag, kDestinationTag,
+                                              kCurrentVerbalCueTag, kNextVerbalCueTag, kKilometersTag,
+                                              kMetersTag, kMilesTag, kTenthsOfMilesTag, kFeetTag,
+                                              kNumberSignTag, kBranchSignTag, kTowardSignTag,
+                                              kNameSignTag, kJunctionNameTag, kFerryLabelTag,
+                                              kTransitPlatformTag, kStationLabelTag, kTimeTag,
+                                              kTransitNameTag, kTransitHeadSignTag,
+                                              kTransitPlatformCountTag, kTransitPlatformCountLabelTag,
+                                              kLevelTag};
+  ASSERT_EQ(tag_texts.size(), static_cast<size_t>(PhraseTag::kNone));
+
+  const auto& dictionary = *get_locales().at("en-US");
+  const std::vector<const PhraseSet*> sets = {
+      &dictionary.start_subset, &dictionary.start_verbal_subset, &dictionary.destination_subset,
+      &dictionary.destination_verbal_alert_subset, &dictionary.destination_verbal_subset,
+      &dictionary.becomes_subset, &dictionary.becomes_verbal_subset, &dictionary.continue_subset,
+      &dictionary.continue_verbal_alert_subset, &dictionary.continue_verbal_subset,
+      &dictionary.bear_subset, &dictionary.bear_verbal_subset, &dictionary.turn_subset,
+      &dictionary.turn_verbal_subset, &dictionary.sharp_subset, &dictionary.sharp_verbal_subset,
+      &dictionary.uturn_subset, &dictionary.uturn_verbal_subset, &dictionary.ramp_straight_subset,
+      &dictionary.ramp_straight_verbal_subset, &dictionary.ramp_subset,
+      &dictionary.ramp_verbal_subset, &dictionary.exit_subset, &dictionary.exit_verbal_subset,
+      &dictionary.exit_visual_subset, &dictionary.keep_subset, &dictionary.keep_verbal_subset,
+      &dictionary.keep_to_stay_on_subset, &dictionary.keep_to_stay_on_verbal_subset,
+      &dictionary.merge_subset, &dictionary.merge_verbal_subset, &dictionary.enter_roundabout_subset,
+      &dictionary.enter_roundabout_verbal_subset, &dictionary.exit_roundabout_subset,
+      &dictionary.exit_roundabout_verbal_subset, &dictionary.enter_ferry_subset,
+      &dictionary.enter_ferry_verbal_subset, &dictionary.transit_connection_start_subset,
+      &dictionary.transit_connection_start_verbal_subset,
+      &dictionary.transit_connection_transfer_subset,
+      &dictionary.transit_connection_transfer_verbal_subset,
+      &dictionary.transit_connection_destination_subset,
+      &dictionary.transit_connection_destination_verbal_subset, &dictionary.depart_subset,
+      &dictionary.depart_verbal_subset, &dictionary.arrive_subset, &dictionary.arrive_verbal_subset,
+      &dictionary.transit_subset, &dictionary.transit_verbal_subset,
+      &dictionary.transit_remain_on_subset, &dictionary.transit_remain_on_verbal_subset,
+      &dictionary.transit_transfer_subset, &dictionary.transit_transfer_verbal_subset,
+      &dictionary.post_transition_verbal_subset, &dictionary.post_transition_transit_verbal_subset,
+      &dictionary.verbal_multi_cue_subset, &dictionary.approach_verbal_alert_subset,
+      &dictionary.elevator_subset, &dictionary.steps_subset, &dictionary.escalator_subset,
+      &dictionary.enter_building_subset, &dictionary.exit_building_subset};
+  for (const auto* set : sets) {
+    ASSERT_EQ(set->templates.size(), set->phrases.size());
+    for (const auto& phrase : set->phrases) {
+      const auto& phrase_template = set->templates.at(std::stoul(phrase.first));
+      EXPECT_EQ(phrase_template.phrase(), phrase.second);
+
+      // with no values every tag is written as it is
+      std::string instruction;
+      phrase_template.Render(instruction);
+      EXPECT_EQ(instruction, phrase.second);
+
+      // and replacing a tag with its own text has to give the phrase back too
+      for (size_t i = 0; i < tag_texts.size(); ++i) {
+        phrase_template.Render(instruction, {{static_cast<PhraseTag>(i), tag_texts[i]}});
+        EXPECT_EQ(instruction, phrase.second) << tag_texts[i];
+      }
+    }
+  }
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
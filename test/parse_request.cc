@@ -2811,6 +2811,65 @@ TEST(ParseRequest, test_operators_transit_filter) {
   test_filter_operator_parsing(costing, filter_action, filter_ids);
 }
 
+TEST(ParseRequest, pbf_input_validated_like_json) {
+  const std::string locations = R"("locations":[{"lat":52.09,"lon":5.11},{"lat":52.1,"lon":5.12}])";
+  const std::unordered_map<Options::Action, std::string> requests{
+      {Options::route, "{" + locations + R"(,"costing":"auto","units":"mi"})"},
+      {Options::locate, "{" + locations + R"(,"costing":"pedestrian","verbose":true})"},
+      {Options::sources_to_targets,
+       R"({"sources":[{"lat":52.09,"lon":5.11}],"targets":[{"lat":52.1,"lon":5.12}],)"
+       R"("costing":"bicycle"})"},
+      {Options::isochrone, "{" + locations + R"(,"costing":"auto","contours":[{"time":10}]})"},
+      {Options::height, R"({"shape":[{"lat":52.09,"lon":5.11}],"range":true})"},
+  };
+
+  for (const auto& request : requests) {
+    // parsing is only timed when asked
+    Api untimed;
+    ParseApi(request.second, request.first, untimed);
+    EXPECT_EQ(untimed.info().statistics_size(), 0);
+
+    Api from_json;
+    ParseApi(request.second, request.first, from_json, true);
+    ASSERT_EQ(from_json.info().statistics_size(), 1);
+    EXPECT_EQ(from_json.info().statistics(0).key(),
+              Options_Action_Enum_Name(request.first) + ".info.parse_json.latency_ms");
+
+    // the same options as bytes come out the same after going through validation again, the
+    // costing options get filled back in from the costing type
+    Api from_pbf;
+    ASSERT_TRUE(from_pbf.ParseFromString(from_json.SerializeAsString()));
+    from_pbf.mutable_options()->clear_costings();
+    ParseApi("", request.first, from_pbf, true);
+    const auto& expected = from_json.options();
+    const auto& actual = from_pbf.options();
+    EXPECT_EQ(actual.action(), expected.action());
+    EXPECT_EQ(actual.costing_type(), expected.costing_type());
+    EXPECT_EQ(actual.costings().size(), expected.costings().size());
+    EXPECT_EQ(actual.units(), expected.units());
+    EXPECT_EQ(actual.verbose(), expected.verbose());
+    EXPECT_EQ(actual.range(), expected.range());
+    EXPECT_EQ(actual.locations_size(), expected.locations_size());
+    EXPECT_EQ(actual.sources_size(), expected.sources_size());
+    EXPECT_EQ(actual.targets_size(), expected.targets_size());
+    EXPECT_EQ(actual.shape_size(), expected.shape_size());
+    EXPECT_EQ(actual.contours_size(), expected.contours_size());
+    ASSERT_EQ(from_pbf.info().statistics_size(), 1);
+    EXPECT_EQ(from_pbf.info().statistics(0).key(),
+              Options_Action_Enum_Name(request.first) + ".info.parse_pbf.latency_ms");
+    EXPECT_EQ(from_pbf.info().statistics(0).type(), timing);
+  }
+
+  // and bad pbf input is caught the same way as bad json input
+  Api bad;
+  bad.mutable_options()->set_costing_type(Costing::auto_);
+  bad.mutable_options()->set_date_time_type(Options::depart_at);
+  try {
+    ParseApi("", Options::route, bad);
+    FAIL() << "Expected a departure time to be required";
+  } catch (const valhalla_exception_t& e) { EXPECT_EQ(e.code, 160); }
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
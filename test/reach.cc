@@ -82,6 +82,61 @@ TEST(Reach, check_all_reach) {
   }
 }
 
+TEST(Reach, cached_reach) {
+  GraphReader reader(conf.get_child("mjolnir"));
+  auto costing = vs::CostFactory{}.Create(Costing::auto_);
+  Reach reach_finder;
+  ReachCache cache(1 << 24);
+  Reach cached_reach_finder(&cache, 42);
+
+  // fill up the cache
+  std::vector<std::pair<GraphId, const DirectedEdge*>> edges;
+  for (auto tile_id : reader.GetTileSet()) {
+    auto tile = reader.GetGraphTile(tile_id);
+    for (GraphId edge_id = tile->header()->graphid();
+         edge_id.id() < tile->header()->directededgecount(); ++edge_id) {
+      edges.emplace_back(edge_id, tile->directededge(edge_id));
+      cached_reach_finder(edges.back().second, edge_id, 50, reader, costing);
+    }
+  }
+  ASSERT_EQ(cache.size(), edges.size());
+  ASSERT_EQ(cache.hits(), 0);
+
+  // the cached answers have to be the same as expanding again, even for a smaller max reach
+  for (uint32_t max_reach : {50, 20}) {
+    for (const auto& edge : edges) {
+      auto expected = reach_finder(edge.second, edge.first, max_reach, reader, costing);
+      auto reach = cached_reach_finder(edge.second, edge.first, max_reach, reader, costing);
+      EXPECT_EQ(reach.outbound, expected.outbound) << std::to_string(edge.first.value);
+      EXPECT_EQ(reach.inbound, expected.inbound) << std::to_string(edge.first.value);
+    }
+  }
+  EXPECT_EQ(cache.hits(), edges.size() * 2);
+
+  // a larger max reach can only use the results that were below the old max
+  size_t hits = cache.hits();
+  size_t below = 0;
+  for (const auto& edge : edges) {
+    directed_reach reach;
+    below += cache.Find(42, edge.first, reader.GetGraphTile(edge.first)->header()->dataset_id(), 100,
+                        kInbound | kOutbound, reach);
+  }
+  EXPECT_LT(below, edges.size());
+  EXPECT_EQ(cache.hits(), hits + below);
+
+  // other costings and other datasets dont share results
+  directed_reach reach;
+  const auto& edge = edges.front();
+  auto dataset_id = reader.GetGraphTile(edge.first)->header()->dataset_id();
+  EXPECT_TRUE(cache.Find(42, edge.first, dataset_id, 50, kInbound | kOutbound, reach));
+  EXPECT_FALSE(cache.Find(43, edge.first, dataset_id, 50, kInbound | kOutbound, reach));
+  EXPECT_FALSE(cache.Find(42, edge.first, dataset_id + 1, 50, kInbound | kOutbound, reach));
+  EXPECT_FALSE(cache.Find(42, edge.first, dataset_id, 50, kOutbound, reach));
+
+  cache.Clear();
+  EXPECT_EQ(cache.size(), 0);
+}
+
 TEST(Reach, transition_misscount) {
   const std::string ascii_map = R"(
       b--c--d
@@ -1,4 +1,5 @@
 #include <cstdint>
+#include <set>
 // -*- mode: c++ -*-
 #include "meili/routing.h"
 
@@ -212,6 +213,38 @@ TEST(Routing, TestRoutePathIterator) {
   EXPECT_EQ(it5, the_end) << "TestRoutePathIterator: wrong advance";
 }
 
+TEST(Routing, TestLabelSetStorage) {
+  auto storage = std::make_shared<meili::LabelSetStorage>();
+  sif::TravelMode travelmode = static_cast<sif::TravelMode>(0);
+  baldr::GraphId node(1, 2, 3);
+
+  // the same node and destination get a label for each origin but only one per origin
+  meili::LabelSet labelset(100, 1.0f, storage);
+  labelset.put(node, travelmode, nullptr, 0);
+  labelset.put(node, travelmode, nullptr, 1);
+  labelset.put(node, travelmode, nullptr, 1);
+  labelset.put(7, travelmode, nullptr, 0);
+  labelset.put(7, travelmode, nullptr, 1);
+  std::multiset<uint16_t> origins;
+  for (auto idx = labelset.pop(); idx != baldr::kInvalidLabel; idx = labelset.pop()) {
+    origins.insert(labelset.label(idx).origin());
+  }
+  EXPECT_EQ(origins, (std::multiset<uint16_t>{0, 0, 1, 1}));
+
+  // a new label set starts from scratch even if the last search didnt clean up after itself
+  labelset.put(baldr::GraphId(1, 2, 4), travelmode, nullptr, 0);
+  meili::LabelSet reused(100, 1.0f, storage);
+  EXPECT_EQ(reused.pop(), baldr::kInvalidLabel);
+  reused.put(node, travelmode, nullptr, 0);
+  EXPECT_EQ(reused.pop(), 0);
+  EXPECT_EQ(reused.label(0).nodeid(), node);
+
+  // the labels of the old one are still there to recover paths from
+  EXPECT_EQ(labelset.label(0).nodeid(), node);
+  EXPECT_EQ(labelset.label(3).dest(), 7);
+  EXPECT_EQ(labelset.label(3).origin(), 1);
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
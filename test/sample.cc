@@ -9,6 +9,9 @@
 #include <fstream>
 #include <list>
 #include <lz4frame.h>
+#include <random>
+#include <thread>
+#include <utime.h>
 
 #include "test.h"
 
@@ -81,9 +84,9 @@ TEST(Sample, create_tile) {
   lzfile.write(static_cast<const char*>(static_cast<void*>(lz4_buffer.data())), out_bytes);
 }
 
-void _get(const std::string& location) {
+void _get(const std::string& location, const std::string& unpacked = "") {
   // check a single point
-  skadi::sample s(location);
+  skadi::sample s(location, unpacked);
   EXPECT_NEAR(490, s.get(std::make_pair(-76.503915, 40.678783)), 1.0);
 
   // check a point near the edge of a tile
@@ -118,6 +121,87 @@ TEST(Sample, getlz4) {
   _get("test/data/samplelz4");
 };
 
+TEST(Sample, get_unpacked) {
+  // the first sample unpacks the tile to disk
+  filesystem::remove_all("test/data/sampleunpacked");
+  _get("test/data/samplegz", "test/data/sampleunpacked");
+  const std::string unpacked = "test/data/sampleunpacked/N40/N40W077.hgt";
+  ASSERT_TRUE(filesystem::exists(unpacked));
+  EXPECT_EQ(filesystem::directory_entry(unpacked).file_size(), 3601 * 3601 * sizeof(int16_t));
+
+  // and the next one picks up what it left behind
+  _get("test/data/samplegz", "test/data/sampleunpacked");
+  _get("test/data/samplelz4", "test/data/sampleunpacked");
+
+  // a partial copy is unpacked again
+  { std::ofstream file(unpacked, std::ios::binary | std::ios::trunc); }
+  _get("test/data/samplegz", "test/data/sampleunpacked");
+  EXPECT_EQ(filesystem::directory_entry(unpacked).file_size(), 3601 * 3601 * sizeof(int16_t));
+
+  // and so is a copy older than the compressed tile
+  {
+    std::vector<int16_t> tile(3601 * 3601, 0);
+    std::ofstream file(unpacked, std::ios::binary | std::ios::trunc);
+    file.write(static_cast<const char*>(static_cast<void*>(tile.data())), tile.size() * 2);
+  }
+  struct utimbuf epoch {};
+  ASSERT_EQ(utime(unpacked.c_str(), &epoch), 0);
+  _get("test/data/samplegz", "test/data/sampleunpacked");
+}
+
+// postings in and around the tile we have with some jumping off to tiles we dont have
+std::vector<std::pair<double, double>> scattered_postings(size_t count) {
+  std::mt19937 generator(17);
+  std::uniform_real_distribution<double> lon(-77, -76), lat(40, 41);
+  std::uniform_int_distribution<int> elsewhere(0, 9);
+  std::vector<std::pair<double, double>> postings;
+  for (size_t i = 0; i < count; ++i) {
+    if (elsewhere(generator) == 0) {
+      postings.emplace_back(lon(generator) + 2, lat(generator) - 3);
+    } else {
+      postings.emplace_back(lon(generator), lat(generator));
+    }
+  }
+  return postings;
+}
+
+TEST(Sample, get_all_order) {
+  // sampling by tile shouldnt change which value goes with which posting
+  skadi::sample s("test/data/sample");
+  auto postings = scattered_postings(200);
+  auto values = s.get_all(postings);
+  ASSERT_EQ(values.size(), postings.size());
+  for (size_t i = 0; i < postings.size(); ++i) {
+    EXPECT_EQ(values[i], s.get(postings[i])) << "Wrong value for posting " << i;
+  }
+}
+
+TEST(Sample, concurrent) {
+  auto postings = scattered_postings(1000);
+  skadi::sample raw("test/data/sample");
+  auto expected = raw.get_all(postings);
+
+  // lots of threads racing to unpack the same tile and then reading it without locks
+  for (const auto& location : {"test/data/samplegz", "test/data/samplelz4"}) {
+    skadi::sample s(location);
+    std::vector<std::vector<double>> results(8);
+    std::vector<std::thread> threads;
+    for (auto& result : results) {
+      threads.emplace_back([&s, &postings, &result]() {
+        for (int i = 0; i < 4; ++i) {
+          result = s.get_all(postings);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (const auto& result : results) {
+      EXPECT_EQ(result, expected) << location;
+    }
+  }
+}
+
 struct testable_sample_t : public skadi::sample {
   testable_sample_t(const std::string& dir) : sample(dir) {
     {
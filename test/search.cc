@@ -8,6 +8,7 @@
 #include "baldr/graphreader.h"
 #include "baldr/location.h"
 #include "baldr/pathlocation.h"
+#include "baldr/segment_index.h"
 #include "baldr/tilehierarchy.h"
 #include "filesystem.h"
 #include "midgard/pointll.h"
@@ -23,6 +24,7 @@ namespace vs = valhalla::sif;
 
 #include "mjolnir/directededgebuilder.h"
 #include "mjolnir/graphtilebuilder.h"
+#include "mjolnir/segmentindexbuilder.h"
 
 namespace {
 
@@ -41,6 +43,7 @@ namespace {
 //    |/
 //    c
 const std::string tile_dir = "test/search_tiles";
+const std::string segment_index_file = tile_dir + "/segment_index.bin";
 GraphId tile_id = TileHierarchy::GetGraphId({.125, .125}, 2);
 PointLL base_ll = TileHierarchy::get_tiling(tile_id.level()).Base(tile_id.tileid());
 std::pair<GraphId, PointLL> b({tile_id.tileid(), tile_id.level(), 0}, {.01, .2});
@@ -170,6 +173,22 @@ void make_tile() {
     valhalla::baldr::GraphReader reader(conf);
     auto tile = reader.GetGraphTile(tile_id);
     ASSERT_EQ(tile->header()->directededgecount(), 10);
+
+    // index the segments too so we can compare against the bins
+    SegmentIndexBuilder::Build(conf, segment_index_file);
+  }
+}
+
+// searching with the segment index has to give the same answers as walking the bins
+void compare_segment_index(const Location& location,
+                           GraphReader& reader,
+                           const std::shared_ptr<vs::DynamicCost>& costing,
+                           const std::unordered_map<Location, PathLocation>& results) {
+  SegmentIndex index(segment_index_file);
+  const auto indexed = Search({location}, reader, costing, &index);
+  ASSERT_EQ(results.size(), indexed.size()) << "Segment index found different locations";
+  for (const auto& result : results) {
+    ASSERT_TRUE(result.second == indexed.at(result.first)) << "Segment index found different edges";
   }
 }
 
@@ -195,6 +214,7 @@ void search(valhalla::baldr::Location location,
 
   const auto costing = create_costing();
   const auto results = Search({location}, reader, costing);
+  compare_segment_index(location, reader, costing, results);
   const auto& p = results.at(location);
 
   ASSERT_EQ((p.edges.front().begin_node() || p.edges.front().end_node()), expected_node)
@@ -234,6 +254,7 @@ void search(valhalla::baldr::Location location, size_t result_count, int reachab
   const auto costing = create_costing();
 
   const auto results = Search({location}, reader, costing);
+  compare_segment_index(location, reader, costing, results);
   if (results.empty() && result_count == 0)
     return;
 
@@ -456,6 +477,88 @@ TEST(Search, test_search_cutoff) {
   search(x, 2, 0);
 }
 
+TEST(Search, test_segment_index) {
+  SegmentIndex index(segment_index_file);
+  // 5 edges with 2 segments each, opposing edges share their shape
+  ASSERT_EQ(index.size(), 10);
+
+  // loki only uses an index that was built from the tiles it has
+  boost::property_tree::ptree conf;
+  conf.put("tile_dir", tile_dir);
+  GraphReader reader(conf);
+  EXPECT_EQ(index.dataset_id(), reader.GetDatasetId());
+
+  // closest to the middle of a-d is one of its two directions
+  auto hits = index.Nearest(a.second.PointAlongSegment(d.second), 1);
+  ASSERT_EQ(hits.size(), 1);
+  EXPECT_LT(hits.front().distance, 1.0);
+  EXPECT_TRUE(hits.front().edge_id.id() == 3 || hits.front().edge_id.id() == 8);
+
+  // a has 3 edges leaving it
+  hits = index.Within(a.second, 1.0);
+  ASSERT_EQ(hits.size(), 3);
+  for (const auto& hit : hits) {
+    EXPECT_TRUE(hit.point.ApproximatelyEqual(a.second));
+  }
+
+  // k nearest come back sorted and unique
+  hits = index.Nearest(a.second, 5);
+  ASSERT_EQ(hits.size(), 5);
+  for (size_t i = 1; i < hits.size(); ++i) {
+    EXPECT_LE(hits[i - 1].distance, hits[i].distance);
+  }
+
+  // and everything can be filtered out
+  SegmentIndex::Filter filter;
+  filter.min_road_class = RoadClass::kTrunk;
+  filter.max_road_class = RoadClass::kTrunk;
+  EXPECT_TRUE(index.Nearest(a.second, 5, filter).empty());
+  filter = {};
+  filter.access_mask = 0;
+  EXPECT_TRUE(index.Within(a.second, 100000, filter).empty());
+}
+
+TEST(Search, test_parallel) {
+  boost::property_tree::ptree conf;
+  conf.put("tile_dir", tile_dir);
+  conf.put("global_synchronized_cache", true);
+  GraphReader reader(conf);
+  std::vector<std::shared_ptr<GraphReader>> thread_readers;
+  for (int i = 0; i < 4; ++i) {
+    thread_readers.emplace_back(std::make_shared<GraphReader>(conf));
+  }
+  valhalla::midgard::ThreadPool pool(3);
+
+  // enough locations with a variety of options to get spread over all of the threads
+  std::vector<Location> locations;
+  for (int i = 0; i < 8; ++i) {
+    for (int j = 0; j < 8; ++j) {
+      Location location({.005 + .03 * i, .005 + .03 * j});
+      location.min_outbound_reach_ = location.min_inbound_reach_ = (i + j) % 3;
+      location.radius_ = (i * j) % 2 ? 500 : 0;
+      if (j % 4 == 0)
+        location.heading_ = 45.f * i;
+      locations.push_back(location);
+    }
+  }
+
+  // it has to be the same as doing them all on one thread
+  const auto costing = create_costing();
+  const auto serial = Search(locations, reader, costing);
+  const auto parallel = Search(locations, reader, costing, nullptr, thread_readers, &pool);
+  ASSERT_EQ(serial.size(), locations.size());
+  ASSERT_EQ(serial.size(), parallel.size());
+  for (const auto& result : serial) {
+    ASSERT_TRUE(result.second == parallel.at(result.first)) << "Parallel search differs";
+  }
+
+  // and also the same as doing them one at a time
+  for (const auto& location : locations) {
+    const auto single = Search({location}, reader, costing);
+    ASSERT_TRUE(single.at(location) == serial.at(location)) << "Batch search found different edges";
+  }
+}
+
 } // namespace
 
 // Setup and tearown will be called only once for the entire suite121
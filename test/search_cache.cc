@@ -0,0 +1,100 @@
+#include "loki/search_cache.h"
+
+#include "test.h"
+
+using namespace valhalla;
+using namespace valhalla::baldr;
+using namespace valhalla::loki;
+
+namespace {
+
+PathLocation make_result(const baldr::Location& location, size_t edge_count) {
+  PathLocation result(location);
+  for (size_t i = 0; i < edge_count; ++i) {
+    result.edges.emplace_back(GraphId(1, 2, i), .5, location.latlng_, 10.0 * i);
+  }
+  result.filtered_edges.emplace_back(GraphId(1, 2, 100), 0, location.latlng_, 100.0);
+  return result;
+}
+
+TEST(SearchCache, hit_and_miss) {
+  SearchCache cache(1 << 20);
+  baldr::Location location({5.1, 52.1});
+  location.radius_ = 10;
+
+  PathLocation result(location);
+  EXPECT_FALSE(cache.Find(location, 1, result));
+  cache.Insert(location, 1, make_result(location, 3));
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_GT(cache.bytes(), 0);
+
+  // the same spot gives back the same candidates
+  ASSERT_TRUE(cache.Find(location, 1, result));
+  ASSERT_EQ(result.edges.size(), 3);
+  EXPECT_EQ(result.edges[2].id, GraphId(1, 2, 2));
+  ASSERT_EQ(result.filtered_edges.size(), 1);
+  EXPECT_EQ(result.filtered_edges[0].id, GraphId(1, 2, 100));
+
+  // but not a spot right next to it, the candidates are projections of the input location
+  baldr::Location nearby({5.1 + 1e-8, 52.1 - 1e-8});
+  nearby.radius_ = 10;
+  EXPECT_FALSE(cache.Find(nearby, 1, result));
+
+  // or if the search would have been different
+  baldr::Location wider(location);
+  wider.radius_ = 20;
+  EXPECT_FALSE(cache.Find(wider, 1, result));
+  baldr::Location headed(location);
+  headed.heading_ = 90;
+  EXPECT_FALSE(cache.Find(headed, 1, result));
+  baldr::Location filtered(location);
+  filtered.search_filter_.exclude_ramp_ = true;
+  EXPECT_FALSE(cache.Find(filtered, 1, result));
+  EXPECT_FALSE(cache.Find(location, 2, result));
+
+  EXPECT_EQ(cache.hits(), 1);
+  EXPECT_EQ(cache.misses(), 6);
+
+  cache.Clear();
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_EQ(cache.bytes(), 0);
+  EXPECT_FALSE(cache.Find(location, 1, result));
+}
+
+TEST(SearchCache, precision) {
+  // snapping coordinates to a grid lets nearby spots share the candidates
+  SearchCache cache(1 << 20, 1e-6);
+  baldr::Location location({5.1, 52.1});
+  cache.Insert(location, 1, make_result(location, 3));
+
+  PathLocation result(location);
+  baldr::Location nearby({5.1 + 1e-8, 52.1 - 1e-8});
+  EXPECT_TRUE(cache.Find(nearby, 1, result));
+  EXPECT_EQ(result.edges.size(), 3);
+  baldr::Location moved({5.1 + 1e-5, 52.1});
+  EXPECT_FALSE(cache.Find(moved, 1, result));
+}
+
+TEST(SearchCache, costing_key) {
+  Options options;
+  options.set_costing_type(Costing::auto_);
+  auto& costing = (*options.mutable_costings())[Costing::auto_];
+  costing.mutable_options()->set_use_tolls(.5f);
+  auto key = SearchCache::CostingKey(options, nullptr);
+  EXPECT_EQ(key, SearchCache::CostingKey(options, nullptr));
+
+  costing.mutable_options()->set_use_tolls(.1f);
+  EXPECT_NE(key, SearchCache::CostingKey(options, nullptr));
+  costing.mutable_options()->set_use_tolls(.5f);
+  EXPECT_EQ(key, SearchCache::CostingKey(options, nullptr));
+
+  options.set_costing_type(Costing::bicycle);
+  EXPECT_NE(key, SearchCache::CostingKey(options, nullptr));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,140 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "skadi/sample.h"
+#include "thor/costmatrix.h"
+#include "tyr/serializers.h"
+
+#include "test.h"
+
+using namespace valhalla;
+using namespace valhalla::baldr;
+using namespace valhalla::thor;
+
+namespace {
+
+void add_location(google::protobuf::RepeatedPtrField<valhalla::Location>& locations,
+                  double lon,
+                  double lat,
+                  const std::string& name,
+                  bool correlated = true) {
+  auto* location = locations.Add();
+  location->mutable_ll()->set_lng(lon);
+  location->mutable_ll()->set_lat(lat);
+  if (correlated) {
+    auto* edge = location->mutable_correlation()->add_edges();
+    edge->mutable_ll()->set_lng(lon + 0.0001);
+    edge->mutable_ll()->set_lat(lat - 0.00005);
+    if (!name.empty()) {
+      edge->add_names(name);
+    }
+  }
+}
+
+Api matrix_request(Options::Format format, bool with_id) {
+  Api request;
+  auto& options = *request.mutable_options();
+  options.set_format(format);
+  options.set_units(Options::miles);
+  if (with_id) {
+    options.set_id("matrix/1 \"quoted\"\ttabbed");
+  }
+  add_location(*options.mutable_sources(), 5.1, 52.09, "Oudegracht");
+  add_location(*options.mutable_sources(), 5.12, 52.1, "A/B \\ road");
+  add_location(*options.mutable_sources(), 5.13, 52.11, "", false);
+  add_location(*options.mutable_targets(), 5.11, 52.08, "");
+  add_location(*options.mutable_targets(), -0.5, -0.25, "Straße\x01");
+  return request;
+}
+
+std::vector<TimeDistance> time_distances() {
+  const auto unreachable = static_cast<uint32_t>(kMaxCost);
+  return {{61, 1234}, {0, 0}, {unreachable, 0}, {3599, 98765}, {17, 3}, {unreachable, unreachable}};
+}
+
+TEST(Serializers, osrm_matrix) {
+  auto request = matrix_request(Options::osrm, true);
+  EXPECT_EQ(tyr::serializeMatrix(request, time_distances(), 0.001),
+            R"({"code":"Ok",)"
+            R"("sources":[{"location":[5.100100,52.089950],"name":"Oudegracht","distance":8.818},)"
+            R"({"location":[5.120100,52.099950],"name":"A\/B \\ road","distance":8.817},null],)"
+            R"("destinations":[{"location":[5.110100,52.079950],"name":"","distance":8.820},)"
+            R"({"location":[-0.499900,-0.250050],"name":"Straße\u0001","distance":12.446}],)"
+            R"("durations":[[61,0],[null,3599],[17,null]],)"
+            R"("distances":[[1.234,0.000],[null,98.765],[0.003,null]]})");
+}
+
+TEST(Serializers, valhalla_matrix) {
+  const std::string locations =
+      R"("targets":[[{"lat":52.080000,"lon":5.110000},{"lat":-0.250000,"lon":-0.500000}]],)"
+      R"("sources":[[{"lat":52.090000,"lon":5.100000},{"lat":52.100000,"lon":5.120000},)"
+      R"({"lat":52.110000,"lon":5.130000}]])";
+
+  auto request = matrix_request(Options::json, true);
+  EXPECT_EQ(tyr::serializeMatrix(request, time_distances(), 0.000621371),
+            R"({"sources_to_targets":[[)"
+            R"({"from_index":0,"to_index":0,"time":61,"distance":0.767},)"
+            R"({"from_index":0,"to_index":1,"time":0,"distance":0.000}],[)"
+            R"({"from_index":1,"to_index":0,"time":null,"distance":null},)"
+            R"({"from_index":1,"to_index":1,"time":3599,"distance":61.370}],[)"
+            R"({"from_index":2,"to_index":0,"time":17,"distance":0.002},)"
+            R"({"from_index":2,"to_index":1,"time":null,"distance":null}]],"units":"miles",)" +
+                locations + R"(,"id":"matrix\/1 \"quoted\"\ttabbed"})");
+
+  request = matrix_request(Options::json, false);
+  EXPECT_EQ(tyr::serializeMatrix(request, time_distances(), 1.0),
+            R"({"sources_to_targets":[[)"
+            R"({"from_index":0,"to_index":0,"time":61,"distance":1234.000},)"
+            R"({"from_index":0,"to_index":1,"time":0,"distance":0.000}],[)"
+            R"({"from_index":1,"to_index":0,"time":null,"distance":null},)"
+            R"({"from_index":1,"to_index":1,"time":3599,"distance":98765.000}],[)"
+            R"({"from_index":2,"to_index":0,"time":17,"distance":3.000},)"
+            R"({"from_index":2,"to_index":1,"time":null,"distance":null}]],"units":"miles",)" +
+                locations + "}");
+}
+
+Api height_request(uint32_t precision, bool polyline, bool with_id) {
+  Api request;
+  auto& options = *request.mutable_options();
+  options.set_height_precision(precision);
+  if (with_id) {
+    options.set_id("heights/2");
+  }
+  if (polyline) {
+    options.set_encoded_polyline("_p~iF~ps|U_ulLnnqC_mqNvxq`@\\\\");
+  } else {
+    for (size_t i = 0; i < 4; ++i) {
+      add_location(*options.mutable_shape(), -76.5 + i * 0.01, 40.7 - i * 0.01, "");
+    }
+  }
+  return request;
+}
+
+TEST(Serializers, height) {
+  const std::vector<double> heights{303.25, skadi::get_no_data_value(), -12.5, 0};
+  const std::vector<double> ranges{0, 8467.4, 25380, 31000.5};
+
+  auto request = height_request(1, true, true);
+  EXPECT_EQ(tyr::serializeHeight(request, heights, ranges),
+            R"({"range_height":[[0,303.2],[8467,null],[25380,-12.5],[31000,0.0]],)"
+            R"("encoded_polyline":"_p~iF~ps|U_ulLnnqC_mqNvxq`@\\\\","id":"heights\/2"})");
+
+  const std::string shape =
+      R"("shape":[{"lon":-76.500000,"lat":40.700000},{"lon":-76.490000,"lat":40.690000},)"
+      R"({"lon":-76.480000,"lat":40.680000},{"lon":-76.470000,"lat":40.670000}])";
+  request = height_request(0, false, false);
+  EXPECT_EQ(tyr::serializeHeight(request, heights, {}),
+            R"({"height":[303,null,-12,0],)" + shape + "}");
+  request = height_request(2, false, false);
+  EXPECT_EQ(tyr::serializeHeight(request, heights, ranges),
+            R"({"range_height":[[0,303.25],[8467,null],[25380,-12.50],[31000,0.00]],)" + shape +
+                "}");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,93 @@
+#include "midgard/thread_pool.h"
+
+#include "test.h"
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace valhalla::midgard;
+
+namespace {
+
+TEST(ThreadPool, runs_every_task_once) {
+  for (size_t threads : {0, 1, 3}) {
+    ThreadPool pool(threads);
+    EXPECT_EQ(pool.concurrency(), threads + 1);
+    for (size_t count : {0, 1, 2, 4, 100}) {
+      std::vector<std::atomic<int>> ran(count);
+      for (auto& r : ran) {
+        r = 0;
+      }
+      pool.Run(count, [&ran](size_t i) { ++ran[i]; });
+      for (const auto& r : ran) {
+        EXPECT_EQ(r, 1);
+      }
+    }
+  }
+}
+
+TEST(ThreadPool, without_threads_runs_in_order_on_the_caller) {
+  ThreadPool pool(0);
+  std::vector<size_t> order;
+  const auto caller = std::this_thread::get_id();
+  pool.Run(5, [&order, caller](size_t i) {
+    EXPECT_EQ(std::this_thread::get_id(), caller);
+    order.push_back(i);
+  });
+  EXPECT_EQ(order, (std::vector<size_t>{0, 1, 2, 3, 4}));
+}
+
+TEST(ThreadPool, uses_the_threads) {
+  ThreadPool pool(3);
+  std::mutex mutex;
+  std::set<std::thread::id> ids;
+  std::atomic<int> waiting{0};
+  // every task waits for all of the others to start so they must be on different threads
+  pool.Run(4, [&](size_t) {
+    ++waiting;
+    while (waiting < 4) {
+      std::this_thread::yield();
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    ids.insert(std::this_thread::get_id());
+  });
+  EXPECT_EQ(ids.size(), 4);
+  EXPECT_EQ(ids.count(std::this_thread::get_id()), 1);
+}
+
+TEST(ThreadPool, rethrows_the_first_failure) {
+  ThreadPool pool(2);
+  std::atomic<int> ran{0};
+  try {
+    pool.Run(10, [&ran](size_t i) {
+      ++ran;
+      if (i == 3 || i == 7) {
+        throw std::runtime_error(std::to_string(i));
+      }
+    });
+    FAIL() << "Expected an exception";
+  } catch (const std::runtime_error& e) { EXPECT_STREQ(e.what(), "3"); }
+  // the others still ran and the pool is still usable
+  EXPECT_EQ(ran, 10);
+  ran = 0;
+  pool.Run(10, [&ran](size_t) { ++ran; });
+  EXPECT_EQ(ran, 10);
+}
+
+TEST(ThreadPool, nested_runs_dont_deadlock) {
+  ThreadPool pool(2);
+  std::atomic<int> ran{0};
+  pool.Run(3, [&](size_t) { pool.Run(3, [&ran](size_t) { ++ran; }); });
+  EXPECT_EQ(ran, 9);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,126 @@
+#include "baldr/directededge.h"
+#include "meili/transition_cache.h"
+
+#include "test.h"
+
+using namespace valhalla;
+using namespace valhalla::meili;
+
+namespace {
+
+const baldr::DirectedEdge edge{};
+
+// a path of the given number of edges, each 100m and 10s long
+std::vector<Label> make_path(size_t edge_count) {
+  std::vector<Label> path(1);
+  for (size_t i = 0; i < edge_count; ++i) {
+    path.emplace_back(baldr::GraphId(1, 2, i + 1), kInvalidDestination, baldr::GraphId(1, 2, i), 0.f,
+                      1.f, sif::Cost(100.f * (i + 1), 10.f * (i + 1)), 0.f, 100.f * (i + 1),
+                      path.size() - 1, &edge, sif::TravelMode::kDrive, -1);
+  }
+  return path;
+}
+
+baldr::PathLocation make_candidate(uint32_t edge_id, double percent_along) {
+  baldr::PathLocation candidate(baldr::Location({5.1, 52.1}));
+  candidate.edges.emplace_back(baldr::GraphId(1, 2, edge_id), percent_along,
+                               midgard::PointLL{5.1, 52.1}, 0.);
+  return candidate;
+}
+
+TEST(TransitionCache, keys) {
+  const auto a = make_candidate(1, .5), b = make_candidate(2, .25);
+  const auto key = TransitionCache::Key(7, nullptr, a, b);
+  EXPECT_EQ(key, TransitionCache::Key(7, nullptr, make_candidate(1, .5), make_candidate(2, .25)));
+
+  // anything that could change the path changes the key
+  EXPECT_NE(key, TransitionCache::Key(8, nullptr, a, b));
+  EXPECT_NE(key, TransitionCache::Key(7, nullptr, b, a));
+  EXPECT_NE(key, TransitionCache::Key(7, nullptr, make_candidate(1, .51), b));
+  const auto path = make_path(1);
+  EXPECT_NE(key, TransitionCache::Key(7, &path.back(), a, b));
+
+  Options options;
+  options.set_costing_type(Costing::auto_);
+  const auto costing_key = TransitionCache::CostingKey(options, 200.f);
+  EXPECT_EQ(costing_key, TransitionCache::CostingKey(options, 200.f));
+  EXPECT_NE(costing_key, TransitionCache::CostingKey(options, 0.f));
+  (*options.mutable_costings())[Costing::auto_].mutable_options()->set_use_tolls(.1f);
+  EXPECT_NE(costing_key, TransitionCache::CostingKey(options, 200.f));
+  options.set_costing_type(Costing::bicycle);
+  EXPECT_NE(costing_key, TransitionCache::CostingKey(options, 200.f));
+}
+
+TEST(TransitionCache, limits) {
+  TransitionCache cache(16);
+  const std::vector<Label>* path = nullptr;
+  EXPECT_FALSE(cache.Find("found", 1000.f, 100.f, path));
+
+  // 300m and 30s found with a 1000m and 100s search
+  cache.Insert("found", make_path(3), 1000.f, 100.f);
+  ASSERT_TRUE(cache.Find("found", 1000.f, 100.f, path));
+  ASSERT_NE(path, nullptr);
+  EXPECT_EQ(path->size(), 4);
+  EXPECT_TRUE(cache.Find("found", 5000.f, 50.f, path));
+  EXPECT_NE(path, nullptr);
+
+  // the shortest path is too long so there is none
+  EXPECT_TRUE(cache.Find("found", 300.f, 100.f, path));
+  EXPECT_EQ(path, nullptr);
+
+  // too slow, but there could be a longer quicker one
+  EXPECT_FALSE(cache.Find("found", 1000.f, 30.f, path));
+
+  // a looser time limit could have let a shorter slower one through
+  EXPECT_FALSE(cache.Find("found", 1000.f, 200.f, path));
+  EXPECT_FALSE(cache.Find("found", 1000.f, -1.f, path));
+
+  // nothing within 1000m without a time limit
+  cache.Insert("missing", {}, 1000.f, -1.f);
+  EXPECT_TRUE(cache.Find("missing", 500.f, 100.f, path));
+  EXPECT_EQ(path, nullptr);
+  EXPECT_TRUE(cache.Find("missing", 1000.f, -1.f, path));
+  EXPECT_FALSE(cache.Find("missing", 2000.f, -1.f, path));
+
+  EXPECT_EQ(cache.hits(), 5);
+  EXPECT_EQ(cache.misses(), 5);
+
+  cache.Clear();
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_FALSE(cache.Find("found", 1000.f, 100.f, path));
+}
+
+TEST(TransitionCache, disabled) {
+  // a disabled cache keeps nothing
+  TransitionCache cache(0);
+  const std::vector<Label>* path = nullptr;
+  cache.Insert("a", make_path(1), 1000.f, -1.f);
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_FALSE(cache.Find("a", 1000.f, -1.f, path));
+}
+
+TEST(TransitionCache, copy_path_into_labelset) {
+  LabelSet labelset(1000.f);
+  labelset.put(0, sif::TravelMode::kDrive, nullptr);
+  const auto path = make_path(3);
+  const auto last = labelset.put(path);
+  EXPECT_EQ(last, 4);
+
+  // the path is chained back to its origin in the new label set
+  std::vector<baldr::GraphId> edges;
+  for (RoutePathIterator label(&labelset, last), end(&labelset); label != end; ++label) {
+    edges.push_back(label->edgeid());
+  }
+  ASSERT_EQ(edges.size(), 4);
+  EXPECT_EQ(edges[0], baldr::GraphId(1, 2, 2));
+  EXPECT_EQ(edges[2], baldr::GraphId(1, 2, 0));
+  EXPECT_FALSE(edges[3].Is_Valid());
+  EXPECT_EQ(labelset.label(last).cost().cost, 300.f);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -145,6 +145,8 @@ const std::string kShapeAttributesClosure = "shape_attributes.closure";
 
 // Categories
 const std::string kNodeCategory = "node.";
+const std::string kNodeIntersectingEdgeCategory = "node.intersecting_edge.";
+const std::string kEdgeSignCategory = "edge.sign.";
 const std::string kAdminCategory = "admin.";
 const std::string kMatchedCategory = "matched.";
 const std::string kShapeAttributesCategory = "shape_attributes.";
@@ -464,6 +464,20 @@ public:
     return !tile_extract_->traffic_tiles.empty();
   }
 
+  /**
+   * The last time any of the live traffic tiles was updated. This changes whenever new speeds are
+   * written into the traffic extract so it works as a version of the live traffic snapshot
+   * @return seconds since epoch of the latest update or 0 if there is no live traffic
+   */
+  uint64_t GetTrafficLastUpdate() const;
+
+  /**
+   * The dataset id of the tileset, taken from the first tile on a road level with any nodes in it.
+   * The tiles of one build all share it so it tells one build of the graph from another
+   * @return the dataset id or 0 if there are no such tiles
+   */
+  uint64_t GetDatasetId();
+
   /**
    * Get a pointer to a graph tile object given a GraphId.
    * @param graphid  the graphid of the tile
@@ -1,6 +1,8 @@
 #ifndef VALHALLA_BALDR_RAPIDJSON_UTILS_H_
 #define VALHALLA_BALDR_RAPIDJSON_UTILS_H_
 
+#include <cmath>
+#include <cstdio>
 #include <fstream>
 #include <istream>
 #include <locale>
@@ -421,6 +423,85 @@ public:
   inline void operator()(const std::nullptr_t) {
     writer.Null();
   }
+
+  /**
+   * Writes a number with exactly the given number of decimal places, trailing zeros included,
+   * which is how json::fixed_t comes out of the DOM. set_precision on the other hand only caps the
+   * decimal places. Numbers that arent finite come out as strings, also like fixed_t
+   */
+  inline void fixed(const double value, const int precision) {
+    char number[64];
+    auto length = std::snprintf(number, sizeof(number), "%.*f", precision, value);
+    if (length < 0 || length >= static_cast<int>(sizeof(number))) {
+      // only absurdly large numbers dont fit, let the writer have a go at those
+      writer.Double(value);
+    } else if (!std::isfinite(value)) {
+      writer.String(number, length);
+    } else {
+      writer.RawValue(number, length, rapidjson::kNumberType);
+    }
+  }
+
+  inline void fixed(const char* key, const double value, const int precision) {
+    writer.String(key);
+    fixed(value, precision);
+  }
+
+  /**
+   * Writes a string escaped the way the json DOM escapes it, which also escapes forward slashes
+   */
+  inline void dom_string(const std::string& value) {
+    if (value.find('/') == std::string::npos) {
+      writer.String(value);
+      return;
+    }
+    std::string escaped(1, '"');
+    escaped.reserve(value.size() + 8);
+    for (const auto c : value) {
+      switch (c) {
+        case '\\':
+          escaped += "\\\\";
+          break;
+        case '"':
+          escaped += "\\\"";
+          break;
+        case '/':
+          escaped += "\\/";
+          break;
+        case '\b':
+          escaped += "\\b";
+          break;
+        case '\f':
+          escaped += "\\f";
+          break;
+        case '\n':
+          escaped += "\\n";
+          break;
+        case '\r':
+          escaped += "\\r";
+          break;
+        case '\t':
+          escaped += "\\t";
+          break;
+        default:
+          if (c >= 0 && c < 32) {
+            char hex[8];
+            std::snprintf(hex, sizeof(hex), "\\u%04X", c);
+            escaped += hex;
+          } else {
+            escaped.push_back(c);
+          }
+          break;
+      }
+    }
+    escaped.push_back('"');
+    writer.RawValue(escaped.c_str(), escaped.size(), rapidjson::kStringType);
+  }
+
+  inline void dom_string(const char* key, const std::string& value) {
+    writer.String(key);
+    dom_string(value);
+  }
 };
 
 } // namespace rapidjson
@@ -0,0 +1,178 @@
+#ifndef VALHALLA_BALDR_SEGMENT_INDEX_H_
+#define VALHALLA_BALDR_SEGMENT_INDEX_H_
+
+#include <valhalla/baldr/graphconstants.h>
+#include <valhalla/baldr/graphid.h>
+#include <valhalla/midgard/pointll.h>
+#include <valhalla/midgard/sequence.h>
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace valhalla {
+namespace baldr {
+
+// coordinates in the index are stored as fixed point integers with this precision
+constexpr double kSegmentIndexPrecision = 1e7;
+constexpr uint32_t kSegmentIndexVersion = 2;
+constexpr uint32_t kSegmentIndexMaxLevels = 16;
+constexpr char kSegmentIndexMagic[8] = {'V', 'H', 'S', 'E', 'G', 'I', 'D', 'X'};
+
+/**
+ * The header of a segment index file. The file is laid out as the header followed by all of the
+ * segments sorted along a hilbert curve followed by the bounding boxes of the packed rtree nodes
+ * from the leaf level (boxes of node_size segments) to the root (a single box).
+ */
+struct SegmentIndexHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t node_size;
+  uint64_t segment_count;
+  uint64_t dataset_id;
+  uint32_t level_count;
+  uint32_t spare;
+  uint64_t level_offsets[kSegmentIndexMaxLevels];
+  uint64_t level_sizes[kSegmentIndexMaxLevels];
+};
+
+/**
+ * A single segment (two consecutive shape points) of an edge along with what we need to prefilter
+ * it without touching the tile the edge lives in
+ */
+struct IndexedSegment {
+  int32_t lon0;
+  int32_t lat0;
+  int32_t lon1;
+  int32_t lat1;
+  uint64_t edge_id;
+  uint32_t shape_index; // index of the first point of this segment in the edges shape
+  uint16_t access;      // union of the forward and reverse access of the edge
+  uint8_t road_class;
+  uint8_t spare;
+
+  midgard::PointLL a() const {
+    return {lon0 / kSegmentIndexPrecision, lat0 / kSegmentIndexPrecision};
+  }
+  midgard::PointLL b() const {
+    return {lon1 / kSegmentIndexPrecision, lat1 / kSegmentIndexPrecision};
+  }
+};
+static_assert(sizeof(IndexedSegment) == 32, "IndexedSegment must be 32 bytes");
+
+/**
+ * Bounding box of an rtree node in fixed point coordinates
+ */
+struct SegmentBox {
+  int32_t minx;
+  int32_t miny;
+  int32_t maxx;
+  int32_t maxy;
+};
+
+/**
+ * Prefilter applied to segments in the index before they are ever measured
+ */
+struct SegmentFilter {
+  RoadClass max_road_class = RoadClass::kMotorway;
+  RoadClass min_road_class = RoadClass::kServiceOther;
+  uint16_t access_mask = kAllAccess;
+
+  bool allowed(const IndexedSegment& segment) const {
+    return segment.road_class >= static_cast<uint8_t>(max_road_class) &&
+           segment.road_class <= static_cast<uint8_t>(min_road_class) &&
+           (segment.access & access_mask);
+  }
+};
+
+/**
+ * A read only, memory mapped, packed hilbert rtree over all of the edge segments in a tileset.
+ * It is built by mjolnir (see valhalla_build_segment_index) and allows for k-nearest and radius
+ * queries whose cost does not depend on how many edges happen to share a tile bin.
+ */
+class SegmentIndex {
+public:
+  using Filter = SegmentFilter;
+
+  /**
+   * The closest point on a segment to the query point
+   */
+  struct Hit {
+    GraphId edge_id;
+    uint32_t shape_index;
+    midgard::PointLL point;
+    double distance;
+  };
+
+  /**
+   * Memory maps the index found at the given path
+   * @param file_name  the path to the index file
+   */
+  explicit SegmentIndex(const std::string& file_name);
+
+  /**
+   * Visits segments in order of increasing distance from the given point. Segments of the same
+   * edge will all be visited so callers interested in edges should dedupe on the edge id.
+   *
+   * @param point         the point to search around
+   * @param max_distance  the distance in meters beyond which we stop the search
+   * @param filter        prefilter for the segments
+   * @param visitor       called for each hit, return false to stop the search
+   */
+  void Visit(const midgard::PointLL& point,
+             double max_distance,
+             const Filter& filter,
+             const std::function<bool(const Hit&)>& visitor) const;
+
+  /**
+   * Finds the k nearest edges to the given point
+   *
+   * @param point         the point to search around
+   * @param k             the number of edges to find
+   * @param filter        prefilter for the segments
+   * @param max_distance  the distance in meters beyond which we stop the search
+   * @return the closest segment of each of the k nearest edges sorted by distance
+   */
+  std::vector<Hit> Nearest(const midgard::PointLL& point,
+                           size_t k,
+                           const Filter& filter = {},
+                           double max_distance = std::numeric_limits<double>::max()) const;
+
+  /**
+   * Finds all edges within a radius of the given point
+   *
+   * @param point   the point to search around
+   * @param radius  the radius in meters
+   * @param filter  prefilter for the segments
+   * @return the closest segment of each edge within the radius sorted by distance
+   */
+  std::vector<Hit>
+  Within(const midgard::PointLL& point, double radius, const Filter& filter = {}) const;
+
+  /**
+   * @return the number of segments in the index
+   */
+  size_t size() const {
+    return header_->segment_count;
+  }
+
+  /**
+   * @return the dataset id of the tiles the index was built from
+   */
+  uint64_t dataset_id() const {
+    return header_->dataset_id;
+  }
+
+protected:
+  midgard::mem_map<char> memory_;
+  const SegmentIndexHeader* header_;
+  const IndexedSegment* segments_;
+  const SegmentBox* boxes_;
+};
+
+} // namespace baldr
+} // namespace valhalla
+
+#endif // VALHALLA_BALDR_SEGMENT_INDEX_H_
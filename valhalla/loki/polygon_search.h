@@ -1,7 +1,12 @@
 #ifndef VALHALLA_LOKI_POLYGON_SEARCH_H_
 #define VALHALLA_LOKI_POLYGON_SEARCH_H_
 
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
 #include <valhalla/baldr/graphreader.h>
+#include <valhalla/midgard/thread_pool.h>
 #include <valhalla/proto/options.pb.h>
 #include <valhalla/sif/dynamiccost.h>
 
@@ -13,13 +18,20 @@ namespace loki {
  *
  * @param rings The (optionally closed) rings to intersect edges with
  * @param reader GraphReader instance
+ * @param costing The costing, edges it wouldnt allow anyway are not returned
+ * @param max_length The maximum total perimeter of the rings in meters
+ * @param thread_readers Readers sharing a synchronized tile cache which allow the tiles the rings
+ *                       pass through to be searched in parallel, one reader per thread
+ * @param thread_pool    The threads to search the tiles with
  *
  */
 std::unordered_set<valhalla::baldr::GraphId>
 edges_in_rings(const google::protobuf::RepeatedPtrField<valhalla::Ring>& rings,
                baldr::GraphReader& reader,
                const std::shared_ptr<sif::DynamicCost>& costing,
-               float max_length);
+               float max_length,
+               const std::vector<std::shared_ptr<baldr::GraphReader>>& thread_readers = {},
+               midgard::ThreadPool* thread_pool = nullptr);
 
 } // namespace loki
 } // namespace valhalla
@@ -1,5 +1,9 @@
 #pragma once
+#include <atomic>
 #include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include <valhalla/baldr/directededge.h>
 #include <valhalla/loki/search.h>
@@ -32,9 +36,110 @@ struct directed_reach {
   uint32_t inbound : 16;
 };
 
+/**
+ * A thread safe memo of the reach of edges we've already expanded from so that popular edges, which
+ * come up request after request, dont need another expansion. Reach depends on the costing so the
+ * results are kept per costing fingerprint. Each result remembers the dataset of the tile its edge
+ * came from so that results from older tiles are never used. It is split into shards which start
+ * over when they fill up to keep the memory bounded without the bookkeeping of an lru.
+ */
+class ReachCache {
+public:
+  /**
+   * Constructor
+   * @param max_entries  roughly how many edges worth of results to keep
+   * @param shards       how many independently locked parts to split the cache into
+   */
+  explicit ReachCache(size_t max_entries, size_t shards = 16);
+
+  /**
+   * Looks up a previous result that can answer a query for the given max reach. A result
+   * computed with a higher max reach can answer for a lower one and a result below its max reach
+   * is exact and can answer for any max reach.
+   * @param costing_key  the fingerprint of the costing the reach is for
+   * @param edge_id      the edge in question
+   * @param dataset_id   the dataset id of the tile the edge is in
+   * @param max_reach    the maximum reach to check
+   * @param direction    a mask of the directions we care about
+   * @param reach        set to the result if one was found
+   * @return true if the reach was found
+   */
+  bool Find(uint64_t costing_key,
+            const baldr::GraphId& edge_id,
+            uint64_t dataset_id,
+            uint32_t max_reach,
+            uint8_t direction,
+            directed_reach& reach);
+
+  /**
+   * Remembers the result of an expansion
+   * @param costing_key  the fingerprint of the costing the reach is for
+   * @param edge_id      the edge in question
+   * @param dataset_id   the dataset id of the tile the edge is in
+   * @param max_reach    the maximum reach the expansion checked
+   * @param direction    a mask of the directions the expansion was done in
+   * @param reach        the result of the expansion
+   */
+  void Insert(uint64_t costing_key,
+              const baldr::GraphId& edge_id,
+              uint64_t dataset_id,
+              uint32_t max_reach,
+              uint8_t direction,
+              const directed_reach& reach);
+
+  /**
+   * Forgets everything
+   */
+  void Clear();
+
+  size_t size() const;
+  size_t hits() const {
+    return hits_;
+  }
+  size_t misses() const {
+    return misses_;
+  }
+
+protected:
+  struct edge_key_t {
+    uint64_t costing_key;
+    uint64_t edge_id;
+    bool operator==(const edge_key_t& other) const {
+      return costing_key == other.costing_key && edge_id == other.edge_id;
+    }
+  };
+  struct edge_key_hash_t {
+    size_t operator()(const edge_key_t& key) const {
+      return std::hash<uint64_t>()(key.costing_key ^ (key.edge_id * 0x9E3779B97F4A7C15ull));
+    }
+  };
+  struct entry_t {
+    uint64_t dataset_id;
+    uint32_t max_reach;
+    uint8_t direction;
+    directed_reach reach;
+  };
+  struct shard_t {
+    mutable std::mutex mutex;
+    std::unordered_map<edge_key_t, entry_t, edge_key_hash_t> entries;
+  };
+
+  shard_t& shard(const baldr::GraphId& edge_id);
+
+  size_t max_shard_entries_;
+  std::vector<shard_t> shards_;
+  std::atomic<size_t> hits_;
+  std::atomic<size_t> misses_;
+};
+
 class Reach : public thor::Dijkstras {
 public:
-  Reach();
+  /**
+   * Constructor
+   * @param cache        optional cache of previous results to check before expanding
+   * @param costing_key  the fingerprint of the costing that will be used with the cache
+   */
+  explicit Reach(ReachCache* cache = nullptr, uint64_t costing_key = 0);
   // TODO: currently this interface has no place for time, we need to both add it and handle
   // TODO: the problem of guessing what time to use at the other end of the route depending on
   // TODO: whether its depart_at or arrive_by
@@ -100,6 +205,8 @@ protected:
   std::unordered_set<uint64_t> queue_, done_;
   uint32_t max_reach_{};
   size_t transitions_{};
+  ReachCache* cache_;
+  uint64_t costing_key_;
 };
 
 } // namespace loki
@@ -6,13 +6,20 @@
 #include <valhalla/baldr/graphreader.h>
 #include <valhalla/baldr/location.h>
 #include <valhalla/baldr/pathlocation.h>
+#include <valhalla/baldr/segment_index.h>
+#include <valhalla/midgard/thread_pool.h>
 #include <valhalla/sif/dynamiccost.h>
 
 #include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace valhalla {
 namespace loki {
 
+class ReachCache;
+
 /**
  * Find an location within the route network given an input location
  * same tiled route data and a search strategy
@@ -22,13 +29,27 @@ namespace loki {
  * proper cache
  * @param costing        a costing object by which we can determine which portions of the graph are
  *                       accessable and therefor potential candidates
+ * @param segment_index  optional index of edge segments, when provided candidates are found by
+ *                       visiting the nearest segments rather than walking the tile bins
+ * @param thread_readers optional readers sharing a tile cache to search in parallel with. When
+ *                       there are enough locations they are partitioned by tile and each partition
+ *                       is searched on the thread pool with one of these readers. The results are
+ *                       the same as searching them all with the reader above
+ * @param thread_pool    optional threads to search the partitions with
+ * @param reach_cache    optional cache of reach results shared across searches
+ * @param costing_key    the fingerprint of the costing, used to key the reach cache
  * @return pathLocations the correlated data with in the tile that matches the inputs. If a
  * projection is not found, it will not have any entry in the returned value.
  */
 std::unordered_map<baldr::Location, baldr::PathLocation>
 Search(const std::vector<baldr::Location>& locations,
        baldr::GraphReader& reader,
-       const std::shared_ptr<sif::DynamicCost>& costing);
+       const std::shared_ptr<sif::DynamicCost>& costing,
+       const baldr::SegmentIndex* segment_index = nullptr,
+       const std::vector<std::shared_ptr<baldr::GraphReader>>& thread_readers = {},
+       midgard::ThreadPool* thread_pool = nullptr,
+       ReachCache* reach_cache = nullptr,
+       uint64_t costing_key = 0);
 
 } // namespace loki
 } // namespace valhalla
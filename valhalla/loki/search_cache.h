@@ -0,0 +1,113 @@
+#ifndef VALHALLA_LOKI_SEARCH_CACHE_H_
+#define VALHALLA_LOKI_SEARCH_CACHE_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <valhalla/baldr/location.h>
+#include <valhalla/baldr/pathlocation.h>
+#include <valhalla/midgard/lru_cache.h>
+#include <valhalla/proto/options.pb.h>
+#include <valhalla/sif/dynamiccost.h>
+
+namespace valhalla {
+namespace loki {
+
+/**
+ * A least recently used cache of the candidates loki found for a given input location. Lots of
+ * requests come in for the same handful of places (depots, stores and so on) so rather than
+ * searching the graph for them over and over we remember what we found the last time.
+ *
+ * Locations are keyed by their exact coordinates, everything else about them that affects the
+ * search (radius, heading, reachability, search filters etc) and a fingerprint of the costing used
+ * to filter edges. The candidates carry the distance to and the projection of the input location,
+ * so only the very same location can get them back. Coordinates can be snapped to a grid to get
+ * more hits, but then a location is answered with the candidates of a nearby one and its
+ * distances and projections are off by up to the size of a grid cell. The cache is not thread
+ * safe, each worker keeps its own.
+ */
+class SearchCache {
+public:
+  using clock_t = std::chrono::steady_clock;
+
+  /**
+   * Constructor
+   * @param max_bytes  the approximate amount of memory the cache may use before evicting
+   * @param precision  the size in degrees of the grid input coordinates are snapped to for keying,
+   *                   0 to key on the exact coordinates. Anything else changes results, see above
+   * @param max_age    how many seconds a result is valid for, 0 for forever. Candidates are
+   *                   filtered by closures from live traffic so this bounds how stale they can be
+   */
+  SearchCache(size_t max_bytes, double precision = 0, uint32_t max_age = 0);
+
+  /**
+   * Looks for a previous search result for the location
+   * @param location     the input location
+   * @param costing_key  the fingerprint of the costing used for the search, see CostingKey
+   * @param result       filled with the cached candidates on a hit
+   * @param now          the current time, used to expire old results
+   * @return true if the candidates were found in the cache
+   */
+  bool Find(const baldr::Location& location,
+            uint64_t costing_key,
+            baldr::PathLocation& result,
+            clock_t::time_point now = clock_t::now());
+
+  /**
+   * Stores the result of a search for the location evicting the least recently used entries if
+   * need be
+   * @param location     the input location
+   * @param costing_key  the fingerprint of the costing used for the search, see CostingKey
+   * @param result       the candidates found by the search
+   * @param now          the current time, used to expire old results
+   */
+  void Insert(const baldr::Location& location,
+              uint64_t costing_key,
+              const baldr::PathLocation& result,
+              clock_t::time_point now = clock_t::now());
+
+  /**
+   * Drops everything, for example because the tiles the results came from have changed
+   */
+  void Clear();
+
+  /**
+   * Computes a fingerprint for the costing which covers the type of costing, its access mode and
+   * all of the options that were used to configure it
+   * @param options  the request options the costing was created from
+   * @param costing  the costing used to filter edges during the search
+   * @return the fingerprint of the costing
+   */
+  static uint64_t CostingKey(const Options& options, const sif::cost_ptr_t& costing);
+
+  size_t size() const {
+    return results_.size();
+  }
+  size_t bytes() const {
+    return results_.bytes();
+  }
+  size_t hits() const {
+    return results_.hits();
+  }
+  size_t misses() const {
+    return results_.misses();
+  }
+
+protected:
+  struct result_t {
+    std::vector<baldr::PathLocation::PathEdge> edges;
+    std::vector<baldr::PathLocation::PathEdge> filtered_edges;
+  };
+
+  std::string make_key(const baldr::Location& location, uint64_t costing_key) const;
+
+  double precision_;
+  midgard::lru_cache<std::string, result_t> results_;
+};
+
+} // namespace loki
+} // namespace valhalla
+
+#endif // VALHALLA_LOKI_SEARCH_CACHE_H_
@@ -10,9 +10,14 @@
 #include <valhalla/baldr/graphreader.h>
 #include <valhalla/baldr/location.h>
 #include <valhalla/baldr/pathlocation.h>
+#include <valhalla/baldr/segment_index.h>
 #include <valhalla/baldr/rapidjson_utils.h>
+#include <valhalla/loki/reach.h>
+#include <valhalla/loki/search_cache.h>
 #include <valhalla/midgard/pointll.h>
+#include <valhalla/midgard/thread_pool.h>
 #include <valhalla/proto/options.pb.h>
+#include <valhalla/response_cache.h>
 #include <valhalla/sif/costfactory.h>
 #include <valhalla/skadi/sample.h>
 #include <valhalla/tyr/actor.h>
@@ -54,6 +59,8 @@ protected:
   void parse_trace(Api& request);
   void parse_costing(Api& request, bool allow_none = false);
   void locations_from_shape(Api& request);
+  std::unordered_map<baldr::Location, baldr::PathLocation>
+  search(const std::vector<baldr::Location>& locations, Api& request);
 
   void init_locate(Api& request);
   void init_route(Api& request);
@@ -62,12 +69,24 @@ protected:
   void init_trace(Api& request);
   std::vector<midgard::PointLL> init_height(Api& request);
   void init_transit_available(Api& request);
+  // (re)loads the segment index, dropping it if it doesnt match the tiles
+  void load_segment_index();
 
   boost::property_tree::ptree config;
   sif::CostFactory factory;
   sif::cost_ptr_t costing;
   std::shared_ptr<baldr::GraphReader> reader;
   std::shared_ptr<baldr::connectivity_map_t> connectivity_map;
+  std::string segment_index_file;
+  std::shared_ptr<const baldr::SegmentIndex> segment_index;
+  // readers sharing a tile cache and the threads to search lots of locations in parallel with
+  std::vector<std::shared_ptr<baldr::GraphReader>> search_readers;
+  std::shared_ptr<midgard::ThreadPool> search_pool;
+  std::unique_ptr<SearchCache> search_cache;
+  std::unique_ptr<ReachCache> reach_cache;
+  std::shared_ptr<ResponseCache> response_cache;
+  uint64_t costing_key;
+  time_t tileset_last_modified;
   std::unordered_set<Options::Action> actions;
   std::string action_str;
   std::unordered_map<std::string, size_t> max_locations;
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <memory>
 #include <tuple>
 
 #include <boost/property_tree/ptree.hpp>
@@ -19,6 +20,7 @@
 #include <valhalla/midgard/tiles.h>
 #include <valhalla/sif/dynamiccost.h>
 
+#include <valhalla/meili/grid_cache.h>
 #include <valhalla/meili/grid_range_query.h>
 
 namespace valhalla {
@@ -36,9 +38,20 @@ public:
 
 class CandidateGridQuery final : public CandidateQuery {
 public:
-  using grid_t = GridRangeQuery<baldr::GraphId, midgard::PointLL>;
-
-  CandidateGridQuery(baldr::GraphReader& reader, float cell_width, float cell_height);
+  using grid_t = GridCache::grid_t;
+
+  /**
+   * Constructor
+   * @param reader        the reader to get the tiles of the bins from
+   * @param cell_width    the width of the grid cells the bins are indexed into
+   * @param cell_height   the height of the grid cells the bins are indexed into
+   * @param shared_cache  optionally a cache of indexed bins shared with other queries, the bins
+   *                      this query has used are still kept locally so they dont need locking
+   */
+  CandidateGridQuery(baldr::GraphReader& reader,
+                     float cell_width,
+                     float cell_height,
+                     const std::shared_ptr<GridCache>& shared_cache = nullptr);
 
   ~CandidateGridQuery() override;
 
@@ -64,7 +77,7 @@ public:
                                            edgeids.end(), costing);
   }
 
-  std::unordered_map<baldr::GraphId, grid_t>::size_type size() const {
+  std::unordered_map<int32_t, GridCache::grid_ptr>::size_type size() const {
     return grid_cache_.size();
   }
 
@@ -87,7 +100,10 @@ private:
   float cell_height_;
 
   // Grid cache - cached per "bin" within a graph tile
-  mutable std::unordered_map<int32_t, grid_t> grid_cache_;
+  mutable std::unordered_map<int32_t, GridCache::grid_ptr> grid_cache_;
+
+  // where to look before indexing a bin ourselves
+  std::shared_ptr<GridCache> shared_cache_;
 
   baldr::GraphReader& reader_;
 };
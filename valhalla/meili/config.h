@@ -23,6 +23,8 @@ struct Config {
 
     size_t cache_size = 100240;
     size_t grid_size = 500;
+    // how many indexed bins to keep in the cache shared by all matchers in the process, 0 for none
+    size_t shared_cache_size = 4096;
 
     void Read(const boost::property_tree::ptree& params);
   };
@@ -42,6 +44,12 @@ struct Config {
     float turn_penalty_factor = 200.f;
     // define if 'turn_penalty_factor' option can be reassigned with user request
     bool is_turn_penalty_factor_customizable = true;
+    // route from all of the candidates of a measurement to those of the next in one expansion
+    bool multi_source_routing = false;
+    // how many paths between candidates to remember across traces, 0 for none
+    size_t cache_size = 0;
+    // how many threads route from the candidates left behind by each of the top k paths
+    size_t concurrency = 1;
 
     void Read(const boost::property_tree::ptree& params);
   };
@@ -21,6 +21,56 @@ Project(const midgard::projector_t& p,
         midgard::Shape7Decoder<midgard::PointLL>& shape,
         double snap_distance = 0.0);
 
+/**
+ * A shape decoded into separate arrays of longitudes and latitudes along with room for a value per
+ * segment. Reusing one of these for every edge near a measurement saves allocating for each one.
+ */
+struct ShapeBuffer {
+  std::vector<double> lngs;
+  std::vector<double> lats;
+  std::vector<double> sq_distances;
+
+  // decodes the shape into the buffer, returns the number of points
+  size_t Decode(midgard::Shape7Decoder<midgard::PointLL>& shape);
+
+  size_t size() const {
+    return lngs.size();
+  }
+};
+
+/**
+ * Computes the squared distance from the point of the projector to each segment of a shape. It is
+ * the same math as the projector and the distance approximator but written without branches over
+ * plain arrays so that the compiler can vectorize it and handle several segments per instruction.
+ * @param p             the projector of the point
+ * @param lngs          the longitudes of the shape points
+ * @param lats          the latitudes of the shape points
+ * @param count         the number of shape points
+ * @param sq_distances  filled with count - 1 squared distances in meters, one per segment
+ */
+void SqDistancesToSegments(const midgard::projector_t& p,
+                           const double* lngs,
+                           const double* lats,
+                           size_t count,
+                           double* sq_distances);
+
+/**
+ * Finds the segment of a decoded shape closest to the point of the projector
+ * @param p            the projector of the point
+ * @param shape        the decoded shape, needs at least one point
+ * @param sq_distance  set to the squared distance to the closest segment in meters
+ * @return the index of the closest segment
+ */
+size_t ClosestSegment(const midgard::projector_t& p, ShapeBuffer& shape, double& sq_distance);
+
+// snapped point, squared distance, segment index, offset for a decoded shape given its closest
+// segment, the same as the Project above for the undecoded shape
+std::tuple<midgard::PointLL, double, typename std::vector<midgard::PointLL>::size_type, double>
+Project(const midgard::projector_t& p,
+        const ShapeBuffer& shape,
+        size_t closest_segment,
+        double snap_distance = 0.0);
+
 } // namespace helpers
 } // namespace meili
 } // namespace valhalla
@@ -0,0 +1,114 @@
+// -*- mode: c++ -*-
+#ifndef MMP_GRID_CACHE_H_
+#define MMP_GRID_CACHE_H_
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <valhalla/baldr/graphid.h>
+#include <valhalla/midgard/lru_cache.h>
+#include <valhalla/midgard/pointll.h>
+
+#include <valhalla/meili/grid_range_query.h>
+
+namespace valhalla {
+namespace meili {
+
+/**
+ * A bounded cache of indexed bins that every CandidateGridQuery in the process can share no matter
+ * which thread its used on. Indexing a bin means decoding the shape of every edge in it so its
+ * well worth not doing it again for each matcher. Grids are immutable once they are in the cache
+ * and are handed out as shared pointers so evicting one doesnt pull it out from under a query.
+ *
+ * Bins are keyed by their id and versioned by the dataset id of the tile they were indexed from,
+ * a grid indexed from an older tileset is treated as a miss. The cache is split into shards
+ * with a least recently used list each so that threads dont all wait on the same lock.
+ */
+class GridCache {
+public:
+  using grid_t = GridRangeQuery<baldr::GraphId, midgard::PointLL>;
+  using grid_ptr = std::shared_ptr<const grid_t>;
+
+  /**
+   * Constructor
+   * @param max_bins  how many bins the cache may hold before evicting the least recently used
+   */
+  explicit GridCache(size_t max_bins);
+
+  /**
+   * Looks for the grid of a bin
+   * @param bin_id   the id of the bin
+   * @param version  the dataset id of the tile the bin is in
+   * @return the grid or nullptr if its not in the cache or was indexed from another tileset
+   */
+  grid_ptr Find(int32_t bin_id, uint64_t version);
+
+  /**
+   * Adds the grid of a bin, if another thread beat us to it we keep theirs
+   * @param bin_id   the id of the bin
+   * @param version  the dataset id of the tile the bin is in
+   * @param grid     the indexed bin
+   * @return the grid that is now in the cache
+   */
+  grid_ptr Insert(int32_t bin_id, uint64_t version, grid_ptr grid);
+
+  /**
+   * Drops all of the grids
+   */
+  void Clear();
+
+  size_t size() const;
+  size_t hits() const;
+  size_t misses() const;
+
+  /**
+   * Gets the cache shared by the whole process for grids of the given tileset and cell size, the
+   * first caller decides how big it is
+   * @param max_bins     how many bins the cache may hold
+   * @param tileset      identifies where the tiles come from, eg the tile extract or directory
+   * @param cell_width   the width of the grid cells
+   * @param cell_height  the height of the grid cells
+   * @return the shared cache
+   */
+  static std::shared_ptr<GridCache>
+  Global(size_t max_bins, const std::string& tileset, float cell_width, float cell_height);
+
+protected:
+  static constexpr size_t kShardCount = 16;
+
+  struct entry_t {
+    uint64_t version;
+    grid_ptr grid;
+  };
+
+  struct shard_t {
+    explicit shard_t(size_t max_bins) : bins(max_bins) {
+    }
+    mutable std::mutex mutex;
+    midgard::lru_cache<int32_t, entry_t> bins;
+  };
+
+  shard_t& shard(int32_t bin_id) {
+    return *shards_[static_cast<uint32_t>(bin_id) % kShardCount];
+  }
+
+  // sums up something about all of the shards
+  template <typename Getter> size_t sum(const Getter& get) const {
+    size_t total = 0;
+    for (const auto& s : shards_) {
+      std::lock_guard<std::mutex> lock(s->mutex);
+      total += get(s->bins);
+    }
+    return total;
+  }
+
+  std::array<std::unique_ptr<shard_t>, kShardCount> shards_;
+};
+
+} // namespace meili
+} // namespace valhalla
+
+#endif // MMP_GRID_CACHE_H_
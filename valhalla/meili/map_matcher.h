@@ -2,6 +2,7 @@
 #ifndef MMP_MAP_MATCHER_H_
 #define MMP_MAP_MATCHER_H_
 
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -28,7 +29,12 @@ public:
              baldr::GraphReader& graphreader,
              CandidateQuery& candidatequery,
              const sif::mode_costing_t& mode_costing,
-             sif::TravelMode travelmode);
+             sif::TravelMode travelmode,
+             const labelset_storage_ptr_t& labelset_storage = {},
+             const transition_cache_ptr_t& transition_cache = {},
+             uint64_t costing_key = 0,
+             const std::vector<std::shared_ptr<baldr::GraphReader>>& thread_readers = {},
+             midgard::ThreadPool* thread_pool = nullptr);
 
   ~MapMatcher();
 
@@ -69,6 +75,22 @@ public:
   std::vector<MatchResults> OfflineMatch(const std::vector<Measurement>& measurements,
                                          uint32_t k = 1);
 
+  /**
+   * Matches a trace a few measurements at a time, for example the pings of a vehicle as they come
+   * in. The search carries on from where the previous call left off and only the part of the match
+   * which can no longer change, no matter what measurements come after it, is returned. Call Clear
+   * to start matching a new trace.
+   *
+   * Other than the first, each chunk starts with the last result of the previous one so that the
+   * segments connect them. Their state ids are only valid until the next call because history
+   * which has already been returned is dropped from time to time.
+   *
+   * @param measurements  the measurements that came in since the last call
+   * @param finish        whether this is the end of the trace, if so everything left is returned
+   * @return the newly finalized matches and the segments between them, possibly empty
+   */
+  MatchResults OnlineMatch(const std::vector<Measurement>& measurements, bool finish = false);
+
   /**
    * Set a callback that will throw when the map-matching should be aborted
    * @param interrupt_callback  the function to periodically call to see if we should abort
@@ -87,6 +109,10 @@ private:
   void RemoveRedundancies(const std::vector<StateId>& result,
                           const std::vector<MatchResult>& results);
 
+  void AppendOnlineMeasurement(const Measurement& measurement, const float sq_max_search_radius);
+
+  void CompactOnline();
+
   Config config_;
 
   baldr::GraphReader& graphreader_;
@@ -109,6 +135,14 @@ private:
   EmissionCostModel emission_cost_model_;
 
   TransitionCostModel transition_cost_model_;
+
+  // What OnlineMatch has to remember between calls: the measurements close enough to a matched one
+  // to be interpolated, the states on the path so far, how many of them have been handed out and
+  // the last result that was
+  std::unordered_map<StateId::Time, std::vector<Measurement>> online_interpolated_;
+  std::vector<StateId> online_path_;
+  StateId::Time online_emitted_;
+  MatchResult online_last_;
 };
 
 /**
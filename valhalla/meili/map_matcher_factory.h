@@ -14,6 +14,8 @@
 #include <valhalla/meili/candidate_search.h>
 #include <valhalla/meili/config.h>
 #include <valhalla/meili/map_matcher.h>
+#include <valhalla/meili/transition_cache.h>
+#include <valhalla/midgard/thread_pool.h>
 
 namespace valhalla {
 namespace meili {
@@ -33,6 +35,10 @@ public:
     return *candidatequery_;
   }
 
+  const transition_cache_ptr_t& transition_cache() const {
+    return transition_cache_;
+  }
+
   MapMatcher* Create(const Options& options);
 
   MapMatcher* Create(const Costing::Type costing_type) {
@@ -59,6 +65,17 @@ private:
   sif::CostFactory cost_factory_;
 
   std::shared_ptr<CandidateGridQuery> candidatequery_;
+
+  // the matchers we create run one at a time so they can all route with the same queue
+  labelset_storage_ptr_t labelset_storage_;
+
+  // paths between candidates the matchers we create have found, empty if disabled
+  transition_cache_ptr_t transition_cache_;
+
+  // readers sharing a tile cache and the threads that use them for routing from many candidates at
+  // once, empty if disabled. the matchers we create run one at a time so they can share them
+  std::vector<std::shared_ptr<baldr::GraphReader>> thread_readers_;
+  std::unique_ptr<midgard::ThreadPool> thread_pool_;
 };
 
 } // namespace meili
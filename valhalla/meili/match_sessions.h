@@ -0,0 +1,92 @@
+// -*- mode: c++ -*-
+#ifndef MMP_MATCH_SESSIONS_H_
+#define MMP_MATCH_SESSIONS_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <valhalla/meili/map_matcher.h>
+#include <valhalla/midgard/lru_cache.h>
+
+namespace valhalla {
+namespace meili {
+
+/**
+ * Keeps the map matchers of traces that are being matched a few points at a time, see
+ * MapMatcher::OnlineMatch. Each session (a vehicle, a device etc) is identified by a string and
+ * holds on to its matcher between requests. Sessions that have been idle for too long or that
+ * are the least recently used once there are too many of them are thrown away. Not thread safe,
+ * each worker keeps its own, so all of the requests of a session have to be sent to the same
+ * worker. The matchers read the graph through their worker's GraphReader, which is why they are
+ * not shared between workers.
+ */
+class MatchSessions {
+public:
+  using clock_t = std::chrono::steady_clock;
+
+  /**
+   * Constructor
+   * @param max_sessions  how many sessions may be open at once before the least recently used
+   *                      one is evicted
+   * @param max_idle      how many seconds a session may go without a request before its evicted,
+   *                      0 for forever
+   */
+  MatchSessions(size_t max_sessions, uint32_t max_idle);
+
+  /**
+   * Gets the matcher for the session creating it if need be. Evicts idle sessions first
+   * @param id           the id of the session
+   * @param fingerprint  the options the matcher was made with, a session keeps the ones it was
+   *                     started with
+   * @param create       makes a new matcher if the session doesnt exist yet, the sessions own it
+   * @param now          the current time
+   * @return the matcher of the session, it stays usable even if the session is evicted meanwhile.
+   *         nullptr if the session exists but was started with a different fingerprint
+   */
+  std::shared_ptr<MapMatcher> Get(const std::string& id,
+                                  const std::string& fingerprint,
+                                  const std::function<MapMatcher*()>& create,
+                                  clock_t::time_point now = clock_t::now());
+
+  /**
+   * Ends the session, for example once the last of its trace was matched
+   * @param id  the id of the session
+   * @return true if there was such a session
+   */
+  bool Remove(const std::string& id);
+
+  /**
+   * Evicts all of the sessions that have been idle for too long
+   * @param now  the current time
+   * @return how many sessions were evicted
+   */
+  size_t Evict(clock_t::time_point now = clock_t::now());
+
+  /**
+   * Ends all sessions, for example because the tiles they were matched on have changed
+   */
+  void Clear();
+
+  size_t size() const {
+    return sessions_.size();
+  }
+  size_t evicted() const {
+    return sessions_.evictions();
+  }
+
+protected:
+  struct session_t {
+    std::string fingerprint;
+    std::shared_ptr<MapMatcher> matcher;
+  };
+
+  midgard::lru_cache<std::string, session_t> sessions_;
+};
+
+} // namespace meili
+} // namespace valhalla
+
+#endif // MMP_MATCH_SESSIONS_H_
@@ -4,6 +4,7 @@
 #include <cstdint>
 
 #include <algorithm>
+#include <memory>
 #include <stdexcept>
 #include <unordered_map>
 #include <vector>
@@ -50,7 +51,8 @@ public:
         const uint32_t predecessor,
         const baldr::DirectedEdge* edge,
         const sif::TravelMode mode,
-        int restriction_idx)
+        int restriction_idx,
+        uint16_t origin = 0)
       : sif::EdgeLabel(predecessor,
                        edgeid,
                        edge,
@@ -64,7 +66,8 @@ public:
                        true,
                        false,
                        sif::InternalTurn::kNoTurn),
-        nodeid_(nodeid), dest_(dest), source_(source), target_(target), turn_cost_(turn_cost) {
+        nodeid_(nodeid), dest_(dest), origin_(origin), source_(source), target_(target),
+        turn_cost_(turn_cost) {
     // Validate inputs
     if (!(0.f <= source && source <= target && target <= 1.f)) {
       throw std::invalid_argument("invalid source (" + std::to_string(source) + ") or target (" +
@@ -94,6 +97,15 @@ public:
     return dest_;
   }
 
+  /**
+   * Get the index of the origin the path to this label started from, always 0 unless the search
+   * was run from several origins at once.
+   * @return Returns the origin index.
+   */
+  uint16_t origin() const {
+    return origin_;
+  }
+
   /**
    * Get the source distance.
    * @return  Returns the source distance (0-1).
@@ -122,7 +134,10 @@ public:
    * Set all costs to 0. This is used when copying a prior Label to use as an
    * origin - we want to preserve Label values except costs must be set to 0.
    */
-  void InitAsOrigin(const sif::TravelMode mode, const uint16_t dest, const baldr::GraphId& id) {
+  void InitAsOrigin(const sif::TravelMode mode,
+                    const uint16_t dest,
+                    const baldr::GraphId& id,
+                    const uint16_t origin = 0) {
     source_ = 0.0f;
     target_ = 0.0f;
     turn_cost_ = 0.0f;
@@ -132,12 +147,23 @@ public:
     mode_ = static_cast<uint32_t>(mode);
     dest_ = dest;
     nodeid_ = id;
+    origin_ = origin;
+  }
+
+  /**
+   * Set the predecessor. This is used when copying a path of Labels from one
+   * label set to another.
+   * @param predecessor  Index of the predecessor label.
+   */
+  void set_predecessor(const uint32_t predecessor) {
+    predecessor_ = predecessor;
   }
 
 private:
   // Must be mutually exclusive, i.e. nodeid.Is_Valid() XOR dest != kInvalidDestination
   baldr::GraphId nodeid_;
   uint16_t dest_;
+  uint16_t origin_;
 
   // Assert: 0.f <= source <= target <= 1.f
   float source_;
@@ -159,46 +185,78 @@ struct Status {
   uint32_t permanent : 1;
 };
 
+/**
+ * The priority queue and status maps a LabelSet searches with. They are only needed while the
+ * search runs, unlike the labels which are kept for path recovery, so a matcher can hand the same
+ * storage to every LabelSet it creates and the buckets and hash tables get reused rather than
+ * allocated again for every transition. Only one LabelSet can be searching with it at a time.
+ */
+struct LabelSetStorage {
+  baldr::DoubleBucketQueue<Label> queue;
+  std::unordered_map<uint64_t, Status> node_status;
+  std::unordered_map<uint32_t, Status> dest_status;
+};
+
+using labelset_storage_ptr_t = std::shared_ptr<LabelSetStorage>;
+
 /**
  * LabelSet used during shortest path construction and recovery. Includes a
  * priority queue (sorted by sortdist) and maps that contain status (is the
- * element "permanently" labeled) of nodes and edges.
+ * element "permanently" labeled) of nodes and edges. When searching from
+ * several origins at once each origin has its own status for a node or
+ * destination so the paths from different origins dont interfere.
  */
 class LabelSet {
 public:
-  LabelSet(const float max_cost, const float bucket_size = 1.0f);
+  /**
+   * Constructor
+   * @param max_cost     the cost range of the low level buckets of the queue
+   * @param bucket_size  the cost range of each bucket
+   * @param storage      queue and status maps to reuse, if empty the label set allocates its own
+   */
+  LabelSet(const float max_cost,
+           const float bucket_size = 1.0f,
+           const labelset_storage_ptr_t& storage = {});
 
   /**
    * Add an origin label using a destination index.
    */
-  void put(const uint16_t dest, const sif::TravelMode mode, const Label* edgelabel) {
+  void put(const uint16_t dest,
+           const sif::TravelMode mode,
+           const Label* edgelabel,
+           const uint16_t origin = 0) {
     // Do not add a duplicate label for the same destination index
-    if (dest_status_.find(dest) == dest_status_.end()) {
+    const auto key = dest_key(dest, origin);
+    if (storage_->dest_status.find(key) == storage_->dest_status.end()) {
       // If edgelabel is not null, append it to the label set otherwise append
       // a dummy. In both cases add the label to the priority queue, set its
       // predecessor to kInvalidLabel, and initialize costs to 0.
       const uint32_t idx = labels_.size();
-      dest_status_.emplace(dest, idx);
+      storage_->dest_status.emplace(key, idx);
       labels_.emplace_back(edgelabel ? *edgelabel : Label());
-      labels_.back().InitAsOrigin(mode, dest, {});
-      queue_.add(idx);
+      labels_.back().InitAsOrigin(mode, dest, {}, origin);
+      storage_->queue.add(idx);
     }
   }
 
   /**
    * Add an origin label using a node id.
    */
-  void put(const baldr::GraphId& nodeid, const sif::TravelMode mode, const Label* edgelabel) {
+  void put(const baldr::GraphId& nodeid,
+           const sif::TravelMode mode,
+           const Label* edgelabel,
+           const uint16_t origin = 0) {
     // Do not add a duplicate origin label for the same node
-    if (node_status_.find(nodeid) == node_status_.end()) {
+    const auto key = node_key(nodeid, origin);
+    if (storage_->node_status.find(key) == storage_->node_status.end()) {
       // If edgelabel is not null, append it to the label set otherwise append
       // a dummy. In both cases add the label to the priority queue and set its
       // predecessor to kInvalidLabel
       const uint32_t idx = labels_.size();
-      node_status_.emplace(nodeid, idx);
+      storage_->node_status.emplace(key, idx);
       labels_.emplace_back(edgelabel ? *edgelabel : Label());
-      labels_.back().InitAsOrigin(mode, kInvalidDestination, nodeid);
-      queue_.add(idx);
+      labels_.back().InitAsOrigin(mode, kInvalidDestination, nodeid, origin);
+      storage_->queue.add(idx);
     }
   }
 
@@ -215,7 +273,8 @@ public:
            const uint32_t predecessor,
            const baldr::DirectedEdge* edge,
            const sif::TravelMode mode,
-           int restriction_idx);
+           int restriction_idx,
+           const uint16_t origin = 0);
 
   /**
    * Add a label with an edge and a destination index.
@@ -230,7 +289,15 @@ public:
            const uint32_t predecessor,
            const baldr::DirectedEdge* edge,
            const sif::TravelMode mode,
-           int restriction_idx);
+           int restriction_idx,
+           const uint16_t origin = 0);
+
+  /**
+   * Add the labels of a path found by another search, they are not queued.
+   * @param path  the labels from the origin to the destination
+   * @return  Returns the index of the last label of the path.
+   */
+  uint32_t put(const std::vector<Label>& path);
 
   /**
    * Get the next label from the priority queue. Marks the popped label
@@ -252,22 +319,28 @@ public:
    * Clear the priority queue.
    */
   void clear_queue() {
-    queue_.clear();
+    storage_->queue.clear();
   }
 
   /**
    * Clear the status maps.
    */
   void clear_status() {
-    node_status_.clear();
-    dest_status_.clear();
+    storage_->node_status.clear();
+    storage_->dest_status.clear();
   }
 
 private:
-  baldr::DoubleBucketQueue<Label> queue_;                  // Priority queue
-  std::unordered_map<baldr::GraphId, Status> node_status_; // Node status
-  std::unordered_map<uint16_t, Status> dest_status_;       // Destination status
-  std::vector<Label> labels_;                              // Label list.
+  // status is kept per origin, graph ids only use the lower 46 bits so the origin fits on top
+  static uint64_t node_key(const baldr::GraphId& nodeid, const uint16_t origin) {
+    return nodeid.value | (static_cast<uint64_t>(origin) << 48);
+  }
+  static uint32_t dest_key(const uint16_t dest, const uint16_t origin) {
+    return dest | (static_cast<uint32_t>(origin) << 16);
+  }
+
+  labelset_storage_ptr_t storage_; // Priority queue and node/destination status
+  std::vector<Label> labels_;      // Label list.
 };
 
 using labelset_ptr_t = std::shared_ptr<LabelSet>;
@@ -304,6 +377,41 @@ find_shortest_path(baldr::GraphReader& reader,
                    const float max_dist,
                    const float max_time);
 
+/**
+ * Find the shortest paths from each of a set of origins to all of the destinations in a single
+ * expansion. The origins share the queue, the destination lookup and the tiles they touch but each
+ * has its own search tree so the paths found are the same as running find_shortest_path from each
+ * one of them, up to the order of labels whose costs fall in the same bucket.
+ * @param reader            a graph reader for tile access
+ * @param destinations      a vector of locations containing both the origins and the destinations
+ * @param origin_idxs       the indices of the origin locations in the destinations vector, the other
+ *                          origins are not destinations of an origin
+ * @param labelset          labelset to associate with this computation for later look up/path
+ *                          recovery, the labels record which origin they belong to
+ * @param approximator      used for quick approximation of the distance to goal for a* heuristic
+ * @param search_radius     also used for a* heuristic
+ * @param costing           used for doing best first expansion and checking access/restrictions
+ * @param edgelabels        for each origin the last label from the previous expansion that lead to
+ *                          it, or nullptr
+ * @param turn_cost_table   array of turn costs based on turn angle
+ * @param max_dist          how far to allow the expansion to run
+ * @param max_time          how long to allow the expansion to run
+ * @return for each origin a map of destination index to label index so that you can recover a path
+ * for any destination
+ */
+std::vector<std::unordered_map<uint16_t, uint32_t>>
+find_shortest_paths(baldr::GraphReader& reader,
+                    const std::vector<baldr::PathLocation>& destinations,
+                    const std::vector<uint16_t>& origin_idxs,
+                    labelset_ptr_t labelset,
+                    const midgard::DistanceApproximator<midgard::PointLL>& approximator,
+                    const float search_radius,
+                    sif::cost_ptr_t costing,
+                    const std::vector<const Label*>& edgelabels,
+                    const float turn_cost_table[181],
+                    const float max_dist,
+                    const float max_time);
+
 // Route path iterator. Methods to assist recovering route paths from Labels.
 class RoutePathIterator : public std::iterator<std::forward_iterator_tag, const Label> {
 public:
@@ -18,7 +18,8 @@ namespace meili {
 class State {
 public:
   State(const StateId& stateid, const baldr::PathLocation& candidate)
-      : stateid_(stateid), candidate_(candidate), labelset_(nullptr), label_idx_() {
+      : stateid_(stateid), candidate_(candidate), labelset_(nullptr), label_idx_(),
+        tentative_(false) {
   }
 
   const StateId& stateid() const {
@@ -53,9 +54,41 @@ public:
       ++dest;
     }
     labelset_ = labelset;
+    tentative_ = false;
     LOG_TRACE("Found " + std::to_string(found) + " destinations out of " + std::to_string(dest - 1));
   }
 
+  /**
+   * Sets a route that was computed before the search settled on the predecessor of this state, on
+   * the assumption that it would be the given one
+   */
+  void SetTentativeRoute(const std::vector<StateId>& stateids,
+                         const std::unordered_map<uint16_t, uint32_t>& results,
+                         labelset_ptr_t labelset,
+                         const StateId& predecessor) const {
+    SetRoute(stateids, results, labelset);
+    tentative_ = true;
+    tentative_predecessor_ = predecessor;
+  }
+
+  /**
+   * Whether the route is still waiting to be checked against the predecessor the search settles on
+   */
+  bool tentative() const {
+    return tentative_;
+  }
+
+  /**
+   * Checks a tentative route against the predecessor the search settled on
+   * @param predecessor  the settled predecessor
+   * @return true if the route assumed a different predecessor and has to be computed again
+   */
+  bool Settle(const StateId& predecessor) const {
+    const bool stale = tentative_ && tentative_predecessor_ != predecessor;
+    tentative_ = false;
+    return stale;
+  }
+
   const Label* last_label(const State& state) const {
     const auto it = label_idx_.find(state.stateid());
     if (it != label_idx_.end()) {
@@ -84,6 +117,10 @@ private:
   mutable std::shared_ptr<LabelSet> labelset_;
 
   mutable std::unordered_map<StateId, uint32_t> label_idx_;
+
+  mutable bool tentative_;
+
+  mutable StateId tentative_predecessor_;
 };
 
 class StateContainer {
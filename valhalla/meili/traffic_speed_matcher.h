@@ -0,0 +1,110 @@
+// -*- mode: c++ -*-
+#ifndef MMP_TRAFFIC_SPEED_MATCHER_H_
+#define MMP_TRAFFIC_SPEED_MATCHER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <valhalla/baldr/graphid.h>
+#include <valhalla/baldr/graphreader.h>
+#include <valhalla/baldr/traffictile.h>
+#include <valhalla/meili/map_matcher_factory.h>
+#include <valhalla/meili/match_result.h>
+#include <valhalla/meili/measurement.h>
+#include <valhalla/midgard/thread_pool.h>
+#include <valhalla/proto/options.pb.h>
+
+namespace valhalla {
+namespace meili {
+
+// how far and for how long the probes that were matched to an edge travelled along it
+struct edge_speed_t {
+  double length = 0;  // meters
+  double seconds = 0; // seconds
+  uint32_t probes = 0;
+
+  // the space mean speed in kph, 0 if there is no time along the edge
+  float kph() const {
+    return seconds > 0 ? static_cast<float>(length / seconds * 3.6) : 0.f;
+  }
+};
+
+/**
+ * Turns lots of timestamped gps probe traces into live speeds. The traces are matched in parallel
+ * on threads kept from one call to the next, each with its own matchers and graph reader but all of
+ * them sharing a tile cache, then
+ * the time spent on each edge is interpolated between the matched points and added up per edge.
+ * The speeds can be written straight into the live traffic tiles of a traffic extract.
+ *
+ * The accumulated speeds only depend on the traces and the number of threads, the traces are split
+ * into contiguous runs per thread and merged back in the same order every time.
+ */
+class TrafficSpeedMatcher {
+public:
+  /**
+   * Constructor
+   * @param config       the config with at least the mjolnir and meili sections
+   * @param concurrency  how many threads to match with, 0 means one per core
+   */
+  TrafficSpeedMatcher(const boost::property_tree::ptree& config, unsigned int concurrency = 0);
+
+  /**
+   * Matches the traces and adds the speeds along their paths to the ones accumulated so far
+   * @param traces   the probe traces, only measurements with epoch times contribute speeds
+   * @param options  the options to match with, mainly the costing
+   * @return how many of the traces could not be matched
+   */
+  size_t Match(const std::vector<std::vector<Measurement>>& traces, const Options& options);
+
+  /**
+   * Adds the time spent on each edge of a matched path to the given speeds
+   * @param results  the match results of a trace
+   * @param reader   graph reader to get the length of the edges with
+   * @param speeds   where to add the speeds
+   */
+  static void Accumulate(const MatchResults& results,
+                         baldr::GraphReader& reader,
+                         std::unordered_map<baldr::GraphId, edge_speed_t>& speeds);
+
+  /**
+   * Encodes a speed as a live traffic speed covering the whole edge
+   * @param speed  the accumulated speed
+   * @return the encoded speed, which is never closed no matter how slow the probes went
+   */
+  static baldr::TrafficSpeed Encode(const edge_speed_t& speed);
+
+  /**
+   * Updates the speeds of the matched edges in place in a traffic extract, anything mapping the
+   * extract sees them right away
+   * @param traffic_extract  the tar of live traffic tiles
+   * @param last_update      seconds since epoch to stamp the updated tiles with
+   * @param min_probes       edges with fewer probes than this are left alone
+   * @return how many edges were updated
+   */
+  size_t Write(const std::string& traffic_extract, uint64_t last_update, uint32_t min_probes = 1);
+
+  const std::unordered_map<baldr::GraphId, edge_speed_t>& speeds() const {
+    return speeds_;
+  }
+
+  void Clear() {
+    speeds_.clear();
+  }
+
+private:
+  // one of each per thread, the readers share a tile cache when there is more than one
+  std::vector<std::shared_ptr<baldr::GraphReader>> readers_;
+  std::vector<std::unique_ptr<MapMatcherFactory>> factories_;
+  std::unique_ptr<midgard::ThreadPool> pool_;
+
+  std::unordered_map<baldr::GraphId, edge_speed_t> speeds_;
+};
+
+} // namespace meili
+} // namespace valhalla
+#endif // MMP_TRAFFIC_SPEED_MATCHER_H_
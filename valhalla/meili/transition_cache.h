@@ -0,0 +1,114 @@
+// -*- mode: c++ -*-
+#ifndef MMP_TRANSITION_CACHE_H_
+#define MMP_TRANSITION_CACHE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <valhalla/baldr/pathlocation.h>
+#include <valhalla/meili/routing.h>
+#include <valhalla/midgard/lru_cache.h>
+#include <valhalla/proto/options.pb.h>
+
+namespace valhalla {
+namespace meili {
+
+/**
+ * A least recently used cache of the paths found between pairs of candidates. Fleets drive the
+ * same corridors over and over and traces get matched again (sessions, alternates, resubmits) so
+ * the same hops between the same candidate edges and percents along come up a lot. Rather than
+ * routing them again we keep the labels of the path found the last time and copy them into the
+ * label set of the new transition.
+ *
+ * Paths are keyed by a fingerprint of the costing, the label the route comes in on and the edges
+ * and percents along of both candidates. Along with each path we keep the limits of the search
+ * that found it (or didnt) so we only answer when that search would have come to the same
+ * conclusion. The cache is not thread safe, each matcher factory keeps its own.
+ */
+class TransitionCache {
+public:
+  /**
+   * Constructor
+   * @param max_paths  how many paths the cache may hold before evicting the least recently used
+   */
+  explicit TransitionCache(size_t max_paths);
+
+  /**
+   * Computes a fingerprint of everything about the costing that affects the paths found and the
+   * costs on their labels
+   * @param options              the request options the costing was created from
+   * @param turn_penalty_factor  the turn penalty factor of the matcher
+   * @return the fingerprint
+   */
+  static uint64_t CostingKey(const Options& options, float turn_penalty_factor);
+
+  /**
+   * Computes the key of the path between two candidates
+   * @param costing_key  see CostingKey
+   * @param edgelabel    the label the route comes in on or nullptr
+   * @param origin       the candidate the path starts at
+   * @param destination  the candidate the path goes to
+   * @return the key
+   */
+  static std::string Key(uint64_t costing_key,
+                         const Label* edgelabel,
+                         const baldr::PathLocation& origin,
+                         const baldr::PathLocation& destination);
+
+  /**
+   * Looks for what a search with the given limits would find between the candidates of the key
+   * @param key       see Key
+   * @param max_dist  the distance the search is limited to
+   * @param max_time  the time the search is limited to, negative for no limit
+   * @param path      set to the labels from the origin to the destination, or nullptr if there is
+   *                  no path within the limits. Valid until the next insert
+   * @return true if the cache knows the outcome of the search
+   */
+  bool Find(const std::string& key,
+            float max_dist,
+            float max_time,
+            const std::vector<Label>*& path);
+
+  /**
+   * Stores the outcome of a search evicting the least recently used paths if need be
+   * @param key       see Key
+   * @param path      the labels from the origin to the destination, empty if none was found
+   * @param max_dist  the distance the search was limited to
+   * @param max_time  the time the search was limited to, negative for no limit
+   */
+  void Insert(std::string key, std::vector<Label> path, float max_dist, float max_time);
+
+  /**
+   * Drops everything, for example because the tiles the paths came from have changed
+   */
+  void Clear();
+
+  size_t size() const {
+    return paths_.size();
+  }
+  size_t hits() const {
+    return paths_.hits();
+  }
+  size_t misses() const {
+    return paths_.misses();
+  }
+
+protected:
+  struct path_t {
+    std::vector<Label> labels;
+    float max_dist;
+    float max_time;
+  };
+
+  bool enabled_;
+  midgard::lru_cache<std::string, path_t> paths_;
+};
+
+using transition_cache_ptr_t = std::shared_ptr<TransitionCache>;
+
+} // namespace meili
+} // namespace valhalla
+
+#endif // MMP_TRANSITION_CACHE_H_
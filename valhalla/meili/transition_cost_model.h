@@ -2,13 +2,19 @@
 #define MMP_TRANSITION_COST_MODEL_H_
 
 #include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <valhalla/baldr/graphreader.h>
 #include <valhalla/meili/config.h>
 #include <valhalla/meili/measurement.h>
 #include <valhalla/meili/state.h>
 #include <valhalla/meili/topk_search.h>
+#include <valhalla/meili/transition_cache.h>
 #include <valhalla/meili/viterbi_search.h>
+#include <valhalla/midgard/thread_pool.h>
 #include <valhalla/sif/dynamiccost.h>
 
 namespace valhalla {
@@ -26,7 +32,13 @@ public:
                       float breakage_distance,
                       float max_route_distance_factor,
                       float max_route_time_factor,
-                      float turn_penalty_factor);
+                      float turn_penalty_factor,
+                      bool multi_source_routing = false,
+                      const labelset_storage_ptr_t& labelset_storage = {},
+                      const transition_cache_ptr_t& transition_cache = {},
+                      uint64_t costing_key = 0,
+                      const std::vector<std::shared_ptr<baldr::GraphReader>>& thread_readers = {},
+                      midgard::ThreadPool* thread_pool = nullptr);
 
   TransitionCostModel(baldr::GraphReader& graphreader,
                       const IViterbiSearch& vs,
@@ -34,7 +46,12 @@ public:
                       const StateContainer& container,
                       const sif::mode_costing_t& mode_costing,
                       const sif::TravelMode travelmode,
-                      const Config::TransitionCost& config);
+                      const Config::TransitionCost& config,
+                      const labelset_storage_ptr_t& labelset_storage = {},
+                      const transition_cache_ptr_t& transition_cache = {},
+                      uint64_t costing_key = 0,
+                      const std::vector<std::shared_ptr<baldr::GraphReader>>& thread_readers = {},
+                      midgard::ThreadPool* thread_pool = nullptr);
 
   // we use the difference between the original two measurements and the distance along the route
   // network to compute a transition cost of a given candidate, transition_time may be added if
@@ -51,9 +68,70 @@ public:
 
   float operator()(const StateId& lhs, const StateId& rhs) const;
 
+  /**
+   * Routes from each of the given states to the states of the next column, the same as asking for
+   * a transition cost from each of them would, but spread over the thread pool and its graph
+   * readers. The transition cache is looked up and filled in on the calling thread
+   * @param stateids  the states to route from, the ones that are already routed are skipped
+   */
+  void RouteAll(const std::vector<StateId>& stateids) const;
+
 private:
+  // everything needed to search for the paths from one state to the states of another column
+  struct route_request_t {
+    const State* left;
+    const Label* edgelabel;
+    // the origin followed by the destinations that still have to be searched for
+    std::vector<baldr::PathLocation> locations;
+    std::vector<StateId> stateids;
+    midgard::DistanceApproximator<midgard::PointLL> approximator;
+    float search_radius;
+    float max_route_distance;
+    float max_route_time;
+    // for each state its key in the transition cache and the path the cache knows about, if any
+    std::vector<std::string> keys;
+    std::vector<const std::vector<Label>*> cached;
+    // for each destination being searched for the index of its state
+    std::vector<uint16_t> searched;
+  };
+
+  // what a search for a request found
+  struct route_t {
+    labelset_ptr_t labelset;
+    std::unordered_map<uint16_t, uint32_t> found;
+  };
+
+  // prepares the search from the left state to the states of the other column, leaving out the
+  // destinations whose paths the transition cache already knows about
+  route_request_t RouteRequest(const State& left, const StateId::Time& rhs_time) const;
+
+  // searches for the paths of the request that werent in the transition cache
+  route_t Route(baldr::GraphReader& reader,
+                const labelset_storage_ptr_t& storage,
+                const route_request_t& request) const;
+
+  // copies the cached paths in with the ones that were searched for, remembers the searched ones
+  // in the transition cache and hands them all to the left states
+  void SetRoutes(const std::vector<route_request_t>& requests, std::vector<route_t>& routes) const;
+
   void UpdateRoute(const StateId& lhs, const StateId& rhs) const;
 
+  // routes from the left state and the rest of its column that hasnt been routed yet in one
+  // expansion, the others get tentative routes that are redone if their predecessor was wrong
+  void UpdateRoutes(const StateId& lhs, const StateId& rhs) const;
+
+  // the last label of the route from the previous state into the given one, nullptr if none
+  const Label* EdgeLabel(const State& state, const StateId& prev_stateid) const;
+
+  // the state whose route leads into the given one according to the search, invalid if none
+  StateId RoutedPredecessor(const StateId& stateid) const;
+
+  // the best predecessor the given not yet settled state can have among the states the search has
+  // settled so far, invalid if none
+  StateId TentativePredecessor(const State& state) const;
+
+  float LabelCost(const StateId& lhs, const StateId& rhs, const Label& label) const;
+
   float ClockDistance(const StateId::Time& lhs, const StateId::Time& rhs) const {
     double clk_dist = -1.0;
 
@@ -93,6 +171,24 @@ private:
   float turn_cost_table_[181];
 
   bool match_on_restrictions_{false};
+
+  // route from all of the candidates of a measurement in one expansion, without the transition
+  // cache or the thread pool
+  bool multi_source_routing_;
+
+  // the queue and status maps shared by all of the label sets we search with
+  labelset_storage_ptr_t labelset_storage_;
+
+  // paths found by earlier transitions, possibly of other traces, and the fingerprint of our
+  // costing to look them up with
+  transition_cache_ptr_t transition_cache_;
+  uint64_t costing_key_;
+
+  // one reader sharing a tile cache and one label storage for each task of the thread pool, so
+  // that we can route from many states at once
+  std::vector<std::shared_ptr<baldr::GraphReader>> thread_readers_;
+  mutable std::vector<labelset_storage_ptr_t> thread_storage_;
+  midgard::ThreadPool* thread_pool_;
 };
 
 } // namespace meili
@@ -165,6 +165,15 @@ public:
   StateId Predecessor(const StateId& stateid) const override;
   double AccumulatedCost(const StateId& stateid) const override;
 
+  /**
+   * Finds the latest state which every path the search could still report has to go through, no
+   * matter what states are added after it. Everything up to and including it on the winning path
+   * is final. This lets a trace be matched a few measurements at a time.
+   *
+   * @return the converged state or an invalid state id if nothing has converged yet
+   */
+  StateId ConvergedState() const;
+
 private:
   // Initialize labels from a column and push them into priority queue
   void InitQueue(const std::vector<StateId>& column);
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
+#include <iterator>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
@@ -43,20 +45,24 @@ private:
   int32_t lon = 0;
   double prec;
 
+  // a 32 bit number takes at most this many 7 bit chunks
+  static constexpr int kMaxChunks = 5;
+
   int32_t next(const int32_t previous) noexcept(false) {
-    int32_t byte, shift = 0, result = 0;
-    do {
-      if (empty()) {
-        throw std::runtime_error("Bad encoded polyline");
-      }
+    // away from the end of the string a whole number is there so we dont check every char
+    const int chunks = end - begin >= kMaxChunks ? kMaxChunks : static_cast<int>(end - begin);
+    uint32_t result = 0;
+    for (int chunk = 0; chunk < chunks; ++chunk) {
       // take the least significant 7 bits shifted into place
-      byte = int32_t(*begin++);
-      result |= (byte & 0x7f) << shift;
-      shift += 7;
+      const uint32_t byte = static_cast<unsigned char>(*begin++);
+      result |= (byte & 0x7f) << (chunk * 7);
       // if the most significant bit is set there is more to this number
-    } while (byte & 0x80);
-    // handle the bit flipping and add to previous since its an offset
-    return previous + ((result & 1 ? ~result : result) >> 1);
+      if (!(byte & 0x80)) {
+        // handle the bit flipping and add to previous since its an offset
+        return previous + (static_cast<int32_t>(result & 1 ? ~result : result) >> 1);
+      }
+    }
+    throw std::runtime_error("Bad encoded polyline");
   }
 };
 
@@ -81,21 +87,24 @@ private:
   int32_t lon = 0;
   double prec;
 
+  // a 32 bit number takes at most this many 5 bit chunks
+  static constexpr int kMaxChunks = 7;
+
   int32_t next(const int32_t previous) noexcept(false) {
-    // grab each 5 bits and mask it in where it belongs using the shift
-    int byte, shift = 0, result = 0;
-    do {
-      if (empty()) {
-        throw std::runtime_error("Bad encoded polyline");
+    // away from the end of the string a whole number is there so we dont check every char
+    const int chunks = end - begin >= kMaxChunks ? kMaxChunks : static_cast<int>(end - begin);
+    uint32_t result = 0;
+    for (int chunk = 0; chunk < chunks; ++chunk) {
+      // grab each 5 bits and mask it in where it belongs using the shift
+      const int32_t byte = int32_t(*begin++) - 63;
+      result |= static_cast<uint32_t>(byte & 0x1f) << (chunk * 5);
+      // if the 6th bit is set there is more to this number
+      if (byte < 0x20) {
+        // handle the bit flipping and add to previous since its an offset
+        return previous + static_cast<int32_t>(result & 1 ? ~(result >> 1) : (result >> 1));
       }
-      // take the least significant 5 bits shifted into place
-      byte = int32_t(*begin++) - 63;
-      result |= (byte & 0x1f) << shift;
-      shift += 5;
-      // if the most significant bit is set there is more to this number
-    } while (byte >= 0x20);
-    // handle the bit flipping and add to previous since its an offset
-    return previous + (result & 1 ? ~(result >> 1) : (result >> 1));
+    }
+    throw std::runtime_error("Bad encoded polyline");
   }
 };
 
@@ -157,6 +166,87 @@ container_t decode7(const std::string& encoded, const double precision = DECODE_
   return decode7<container_t>(encoded.c_str(), encoded.length(), precision);
 }
 
+namespace detail {
+
+// the zigzag encoding puts the sign bit at the least significant end so small negative numbers
+// have mostly zeros in their most significant bits too
+inline uint32_t zigzag(const int32_t number) {
+  return number < 0 ? ~(static_cast<uint32_t>(number) << 1) : static_cast<uint32_t>(number) << 1;
+}
+
+// writes a number as 5 bit chunks offset into printable ascii, at most 7 chars
+inline char* write_polyline(char* output, const int32_t number) {
+  uint32_t bits = zigzag(number);
+  while (bits >= 0x20) {
+    *output++ = static_cast<char>((0x20 | (bits & 0x1f)) + 63);
+    bits >>= 5;
+  }
+  *output++ = static_cast<char>(bits + 63);
+  return output;
+}
+
+// writes a number as 7 bit chunks with the most significant bit marking more to come, at most 5
+inline char* write_varint(char* output, const int32_t number) {
+  uint32_t bits = zigzag(number);
+  while (bits > 0x7f) {
+    *output++ = static_cast<char>(0x80 | (bits & 0x7f));
+    bits >>= 7;
+  }
+  *output++ = static_cast<char>(bits);
+  return output;
+}
+
+// the delta encoding both formats share. the chars are written straight into the output rather
+// than pushed back one at a time. most points take far fewer chars than the worst case so, like the
+// old encoder, the output starts out at about 8 chars a point and only grows when it gets close to
+// not having room for the next one
+template <class iterator_t, char* (*write)(char*, int32_t), size_t kMaxChars>
+void encode(iterator_t begin, iterator_t end, std::string& output, const int precision) {
+  constexpr size_t kCharsPerPoint = 8;
+  size_t remaining = std::distance(begin, end);
+  size_t used = output.size();
+  output.resize(used + remaining * kCharsPerPoint + 2 * kMaxChars);
+  char* out = &output[used];
+  // this is an offset encoding so we remember the last point we saw
+  int last_lon = 0, last_lat = 0;
+  for (; begin != end; ++begin, --remaining) {
+    // make sure the next point fits whatever it looks like
+    if (static_cast<size_t>(output.data() + output.size() - out) < 2 * kMaxChars) {
+      used = out - output.data();
+      output.resize(used + remaining * kCharsPerPoint + 2 * kMaxChars);
+      out = &output[used];
+    }
+    // shift the decimal point x places to the right and truncate
+    int lon = static_cast<int>(round(static_cast<double>(begin->first) * precision));
+    int lat = static_cast<int>(round(static_cast<double>(begin->second) * precision));
+    // encode each coordinate, lat first for some reason
+    out = write(out, lat - last_lat);
+    out = write(out, lon - last_lon);
+    // remember the last one we encountered
+    last_lon = lon;
+    last_lat = lat;
+  }
+  output.resize(out - output.data());
+}
+
+} // namespace detail
+
+/**
+ * Polyline encode a range of points onto the end of a string
+ *
+ * @param begin     the first point to encode
+ * @param end       one past the last point to encode
+ * @param output    where the encoded points are appended
+ * @param precision Precision of the encoded polyline. Defaults to 6 digit precision.
+ */
+template <class iterator_t>
+void encode(iterator_t begin,
+            iterator_t end,
+            std::string& output,
+            const int precision = ENCODE_PRECISION) {
+  detail::encode<iterator_t, detail::write_polyline, 7>(begin, end, output, precision);
+}
+
 /**
  * Polyline encode a container of points into a string suitable for web use
  * Note: newer versions of this algorithm allow one to specify a zoom level
@@ -168,44 +258,27 @@ container_t decode7(const std::string& encoded, const double precision = DECODE_
  */
 template <class container_t>
 std::string encode(const container_t& points, const int precision = ENCODE_PRECISION) {
-  // a place to keep the output
   std::string output;
-  // unless the shape is very course you should probably only need about 3 bytes
-  // per coord, which is 6 bytes with 2 coords, so we overshoot to 8 just in case
-  output.reserve(points.size() * 8);
-
-  // handy lambda to turn an integer into an encoded string
-  auto serialize = [&output](int number) {
-    // move the bits left 1 position and flip all the bits if it was a negative number
-    number = number < 0 ? ~(static_cast<unsigned int>(number) << 1) : (number << 1);
-    // write 5 bit chunks of the number
-    while (number >= 0x20) {
-      int nextValue = (0x20 | (number & 0x1f)) + 63;
-      output.push_back(static_cast<char>(nextValue));
-      number >>= 5;
-    }
-    // write the last chunk
-    number += 63;
-    output.push_back(static_cast<char>(number));
-  };
-
-  // this is an offset encoding so we remember the last point we saw
-  int last_lon = 0, last_lat = 0;
-  // for each point
-  for (const auto& p : points) {
-    // shift the decimal point 5 places to the right and truncate
-    int lon = static_cast<int>(round(static_cast<double>(p.first) * precision));
-    int lat = static_cast<int>(round(static_cast<double>(p.second) * precision));
-    // encode each coordinate, lat first for some reason
-    serialize(lat - last_lat);
-    serialize(lon - last_lon);
-    // remember the last one we encountered
-    last_lon = lon;
-    last_lat = lat;
-  }
+  encode(points.begin(), points.end(), output, precision);
   return output;
 }
 
+/**
+ * Varint encode a range of points onto the end of a string
+ *
+ * @param begin     the first point to encode
+ * @param end       one past the last point to encode
+ * @param output    where the encoded points are appended
+ * @param precision Precision of the encoded points. Defaults to 6 digit precision.
+ */
+template <class iterator_t>
+void encode7(iterator_t begin,
+             iterator_t end,
+             std::string& output,
+             const int precision = ENCODE_PRECISION) {
+  detail::encode<iterator_t, detail::write_varint, 5>(begin, end, output, precision);
+}
+
 /**
  * Varint encode a container of points into a string
  *
@@ -214,42 +287,8 @@ std::string encode(const container_t& points, const int precision = ENCODE_PRECI
  */
 template <class container_t>
 std::string encode7(const container_t& points, const int precision = ENCODE_PRECISION) {
-  // a place to keep the output
   std::string output;
-  // unless the shape is very course you should probably only need about 3 bytes
-  // per coord, which is 6 bytes with 2 coords, so we overshoot to 8 just in case
-  output.reserve(points.size() * 8);
-
-  // handy lambda to turn an integer into an encoded string
-  auto serialize = [&output](int number) {
-    // get the sign bit down on the least significant end to
-    // make the most significant bits mostly zeros
-    number = number < 0 ? ~(static_cast<unsigned int>(number) << 1) : number << 1;
-    // we take 7 bits of this at a time
-    while (number > 0x7f) {
-      // marking the most significant bit means there are more pieces to come
-      int nextValue = (0x80 | (number & 0x7f));
-      output.push_back(static_cast<char>(nextValue));
-      number >>= 7;
-    }
-    // write the last chunk
-    output.push_back(static_cast<char>(number & 0x7f));
-  };
-
-  // this is an offset encoding so we remember the last point we saw
-  int last_lon = 0, last_lat = 0;
-  // for each point
-  for (const auto& p : points) {
-    // shift the decimal point x places to the right and truncate
-    int lon = static_cast<int>(round(static_cast<double>(p.first) * precision));
-    int lat = static_cast<int>(round(static_cast<double>(p.second) * precision));
-    // encode each coordinate, lat first for some reason
-    serialize(lat - last_lat);
-    serialize(lon - last_lon);
-    // remember the last one we encountered
-    last_lon = lon;
-    last_lat = lat;
-  }
+  encode7(points.begin(), points.end(), output, precision);
   return output;
 }
 
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace valhalla {
+namespace midgard {
+
+/**
+ * A least recently used cache that can be limited by how many entries it holds, how many bytes
+ * they take, how long ago they were inserted and how long they have gone unused. When an insert
+ * would go over the size or bytes limit, the least recently used entries are evicted first. Entries
+ * that are too old are dropped when they are looked up or when expire() is called.
+ *
+ * The cache counts its hits, misses and evictions. It is not thread safe, so callers that share
+ * one have to lock around it.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>> class lru_cache {
+public:
+  using clock_t = std::chrono::steady_clock;
+
+  /**
+   * Constructor
+   * @param max_size   how many entries to hold at most, 0 for no limit
+   * @param max_bytes  how many bytes the entries may take at most, see insert. 0 for no limit
+   * @param max_age    how long after it was inserted an entry is still served
+   * @param max_idle   how long an entry may go without being found before it is dropped
+   */
+  explicit lru_cache(size_t max_size,
+                     size_t max_bytes = 0,
+                     clock_t::duration max_age = clock_t::duration::max(),
+                     clock_t::duration max_idle = clock_t::duration::max())
+      : max_size_(max_size), max_bytes_(max_bytes), max_age_(max_age), max_idle_(max_idle),
+        bytes_(0), hits_(0), misses_(0), evictions_(0) {
+  }
+
+  /**
+   * Looks for the value of a key and makes it the most recently used
+   * @param key  the key to look for
+   * @param now  the current time
+   * @return the value or nullptr if it isnt there or is too old. Valid until the next change
+   */
+  Value* find(const Key& key, clock_t::time_point now = clock_t::now()) {
+    return find_if(key, [](const Value&) { return true; }, now);
+  }
+
+  /**
+   * Like find but only counts it as a hit if the value is good for what the caller wants, an entry
+   * that isnt is left where it is
+   * @param key     the key to look for
+   * @param usable  decides if the value can be used
+   * @param now     the current time
+   * @return the value or nullptr if it isnt there, is too old or isnt usable
+   */
+  template <typename Predicate>
+  Value* find_if(const Key& key, const Predicate& usable, clock_t::time_point now = clock_t::now()) {
+    auto found = index_.find(key);
+    if (found == index_.end()) {
+      ++misses_;
+      return nullptr;
+    }
+
+    auto entry = found->second;
+    if (expired(*entry, now)) {
+      evict(entry);
+      ++misses_;
+      return nullptr;
+    }
+    if (!usable(entry->value)) {
+      ++misses_;
+      return nullptr;
+    }
+
+    // its now the most recently used
+    entries_.splice(entries_.begin(), entries_, entry);
+    entry->used = now;
+    ++hits_;
+    return &entry->value;
+  }
+
+  /**
+   * Looks at the value of a key without it counting as a use, a hit or a miss
+   * @param key  the key to look for
+   * @return the value or nullptr if it isnt there. It may be too old to be found
+   */
+  Value* peek(const Key& key) {
+    auto found = index_.find(key);
+    return found == index_.end() ? nullptr : &found->second->value;
+  }
+
+  /**
+   * Stores the value of a key, replacing whatever it had before, and evicts the least recently
+   * used entries until everything fits
+   * @param key    the key to store it under
+   * @param value  the value to store
+   * @param bytes  how many bytes the entry takes, only used when there is a max_bytes
+   * @param now    the current time
+   * @return the stored value or nullptr if it is bigger than max_bytes on its own, in which case
+   *         the cache is left as it was
+   */
+  Value*
+  insert(const Key& key, Value value, size_t bytes = 0, clock_t::time_point now = clock_t::now()) {
+    if (max_bytes_ && bytes > max_bytes_) {
+      return nullptr;
+    }
+    erase(key);
+
+    // make room for it
+    while (!entries_.empty() && ((max_size_ && entries_.size() >= max_size_) ||
+                                 (max_bytes_ && bytes_ + bytes > max_bytes_))) {
+      evict(std::prev(entries_.end()));
+    }
+
+    entries_.push_front(entry_t{key, std::move(value), bytes, now, now});
+    index_.emplace(key, entries_.begin());
+    bytes_ += bytes;
+    return &entries_.front().value;
+  }
+
+  /**
+   * Removes the entry of a key, it does not count as an eviction
+   * @param key  the key to remove
+   * @return true if there was such an entry
+   */
+  bool erase(const Key& key) {
+    auto found = index_.find(key);
+    if (found == index_.end()) {
+      return false;
+    }
+    bytes_ -= found->second->bytes;
+    entries_.erase(found->second);
+    index_.erase(found);
+    return true;
+  }
+
+  /**
+   * Removes all of the entries a predicate holds for, they do not count as evictions
+   * @param remove  takes the key and the value and says if the entry should go
+   * @return how many entries were removed
+   */
+  template <typename Predicate> size_t erase_if(const Predicate& remove) {
+    size_t count = 0;
+    for (auto entry = entries_.begin(); entry != entries_.end();) {
+      if (remove(entry->key, entry->value)) {
+        bytes_ -= entry->bytes;
+        index_.erase(entry->key);
+        entry = entries_.erase(entry);
+        ++count;
+      } else {
+        ++entry;
+      }
+    }
+    return count;
+  }
+
+  /**
+   * Evicts every entry that is too old or has been idle for too long
+   * @param now  the current time
+   * @return how many entries were evicted
+   */
+  size_t expire(clock_t::time_point now = clock_t::now()) {
+    size_t count = 0;
+    // the back was used longest ago, so we can stop at the first one that isnt idle
+    while (!entries_.empty() && now - entries_.back().used >= max_idle_) {
+      evict(std::prev(entries_.end()));
+      ++count;
+    }
+    // inserts dont happen in the order of use so this has to look at all of them
+    if (max_age_ != clock_t::duration::max()) {
+      for (auto entry = entries_.begin(); entry != entries_.end();) {
+        auto next = std::next(entry);
+        if (now - entry->inserted >= max_age_) {
+          evict(entry);
+          ++count;
+        }
+        entry = next;
+      }
+    }
+    return count;
+  }
+
+  /**
+   * Removes everything, the counters are kept
+   */
+  void clear() {
+    index_.clear();
+    entries_.clear();
+    bytes_ = 0;
+  }
+
+  size_t size() const {
+    return index_.size();
+  }
+  size_t bytes() const {
+    return bytes_;
+  }
+  size_t hits() const {
+    return hits_;
+  }
+  size_t misses() const {
+    return misses_;
+  }
+  size_t evictions() const {
+    return evictions_;
+  }
+
+protected:
+  struct entry_t {
+    Key key;
+    Value value;
+    size_t bytes;
+    clock_t::time_point inserted;
+    clock_t::time_point used;
+  };
+  using iterator_t = typename std::list<entry_t>::iterator;
+
+  bool expired(const entry_t& entry, clock_t::time_point now) const {
+    return now - entry.inserted >= max_age_ || now - entry.used >= max_idle_;
+  }
+
+  void evict(iterator_t entry) {
+    bytes_ -= entry->bytes;
+    index_.erase(entry->key);
+    entries_.erase(entry);
+    ++evictions_;
+  }
+
+  size_t max_size_;
+  size_t max_bytes_;
+  clock_t::duration max_age_;
+  clock_t::duration max_idle_;
+  size_t bytes_;
+  size_t hits_;
+  size_t misses_;
+  size_t evictions_;
+  // most recently used at the front
+  std::list<entry_t> entries_;
+  std::unordered_map<Key, iterator_t, Hash> index_;
+};
+
+} // namespace midgard
+} // namespace valhalla
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace valhalla {
+namespace midgard {
+
+/**
+ * A fixed set of threads that a worker keeps around for the parts of its requests that can be
+ * split up, so that a request does not have to start and join threads of its own. The thread that
+ * asks for the work always helps with it. So a pool without threads does the work in order on the
+ * calling thread, and a caller whose pool is busy with other work never waits on tasks nobody has
+ * started. That also makes it safe to run more work on the pool from one of its own tasks.
+ */
+class ThreadPool {
+public:
+  /**
+   * Starts the threads
+   * @param threads  how many threads to keep around besides the ones that call Run
+   */
+  explicit ThreadPool(size_t threads);
+
+  /**
+   * Lets the threads finish what they are doing and joins them
+   */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * @return how many tasks can run at once, the threads of the pool plus the calling thread
+   */
+  size_t concurrency() const {
+    return threads_.size() + 1;
+  }
+
+  /**
+   * Runs task(0) through task(count - 1) on the pool and the calling thread and waits for all of
+   * them to finish. The tasks may run in any order and on any thread. If any of them throw, the
+   * exception of the lowest numbered one is rethrown once they are all done.
+   * @param count  how many tasks to run
+   * @param task   what to do for each of them
+   */
+  void Run(size_t count, const std::function<void(size_t)>& task);
+
+protected:
+  // takes jobs off of the queue until the pool is destroyed
+  void Work();
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<std::function<void()>> queue_;
+  bool stopping_;
+};
+
+} // namespace midgard
+} // namespace valhalla
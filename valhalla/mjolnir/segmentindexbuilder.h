@@ -0,0 +1,44 @@
+#ifndef VALHALLA_MJOLNIR_SEGMENTINDEXBUILDER_H
+#define VALHALLA_MJOLNIR_SEGMENTINDEXBUILDER_H
+
+#include <boost/property_tree/ptree.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <valhalla/baldr/segment_index.h>
+
+namespace valhalla {
+namespace mjolnir {
+
+/**
+ * Class used to build the packed hilbert rtree of edge segments that loki can use instead of
+ * walking the tile bins when searching for candidate edges.
+ */
+class SegmentIndexBuilder {
+public:
+  /**
+   * Collects the segments of all of the edges in the tileset and writes the index.
+   * @param pt         the mjolnir config subtree
+   * @param file_name  where to write the index
+   * @return the number of segments in the index
+   */
+  static size_t Build(const boost::property_tree::ptree& pt, const std::string& file_name);
+
+  /**
+   * Sorts the segments along a hilbert curve, packs the rtree on top of them and writes it out.
+   * @param file_name   where to write the index
+   * @param segments    the segments to index, they will be reordered
+   * @param dataset_id  the dataset id of the tiles the segments came from
+   * @param node_size   the fan out of the tree
+   */
+  static void Write(const std::string& file_name,
+                    std::vector<baldr::IndexedSegment>& segments,
+                    uint64_t dataset_id,
+                    uint32_t node_size = 16);
+};
+
+} // namespace mjolnir
+} // namespace valhalla
+
+#endif // VALHALLA_MJOLNIR_SEGMENTINDEXBUILDER_H
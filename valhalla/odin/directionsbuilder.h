@@ -3,6 +3,7 @@
 
 #include <list>
 
+#include <valhalla/midgard/thread_pool.h>
 #include <valhalla/odin/enhancedtrippath.h>
 #include <valhalla/odin/maneuver.h>
 #include <valhalla/odin/markup_formatter.h>
@@ -24,10 +25,16 @@ public:
    * calls PopulateDirectionsLeg to transform the maneuver list into the
    * trip directions.
    *
-   * @param api   the protobuf object containing the request, the path and a place
-   *              to store the resulting directions
+   * @param api               the protobuf object containing the request, the path and a place
+   *                          to store the resulting directions
+   * @param markup_formatter  formats the street names and signs in the narrative
+   * @param thread_pool       where to build the legs, they are independent so the directions come
+   *                          out the same no matter how many threads the pool has. when null
+   *                          they are all built on the calling thread
    */
-  static void Build(Api& api, const MarkupFormatter& markup_formatter);
+  static void Build(Api& api,
+                    const MarkupFormatter& markup_formatter,
+                    midgard::ThreadPool* thread_pool = nullptr);
 
 protected:
   /**
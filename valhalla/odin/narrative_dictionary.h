@@ -1,6 +1,8 @@
 #ifndef VALHALLA_ODIN_NARRATIVE_DICTIONARY_H_
 #define VALHALLA_ODIN_NARRATIVE_DICTIONARY_H_
 
+#include <cstdint>
+#include <initializer_list>
 #include <locale>
 #include <string>
 #include <unordered_map>
@@ -163,8 +165,91 @@ constexpr auto kLevelTag = "<LEVEL>";
 namespace valhalla {
 namespace odin {
 
+// The tags that can be replaced in a phrase, one for each of the phrase tag strings above
+enum class PhraseTag : uint8_t {
+  kCardinalDirection,
+  kRelativeDirection,
+  kOrdinalValue,
+  kStreetNames,
+  kPreviousStreetNames,
+  kBeginStreetNames,
+  kCrossStreetNames,
+  kRoundaboutExitStreetNames,
+  kRoundaboutExitBeginStreetNames,
+  kRampExitNumbersVisual,
+  kLength,
+  kDestination,
+  kCurrentVerbalCue,
+  kNextVerbalCue,
+  kKilometers,
+  kMeters,
+  kMiles,
+  kTenthsOfMiles,
+  kFeet,
+  kNumberSign,
+  kBranchSign,
+  kTowardSign,
+  kNameSign,
+  kJunctionName,
+  kFerryLabel,
+  kTransitPlatform,
+  kStationLabel,
+  kTime,
+  kTransitName,
+  kTransitHeadSign,
+  kTransitPlatformCount,
+  kTransitPlatformCountLabel,
+  kLevel,
+  kNone // plain text, or something in angle brackets that isnt one of the tags
+};
+
+/**
+ * A phrase split into its plain text and its tags when the dictionary is loaded, so that forming
+ * an instruction is a single pass over the pieces rather than a search of the phrase per tag.
+ */
+class PhraseTemplate {
+public:
+  // the value only has to live until the instruction is rendered, it is never copied
+  struct tag_value_t {
+    tag_value_t(PhraseTag tag, const std::string& value) : tag(tag), value(value) {
+    }
+    PhraseTag tag;
+    const std::string& value;
+  };
+  using tag_values_t = std::initializer_list<tag_value_t>;
+
+  PhraseTemplate() = default;
+  explicit PhraseTemplate(const std::string& phrase);
+
+  /**
+   * Writes the phrase with its tags replaced by the specified values into the specified string,
+   * tags without a value are written as they are.
+   *
+   * @param  instruction  The string to write to, it is cleared first so its capacity is reused.
+   * @param  values       The tags to replace and the values to replace them with.
+   */
+  void Render(std::string& instruction, tag_values_t values = {}) const;
+
+  const std::string& phrase() const {
+    return phrase_;
+  }
+
+private:
+  struct token_t {
+    uint32_t offset;
+    uint32_t length;
+    PhraseTag tag;
+  };
+
+  std::string phrase_;
+  std::vector<token_t> tokens_;
+};
+
 struct PhraseSet {
   std::unordered_map<std::string, std::string> phrases;
+
+  // the same phrases already split into templates, keyed by phrase id
+  std::unordered_map<uint8_t, PhraseTemplate> templates;
 };
 
 struct StartSubset : PhraseSet {
@@ -32,8 +32,29 @@ public:
   NarrativeBuilder(const NarrativeBuilder&) = default;
   NarrativeBuilder& operator=(const NarrativeBuilder&) = default;
 
+  /**
+   * Sets both the text and the verbal instructions of the specified maneuvers.
+   *
+   * @param maneuvers The maneuver list to process.
+   */
   void Build(std::list<Maneuver>& maneuvers);
 
+  /**
+   * Sets only the text instructions (including depart and arrive) of the specified maneuvers.
+   *
+   * @param maneuvers The maneuver list to process.
+   */
+  void BuildInstructions(std::list<Maneuver>& maneuvers);
+
+  /**
+   * Sets only the verbal instructions of the specified maneuvers, including the multi-cue
+   * instructions. These do not depend on the text instructions so they can be skipped when the
+   * output does not use them.
+   *
+   * @param maneuvers The maneuver list to process.
+   */
+  void BuildVerbalInstructions(std::list<Maneuver>& maneuvers);
+
   // A few of the form instruction methods need to be public to enable updates based on length
 
   /////////////////////////////////////////////////////////////////////////////
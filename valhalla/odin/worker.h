@@ -1,8 +1,10 @@
 #ifndef __VALHALLA_ODIN_SERVICE_H__
 #define __VALHALLA_ODIN_SERVICE_H__
 
+#include <valhalla/midgard/thread_pool.h>
 #include <valhalla/odin/markup_formatter.h>
 #include <valhalla/proto/api.pb.h>
+#include <valhalla/response_cache.h>
 #include <valhalla/worker.h>
 
 namespace valhalla {
@@ -32,6 +34,10 @@ public:
 
 protected:
   MarkupFormatter markup_formatter_;
+  // the threads to build the directions of the legs of a route with
+  std::shared_ptr<midgard::ThreadPool> leg_pool_;
+  // where route responses go if caching is enabled
+  std::shared_ptr<ResponseCache> response_cache_;
 
 private:
   std::string service_name() const override {
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <valhalla/baldr/graphreader.h>
+#include <valhalla/midgard/lru_cache.h>
+#include <valhalla/proto/api.pb.h>
+
+namespace valhalla {
+
+/**
+ * A cache of serialized responses for requests that come in over and over again, like dashboards
+ * polling the same etas. Requests are keyed on their parsed options with a current date_time
+ * bucketed. The locations are kept exactly as they came in because the responses echo them back.
+ * Each response also remembers the dataset id of the graph and the version of the live traffic it
+ * was computed with and is only served while those havent changed and it hasnt expired. Workers
+ * check for new tiles and traffic with Refresh() when they clean up after a request.
+ *
+ * The cache is configured under `loki.response_cache` and disabled unless
+ * `loki.response_cache.max_bytes` is set. The workers of a process that are configured with the
+ * same settings share one cache. Lookups happen before loki, on a miss the key travels along in the
+ * request info so that whoever serializes the response can store it. So the cache only fills up
+ * when the stages of the pipeline run in the same process.
+ */
+class ResponseCache {
+public:
+  /**
+   * Gets the cache of this process for the response_cache settings in the config, making it on the
+   * first call with those settings
+   * @param config  the config with the optional loki.response_cache section
+   * @return the cache or nullptr if caching is disabled
+   */
+  static std::shared_ptr<ResponseCache> Get(const boost::property_tree::ptree& config);
+
+  /**
+   * Constructor, you probably want the shared one from Get()
+   * @param max_bytes         how many bytes of keys and responses to keep at most
+   * @param max_age           how many seconds responses are served for
+   * @param date_time_bucket  how many seconds a current date_time request is the same request
+   */
+  ResponseCache(size_t max_bytes, uint32_t max_age, uint32_t date_time_bucket);
+
+  /**
+   * Looks up the response to a parsed request. On a miss of a request that can be cached its key
+   * and what it will be computed on are put in its info for Store() to find later. Either way a
+   * hit or miss statistic is added to the info
+   * @param api       the parsed request
+   * @param reader    the graph the request would be computed on
+   * @param response  where the cached response goes
+   * @return true if there was a response to serve
+   */
+  bool Lookup(Api& api, baldr::GraphReader& reader, std::string& response);
+
+  /**
+   * Looks at the tiles to see if they or their live traffic changed since the last time. New tiles
+   * mean a new dataset id and none of their responses are kept. The traffic is only scanned again
+   * once in a while. This is meant to be called between requests, like when a worker cleans up, so
+   * that lookups dont have to
+   * @param reader  the graph requests are computed on
+   */
+  void Refresh(baldr::GraphReader& reader);
+
+  /**
+   * Keeps the response to a request if Lookup() marked it as one that can be cached
+   * @param api       the request whose response this is
+   * @param response  the serialized response
+   */
+  void Store(const Api& api, const std::string& response);
+
+  /**
+   * @return how many bytes of keys and responses are in the cache
+   */
+  size_t size() const;
+
+  /**
+   * Removes everything from the cache
+   */
+  void Clear();
+
+protected:
+  // the normalized request, the same for every request that should get the same response
+  std::string Key(const Api& api, const baldr::GraphReader& reader) const;
+
+  struct entry_t {
+    std::string response;
+    uint64_t dataset_id;
+    uint64_t traffic;
+  };
+
+  // what the graph and traffic looked like when Refresh() last looked at them
+  struct tileset_t {
+    uint64_t dataset_id;
+    uint64_t traffic;
+    time_t last_modified;
+    std::chrono::steady_clock::time_point traffic_checked;
+  };
+
+  const uint32_t date_time_bucket_;
+
+  mutable std::mutex mutex_;
+  midgard::lru_cache<std::string, entry_t> entries_;
+  std::unordered_map<std::string, tileset_t> tilesets_;
+};
+
+} // namespace valhalla
@@ -36,9 +36,12 @@ public:
   /// when valhalla_benchmark_skadi start using config instead of folder
   /**
    * @brief Constructor
-   * @param[in] data_source  directory name of the datasource from which to sample
+   * @param[in] data_source   directory name of the datasource from which to sample
+   * @param[in] unpacked_dir  directory to unpack compressed tiles into the first time they are used,
+   *                          they are memory mapped from there afterwards rather than kept unpacked
+   *                          in memory. empty to keep them in memory
    */
-  sample(const std::string& data_source);
+  sample(const std::string& data_source, const std::string& unpacked_dir = "");
   ~sample();
 
   /**
@@ -48,8 +51,10 @@ public:
   template <class coord_t> double get(const coord_t& coord);
 
   /**
-   * @brief Get multiple samples from the datasource
+   * @brief Get multiple samples from the datasource, grouped by tile so that each tile is only
+   * looked up once
    * @param coords  the list of postings at which to sample the datasource
+   * @return the samples in the same order as the postings
    */
   template <class coords_t> std::vector<double> get_all(const coords_t& coords);
 
@@ -98,8 +103,9 @@ private:
   /**
    * @brief used to warm cache
    * @param[in] source_path File local storage directory.
+   * @param[in] unpacked_dir Where to unpack compressed tiles to, if anywhere.
    */
-  void cache_initialisation(const std::string& source_path);
+  void cache_initialisation(const std::string& source_path, const std::string& unpacked_dir);
 
   std::mutex cache_lck;
   std::string url_;
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 #include <boost/property_tree/ptree.hpp>
@@ -15,8 +16,11 @@
 #include <valhalla/baldr/location.h>
 #include <valhalla/meili/map_matcher_factory.h>
 #include <valhalla/meili/match_result.h>
+#include <valhalla/meili/match_sessions.h>
+#include <valhalla/midgard/thread_pool.h>
 #include <valhalla/proto/options.pb.h>
 #include <valhalla/proto/trip.pb.h>
+#include <valhalla/response_cache.h>
 #include <valhalla/sif/costfactory.h>
 #include <valhalla/sif/edgelabel.h>
 #include <valhalla/thor/astar_bss.h>
@@ -94,6 +98,27 @@ protected:
   void path_arrive_by(Api& api, const std::string& costing);
   void path_depart_at(Api& api, const std::string& costing);
 
+  // everything TripLegBuilder needs to build one leg of a route once its path is found
+  struct leg_job_t {
+    TripLeg* leg;
+    std::vector<PathInfo> path;
+    valhalla::Location origin;
+    valhalla::Location destination;
+    std::vector<std::string> algorithms;
+    std::unordered_map<size_t, std::pair<EdgeTrimmingInfo, EdgeTrimmingInfo>> edge_trimming;
+    std::vector<valhalla::Location> intermediates;
+    // where the origin came from, building the leg can set its date_time when it was 'current'
+    valhalla::Location* correlated_origin;
+  };
+
+  /**
+   * Builds the legs of a route now that all of their paths are found. The legs dont depend on
+   * each other so they are split into contiguous runs over the leg readers and built on leg_pool
+   * @param legs     the legs to build, each one is filled in place
+   * @param options  the request options
+   */
+  void build_legs(std::vector<leg_job_t>& legs, const Options& options);
+
   void parse_locations(Api& request);
   void parse_measurements(const Api& request);
   std::string parse_costing(const Api& request);
@@ -135,9 +160,16 @@ protected:
   std::unordered_map<std::string, float> max_matrix_distance;
   SOURCE_TO_TARGET_ALGORITHM source_to_target_algorithm;
   std::shared_ptr<baldr::GraphReader> reader;
+  // a reader per thread sharing a tile cache and the threads to build the legs of a route in parallel
+  std::vector<std::shared_ptr<baldr::GraphReader>> leg_readers;
+  std::shared_ptr<midgard::ThreadPool> leg_pool;
   meili::MapMatcherFactory matcher_factory;
+  // matchers of the traces that come in a few points at a time
+  meili::MatchSessions match_sessions;
   baldr::AttributesController controller;
   Centroid centroid_gen;
+  // where matrix responses go if caching is enabled
+  std::shared_ptr<ResponseCache> response_cache;
 
 private:
   std::string service_name() const override {
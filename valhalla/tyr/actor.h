@@ -2,6 +2,8 @@
 #define VALHALLA_TYR_ACTOR_H_
 
 #include <boost/property_tree/ptree.hpp>
+#include <functional>
+#include <istream>
 #include <memory>
 #include <unordered_map>
 
@@ -213,6 +215,25 @@ public:
                      const std::function<void()>* interrupt = nullptr,
                      Api* api = nullptr);
 
+  /**
+   * Perform the trace_route or trace_attributes action for many requests at once by spreading them
+   * over a pool of threads. Each thread has its own workers, and so its own map matchers which stay
+   * warm from one request to the next, but they all share the same tile cache. The threads and their
+   * workers are kept for the next batch with the same concurrency. Responses are handed back as soon
+   * as they are ready so they are not in the same order as the requests
+   * @param requests     newline delimited json requests, blank lines are skipped. requests for pbf
+   *                     output fail with error 169 because each response has to fit on a line
+   * @param action       either trace_route or trace_attributes
+   * @param result       called with the line number (starting at 0) of the request, whether or not
+   *                     it succeeded and its json response or error. the calls are serialized
+   * @param concurrency  how many threads to use, 0 means one per core
+   * @return how many of the requests failed
+   */
+  size_t trace_batch(std::istream& requests,
+                     Options::Action action,
+                     const std::function<void(size_t, bool, const std::string&)>& result,
+                     unsigned int concurrency = 0);
+
 protected:
   struct pimpl_t;
   std::shared_ptr<pimpl_t> pimpl;
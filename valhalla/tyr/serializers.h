@@ -1,6 +1,7 @@
 #ifndef __VALHALLA_TYR_SERVICE_H__
 #define __VALHALLA_TYR_SERVICE_H__
 
+#include <cmath>
 #include <iostream>
 #include <list>
 #include <string>
@@ -28,19 +29,20 @@ namespace tyr {
 std::string serializeDirections(Api& request);
 
 /**
- * Turn a time distance matrix into json that one can look up location pair results from
+ * Turn a time distance matrix into json that one can look up location pair results from, or into
+ * the matrix of the pbf response
  */
-std::string serializeMatrix(const Api& request,
+std::string serializeMatrix(Api& request,
                             const std::vector<thor::TimeDistance>& time_distances,
                             double distance_scale);
 
 /**
- * Turn grid data contours into geojson
+ * Turn grid data contours into geojson, or into the isochrone of the pbf response
  *
  * @param grid_contours    the contours generated from the grid
  * @param colors           the #ABC123 hex string color used in geojson fill color
  */
-std::string serializeIsochrones(const Api& request,
+std::string serializeIsochrones(Api& request,
                                 std::vector<midgard::GriddedData<2>::contour_interval_t>& intervals,
                                 midgard::GriddedData<2>::contours_t& contours,
                                 bool polygons = true,
@@ -53,7 +55,7 @@ std::string serializeIsochrones(const Api& request,
  * @param heights  The actual height at each shape point
  * @param ranges   The distances between each point. If this is empty no ranges are serialized
  */
-std::string serializeHeight(const Api& request,
+std::string serializeHeight(Api& request,
                             const std::vector<double>& heights,
                             const std::vector<double>& ranges = {});
 
@@ -66,7 +68,7 @@ std::string serializeHeight(const Api& request,
  * @param reader       A graph reader to get at each correlated points info
  */
 std::string
-serializeLocate(const Api& request,
+serializeLocate(Api& request,
                 const std::vector<baldr::Location>& locations,
                 const std::unordered_map<baldr::Location, baldr::PathLocation>& projections,
                 baldr::GraphReader& reader);
@@ -117,6 +119,25 @@ void openlr(const valhalla::Api& api, int route_index, rapidjson::writer_wrapper
  */
 std::string serializePbf(Api& request);
 
+/**
+ * Appends points to the coordinates of a pbf geometry as lon lat pairs in millionths of a degree,
+ * every pair but the first is stored as the difference from the one before it so they stay small
+ * @param points  the points to add
+ * @param coords  the coordinates of the geometry
+ */
+template <typename points_t>
+void to_pbf_coords(const points_t& points, google::protobuf::RepeatedField<int32_t>& coords) {
+  int32_t lon = 0, lat = 0;
+  for (const auto& point : points) {
+    const auto x = static_cast<int32_t>(std::round(point.first * 1e6));
+    const auto y = static_cast<int32_t>(std::round(point.second * 1e6));
+    coords.Add(x - lon);
+    coords.Add(y - lat);
+    lon = x;
+    lat = y;
+  }
+}
+
 } // namespace tyr
 } // namespace valhalla
 
@@ -136,6 +157,14 @@ valhalla::baldr::json::ArrayPtr
 waypoints(const google::protobuf::RepeatedPtrField<valhalla::Location>& locations,
           bool tracepoints = false);
 valhalla::baldr::json::ArrayPtr waypoints(const valhalla::Trip& locations);
+
+/*
+ * Write locations as an array of osrm waypoints under the given key straight into a json writer,
+ * the same as the DOM ones would come out for locations that arent tracepoints
+ */
+void waypoints(const char* key,
+               const google::protobuf::RepeatedPtrField<valhalla::Location>& locations,
+               rapidjson::writer_wrapper_t& writer);
 valhalla::baldr::json::ArrayPtr intermediate_waypoints(const valhalla::TripLeg& leg);
 
 void serializeIncidentProperties(rapidjson::Writer<rapidjson::StringBuffer>& writer,
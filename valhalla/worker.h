@@ -1,6 +1,8 @@
 #ifndef __VALHALLA_SERVICE_H__
 #define __VALHALLA_SERVICE_H__
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <valhalla/baldr/json.h>
 #include <valhalla/baldr/rapidjson_utils.h>
@@ -57,8 +59,12 @@ struct valhalla_exception_t : public std::runtime_error {
  * @param action        Which action to perform
  * @param api           The pbf request, this will be modified either with the json provided or, if
  *                      already filled out, it will be validated and the json will be ignored
+ * @param time_parsing  Whether to record how long the parsing took as a timing statistic
  */
-void ParseApi(const std::string& json_request, Options::Action action, Api& api);
+void ParseApi(const std::string& json_request,
+              Options::Action action,
+              Api& api,
+              bool time_parsing = false);
 #ifdef HAVE_HTTP
 /**
  * Take the json OR pbf request and parse/validate it. If you pass a protobuf mime type in the request
@@ -69,8 +75,11 @@ void ParseApi(const std::string& json_request, Options::Action action, Api& api)
  * @param api           The pbf request, this will be modified either with the json provided or, if
  *                      pbf bytes were passed, they will be deserialized into this object and any json
  *                      will be ignored
+ * @param time_parsing  Whether to record how long the parsing took as a timing statistic
  */
-void ParseApi(const prime_server::http_request_t& http_request, Api& api);
+void ParseApi(const prime_server::http_request_t& http_request,
+              Api& api,
+              bool time_parsing = false);
 #endif
 
 std::string serialize_error(const valhalla_exception_t& exception, Api& options);
@@ -91,6 +100,32 @@ prime_server::worker_t::result_t to_response(const std::string& data,
                                              const Api& options);
 #endif
 
+/**
+ * Where the Api of each request a worker handles gets allocated. Every request gets a fresh
+ * protobuf arena whose first block is memory kept between requests, so once that block has grown
+ * to fit the usual request the messages in the Api of a request are carved out of it instead of
+ * each being allocated on their own
+ */
+class request_arena_t {
+public:
+  /**
+   * @param max_block_size  the kept block wont grow past this, bigger requests spill onto the heap
+   */
+  explicit request_arena_t(size_t max_block_size = 16 * 1024 * 1024);
+
+  /**
+   * Makes a new empty Api in a new arena. The previous Api and everything in it is freed so only
+   * one of them can be in use at a time
+   * @return the Api which lives until the next call or until this is destroyed
+   */
+  Api& create();
+
+private:
+  std::vector<char> block_;
+  size_t max_block_size_;
+  std::unique_ptr<google::protobuf::Arena> arena_;
+};
+
 struct statsd_client_t;
 class service_worker_t {
 public:
@@ -157,6 +192,8 @@ protected:
 
   const std::function<void()>* interrupt;
   std::unique_ptr<statsd_client_t> statsd_client;
+  // the Api of the request being worked on is allocated from here
+  request_arena_t request_arena;
 };
 } // namespace valhalla
 